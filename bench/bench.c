@@ -0,0 +1,530 @@
+/*
+ * Standalone microbenchmark of the supernodal kernels in src/C.
+ *
+ * The benchmark generates reproducible chordal test problems, computes
+ * a symbolic factorization with symbolic_new(), and times the kernels
+ * cholesky, llt, projected_inverse, completion, hessian, and trsm.
+ * Results are written to stdout in JSON format.
+ *
+ * Usage: see usage() below or run "./chompack_bench --help".
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "chompack.h"
+
+#define MAX_PROBLEMS 64
+#define MAX_KERNELS 16
+
+static const char *default_suite[] = {
+  "grid2d:64", "grid3d:12", "band:4000:20", "arrow:4000:20",
+  "blockarrow:40:50:20", "randchordal:2000:0.9", NULL
+};
+
+static const char *all_kernels[] = {
+  "cholesky", "llt", "projected_inverse", "completion", "completion_fu", "hessian", "trsm", NULL
+};
+
+/* ---------------------------------------------------------------------- */
+/* random numbers (xorshift64*), reproducible across platforms            */
+
+static unsigned long long rng_state = 88172645463325252ULL;
+
+static void rng_seed(unsigned long long seed) {
+  rng_state = seed ? seed*2685821657736338717ULL : 88172645463325252ULL;
+}
+
+static double rng_uniform(void) {
+  rng_state ^= rng_state >> 12;
+  rng_state ^= rng_state << 25;
+  rng_state ^= rng_state >> 27;
+  return ((rng_state*2685821657736338717ULL) >> 11)*(1.0/9007199254740992.0);
+}
+
+/* ---------------------------------------------------------------------- */
+/* test problems                                                          */
+
+typedef struct {
+  char name[64];
+  int_t n;
+  int_t ne, cap;       // number of strictly lower triangular edges
+  int_t *ei, *ej;      // edges (ei > ej)
+  int_t *perm;         // fill-reducing ordering (NULL: natural)
+  int_t *colptr, *rowidx;  // lower triangular CCS pattern incl. diagonal
+  double *val;
+} problem;
+
+static void add_edge(problem *P, int_t i, int_t j) {
+  if (i == j) return;
+  if (P->ne == P->cap) {
+    P->cap = P->cap ? 2*P->cap : 1024;
+    P->ei = realloc(P->ei, P->cap*sizeof(int_t));
+    P->ej = realloc(P->ej, P->cap*sizeof(int_t));
+    if (!P->ei || !P->ej) { fprintf(stderr, "out of memory\n"); exit(1); }
+  }
+  P->ei[P->ne] = (i > j) ? i : j;
+  P->ej[P->ne] = (i > j) ? j : i;
+  P->ne++;
+}
+
+static void dissect(const int_t *dim, int_t *lo, int_t *hi, int_t *perm, int_t *cnt) {
+  /*
+    Nested dissection ordering of the grid points in the box [lo,hi)
+    (geometric bisection of the longest side; the separator plane is
+    ordered last).
+   */
+  int_t d,k,x,y,z,mid,len[3],a[3],b[3];
+  for (d=0;d<3;d++) len[d] = hi[d]-lo[d];
+  if (len[0] <= 0 || len[1] <= 0 || len[2] <= 0) return;
+  k = (len[1] > len[0]) ? 1 : 0;
+  if (len[2] > len[k]) k = 2;
+  if (len[0]*len[1]*len[2] <= 8 || len[k] < 3) {
+    for (z=lo[2];z<hi[2];z++)
+      for (y=lo[1];y<hi[1];y++)
+	for (x=lo[0];x<hi[0];x++) perm[(*cnt)++] = x + dim[0]*(y + dim[1]*z);
+    return;
+  }
+  mid = lo[k] + len[k]/2;
+  memcpy(a, lo, 3*sizeof(int_t)); memcpy(b, hi, 3*sizeof(int_t));
+  b[k] = mid;
+  dissect(dim, a, b, perm, cnt);
+  a[k] = mid+1; b[k] = hi[k];
+  dissect(dim, a, b, perm, cnt);
+  a[k] = mid; b[k] = mid+1;
+  for (z=a[2];z<b[2];z++)
+    for (y=a[1];y<b[1];y++)
+      for (x=a[0];x<b[0];x++) perm[(*cnt)++] = x + dim[0]*(y + dim[1]*z);
+}
+
+static void gen_grid(problem *P, int_t nx, int_t ny, int_t nz) {
+  int_t x,y,z,j,cnt = 0,dim[3] = {nx,ny,nz},lo[3] = {0,0,0};
+  P->n = nx*ny*nz;
+  for (z=0;z<nz;z++) {
+    for (y=0;y<ny;y++) {
+      for (x=0;x<nx;x++) {
+	j = x + nx*(y + ny*z);
+	if (x+1 < nx) add_edge(P, j+1, j);
+	if (y+1 < ny) add_edge(P, j+nx, j);
+	if (z+1 < nz) add_edge(P, j+nx*ny, j);
+      }
+    }
+  }
+  P->perm = malloc(P->n*sizeof(int_t));
+  dissect(dim, lo, dim, P->perm, &cnt);
+}
+
+static void gen_band(problem *P, int_t n, int_t bw) {
+  int_t i,j;
+  P->n = n;
+  for (j=0;j<n;j++)
+    for (i=j+1;i<n && i<=j+bw;i++) add_edge(P, i, j);
+}
+
+static void gen_blockarrow(problem *P, int_t nb, int_t bs, int_t w) {
+  /*
+    nb dense diagonal blocks of order bs and a dense border of width w
+    (an arrow matrix if bs = 1).
+   */
+  int_t b,i,j,m = nb*bs;
+  P->n = m + w;
+  for (b=0;b<nb;b++)
+    for (j=b*bs;j<(b+1)*bs;j++)
+      for (i=j+1;i<(b+1)*bs;i++) add_edge(P, i, j);
+  for (i=m;i<m+w;i++)
+    for (j=0;j<i;j++) add_edge(P, i, j);
+}
+
+static void gen_randchordal(problem *P, int_t n, double keep) {
+  /*
+    Random chordal graph with perfect elimination ordering 0, 1, ...,
+    n-1: column j is adjacent to a random parent p > j and to a random
+    subset (each element kept with probability keep) of the higher
+    neighbors of p.
+   */
+  int_t j,p,t,*ptr,*idx,*cnt,len = 0,cap = 1024;
+  P->n = n;
+  ptr = malloc(n*sizeof(int_t));
+  cnt = calloc(n,sizeof(int_t));
+  idx = malloc(cap*sizeof(int_t));
+  for (j=n-1;j>=0;j--) {
+    ptr[j] = len;
+    if (j == n-1) continue;
+    p = j+1 + (int_t) (rng_uniform()*(n-j-1));
+    if (p > n-1) p = n-1;
+    if (len + cnt[p] + 1 > cap) {
+      while (len + cnt[p] + 1 > cap) cap *= 2;
+      idx = realloc(idx, cap*sizeof(int_t));
+    }
+    idx[len++] = p;
+    cnt[j] = 1;
+    for (t=ptr[p];t<ptr[p]+cnt[p];t++) {
+      if (rng_uniform() < keep) { idx[len++] = idx[t]; cnt[j]++; }
+    }
+    for (t=ptr[j];t<ptr[j]+cnt[j];t++) add_edge(P, idx[t], j);
+  }
+  free(ptr); free(cnt); free(idx);
+}
+
+static int problem_generate(problem *P, const char *spec) {
+  long a = 0, b = 0, c = 0;
+  double f = 0.9;
+  memset(P, 0, sizeof(problem));
+  snprintf(P->name, sizeof(P->name), "%s", spec);
+  if (sscanf(spec, "grid2d:%ld", &a) == 1 && a > 0) gen_grid(P, a, a, 1);
+  else if (sscanf(spec, "grid3d:%ld", &a) == 1 && a > 0) gen_grid(P, a, a, a);
+  else if (sscanf(spec, "band:%ld:%ld", &a, &b) == 2 && a > 0 && b >= 0) gen_band(P, a, b);
+  else if (sscanf(spec, "arrow:%ld:%ld", &a, &b) == 2 && a > b && b >= 0) gen_blockarrow(P, a-b, 1, b);
+  else if (sscanf(spec, "blockarrow:%ld:%ld:%ld", &a, &b, &c) == 3 && a > 0 && b > 0 && c >= 0) gen_blockarrow(P, a, b, c);
+  else if (sscanf(spec, "randchordal:%ld:%lf", &a, &f) >= 1 && a > 0) gen_randchordal(P, a, f);
+  else return -1;
+  return 0;
+}
+
+static int idx_cmp(const void *x, const void *y) {
+  int_t a = *(const int_t *) x, b = *(const int_t *) y;
+  return (a > b) - (a < b);
+}
+
+static void problem_assemble(problem *P) {
+  /*
+    Lower triangular CCS pattern with random off-diagonal values in
+    [-1,1] and a dominant diagonal (A is positive definite).
+   */
+  int_t i,j,t,n = P->n,*pos;
+  double *rowsum = calloc(n,sizeof(double));
+  P->colptr = calloc(n+1,sizeof(int_t));
+  P->rowidx = malloc((P->ne+n)*sizeof(int_t));
+  P->val = malloc((P->ne+n)*sizeof(double));
+  pos = malloc(n*sizeof(int_t));
+  for (t=0;t<P->ne;t++) P->colptr[P->ej[t]+1]++;
+  for (j=0;j<n;j++) P->colptr[j+1] += P->colptr[j] + 1;
+  for (j=0;j<n;j++) {
+    pos[j] = P->colptr[j];
+    P->rowidx[pos[j]++] = j;
+  }
+  for (t=0;t<P->ne;t++) P->rowidx[pos[P->ej[t]]++] = P->ei[t];
+  for (j=0;j<n;j++)
+    qsort(P->rowidx+P->colptr[j]+1, P->colptr[j+1]-P->colptr[j]-1, sizeof(int_t), idx_cmp);
+  for (j=0;j<n;j++) {
+    for (t=P->colptr[j]+1;t<P->colptr[j+1];t++) {
+      i = P->rowidx[t];
+      P->val[t] = 2.0*rng_uniform()-1.0;
+      rowsum[i] += fabs(P->val[t]);
+      rowsum[j] += fabs(P->val[t]);
+    }
+  }
+  for (j=0;j<n;j++) P->val[P->colptr[j]] = rowsum[j] + 1.0;
+  free(rowsum); free(pos);
+  free(P->ei); free(P->ej);
+  P->ei = P->ej = NULL;
+}
+
+static void problem_free(problem *P) {
+  free(P->ei); free(P->ej); free(P->perm);
+  free(P->colptr); free(P->rowidx); free(P->val);
+}
+
+/* ---------------------------------------------------------------------- */
+/* timing                                                                 */
+
+static double wtime(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+static int dbl_cmp(const void *x, const void *y) {
+  double a = *(const double *) x, b = *(const double *) y;
+  return (a > b) - (a < b);
+}
+
+typedef struct {
+  symbolic *S;
+  int_t nnzL;
+  double *A, *L, *Y, *X, *B;  // blkval of A, L, Y = P(inv(A)), work copy; rhs
+  double *fws, *upd, *ws;
+  int_t *upd_size;
+  int nrhs;
+  int nthreads;              // threads for the tiled factorization of large fronts
+} context;
+
+static int run_kernel(context *C, const char *kernel) {
+  /*
+    Runs one kernel on the work copy C->X (which is restored from the
+    appropriate input outside of the timed region). Returns the info
+    value of the kernel.
+   */
+  symbolic *S = C->S;
+  double *ublkval[2];
+  int ldb = (int) S->n, info = 0;
+
+  if (!strcmp(kernel, "cholesky"))
+    info = cholesky(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+		    S->blkptr, C->X, C->fws, C->upd, C->upd_size, C->nthreads, NULL);
+  else if (!strcmp(kernel, "llt"))
+    llt(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+	S->blkptr, C->X, C->fws, C->upd, C->upd_size);
+  else if (!strcmp(kernel, "projected_inverse"))
+    info = projected_inverse(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+			     S->blkptr, C->X, C->fws, C->upd, C->upd_size);
+  else if (!strcmp(kernel, "completion") || !strcmp(kernel, "completion_fu"))
+    info = completion(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+		      S->blkptr, C->X, C->fws, C->upd, C->upd_size, C->ws, !strcmp(kernel, "completion_fu"));
+  else if (!strcmp(kernel, "hessian")) {
+    // H(U) followed by its adjoint, as in chompack.hessian(..., adj = None)
+    ublkval[0] = C->X; ublkval[1] = NULL;
+    info = hessian(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+		   S->blkptr, C->L, C->Y, ublkval, C->fws, C->upd, C->upd_size, C->ws, 0, 0, 0);
+    if (!info)
+      info = hessian(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+		     S->blkptr, C->L, C->Y, ublkval, C->fws, C->upd, C->upd_size, C->ws, 0, 1, 0);
+  }
+  else if (!strcmp(kernel, "trsm")) {
+    trsm('N', C->nrhs, 1.0, S->n, S->nsn, S->snpost, S->snptr, S->snode, S->relptr, S->relidx,
+	 S->chptr, S->chidx, S->blkptr, S->p, C->L, C->X, &ldb, C->fws, C->upd, C->upd_size);
+    trsm('T', C->nrhs, 1.0, S->n, S->nsn, S->snpost, S->snptr, S->snode, S->relptr, S->relidx,
+	 S->chptr, S->chidx, S->blkptr, S->p, C->L, C->X, &ldb, C->fws, C->upd, C->upd_size);
+  }
+  return info;
+}
+
+static void restore(context *C, const char *kernel) {
+  size_t nb = C->S->blkptr[C->S->nsn]*sizeof(double);
+  if (!strcmp(kernel, "cholesky") || !strcmp(kernel, "hessian")) memcpy(C->X, C->A, nb);
+  else if (!strcmp(kernel, "llt") || !strcmp(kernel, "projected_inverse")) memcpy(C->X, C->L, nb);
+  else if (!strncmp(kernel, "completion", 10)) memcpy(C->X, C->Y, nb);
+  else if (!strcmp(kernel, "trsm")) memcpy(C->X, C->B, C->S->n*C->nrhs*sizeof(double));
+}
+
+static double kernel_flops(context *C, const char *kernel) {
+  /*
+    Nominal flop counts in terms of the column counts c_j of L:
+    cholesky and llt sum(c_j^2), projected_inverse and completion
+    2*sum(c_j^2), hessian (forward and adjoint) 4*sum(c_j^2), and trsm
+    (forward and backward) 4*nrhs*sum(c_j).
+   */
+  symbolic *S = C->S;
+  int_t k,i,nn,nj;
+  double s1 = 0.0, s2 = 0.0, c;
+  for (k=0;k<S->nsn;k++) {
+    nn = S->snptr[k+1]-S->snptr[k];
+    nj = S->sncolptr[k+1]-S->sncolptr[k];
+    for (i=0;i<nn;i++) {
+      c = (double) (nj-i);
+      s1 += c;
+      s2 += c*c;
+    }
+  }
+  if (!strcmp(kernel, "cholesky") || !strcmp(kernel, "llt")) return s2;
+  if (!strcmp(kernel, "projected_inverse") || !strncmp(kernel, "completion", 10)) return 2.0*s2;
+  if (!strcmp(kernel, "hessian")) return 4.0*s2;
+  if (!strcmp(kernel, "trsm")) return 4.0*C->nrhs*s1;
+  return 0.0;
+}
+
+static size_t kernel_workspace(context *C, const char *kernel) {
+  /*
+    Estimated workspace (in bytes): the sizes that the Python
+    interface allocates for the kernel, computed from the symbolic
+    factorization and excluding the blkval arrays. This is not a
+    measured peak; the benchmark itself preallocates the workspace of
+    all kernels.
+   */
+  symbolic *S = C->S;
+  size_t cln = S->clique_number, fu = UPDATE_FACTOR_WS(S->update_factor_mem, S->clique_number);
+  if (!strcmp(kernel, "trsm"))
+    return (S->stack_solve*C->nrhs + cln*C->nrhs)*sizeof(double) + S->stack_depth*sizeof(int_t);
+  return (S->stack_mem + cln*cln + (!strcmp(kernel, "completion_fu") ? fu : 0))*sizeof(double)
+    + S->stack_depth*sizeof(int_t);
+}
+
+/* ---------------------------------------------------------------------- */
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+	  "usage: %s [options]\n"
+	  "  --problem SPEC   test problem (may be repeated); SPEC is one of\n"
+	  "                     grid2d:N             N-by-N grid Laplacian (nested dissection)\n"
+	  "                     grid3d:N             N-by-N-by-N grid Laplacian (nested dissection)\n"
+	  "                     band:n:bw            band matrix with bandwidth bw\n"
+	  "                     arrow:n:w            arrow matrix with border width w\n"
+	  "                     blockarrow:nb:bs:w   nb dense blocks of order bs, border width w\n"
+	  "                     randchordal:n[:keep] random chordal graph\n"
+	  "  --kernels LIST   comma-separated list of kernels (default: all)\n"
+	  "                     %s",
+	  prog, all_kernels[0]);
+  {
+    int i;
+    for (i=1;all_kernels[i];i++) fprintf(stderr, ",%s", all_kernels[i]);
+  }
+  fprintf(stderr,
+	  "\n"
+	  "  --reps R         timed repetitions (default: 10)\n"
+	  "  --warmup W       untimed warmup runs (default: 2)\n"
+	  "  --nrhs K         right-hand sides for trsm (default: 1)\n"
+	  "  --threads T      threads for large fronts in cholesky (default: 1)\n"
+	  "  --seed S         random seed (default: 1)\n");
+}
+
+static int bench_problem(const char *spec, char **kernels, int nk, int reps, int warmup, int nrhs,
+			 int nthreads, unsigned long long seed, int first) {
+  problem P;
+  context C;
+  symbolic *S;
+  int_t k,nnz,*colsn,*off;
+  double *v,*wv,*t,t0;
+  size_t nb;
+  int i,r,info,ok = 1;
+
+  rng_seed(seed);
+  if (problem_generate(&P, spec)) {
+    fprintf(stderr, "invalid problem specification '%s'\n", spec);
+    return -1;
+  }
+  problem_assemble(&P);
+  nnz = P.colptr[P.n];
+  if (symbolic_new(P.n, P.colptr, P.rowidx, P.perm, &S)) {
+    fprintf(stderr, "symbolic factorization failed (out of memory)\n");
+    problem_free(&P);
+    return -1;
+  }
+  memset(&C, 0, sizeof(context));
+  C.S = S;
+  C.nrhs = nrhs;
+  C.nthreads = nthreads;
+  nb = S->blkptr[S->nsn]*sizeof(double);
+  for (k=0;k<S->nsn;k++) {
+    int_t nn = S->snptr[k+1]-S->snptr[k], nj = S->sncolptr[k+1]-S->sncolptr[k];
+    C.nnzL += nn*nj - nn*(nn-1)/2;
+  }
+
+  // scatter A into blkval
+  colsn = malloc(S->n*sizeof(int_t));
+  off = malloc(nnz*sizeof(int_t));
+  v = malloc(nnz*sizeof(double));
+  wv = malloc(nnz*sizeof(double));
+  C.A = calloc(S->blkptr[S->nsn]+1, sizeof(double));
+  C.L = malloc(nb+sizeof(double));
+  C.Y = malloc(nb+sizeof(double));
+  C.X = malloc(nb+S->n*nrhs*sizeof(double));
+  C.B = malloc(S->n*nrhs*sizeof(double));
+  C.fws = malloc((S->clique_number*(S->clique_number > nrhs ? S->clique_number : nrhs)+1)*sizeof(double));
+  C.upd = malloc(((S->stack_mem > S->stack_solve*nrhs ? S->stack_mem : S->stack_solve*nrhs)+1)*sizeof(double));
+  C.upd_size = malloc((S->stack_depth+1)*sizeof(int_t));
+  C.ws = malloc(UPDATE_FACTOR_WS(S->update_factor_mem, S->clique_number)*sizeof(double));
+  t = malloc((reps > 0 ? reps : 1)*sizeof(double));
+  if (!colsn || !off || !v || !wv || !C.A || !C.L || !C.Y || !C.X || !C.B || !C.fws || !C.upd ||
+      !C.upd_size || !C.ws || !t) {
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+  spmap_colsn(S->nsn, S->snptr, S->snode, colsn);
+  if (spmap(S->n, colsn, S->sncolptr, S->snrowidx, S->blkptr, S->ip,
+	    P.colptr, P.rowidx, P.val, off, v, wv) != nnz) {
+    fprintf(stderr, "%s: sparsity pattern not contained in symbolic factorization\n", spec);
+    exit(1);
+  }
+  for (k=0;k<nnz;k++) C.A[off[k]] += v[k];
+  for (k=0;k<S->n*nrhs;k++) C.B[k] = 2.0*rng_uniform()-1.0;
+
+  // reference inputs: L = chol(A) and Y = P(inv(A))
+  memcpy(C.L, C.A, nb);
+  info = cholesky(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+		  S->blkptr, C.L, C.fws, C.upd, C.upd_size, nthreads, NULL);
+  if (info) {
+    fprintf(stderr, "%s: cholesky failed (info = %i)\n", spec, info);
+    ok = 0;
+  }
+  memcpy(C.Y, C.L, nb);
+  if (ok) projected_inverse(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+			    S->blkptr, C.Y, C.fws, C.upd, C.upd_size);
+
+  printf("%s    {\n", first ? "" : ",\n");
+  printf("      \"problem\": \"%s\",\n", spec);
+  printf("      \"n\": %ld, \"nnz\": %ld, \"nsn\": %ld, \"clique_number\": %ld, \"nnzL\": %ld,\n",
+	 (long) S->n, (long) (2*nnz-S->n), (long) S->nsn, (long) S->clique_number, (long) C.nnzL);
+  printf("      \"blkval_bytes\": %lu,\n", (unsigned long) nb);
+  printf("      \"kernels\": {");
+  for (i=0;i<nk && ok;i++) {
+    double tmin,tmed,tmean = 0.0,gf;
+    for (r=0;r<warmup;r++) {
+      restore(&C, kernels[i]);
+      run_kernel(&C, kernels[i]);
+    }
+    info = 0;
+    for (r=0;r<reps;r++) {
+      restore(&C, kernels[i]);
+      t0 = wtime();
+      info |= run_kernel(&C, kernels[i]);
+      t[r] = wtime()-t0;
+      tmean += t[r];
+    }
+    qsort(t, reps, sizeof(double), dbl_cmp);
+    tmin = reps ? t[0] : 0.0;
+    tmed = reps ? ((reps % 2) ? t[reps/2] : 0.5*(t[reps/2-1]+t[reps/2])) : 0.0;
+    tmean = reps ? tmean/reps : 0.0;
+    gf = (tmin > 0.0) ? 1e-9*kernel_flops(&C, kernels[i])/tmin : 0.0;
+    printf("%s\n        \"%s\": {\"min\": %.6e, \"median\": %.6e, \"mean\": %.6e, "
+	   "\"gflops\": %.4f, \"workspace_bytes_estimate\": %lu, \"info\": %i}",
+	   i ? "," : "", kernels[i], tmin, tmed, tmean, gf,
+	   (unsigned long) kernel_workspace(&C, kernels[i]), info);
+  }
+  printf("\n      }\n    }");
+
+  free(colsn); free(off); free(v); free(wv);
+  free(C.A); free(C.L); free(C.Y); free(C.X); free(C.B);
+  free(C.fws); free(C.upd); free(C.upd_size); free(C.ws); free(t);
+  symbolic_free(S);
+  problem_free(&P);
+  return ok ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+  const char *problems[MAX_PROBLEMS];
+  char *kernels[MAX_KERNELS], *list = NULL, *tok;
+  int i,np = 0,nk = 0,reps = 10,warmup = 2,nrhs = 1,nthreads = 1,status = 0;
+  unsigned long long seed = 1;
+
+  for (i=1;i<argc;i++) {
+    if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h")) {
+      usage(argv[0]);
+      return 0;
+    }
+    if (i+1 >= argc) { usage(argv[0]); return 1; }
+    if (!strcmp(argv[i], "--problem")) {
+      if (np < MAX_PROBLEMS) problems[np++] = argv[++i];
+    }
+    else if (!strcmp(argv[i], "--kernels")) list = argv[++i];
+    else if (!strcmp(argv[i], "--reps")) reps = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--warmup")) warmup = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--nrhs")) nrhs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--threads")) nthreads = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--seed")) seed = strtoull(argv[++i], NULL, 10);
+    else { usage(argv[0]); return 1; }
+  }
+  if (reps < 1 || warmup < 0 || nrhs < 1 || nthreads < 1) { usage(argv[0]); return 1; }
+  if (np == 0)
+    for (i=0;default_suite[i];i++) problems[np++] = default_suite[i];
+  if (list) {
+    for (tok=strtok(list, ",");tok && nk < MAX_KERNELS;tok=strtok(NULL, ",")) {
+      int found = 0;
+      for (i=0;all_kernels[i];i++) found |= !strcmp(tok, all_kernels[i]);
+      if (!found) { fprintf(stderr, "unknown kernel '%s'\n", tok); return 1; }
+      kernels[nk++] = tok;
+    }
+  }
+  else
+    for (i=0;all_kernels[i];i++) kernels[nk++] = (char *) all_kernels[i];
+
+  printf("{\n  \"reps\": %i, \"warmup\": %i, \"nrhs\": %i, \"threads\": %i, \"seed\": %llu,\n",
+	 reps, warmup, nrhs, nthreads, seed);
+  printf("  \"results\": [\n");
+  for (i=0;i<np;i++)
+    if (bench_problem(problems[i], kernels, nk, reps, warmup, nrhs, nthreads, seed, i == 0)) status = 1;
+  printf("\n  ]\n}\n");
+  return status;
+}
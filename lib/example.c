@@ -0,0 +1,119 @@
+/*
+ * Example and smoke test of libchompack (run with "make check").
+ *
+ * A is the 2-D Laplacian on a k-by-k grid plus a multiple of the
+ * identity. The example factors A, solves A*x = b, and checks the
+ * projected inverse Y = P(inv(A)) through two identities that hold
+ * because the filled pattern of A is chordal:
+ *
+ *   - the completion of Y has the same Cholesky factor as A, and
+ *   - the Hessian mapping at A applied to U = A is P(inv(A)*A*inv(A)) = Y.
+ *
+ * It also assembles A from coordinate format, in two chunks of the
+ * transposed entries with the diagonal split into duplicates, and
+ * checks that an out-of-range row index is rejected.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "libchompack.h"
+
+static double maxdiff(chompack_matrix *X, chompack_matrix *Y) {
+  chompack_int i, len;
+  double *x = chompack_matrix_values(X, &len), *y = chompack_matrix_values(Y, NULL), d = 0.0;
+  for (i=0;i<len;i++) if (fabs(x[i]-y[i]) > d) d = fabs(x[i]-y[i]);
+  return d;
+}
+
+int main(void) {
+  const chompack_int k = 30, n = k*k;
+  chompack_int i, j, t, c, *colptr, *rowidx;
+  chompack_int *ci, *cj;
+  double *val, *cv, *b, *x, r, rmax = 0.0, d0, d1, d2;
+  int bad;
+  chompack_symbolic *symb, *S;
+  chompack_matrix *A, *L, *Y, *U;
+
+  // lower triangle of A in CCS format
+  colptr = malloc((n+1)*sizeof(chompack_int));
+  rowidx = malloc(3*n*sizeof(chompack_int));
+  val = malloc(3*n*sizeof(double));
+  b = malloc(n*sizeof(double));
+  x = malloc(n*sizeof(double));
+  for (c=0,t=0;c<n;c++) {
+    colptr[c] = t;
+    rowidx[t] = c; val[t++] = 4.5;
+    if (c % k < k-1) { rowidx[t] = c+1; val[t++] = -1.0; }
+    if (c+k < n) { rowidx[t] = c+k; val[t++] = -1.0; }
+  }
+  colptr[n] = t;
+
+  if (chompack_analyze(n, colptr, rowidx, NULL, &symb)) return 1;
+  printf("n = %ld, supernodes = %ld, clique number = %ld, nnz(L) = %ld\n",
+	 (long) chompack_symbolic_order(symb), (long) chompack_symbolic_supernodes(symb),
+	 (long) chompack_symbolic_clique_number(symb), (long) chompack_symbolic_nnz(symb));
+
+  if (chompack_matrix_new(symb, &A)) return 1;
+  rowidx[1] = n;
+  bad = (chompack_analyze(n, colptr, rowidx, NULL, &S) != CHOMPACK_ERR_ARGUMENT ||
+	 chompack_matrix_add(A, colptr, rowidx, val, 1.0) != CHOMPACK_ERR_PATTERN);
+  rowidx[1] = 1;
+  if (chompack_matrix_add(A, colptr, rowidx, val, 1.0)) return 1;
+  if (chompack_matrix_copy(A, &L) || chompack_factor(L, 1)) return 1;
+
+  // U = A, assembled from the upper triangle in coordinate format
+  ci = malloc((t+n)*sizeof(chompack_int));
+  cj = malloc((t+n)*sizeof(chompack_int));
+  cv = malloc((t+n)*sizeof(double));
+  for (j=0,c=0;j<n;j++) {
+    for (i=colptr[j];i<colptr[j+1];i++) {
+      ci[c] = j; cj[c] = rowidx[i];
+      cv[c++] = (rowidx[i] == j) ? 0.5*val[i] : val[i];
+      if (rowidx[i] == j) { ci[c] = cj[c] = j; cv[c++] = 0.5*val[i]; }
+    }
+  }
+  if (chompack_matrix_new(symb, &U) ||
+      chompack_matrix_add_coo(U, c/2, ci, cj, cv, 1.0, 'U') ||
+      chompack_matrix_add_coo(U, c-c/2, ci+c/2, cj+c/2, cv+c/2, 1.0, 'A')) return 1;
+  d0 = maxdiff(U, A);
+  chompack_matrix_free(U);
+  free(ci); free(cj); free(cv);
+
+  // solve A*x = b and compute the residual
+  for (i=0;i<n;i++) b[i] = x[i] = 1.0 + (i % 7);
+  if (chompack_solve(L, 1, x, (int) n)) return 1;
+  for (j=0;j<n;j++) {
+    r = b[j];
+    for (t=colptr[j];t<colptr[j+1];t++) {
+      i = rowidx[t];
+      r -= val[t]*x[i];
+      if (i != j) b[i] -= val[t]*x[j];
+    }
+    b[j] = r;
+  }
+  for (i=0;i<n;i++) if (fabs(b[i]) > rmax) rmax = fabs(b[i]);
+
+  // Y = P(inv(A)); completion(Y) = L
+  if (chompack_matrix_copy(L, &Y) || chompack_projected_inverse(Y)) return 1;
+  if (chompack_matrix_copy(Y, &U) || chompack_completion(U, 0)) return 1;
+  d1 = maxdiff(U, L);
+  chompack_matrix_free(U);
+
+  // H(A) = Y
+  if (chompack_matrix_copy(A, &U) || chompack_hessian(L, Y, &U, 1, -1, 0)) return 1;
+  d2 = maxdiff(U, Y);
+
+  printf("invalid input: %s\n", bad ? "accepted" : "rejected");
+  printf("coordinate format: max error = %.2e\n", d0);
+  printf("solve: max residual = %.2e\n", rmax);
+  printf("completion: max error = %.2e\n", d1);
+  printf("hessian: max error = %.2e\n", d2);
+
+  chompack_matrix_free(A); chompack_matrix_free(L);
+  chompack_matrix_free(Y); chompack_matrix_free(U);
+  chompack_symbolic_free(symb);
+  free(colptr); free(rowidx); free(val); free(b); free(x);
+
+  return (!bad && d0 < 1e-15 && rmax < 1e-10 && d1 < 1e-10 && d2 < 1e-10) ? 0 : 1;
+}
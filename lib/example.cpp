@@ -0,0 +1,110 @@
+/*
+ * Example and smoke test of the C++ interface chompack.hpp (run with
+ * "make check"). A is the matrix of example.c; in single and double
+ * precision, with 32-bit and 64-bit indices, the example factors A,
+ * computes inv(A) by a solve with n right-hand sides and compares it
+ * with the projected inverse, and checks that a failed factorization
+ * is not marked as a factor. In double precision, it also checks the
+ * completion and Hessian identities of example.c.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include "chompack.hpp"
+
+template<typename T, typename I>
+struct laplacian {
+  // lower triangle of A in CCS format
+  explicit laplacian(I k) : n(k*k), colptr(n+1) {
+    for (I c=0; c<n; c++) {
+      colptr[c] = static_cast<I>(rowidx.size());
+      rowidx.push_back(c); val.push_back(T(4.5));
+      if (c % k < k-1) { rowidx.push_back(c+1); val.push_back(T(-1)); }
+      if (c+k < n) { rowidx.push_back(c+k); val.push_back(T(-1)); }
+    }
+    colptr[n] = static_cast<I>(rowidx.size());
+  }
+  I n;
+  std::vector<I> colptr, rowidx;
+  std::vector<T> val;
+};
+
+template<typename T, typename I>
+static T maxdiff(const chompack::matrix<T,I>& X, const chompack::matrix<T,I>& Y) {
+  T d = 0;
+  for (std::size_t i=0; i<X.size(); i++) d = std::max(d, std::abs(X.data()[i]-Y.data()[i]));
+  return d;
+}
+
+template<typename T, typename I>
+static bool run(const char *name, T tol) {
+  const laplacian<T,I> A0(30);
+  const I n = A0.n;
+  chompack::symbolic<I> S(n, A0.colptr.data(), A0.rowidx.data());
+  chompack::matrix<T,I> A(S);
+  A.add(A0.colptr.data(), A0.rowidx.data(), A0.val.data());
+  chompack::matrix<T,I> L(A);
+  chompack::cholesky(L);
+
+  // B = inv(A)
+  std::vector<T> B(static_cast<std::size_t>(n)*n, T(0));
+  for (I i=0; i<n; i++) B[static_cast<std::size_t>(i)*n+i] = 1;
+  chompack::solve(L, B.data(), static_cast<int>(n), n);
+
+  // Y = P(inv(A))
+  chompack::matrix<T,I> Y(L);
+  chompack::projected_inverse(Y);
+  T d0 = 0;
+  for (I k=0; k<S.supernodes(); k++) {
+    const I nn = S.snptr[k+1]-S.snptr[k], nj = S.sncolptr[k+1]-S.sncolptr[k];
+    for (I c=0; c<nn; c++) {
+      const I j = S.p[S.snrowidx[S.sncolptr[k]+c]];
+      for (I r=c; r<nj; r++) {
+	const I i = S.p[S.snrowidx[S.sncolptr[k]+r]];
+	d0 = std::max(d0, std::abs(Y.data()[S.blkptr[k]+nj*c+r] - B[static_cast<std::size_t>(j)*n+i]));
+      }
+    }
+  }
+  std::printf("%s: projected inverse error = %.2e\n", name, double(d0));
+
+  // a failed factorization does not mark the matrix as a factor
+  chompack::matrix<T,I> Z(S);
+  bool failed = false;
+  try { chompack::cholesky(Z); }
+  catch (const chompack::error& e) { failed = (e.code() == CHOMPACK_ERR_NUMERIC); }
+  return d0 < tol && failed && !Z.is_factor();
+}
+
+template<typename I>
+static bool run_double(const char *name) {
+  const laplacian<double,I> A0(30);
+  chompack::symbolic<I> S(A0.n, A0.colptr.data(), A0.rowidx.data());
+  chompack::matrix<double,I> A(S);
+  A.add(A0.colptr.data(), A0.rowidx.data(), A0.val.data());
+  chompack::matrix<double,I> L(A);
+  chompack::cholesky(L);
+  chompack::matrix<double,I> Y(L);
+  chompack::projected_inverse(Y);
+
+  // completion(Y) = L, H(A) = Y
+  chompack::matrix<double,I> Z(Y), U(A);
+  chompack::completion(Z);
+  std::vector<chompack::matrix<double,I>*> u(1, &U);
+  chompack::hessian(L, Y, u, -1);
+  const double d1 = maxdiff(Z, L), d2 = maxdiff(U, Y);
+  std::printf("%s: completion error = %.2e, hessian error = %.2e\n", name, d1, d2);
+  return d1 < 1e-10 && d2 < 1e-10;
+}
+
+int main() {
+  bool ok = run<float,std::int32_t>("float/int32", 1e-5f);
+  ok = run<float,std::int64_t>("float/int64", 1e-5f) && ok;
+  ok = run<double,std::int32_t>("double/int32", 1e-12) && ok;
+  ok = run<double,std::int64_t>("double/int64", 1e-12) && ok;
+  ok = run_double<std::int32_t>("double/int32") && ok;
+  ok = run_double<std::int64_t>("double/int64") && ok;
+  return ok ? 0 : 1;
+}
@@ -25,6 +25,22 @@ if type(LAPACK_LIB) is str: LAPACK_LIB = LAPACK_LIB.strip().split(';')
 if type(BLAS_EXTRA_LINK_ARGS) is str: BLAS_EXTRA_LINK_ARGS = BLAS_EXTRA_LINK_ARGS.strip().split(';')
 if BLAS_NOUNDERSCORES: MACROS.append(('BLAS_NO_UNDERSCORE',''))
 
+# Compile with OpenMP (threaded supernodal loops)? (default: False)
+OPENMP = os.environ.get('CHOMPACK_OPENMP',False)
+if type(OPENMP) is str:
+    if OPENMP in ['true','True','1','yes','Yes','Y','y']: OPENMP = True
+    else: OPENMP = False
+if OPENMP:
+    EXTRA_COMPILE_ARGS.append('-fopenmp')
+    BLAS_EXTRA_LINK_ARGS.append('-fopenmp')
+
+# Compile with per-supernode instrumentation (chompack.profiling)? (default: False)
+PROFILE = os.environ.get('CHOMPACK_PROFILE',False)
+if type(PROFILE) is str:
+    if PROFILE in ['true','True','1','yes','Yes','Y','y']: PROFILE = True
+    else: PROFILE = False
+if PROFILE: MACROS.append(('CHOMPACK_PROFILE',''))
+
 # Install Python-only reference implementation? (default: False)
 py_only = os.environ.get('CHOMPACK_PY_ONLY',False)
 if type(py_only) is str:
@@ -0,0 +1,256 @@
+#if defined(CHOMPACK_NO_PYTHON) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "chompack.h"
+
+/*
+  Supernodal amalgamation (see chompack.symbolic.amalgamate) and the
+  cost model used by chompack.symbolic.merge_auto: the predicted time
+  of a supernode in cholesky() is
+
+     overhead + nn^3/3 / potrf(nn) + na*nn^2 / trsm(nn)
+              + na^2*nn / syrk(nn) + extend_add*na*(na+1)/2
+
+  where potrf, trsm, and syrk are the measured flop rates of the dense
+  kernels, interpolated (in log-log scale) between calibrated block
+  sizes.
+*/
+
+static int cmp_int_t(const void *a, const void *b) {
+  int_t x = *(const int_t *) a, y = *(const int_t *) b;
+  return (x > y) - (x < y);
+}
+
+int amalgamate(const int_t nsn, int_t * restrict colcount, int_t * restrict snode, int_t * restrict snptr,
+	       int_t * restrict snpar, int_t * restrict snpost, merge_fun merge, void *data, int_t *nsn_out) {
+  /*
+    Iterates over the supernodes in postorder and merges supernode k
+    with its parent if merge(|J_par(k)|, |J_k|, |N_par(k)|, |N_k|, data)
+    is positive. colcount is indexed by node (only the entries of the
+    first node of each supernode are used and updated), and the other
+    arrays describe the supernodal elimination tree as returned by
+    chompack.symbolic.supernodes().
+
+    On exit, the first *nsn_out+1 (resp. *nsn_out) entries of snptr
+    (resp. snpar and snpost) describe the amalgamated tree, the nodes
+    of each supernode are sorted in snode, and snpost is a postorder.
+    Returns 0 on success, -1 if memory allocation fails, and the
+    return value of merge if it is negative (the arrays are then
+    unchanged).
+   */
+  int_t j, k, p, r, s, N = 0, *cc, *sz, *into, *newidx, *ptr, *snode_;
+  int ret;
+
+  if (!(cc = malloc(5*(nsn+1)*sizeof(int_t)))) return -1;
+  if (!(snode_ = malloc((snptr[nsn]+1)*sizeof(int_t)))) {
+    free(cc);
+    return -1;
+  }
+  sz = cc + (nsn+1);
+  into = sz + (nsn+1);
+  newidx = into + (nsn+1);
+  ptr = newidx + (nsn+1);
+
+  for (k=0;k<nsn;k++) {
+    cc[k] = colcount[snode[snptr[k]]];
+    sz[k] = snptr[k+1]-snptr[k];
+    into[k] = -1;
+  }
+
+  // greedy pass: the parent of k is not visited before k, so
+  // snpar[k] is still a supernode when k is visited
+  for (j=0;j<nsn;j++) {
+    k = snpost[j];
+    p = snpar[k];
+    if (p == k) continue;
+    ret = merge(cc[p], cc[k], sz[p], sz[k], data);
+    if (ret < 0) {
+      free(cc); free(snode_);
+      return ret;
+    }
+    if (ret) {
+      cc[p] += sz[k];
+      sz[p] += sz[k];
+      into[k] = p;
+    }
+  }
+
+  // number the remaining supernodes in the original order
+  for (k=0;k<nsn;k++) {
+    if (into[k] == -1) newidx[k] = N++;
+  }
+  for (k=0;k<nsn;k++) {
+    for (r=k; into[r] != -1; r=into[r]);
+    for (s=k; s != r; s=p) {   // path compression
+      p = into[s];
+      into[s] = r;
+    }
+    newidx[k] = newidx[r];
+  }
+
+  // gather and sort the nodes of each new supernode
+  memset(ptr, 0, (N+1)*sizeof(int_t));
+  for (k=0;k<nsn;k++) ptr[newidx[k]+1] += snptr[k+1]-snptr[k];
+  for (k=0;k<N;k++) ptr[k+1] += ptr[k];
+  for (k=0;k<nsn;k++) {
+    s = newidx[k];
+    memcpy(snode_+ptr[s], snode+snptr[k], (snptr[k+1]-snptr[k])*sizeof(int_t));
+    ptr[s] += snptr[k+1]-snptr[k];
+  }
+  for (k=N;k>0;k--) ptr[k] = ptr[k-1];
+  ptr[0] = 0;
+  for (k=0;k<N;k++) qsort(snode_+ptr[k], ptr[k+1]-ptr[k], sizeof(int_t), cmp_int_t);
+
+  // parents (the parent of a remaining supernode may have been merged)
+  for (k=0;k<nsn;k++) {
+    if (into[k] != -1) continue;
+    s = newidx[k];
+    p = snpar[k];
+    sz[s] = (p == k) ? s : newidx[p];
+    colcount[snode_[ptr[s]]] = cc[k];
+  }
+
+  memcpy(snode, snode_, snptr[nsn]*sizeof(int_t));
+  memcpy(snptr, ptr, (N+1)*sizeof(int_t));
+  memcpy(snpar, sz, N*sizeof(int_t));
+  tree_postorder(N, snpar, snpost, cc);
+  *nsn_out = N;
+  free(cc); free(snode_);
+  return 0;
+}
+
+int merge_size_fill(const int_t cp, const int_t ck, const int_t np, const int_t nk, void *data) {
+  /*
+    The merge heuristic of chompack.symbolic.merge_size_fill; data
+    points to the thresholds {tsize, tfill}.
+   */
+  const int_t *t = data;
+  return ((cp - (ck - nk))*nk <= t[1]) || (nk <= t[0] && np <= t[0]);
+}
+
+static double rate(const merge_model *M, const double *r, const int_t nn) {
+  int k;
+  double x;
+  if (nn <= M->size[0]) return r[0];
+  if (nn >= M->size[M->nb-1]) return r[M->nb-1];
+  for (k=1; M->size[k] < nn; k++);
+  x = (log((double) nn) - log(M->size[k-1]))/(log(M->size[k]) - log(M->size[k-1]));
+  return exp((1.0-x)*log(r[k-1]) + x*log(r[k]));
+}
+
+double front_time(const merge_model *M, const int_t nn, const int_t na) {
+  /*
+    Predicted time of a supernode of order nn with a separator of
+    order na in cholesky().
+   */
+  double n = (double) nn, a = (double) na;
+  double t = M->overhead + n*n*n/3.0/rate(M, M->potrf, nn);
+  if (na > 0)
+    t += a*n*n/rate(M, M->trsm, nn) + a*a*n/rate(M, M->syrk, nn) + M->extend_add*a*(a+1.0)/2.0;
+  return t;
+}
+
+int merge_cost(const int_t cp, const int_t ck, const int_t np, const int_t nk, void *data) {
+  /*
+    Merges if the predicted time of the merged supernode does not
+    exceed the sum of the predicted times of the two supernodes; data
+    points to a merge_model.
+   */
+  const merge_model *M = data;
+  return front_time(M, np+nk, cp-np) <= front_time(M, np, cp-np) + front_time(M, nk, ck-nk);
+}
+
+static double wtime(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+int merge_calibrate(merge_model *M, const double tmin) {
+  /*
+    Measures the flop rates of dpotrf, dtrsm, and dsyrk at the block
+    sizes M->size[0], ..., M->size[M->nb-1] (with a square right-hand
+    side resp. update), and the overhead and extend-add terms of the
+    model. Each kernel is repeated until at least tmin seconds have
+    elapsed. Returns 0 on success and -1 if memory allocation fails.
+   */
+  int b, i, k, reps, info, nmax = 1, ione = 1;
+  int_t *idx;
+  double t, flops, *A, *L, *B, *C, dzero = 0.0, done = 1.0, dmone = -1.0;
+  char cL = 'L', cN = 'N', cR = 'R', cT = 'T';
+
+  for (k=0;k<M->nb;k++) nmax = ((int) M->size[k] > nmax) ? (int) M->size[k] : nmax;
+  if (!(A = malloc(4*nmax*nmax*sizeof(double)))) return -1;
+  if (!(idx = malloc(nmax*sizeof(int_t)))) {
+    free(A);
+    return -1;
+  }
+  L = A + nmax*nmax;
+  B = L + nmax*nmax;
+  C = B + nmax*nmax;
+
+  for (k=0;k<M->nb;k++) {
+    b = (int) M->size[k];
+    // diagonally dominant positive definite matrix and its factor
+    for (i=0;i<b*b;i++) L[i] = 1.0/(1.0 + (i % b) + (i / b));
+    for (i=0;i<b;i++) L[i*(b+1)] = (double) b;
+    memcpy(A, L, b*b*sizeof(double));
+    dpotrf_(&cL, &b, L, &b, &info);
+
+    flops = b*(double) b*b/3.0;
+    reps = 0; t = wtime();
+    do {
+      memcpy(C, A, b*b*sizeof(double));
+      dpotrf_(&cL, &b, C, &b, &info);
+      reps++;
+    } while (wtime()-t < tmin);
+    M->potrf[k] = reps*flops/(wtime()-t);
+
+    flops = b*(double) b*b;
+    reps = 0; t = wtime();
+    do {
+      for (i=0;i<b*b;i++) B[i] = 1.0;
+      dtrsm_(&cR, &cL, &cT, &cN, &b, &b, &done, L, &b, B, &b);
+      reps++;
+    } while (wtime()-t < tmin);
+    M->trsm[k] = reps*flops/(wtime()-t);
+
+    for (i=0;i<b*b;i++) B[i] = 1.0/b;
+    reps = 0; t = wtime();
+    do {
+      dsyrk_(&cL, &cN, &b, &b, &dmone, B, &b, &dzero, C, &b);
+      reps++;
+    } while (wtime()-t < tmin);
+    M->syrk[k] = reps*flops/(wtime()-t);
+  }
+
+  // extend-add: scatter the lower triangle of an nmax x nmax update
+  // matrix into a frontal matrix with relative indices
+  for (i=0;i<nmax;i++) idx[i] = i;
+  for (i=0;i<nmax*nmax;i++) C[i] = 1.0/nmax;
+  reps = 0; t = wtime();
+  do {
+    int j;
+    for (j=0;j<nmax;j++)
+      for (i=j;i<nmax;i++) A[idx[i] + idx[j]*nmax] += C[i + j*nmax];
+    reps++;
+  } while (wtime()-t < tmin);
+  M->extend_add = (wtime()-t)/(reps*0.5*nmax*(nmax+1.0));
+
+  // per-supernode work not covered by the rates: copying the supernode
+  // to and from the frontal matrix and the update matrix
+  reps = 0; t = wtime();
+  do {
+    dlacpy_(&cL, &ione, &ione, A, &ione, C, &ione);
+    dlacpy_(&cL, &ione, &ione, C, &ione, A, &ione);
+    reps++;
+  } while (wtime()-t < tmin);
+  M->overhead = (wtime()-t)/reps;
+
+  free(A); free(idx);
+  return 0;
+}
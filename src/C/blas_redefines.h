@@ -153,4 +153,13 @@
 #define dgeqp3_ dgeqp3
 #define zgeqp3_ zgeqp3
 
+#define slacpy_ slacpy
+#define spotrf_ spotrf
+#define strtri_ strtri
+#define strsm_ strsm
+#define ssymm_ ssymm
+#define sgemm_ sgemm
+#define ssyrk_ ssyrk
+#define ssyr_ ssyr
+
 #endif
@@ -2,9 +2,329 @@
 #include "Python.h"
 #include "chompack.h"
 #include "cvxopt.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 PyDoc_STRVAR(cbase__doc__, "Wrappers for C routines.");
 
+/*
+  Double precision arguments: a cvxopt 'd' matrix, or any object that
+  exports a C- or Fortran-contiguous buffer of doubles (e.g., a numpy
+  array or a memoryview). The data are used in place, except for a
+  C-contiguous 2-D buffer with more than one column, which is copied to
+  a column-major array (and copied back by dbuffer_release() if the
+  argument is written to). With flat = 1, the buffer is treated as a
+  vector (blkval).
+*/
+typedef struct {
+  PyObject *obj;          // owned reference to the argument
+  Py_buffer view;         // view.obj is NULL if obj is a cvxopt matrix
+  double *buf;            // column-major data
+  double *tmp;            // column-major copy of a C-contiguous 2-D buffer
+  Py_ssize_t nrows, ncols, ld;
+  int writable;
+  int mapped;             // blkval of a cspmatrix.open() file mapping
+} dbuffer;
+
+static int dbuffer_get(PyObject *O, dbuffer *b, int writable, int flat, const char *name)
+{
+  Py_ssize_t i, j;
+
+  memset(b, 0, sizeof(dbuffer));
+  b->writable = writable;
+  if (Matrix_Check(O)) {
+    if (MAT_ID(O) != DOUBLE) {
+      PyErr_Format(PyExc_TypeError,"%s must be a 'd' matrix or a buffer of doubles", name);
+      return -1;
+    }
+    b->buf = MAT_BUFD(O);
+    b->nrows = flat ? MAT_LGT(O) : MAT_NROWS(O);
+    b->ncols = flat ? 1 : MAT_NCOLS(O);
+  }
+  else {
+    if (PyObject_GetBuffer(O, &b->view, writable ? PyBUF_RECORDS : PyBUF_RECORDS_RO) < 0) return -1;
+    if (b->view.itemsize != sizeof(double) || !b->view.format ||
+	strchr(b->view.format, 'd') == NULL || b->view.ndim > 2) {
+      PyBuffer_Release(&b->view);
+      PyErr_Format(PyExc_TypeError,"%s must be a 'd' matrix or a buffer of doubles with at most two dimensions", name);
+      return -1;
+    }
+    b->buf = (double *) b->view.buf;
+    if (b->view.ndim < 2 || flat) {
+      if (!PyBuffer_IsContiguous(&b->view, 'A')) {
+	PyBuffer_Release(&b->view);
+	PyErr_Format(PyExc_TypeError,"%s must be contiguous", name);
+	return -1;
+      }
+      b->nrows = b->view.len/sizeof(double);
+      b->ncols = 1;
+    }
+    else {
+      b->nrows = b->view.shape[0];
+      b->ncols = b->view.shape[1];
+      // other than Fortran order, only C order (copied to tmp) is accepted
+      if (!PyBuffer_IsContiguous(&b->view, 'F')) {
+	if (!PyBuffer_IsContiguous(&b->view, 'C')) {
+	  PyBuffer_Release(&b->view);
+	  PyErr_Format(PyExc_TypeError,"%s must be C- or Fortran-contiguous", name);
+	  return -1;
+	}
+	if (!(b->tmp = malloc(b->nrows*b->ncols*sizeof(double)))) {
+	  PyBuffer_Release(&b->view);
+	  PyErr_NoMemory();
+	  return -1;
+	}
+	for (i=0;i<b->nrows;i++)
+	  for (j=0;j<b->ncols;j++) b->tmp[j*b->nrows+i] = b->buf[i*b->ncols+j];
+	b->buf = b->tmp;
+      }
+    }
+  }
+  b->ld = (b->nrows > 1) ? b->nrows : 1;
+  b->obj = O;
+  Py_INCREF(O);
+  return 0;
+}
+
+static int blkval_get(PyObject *X, dbuffer *b)
+{
+  /*
+    Gets the blkval attribute of the cspmatrix X; b->mapped is set if
+    X was returned by cspmatrix.open().
+  */
+  PyObject *Py_blkval, *Py_mmap;
+  int ret;
+
+  if (!(Py_blkval = PyObject_GetAttrString(X, "blkval"))) return -1;
+  ret = dbuffer_get(Py_blkval, b, 1, 1, "blkval");
+  Py_DECREF(Py_blkval);
+  if (ret) return ret;
+  if ((Py_mmap = PyObject_GetAttrString(X, "_mmap"))) {
+    b->mapped = (Py_mmap != Py_None);
+    Py_DECREF(Py_mmap);
+  }
+  else PyErr_Clear();
+  return 0;
+}
+
+static void dbuffer_release(dbuffer *b)
+{
+  Py_ssize_t i, j;
+
+  if (b->tmp) {
+    if (b->writable)
+      for (i=0;i<b->nrows;i++)
+	for (j=0;j<b->ncols;j++) ((double *) b->view.buf)[i*b->ncols+j] = b->tmp[j*b->nrows+i];
+    free(b->tmp);
+  }
+  if (b->view.obj) PyBuffer_Release(&b->view);
+  Py_XDECREF(b->obj);
+  b->obj = NULL;
+}
+
+/*
+  Integer index arguments: a cvxopt 'i' matrix, or a contiguous buffer
+  of integers (e.g., a numpy array). Buffers whose items are not int_t
+  are converted to a temporary int_t array.
+*/
+typedef struct {
+  Py_buffer view;         // view.obj is NULL if the argument is a cvxopt matrix
+  int_t *buf;
+  int_t *tmp;
+  Py_ssize_t len;
+} ibuffer;
+
+static int ibuffer_get(PyObject *O, ibuffer *b, const char *name)
+{
+  Py_ssize_t t;
+  const char *fmt;
+  char c;
+
+  memset(b, 0, sizeof(ibuffer));
+  if (Matrix_Check(O)) {
+    if (MAT_ID(O) != INT) {
+      PyErr_Format(PyExc_TypeError,"%s must be an 'i' matrix or a buffer of integers", name);
+      return -1;
+    }
+    b->buf = MAT_BUFI(O);
+    b->len = MAT_LGT(O);
+    return 0;
+  }
+  if (PyObject_GetBuffer(O, &b->view, PyBUF_RECORDS_RO) < 0) return -1;
+  fmt = b->view.format ? b->view.format : "B";
+  while (*fmt && strchr("@=<>!", *fmt)) fmt++;
+  c = *fmt;
+  if (!c || fmt[1] || !strchr("bBhHiIlLqQnN", c) || !PyBuffer_IsContiguous(&b->view, 'A')) {
+    PyBuffer_Release(&b->view);
+    PyErr_Format(PyExc_TypeError,"%s must be an 'i' matrix or a contiguous buffer of integers", name);
+    return -1;
+  }
+  b->len = b->view.len/b->view.itemsize;
+  if (b->view.itemsize == sizeof(int_t) && strchr("lqn", c)) {
+    b->buf = (int_t *) b->view.buf;
+    return 0;
+  }
+  if (!(b->tmp = malloc((b->len+1)*sizeof(int_t)))) {
+    PyBuffer_Release(&b->view);
+    PyErr_NoMemory();
+    return -1;
+  }
+  for (t=0;t<b->len;t++) {
+    switch (c) {
+    case 'b': b->tmp[t] = ((signed char *) b->view.buf)[t]; break;
+    case 'B': b->tmp[t] = ((unsigned char *) b->view.buf)[t]; break;
+    case 'h': b->tmp[t] = ((short *) b->view.buf)[t]; break;
+    case 'H': b->tmp[t] = ((unsigned short *) b->view.buf)[t]; break;
+    case 'i': b->tmp[t] = ((int *) b->view.buf)[t]; break;
+    case 'I': b->tmp[t] = ((unsigned int *) b->view.buf)[t]; break;
+    case 'l': b->tmp[t] = ((long *) b->view.buf)[t]; break;
+    case 'L': b->tmp[t] = ((unsigned long *) b->view.buf)[t]; break;
+    case 'q': b->tmp[t] = ((long long *) b->view.buf)[t]; break;
+    case 'Q': b->tmp[t] = ((unsigned long long *) b->view.buf)[t]; break;
+    case 'n': b->tmp[t] = ((Py_ssize_t *) b->view.buf)[t]; break;
+    default: b->tmp[t] = ((size_t *) b->view.buf)[t]; break;
+    }
+  }
+  b->buf = b->tmp;
+  return 0;
+}
+
+static void ibuffer_release(ibuffer *b)
+{
+  free(b->tmp);
+  if (b->view.obj) PyBuffer_Release(&b->view);
+  b->tmp = NULL;
+}
+
+/*
+  Access hints for the blkval of a file mapping (see cspmatrix.open()),
+  applied to the pages that lie entirely inside blkval. The supernodes
+  are numbered in postorder, so the bottom-up kernels read blkval front
+  to back: the mapping is then advised MADV_SEQUENTIAL (aggressive
+  read-ahead, and pages behind the traversal are reclaimed first). The
+  top-down kernels read it back to front, which read-ahead does not
+  follow, so they keep the default read-around; ADVISE_NORMAL restores
+  it after each call. Other buffers (e.g., numpy arrays) are not
+  advised.
+*/
+#define ADVISE_NORMAL 0
+#define ADVISE_BOTTOM_UP 1
+#define ADVISE_TOP_DOWN 2
+
+static void blkval_advise(const dbuffer *b, int traversal)
+{
+#ifdef MADV_SEQUENTIAL
+  uintptr_t pg, a0, a1;
+
+  if (!b->mapped || b->tmp) return;
+  pg = (uintptr_t) sysconf(_SC_PAGESIZE);
+  a0 = ((uintptr_t) b->buf + pg-1) & ~(pg-1);
+  a1 = (uintptr_t) (b->buf + b->nrows*b->ncols) & ~(pg-1);
+  if (a1 <= a0) return;
+  madvise((void *) a0, a1-a0, (traversal == ADVISE_BOTTOM_UP) ? MADV_SEQUENTIAL : MADV_NORMAL);
+#endif
+}
+
+/*
+  The numeric kernels run without the GIL (between KERNEL_BEGIN and
+  KERNEL_END), after all arguments have been resolved into raw
+  pointers. While the GIL is released, the cspmatrix arguments are
+  guarded against concurrent use: the attribute _busy counts the calls
+  that read a cspmatrix, and is -1 while a call modifies it. A call
+  that conflicts with a running call raises RuntimeError instead of
+  waiting. The profile records are not thread-safe, so the GIL is kept
+  while profiling is enabled.
+*/
+static int nogil_kernels = 0;   // number of kernels running without the GIL
+
+#ifdef CHOMPACK_PROFILE
+#define KERNEL_BEGIN { PyThreadState *_save = NULL; \
+  if (!prof_enabled) { nogil_kernels++; _save = PyEval_SaveThread(); }
+#define KERNEL_END if (_save) { PyEval_RestoreThread(_save); nogil_kernels--; } }
+#else
+#define KERNEL_BEGIN { nogil_kernels++; Py_BEGIN_ALLOW_THREADS
+#define KERNEL_END Py_END_ALLOW_THREADS nogil_kernels--; }
+#endif
+
+static long guard_get(PyObject *X)
+{
+  PyObject *PyObj;
+  long busy = 0;
+
+  if ((PyObj = PyObject_GetAttrString(X, "_busy"))) {
+    busy = PyLong_AsLong(PyObj);
+    Py_DECREF(PyObj);
+  }
+  PyErr_Clear();
+  return busy;
+}
+
+static void guard_set(PyObject *X, long busy)
+{
+  PyObject *PyObj;
+
+  if ((PyObj = PyLong_FromLong(busy))) {
+    PyObject_SetAttrString(X, "_busy", PyObj);
+    Py_DECREF(PyObj);
+  }
+  PyErr_Clear();
+}
+
+static int guard_acquire(PyObject *X, int write)
+{
+  /*
+    Marks X as read (write = 0) or modified (write = 1) by the calling
+    thread. Returns -1 and raises RuntimeError if X is in use by a call
+    that conflicts.
+  */
+  long busy = guard_get(X);
+
+  if (busy < 0 || (write && busy > 0)) {
+    PyErr_Format(PyExc_RuntimeError,"cspmatrix is in use by another thread");
+    return -1;
+  }
+  guard_set(X, write ? -1 : busy+1);
+  return 0;
+}
+
+static void guard_release(PyObject *X, int write)
+{
+  PyObject *type, *value, *traceback;
+
+  PyErr_Fetch(&type, &value, &traceback);   // keep a pending exception
+  guard_set(X, write ? 0 : guard_get(X)-1);
+  PyErr_Restore(type, value, traceback);
+}
+
+static int guard_acquire_all(PyObject **X, const int *write, int m)
+{
+  /*
+    Acquires X[0], ..., X[m-1]; on failure, the guards already
+    acquired are released.
+  */
+  int i;
+
+  for (i=0;i<m;i++) {
+    if (guard_acquire(X[i], write[i])) {
+      while (i-- > 0) guard_release(X[i], write[i]);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void guard_release_all(PyObject **X, const int *write, int m)
+{
+  int i;
+  for (i=0;i<m;i++) guard_release(X[i], write[i]);
+}
+
 static char doc_frontal_add_update[] =
   "frontal_add_update(F, U, relidx, relptr, i, alpha = 1.0)\n";
 
@@ -107,14 +427,16 @@ static PyObject* cdot
 (PyObject *self, PyObject *args)
 {
   int_t nsn;
-  PyObject *X, *Y, *symbx, *symby, *PyObj, *Py_blkptr, *Py_snptr, *Py_blkvalx, *Py_blkvaly, *Py_sncolptr;
-  double val;
+  PyObject *X, *Y, *symbx, *symby, *PyObj, *Py_blkptr, *Py_snptr, *Py_sncolptr;
+  PyObject *gobj[2];
+  dbuffer blkx, blky;
+  double val = 0.0;
+  int busy, gwrite[2] = {0, 0};
   char str_nsn[] = "Nsn",
     str_symb[] = "symb",
     str_sncolptr[] = "sncolptr",
     str_snptr[] = "snptr",
     str_blkptr[] = "blkptr",
-    str_blkval[] = "blkval",
     str_is_factor[] = "is_factor";
 
   if (!PyArg_ParseTuple(args, "OO", &X, &Y)) return NULL;  // borrowed references
@@ -148,6 +470,16 @@ static PyObject* cdot
     return Py_BuildValue("");
   }
 
+  if (blkval_get(X, &blkx)) {
+    Py_DECREF(symbx); Py_DECREF(symby);
+    return NULL;
+  }
+  if (blkval_get(Y, &blky)) {
+    dbuffer_release(&blkx);
+    Py_DECREF(symbx); Py_DECREF(symby);
+    return NULL;
+  }
+
   // extract parameters
   PyObj = PyObject_GetAttrString(symbx, str_nsn);
   nsn = PYINT_AS_LONG(PyObj);
@@ -155,408 +487,2438 @@ static PyObject* cdot
   Py_snptr  = PyObject_GetAttrString(symbx, str_snptr);
   Py_sncolptr  = PyObject_GetAttrString(symbx, str_sncolptr);
   Py_blkptr  = PyObject_GetAttrString(symbx, str_blkptr);
-  Py_blkvalx  = PyObject_GetAttrString(X, str_blkval);
-  Py_blkvaly  = PyObject_GetAttrString(Y, str_blkval);
 
   // compute inner product
-  val = dot(&nsn, MAT_BUFI(Py_snptr), MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_blkptr), MAT_BUFD(Py_blkvalx), MAT_BUFD(Py_blkvaly));
+  gobj[0] = X; gobj[1] = Y;
+  if (!(busy = guard_acquire_all(gobj, gwrite, 2))) {
+    val = dot(&nsn, MAT_BUFI(Py_snptr), MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_blkptr), blkx.buf, blky.buf);
+    guard_release_all(gobj, gwrite, 2);
+  }
 
   // clean up
   Py_DECREF(Py_snptr);
   Py_DECREF(Py_sncolptr);
   Py_DECREF(Py_blkptr);
-  Py_DECREF(Py_blkvalx);
-  Py_DECREF(Py_blkvaly);
+  dbuffer_release(&blkx);
+  dbuffer_release(&blky);
   Py_DECREF(symbx);
   Py_DECREF(symby);
+  if (busy) return NULL;
 
   return Py_BuildValue("d",val);
 }
 
-static char doc_cchol[] =
-  "Supernodal multifrontal Cholesky factorization:\n"
-  "\n"
-  ".. math::\n"
-  "     X = LL^T\n"
-  "\n"
-  "where :math:`L` is lower-triangular. On exit, the argument :math:`X`\n"
-  "contains the Cholesky factor :math:`L`.\n"
+static char doc_cgram[] =
+  "Computes the matrix of trace products of two lists of\n"
+  ":py:class:`cspmatrix` objects, i.e., :math:`G_{ij} = \\mathbf{tr}(X_i Y_j)`.\n"
   "\n"
-  ":param X:    :py:class:`cspmatrix`\n";
+  ":param X:    list of :py:class:`cspmatrix` objects\n"
+  ":param Y:    list of :py:class:`cspmatrix` objects (default: `X`)\n";
 
-static PyObject* cchol
+static PyObject* cgram
 (PyObject *self, PyObject *args)
 {
-  int info = 0;
-  int_t n, nsn, stack_depth, stack_mem, frontal_mem;
-  int_t *upd_size=NULL;
-  double * restrict fws=NULL, * restrict upd=NULL;
-  char str_symb[] = "symb",
-    str_snpost[] = "snpost",
+  int i, mx, my, nr, ldg, busy, *gwrite = NULL;
+  int_t nsn, nnz;
+  PyObject *X, *Y = Py_None, *L, *Py_Xi, *symb, *symb_test, *PyObj,
+    *Py_snptr, *Py_sncolptr, *Py_blkptr, **gobj = NULL;
+  double **xblkval = NULL, **yblkval = NULL, *ws = NULL;
+  matrix *G;
+  char str_nsn[] = "Nsn",
+    str_symb[] = "symb",
+    str_sncolptr[] = "sncolptr",
     str_snptr[] = "snptr",
-    str_relptr[] = "relptr",
-    str_relidx[] = "relidx",
-    str_chptr[] = "chptr",
-    str_chidx[] = "chidx",
     str_blkptr[] = "blkptr",
     str_blkval[] = "blkval",
-    str_memory[] = "memory",
-    str_stack_depth[] = "stack_depth",
-    str_stack_mem[] = "stack_mem",
-    str_frontal_mem[] = "frontal_mem",
-    str_is_factor[] = "is_factor",
-    str_n[] = "n",
-    str_nsn[] = "Nsn";
+    str_is_factor[] = "is_factor";
 
-  PyObject *A, *symb, *Py_snpost, *Py_snptr, *Py_relptr, *Py_relidx,
-    *Py_chptr, *Py_chidx, *Py_blkptr, *Py_blkval, *PyObj, *Py_memory;
+  if (!PyArg_ParseTuple(args, "O|O", &X, &Y)) return NULL;  // borrowed references
+  if (Y == X) Y = Py_None;
+  if (!PyList_Check(X) || !(Y == Py_None || PyList_Check(Y)))
+    return PyErr_Format(PyExc_TypeError,"X and Y must be lists of cspmatrix objects");
+  mx = (int) PyList_Size(X);
+  my = (Y == Py_None) ? mx : (int) PyList_Size(Y);
+  if (mx == 0 || my == 0) return (PyObject *) Matrix_New(mx, my, DOUBLE);
+
+  if (!(xblkval = malloc(mx*sizeof(double *)))) return PyErr_NoMemory();
+  if ((Y != Py_None && !(yblkval = malloc(my*sizeof(double *)))) ||
+      !(gobj = malloc((mx+my)*sizeof(PyObject *))) || !(gwrite = calloc(mx+my, sizeof(int)))) {
+    free(xblkval); free(yblkval); free(gobj);
+    return PyErr_NoMemory();
+  }
 
-  // extract pointers from cspmatrix A
-  if (!PyArg_ParseTuple(args, "O", &A)) return NULL;  // A : borrowed reference
+  // check that all matrices are cspmatrix objects (not factors) with the same symbolic object
+  symb = PyObject_GetAttrString(PyList_GetItem(X,0),str_symb);
+  for (i=0;i<mx+(yblkval ? my : 0);i++) {
+    L = (i < mx) ? X : Y;
+    Py_Xi = PyList_GetItem(L, (i < mx) ? i : i-mx);
+    symb_test = PyObject_GetAttrString(Py_Xi,str_symb);
+    PyObj = PyObject_GetAttrString(Py_Xi,str_is_factor);
+    Py_XDECREF(symb_test);
+    if (PyObj != Py_False || symb_test != symb) {
+      Py_XDECREF(PyObj);
+      Py_XDECREF(symb);
+      free(xblkval); free(yblkval); free(gobj); free(gwrite);
+      PyErr_Clear();
+      return PyErr_Format(PyExc_ValueError,"X and Y must be lists of cspmatrix objects with the same symbolic factorization");
+    }
+    Py_DECREF(PyObj);
+    gobj[i] = Py_Xi;
+    PyObj = PyObject_GetAttrString(Py_Xi, str_blkval);
+    if (i < mx) xblkval[i] = MAT_BUFD(PyObj);
+    else yblkval[i-mx] = MAT_BUFD(PyObj);
+    Py_DECREF(PyObj);
+  }
+
+  // extract parameters
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj);
+  Py_DECREF(PyObj);
+  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
+  Py_sncolptr  = PyObject_GetAttrString(symb, str_sncolptr);
+  Py_blkptr  = PyObject_GetAttrString(symb, str_blkptr);
+  Py_DECREF(symb);
+
+  // panel height: at most the number of nonzeros, and panels of roughly 8 MB
+  nnz = MAT_BUFI(Py_blkptr)[nsn];
+  nr = (1 << 20)/(mx + (yblkval ? my : 0));
+  if (nr < 64) nr = 64;
+  if (nr > nnz) nr = (int) nnz;
+
+  if (!(G = Matrix_New(mx, my, DOUBLE)) ||
+      !(ws = malloc(((int_t) nr)*(mx+(yblkval ? my : 0))*sizeof(double)))) {
+    Py_XDECREF(G);
+    Py_DECREF(Py_snptr); Py_DECREF(Py_sncolptr); Py_DECREF(Py_blkptr);
+    free(xblkval); free(yblkval); free(gobj); free(gwrite);
+    return PyErr_NoMemory();
+  }
+
+  // compute trace products
+  ldg = mx;
+  if (!(busy = guard_acquire_all(gobj, gwrite, mx+(yblkval ? my : 0)))) {
+    gram(&nsn, MAT_BUFI(Py_snptr), MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_blkptr),
+	 mx, xblkval, my, yblkval, MAT_BUFD(G), &ldg, ws, nr);
+    guard_release_all(gobj, gwrite, mx+(yblkval ? my : 0));
+  }
+
+  // clean up
+  Py_DECREF(Py_snptr);
+  Py_DECREF(Py_sncolptr);
+  Py_DECREF(Py_blkptr);
+  free(xblkval); free(yblkval); free(ws); free(gobj); free(gwrite);
+  if (busy) {
+    Py_DECREF(G);
+    return NULL;
+  }
+
+  return (PyObject *) G;
+}
+
+static PyObject* lowrank_update
+(PyObject *X, PyObject *U, PyObject *V, PyObject *w, double alpha, double beta, int reordered, int nthreads)
+{
+  int m, busy;
+  int_t n, nsn, ldws;
+  double *ws;
+  dbuffer blk, Ub, Vb, wb;
+  PyObject *symb, *PyObj, *Py_snptr, *Py_sncolptr, *Py_snrowidx, *Py_blkptr, *Py_p;
+  char str_symb[] = "symb",
+    str_snptr[] = "snptr",
+    str_sncolptr[] = "sncolptr",
+    str_snrowidx[] = "snrowidx",
+    str_blkptr[] = "blkptr",
+    str_clique_number[] = "clique_number",
+    str_is_factor[] = "is_factor",
+    str_n[] = "n",
+    str_nsn[] = "Nsn",
+    str_p[] = "p";
 
   // check that cspmatrix factor flag is False
-  PyObj = PyObject_GetAttrString(A,str_is_factor);
+  PyObj = PyObject_GetAttrString(X,str_is_factor);
   if (PyObj == Py_False) {
     Py_DECREF(PyObj);
   }
   else {
-    Py_DECREF(PyObj);
-    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix");
+    Py_XDECREF(PyObj);
+    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix (not a factor)");
   }
 
-
-  // extract pointers and values from symbolic object
-  symb = PyObject_GetAttrString(A,str_symb);
-  Py_snpost = PyObject_GetAttrString(symb, str_snpost);
-  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
-  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
-  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
-  Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
-  Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
-  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
+  symb = PyObject_GetAttrString(X,str_symb);
   PyObj = PyObject_GetAttrString(symb, str_n);
   n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
-  PyObj = PyObject_GetAttrString(symb, str_nsn);
-  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
-  Py_memory = PyObject_GetAttrString(symb, str_memory);
-  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
-  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
-  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
-  Py_DECREF(Py_memory);
-  Py_DECREF(symb);
 
-  // allocate workspace
-  if (!(upd = malloc(stack_mem*sizeof(double)))) return PyErr_NoMemory();
-  if (!(fws = malloc(frontal_mem*sizeof(double)))) {
-    free(upd);
-    return PyErr_NoMemory();
+  // check dimensions
+  memset(&Vb, 0, sizeof(dbuffer)); memset(&wb, 0, sizeof(dbuffer));
+  if (dbuffer_get(U, &Ub, 0, 0, "U")) {
+    Py_DECREF(symb);
+    return NULL;
   }
-  if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
-    free(upd);
-    free(fws);
-    return PyErr_NoMemory();
+  if ((V && dbuffer_get(V, &Vb, 0, 0, "V")) || (w && dbuffer_get(w, &wb, 0, 1, "w")) || blkval_get(X, &blk)) {
+    dbuffer_release(&Ub); dbuffer_release(&Vb); dbuffer_release(&wb);
+    Py_DECREF(symb);
+    return NULL;
+  }
+  if (Ub.nrows != n || (V && (Vb.nrows != n || Vb.ncols != Ub.ncols)) || (w && wb.nrows != Ub.ncols)) {
+    dbuffer_release(&Ub); dbuffer_release(&Vb); dbuffer_release(&wb); dbuffer_release(&blk);
+    Py_DECREF(symb);
+    return PyErr_Format(PyExc_TypeError,"invalid type or dimensions of dense arguments");
   }
+  m = (int) Ub.ncols;
 
-  // call numerical cholesky
-  Py_blkval = PyObject_GetAttrString(A, str_blkval);
-  info = cholesky(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
-		  MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
-		  MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
-		  MAT_BUFI(Py_blkptr),MAT_BUFD(Py_blkval),
-		  fws,upd,upd_size);
+#ifdef _OPENMP
+  if (nthreads < 1) nthreads = omp_get_max_threads();
+#else
+  nthreads = 1;
+#endif
 
-  // update reference counts
-  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr);
-  Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
-  Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
-  Py_DECREF(Py_blkptr); Py_DECREF(Py_blkval);
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, str_clique_number);
+  ldws = 2*PYINT_AS_LONG(PyObj)*m; Py_DECREF(PyObj);
 
-  // free workspace
-  free(fws); free(upd); free(upd_size);
+  if (!(ws = malloc((nthreads*ldws+1)*sizeof(double)))) {
+    dbuffer_release(&Ub); dbuffer_release(&Vb); dbuffer_release(&wb); dbuffer_release(&blk);
+    Py_DECREF(symb);
+    return PyErr_NoMemory();
+  }
 
-  // set cspmatrix factor flag to True
-  PyObject_SetAttrString(A, str_is_factor, Py_True);
+  Py_snptr = PyObject_GetAttrString(symb, str_snptr);
+  Py_sncolptr = PyObject_GetAttrString(symb, str_sncolptr);
+  Py_snrowidx = PyObject_GetAttrString(symb, str_snrowidx);
+  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
+  Py_p = PyObject_GetAttrString(symb, str_p);
+  Py_DECREF(symb);
 
-  // check for errors
-  if (info) return PyErr_Format(PyExc_ArithmeticError,"factorization failed");
+  if (!(busy = guard_acquire(X, 1))) {
+    syr2k(&nsn, MAT_BUFI(Py_snptr), MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_snrowidx), MAT_BUFI(Py_blkptr),
+	  reordered ? NULL : MAT_BUFI(Py_p),
+	  m, Ub.buf, (int) Ub.ld, V ? Vb.buf : NULL, (int) Vb.ld, w ? wb.buf : NULL,
+	  alpha, beta, blk.buf, ws, ldws, nthreads);
+    guard_release(X, 1);
+  }
+
+  Py_DECREF(Py_snptr); Py_DECREF(Py_sncolptr); Py_DECREF(Py_snrowidx);
+  Py_DECREF(Py_blkptr); Py_DECREF(Py_p);
+  dbuffer_release(&Ub); dbuffer_release(&Vb); dbuffer_release(&wb); dbuffer_release(&blk);
+  free(ws);
+  if (busy) return NULL;
 
   return Py_BuildValue("");
 }
 
+static char doc_csyr2[] =
+  "Computes the projected rank 2 update of a cspmatrix X\n"
+  "\n"
+  ".. math::\n"
+  "     X := \\alpha*P(u v^T + v u^T) + \\beta X.\n"
+  "\n"
+  ":param X:    :py:class:`cspmatrix`\n"
+  ":param u:    matrix\n"
+  ":param v:    matrix\n"
+  ":param alpha:  float (default: 1.0)\n"
+  ":param beta:   float (default: 1.0)\n"
+  ":param reordered:  boolean (default: False)\n";
 
-static char doc_cllt[] =
-  "Supernodal multifrontal Cholesky product:\n"
+static PyObject* csyr2
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  PyObject *X, *u, *v;
+  double alpha = 1.0, beta = 1.0;
+  int reordered = 0;
+  char *kwlist[] = {"X","u","v","alpha","beta","reordered",NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|ddi", kwlist, &X, &u, &v, &alpha, &beta, &reordered)) return NULL;
+  if (!Matrix_Check(u) || !Matrix_Check(v) || MAT_LGT(u) != MAT_NROWS(u) || MAT_LGT(v) != MAT_NROWS(v))
+    return PyErr_Format(PyExc_TypeError,"u and v must be column vectors");
+  return lowrank_update(X, u, v, NULL, alpha, beta, reordered, 1);
+}
+
+static char doc_csyrk[] =
+  "Computes the projected low-rank update of a cspmatrix X\n"
   "\n"
   ".. math::\n"
-  "     X = LL^T\n"
+  "     X := \\alpha*P(U \\mathbf{diag}(w) U^T) + \\beta X\n"
   "\n"
-  "where :math:`L` is lower-triangular. On exit, the argument `L`\n"
-  "contains the product :math:`X`.\n"
+  "where :math:`U` is a dense matrix with :math:`n` rows.\n"
   "\n"
-  ":param L:    :py:class:`cspmatrix` (factor)";
+  ":param X:    :py:class:`cspmatrix`\n"
+  ":param U:    matrix\n"
+  ":param w:    matrix with one entry per column of :math:`U` (default: all ones)\n"
+  ":param alpha:  float (default: 1.0)\n"
+  ":param beta:   float (default: 1.0)\n"
+  ":param reordered:  boolean (default: False)\n"
+  ":param nthreads:  number of threads used for the supernodal loop if\n"
+  "                  compiled with OpenMP (default: 1; 0 means all available)\n";
 
-static PyObject* cllt
-(PyObject *self, PyObject *args)
+static PyObject* csyrk
+(PyObject *self, PyObject *args, PyObject *kwrds)
 {
-  int_t n, nsn, stack_depth, stack_mem, frontal_mem;
-  int_t *upd_size=NULL;
-  double * restrict fws=NULL, * restrict upd=NULL;
-  char str_symb[] = "symb",
-    str_snpost[] = "snpost",
-    str_snptr[] = "snptr",
-    str_relptr[] = "relptr",
-    str_relidx[] = "relidx",
-    str_chptr[] = "chptr",
-    str_chidx[] = "chidx",
-    str_blkptr[] = "blkptr",
-    str_blkval[] = "blkval",
-    str_memory[] = "memory",
-    str_stack_depth[] = "stack_depth",
-    str_stack_mem[] = "stack_mem",
-    str_frontal_mem[] = "frontal_mem",
-    str_is_factor[] = "is_factor",
-    str_n[] = "n",
-    str_nsn[] = "Nsn";
+  PyObject *X, *U, *w = Py_None;
+  double alpha = 1.0, beta = 1.0;
+  int reordered = 0, nthreads = 1;
+  char *kwlist[] = {"X","U","w","alpha","beta","reordered","nthreads",NULL};
 
-  PyObject *A, *symb, *Py_snpost, *Py_snptr, *Py_relptr, *Py_relidx,
-    *Py_chptr, *Py_chidx, *Py_blkptr, *Py_blkval, *PyObj, *Py_memory;
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|Oddii", kwlist, &X, &U, &w, &alpha, &beta, &reordered, &nthreads)) return NULL;
+  return lowrank_update(X, U, NULL, (w == Py_None) ? NULL : w, alpha, beta, reordered, nthreads);
+}
 
-  // extract pointers from cspmatrix A
-  if (!PyArg_ParseTuple(args, "O", &A)) return NULL;  // A : borrowed reference
-  Py_blkval = PyObject_GetAttrString(A, str_blkval);
+static char doc_csymm[] =
+  "Computes the product of a cspmatrix X and a dense matrix\n"
+  "\n"
+  ".. math::\n"
+  "     C := \\alpha X B + \\beta C\n"
+  "\n"
+  "where :math:`X` is symmetric (not a factor) and :math:`B` and :math:`C`\n"
+  "are dense matrices with :math:`n` rows.\n"
+  "\n"
+  ":param X:    :py:class:`cspmatrix`\n"
+  ":param B:    matrix\n"
+  ":param C:    matrix of the same size as :math:`B`\n"
+  ":param alpha:  float (default: 1.0)\n"
+  ":param beta:   float (default: 0.0)\n"
+  ":param reordered:  boolean (default: False)\n"
+  ":param nthreads:  number of threads (each computes a block of columns of\n"
+  "                  :math:`C`) if compiled with OpenMP (default: 1; 0 means\n"
+  "                  all available)\n";
 
-  // extract pointers and values from symbolic object
-  symb = PyObject_GetAttrString(A,str_symb);
-  Py_snpost = PyObject_GetAttrString(symb, str_snpost);
-  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
-  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
-  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
-  Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
-  Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
-  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
-  PyObj = PyObject_GetAttrString(symb, str_n);
-  n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
-  PyObj = PyObject_GetAttrString(symb, str_nsn);
-  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
-  Py_memory = PyObject_GetAttrString(symb, str_memory);
-  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
-  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
-  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
-  Py_DECREF(Py_memory);
-  Py_DECREF(symb);
+static PyObject* csymm
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  PyObject *X, *B, *C, *symb, *PyObj, *Py_snptr, *Py_sncolptr, *Py_snrowidx, *Py_blkptr, *Py_p;
+  dbuffer blk, Bb, Cb;
+  double alpha = 1.0, beta = 0.0, *ws;
+  int m, reordered = 0, nthreads = 1;
+  int busy;
+  int_t n, nsn, ldws;
+  char *kwlist[] = {"X","B","C","alpha","beta","reordered","nthreads",NULL};
 
-  // check that cspmatrix factor flag is True
-  PyObj = PyObject_GetAttrString(A,str_is_factor);
-  if (PyObj == Py_True) {
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|ddii", kwlist, &X, &B, &C, &alpha, &beta, &reordered, &nthreads)) return NULL;
+
+  // check that cspmatrix factor flag is False
+  PyObj = PyObject_GetAttrString(X,"is_factor");
+  if (PyObj == Py_False) {
     Py_DECREF(PyObj);
   }
   else {
-    Py_DECREF(PyObj);
-    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix");
+    Py_XDECREF(PyObj);
+    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix (not a factor)");
   }
 
-  // allocate workspace
-  if (!(upd = malloc(stack_mem*sizeof(double)))) return PyErr_NoMemory();
-  if (!(fws = malloc(frontal_mem*sizeof(double)))) {
-    free(upd);
-    return PyErr_NoMemory();
+  if (dbuffer_get(B, &Bb, 0, 0, "B")) return NULL;
+  if (dbuffer_get(C, &Cb, 1, 0, "C")) {
+    dbuffer_release(&Bb);
+    return NULL;
   }
-  if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
-    free(upd);
-    free(fws);
-    return PyErr_NoMemory();
+  if (blkval_get(X, &blk)) {
+    dbuffer_release(&Bb); dbuffer_release(&Cb);
+    return NULL;
   }
 
-  // call llt
-  llt(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
-      MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
-      MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
-      MAT_BUFI(Py_blkptr),MAT_BUFD(Py_blkval),
-      fws,upd,upd_size);
+  symb = PyObject_GetAttrString(X,"symb");
+  PyObj = PyObject_GetAttrString(symb, "n");
+  n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  if (Bb.nrows != n || Cb.nrows != n || Cb.ncols != Bb.ncols) {
+    dbuffer_release(&Bb); dbuffer_release(&Cb); dbuffer_release(&blk);
+    Py_DECREF(symb);
+    return PyErr_Format(PyExc_TypeError,"B and C must be 'd' matrices with n rows and the same number of columns");
+  }
+  m = (int) Bb.ncols;
 
-  // update reference counts
-  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr);
-  Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
-  Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
-  Py_DECREF(Py_blkptr); Py_DECREF(Py_blkval);
+#ifdef _OPENMP
+  if (nthreads < 1) nthreads = omp_get_max_threads();
+#else
+  nthreads = 1;
+#endif
+  if (nthreads > m) nthreads = (m > 0) ? m : 1;
 
-  // free workspace
-  free(fws); free(upd); free(upd_size);
+  PyObj = PyObject_GetAttrString(symb, "Nsn");
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, "clique_number");
+  ldws = 2*PYINT_AS_LONG(PyObj)*((m + nthreads - 1)/nthreads); Py_DECREF(PyObj);
 
-  // set cspmatrix factor flag to False
-  PyObject_SetAttrString(A, str_is_factor, Py_False);
+  if (!(ws = malloc((nthreads*ldws+1)*sizeof(double)))) {
+    dbuffer_release(&Bb); dbuffer_release(&Cb); dbuffer_release(&blk);
+    Py_DECREF(symb);
+    return PyErr_NoMemory();
+  }
+
+  Py_snptr = PyObject_GetAttrString(symb, "snptr");
+  Py_sncolptr = PyObject_GetAttrString(symb, "sncolptr");
+  Py_snrowidx = PyObject_GetAttrString(symb, "snrowidx");
+  Py_blkptr = PyObject_GetAttrString(symb, "blkptr");
+  Py_p = PyObject_GetAttrString(symb, "p");
+  Py_DECREF(symb);
+
+  if (!(busy = guard_acquire(X, 0))) {
+    KERNEL_BEGIN
+    symm(n, nsn, MAT_BUFI(Py_snptr), MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_snrowidx), MAT_BUFI(Py_blkptr),
+	 reordered ? NULL : MAT_BUFI(Py_p), m, Bb.buf, (int) Bb.ld, Cb.buf, (int) Cb.ld,
+	 alpha, beta, blk.buf, ws, ldws, nthreads);
+    KERNEL_END
+    guard_release(X, 0);
+  }
+
+  Py_DECREF(Py_snptr); Py_DECREF(Py_sncolptr); Py_DECREF(Py_snrowidx);
+  Py_DECREF(Py_blkptr); Py_DECREF(Py_p);
+  dbuffer_release(&Bb); dbuffer_release(&Cb); dbuffer_release(&blk);
+  free(ws);
+  if (busy) return NULL;
 
   return Py_BuildValue("");
 }
 
-
-static char doc_cprojected_inverse[] =
-  "Supernodal multifrontal projected inverse. The routine computes the projected inverse\n"
-  "\n"
-  ".. math::\n"
-  "     Y = P(L^{-T}L^{-1}) \n"
+static char doc_cspmap_build[] =
+  "Computes blkval offsets of the lower triangular entries of a list of\n"
+  "sparse matrices. Returns (ptr, off, v, wv) such that the entries of the\n"
+  "i'th matrix are off[ptr[i]:ptr[i+1]] with values v and trace product\n"
+  "weights wv.\n"
   "\n"
-  "where :math:`L` is a Cholesky factor. On exit, the argument :math:`L` contains the\n"
-  "projected inverse :math:`Y`.\n"
-  "\n"
-  ":param L:            :py:class:`cspmatrix` (factor)";
+  ":param symb:  :py:class:`symbolic`\n"
+  ":param A:     list of :py:class:`spmatrix` objects\n";
 
-static PyObject* cprojected_inverse
+static PyObject* cspmap_build
 (PyObject *self, PyObject *args)
 {
-  int info = 0;
-  int_t n, nsn, stack_depth, stack_mem, frontal_mem;
-  int_t *upd_size=NULL;
-  double * restrict fws=NULL, * restrict upd=NULL;
-  char str_symb[] = "symb",
-    str_snpost[] = "snpost",
+  int i, m;
+  int_t n, nsn, nnz, cnt, j;
+  int_t *colsn;
+  PyObject *symb, *A, *Ai, *PyObj, *Py_snptr, *Py_snode, *Py_sncolptr, *Py_snrowidx, *Py_blkptr, *Py_ip;
+  matrix *ptr, *off, *v, *wv;
+  char str_n[] = "n",
+    str_nsn[] = "Nsn",
     str_snptr[] = "snptr",
-    str_relptr[] = "relptr",
-    str_relidx[] = "relidx",
-    str_chptr[] = "chptr",
-    str_chidx[] = "chidx",
+    str_snode[] = "snode",
+    str_sncolptr[] = "sncolptr",
+    str_snrowidx[] = "snrowidx",
     str_blkptr[] = "blkptr",
-    str_blkval[] = "blkval",
-    str_memory[] = "memory",
-    str_stack_depth[] = "stack_depth",
-    str_stack_mem[] = "stack_mem",
-    str_frontal_mem[] = "frontal_mem",
-    str_is_factor[] = "is_factor",
-    str_n[] = "n",
-    str_nsn[] = "Nsn";
-
-  PyObject *A, *symb, *Py_snpost, *Py_snptr, *Py_relptr, *Py_relidx,
-    *Py_chptr, *Py_chidx, *Py_blkptr, *Py_blkval, *PyObj, *Py_memory;
+    str_ip[] = "ip";
 
-  // extract pointers from cspmatrix A
-  if (!PyArg_ParseTuple(args, "O", &A)) return NULL;  // A : borrowed reference
-  Py_blkval = PyObject_GetAttrString(A, str_blkval);
+  if (!PyArg_ParseTuple(args, "OO", &symb, &A)) return NULL;  // borrowed references
+  if (!PyList_Check(A)) return PyErr_Format(PyExc_TypeError,"A must be a list of spmatrix objects");
+  m = (int) PyList_Size(A);
 
-  // extract pointers and values from symbolic object
-  symb = PyObject_GetAttrString(A,str_symb);
-  Py_snpost = PyObject_GetAttrString(symb, str_snpost);
-  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
-  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
-  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
-  Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
-  Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
-  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
   PyObj = PyObject_GetAttrString(symb, str_n);
-  n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  n = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
   PyObj = PyObject_GetAttrString(symb, str_nsn);
   nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
-  Py_memory = PyObject_GetAttrString(symb, str_memory);
-  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
-  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
-  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
-  Py_DECREF(Py_memory);
-  Py_DECREF(symb);
 
-  // check that cspmatrix factor flag is True
-  PyObj = PyObject_GetAttrString(A,str_is_factor);
-  if (PyObj == Py_True) {
-    Py_DECREF(PyObj);
-  }
-  else {
-    Py_DECREF(PyObj);
-    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix");
+  // check arguments and count lower triangular nonzeros
+  nnz = 0;
+  for (i=0;i<m;i++) {
+    Ai = PyList_GetItem(A, i);
+    if (!SpMatrix_Check(Ai) || SP_ID(Ai) != DOUBLE || SP_NROWS(Ai) != n || SP_NCOLS(Ai) != n)
+      return PyErr_Format(PyExc_TypeError,"A[%i] must be a real sparse matrix of order %i", i, (int) n);
+    for (j=0;j<n;j++) {
+      for (cnt=SP_COL(Ai)[j];cnt<SP_COL(Ai)[j+1];cnt++) nnz += (SP_ROW(Ai)[cnt] >= j);
+    }
   }
 
-  // allocate workspace
-  if (!(upd = malloc(stack_mem*sizeof(double)))) return PyErr_NoMemory();
-  if (!(fws = malloc(frontal_mem*sizeof(double)))) {
-    free(upd);
+  if (!(colsn = malloc(n*sizeof(int_t)))) return PyErr_NoMemory();
+  ptr = Matrix_New(m+1, 1, INT);
+  off = Matrix_New(nnz, 1, INT);
+  v = Matrix_New(nnz, 1, DOUBLE);
+  wv = Matrix_New(nnz, 1, DOUBLE);
+  if (!ptr || !off || !v || !wv) {
+    Py_XDECREF(ptr); Py_XDECREF(off); Py_XDECREF(v); Py_XDECREF(wv);
+    free(colsn);
     return PyErr_NoMemory();
   }
-  if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
-    free(upd);
-    free(fws);
+
+  Py_snptr = PyObject_GetAttrString(symb, str_snptr);
+  Py_snode = PyObject_GetAttrString(symb, str_snode);
+  Py_sncolptr = PyObject_GetAttrString(symb, str_sncolptr);
+  Py_snrowidx = PyObject_GetAttrString(symb, str_snrowidx);
+  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
+  Py_ip = PyObject_GetAttrString(symb, str_ip);
+
+  spmap_colsn(nsn, MAT_BUFI(Py_snptr), MAT_BUFI(Py_snode), colsn);
+  MAT_BUFI(ptr)[0] = 0;
+  for (i=0;i<m;i++) {
+    Ai = PyList_GetItem(A, i);
+    cnt = spmap(n, colsn, MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_snrowidx), MAT_BUFI(Py_blkptr), MAT_BUFI(Py_ip),
+		SP_COL(Ai), SP_ROW(Ai), SP_VALD(Ai),
+		MAT_BUFI(off)+MAT_BUFI(ptr)[i], MAT_BUFD(v)+MAT_BUFI(ptr)[i], MAT_BUFD(wv)+MAT_BUFI(ptr)[i]);
+    if (cnt < 0) break;
+    MAT_BUFI(ptr)[i+1] = MAT_BUFI(ptr)[i] + cnt;
+  }
+
+  Py_DECREF(Py_snptr); Py_DECREF(Py_snode); Py_DECREF(Py_sncolptr);
+  Py_DECREF(Py_snrowidx); Py_DECREF(Py_blkptr); Py_DECREF(Py_ip);
+  free(colsn);
+
+  if (i < m) {
+    Py_DECREF(ptr); Py_DECREF(off); Py_DECREF(v); Py_DECREF(wv);
+    return PyErr_Format(PyExc_ValueError,"sparsity pattern of A[%i] is not contained in the chordal embedding", i);
+  }
+
+  return Py_BuildValue("NNNN", ptr, off, v, wv);
+}
+
+static char doc_cspmap_dot[] =
+  "Computes y[i] = tr(A_i*X) from the maps computed by spmap_build.\n"
+  "\n"
+  ":param ptr, off, wv:  see spmap_build\n"
+  ":param X:       :py:class:`cspmatrix`\n";
+
+static PyObject* cspmap_dot
+(PyObject *self, PyObject *args)
+{
+  PyObject *ptr, *off, *wv, *X;
+  dbuffer blk;
+  matrix *y;
+  int m, busy;
+
+  if (!PyArg_ParseTuple(args, "OOOO", &ptr, &off, &wv, &X)) return NULL;
+  m = MAT_NROWS(ptr)-1;
+  if (blkval_get(X, &blk)) return NULL;
+  if (!(y = Matrix_New(m, 1, DOUBLE))) {
+    dbuffer_release(&blk);
     return PyErr_NoMemory();
   }
+  if (!(busy = guard_acquire(X, 0))) {
+    spmap_dot(m, MAT_BUFI(ptr), MAT_BUFI(off), MAT_BUFD(wv), blk.buf, MAT_BUFD(y));
+    guard_release(X, 0);
+  }
+  dbuffer_release(&blk);
+  if (busy) {
+    Py_DECREF(y);
+    return NULL;
+  }
+  return (PyObject *) y;
+}
 
-  // call projected_inverse
-  info = projected_inverse(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
-			   MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
-			   MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
-			   MAT_BUFI(Py_blkptr),MAT_BUFD(Py_blkval),
-			   fws,upd,upd_size);
+static char doc_cspmap_axpy[] =
+  "Computes X := X + alpha*sum_i y[i]*A_i from the maps computed by\n"
+  "spmap_build.\n"
+  "\n"
+  ":param ptr, off, v:  see spmap_build\n"
+  ":param y:       matrix\n"
+  ":param X:       :py:class:`cspmatrix`\n"
+  ":param alpha:   float (default: 1.0)\n";
 
-  // update reference counts
-  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr);
-  Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
-  Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
-  Py_DECREF(Py_blkptr); Py_DECREF(Py_blkval);
+static PyObject* cspmap_axpy
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  PyObject *ptr, *off, *v, *y, *X;
+  dbuffer blk;
+  double alpha = 1.0;
+  int busy;
+  char *kwlist[] = {"ptr","off","v","y","X","alpha",NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOOO|d", kwlist, &ptr, &off, &v, &y, &X, &alpha)) return NULL;
+  if (!Matrix_Check(y) || MAT_ID(y) != DOUBLE || MAT_LGT(y) != MAT_NROWS(ptr)-1)
+    return PyErr_Format(PyExc_TypeError,"y must be a real matrix with one entry per data matrix");
+  if (blkval_get(X, &blk)) return NULL;
+  if (!(busy = guard_acquire(X, 1))) {
+    spmap_axpy(MAT_NROWS(ptr)-1, MAT_BUFI(ptr), MAT_BUFI(off), MAT_BUFD(v), MAT_BUFD(y), alpha, blk.buf);
+    guard_release(X, 1);
+  }
+  dbuffer_release(&blk);
+  if (busy) return NULL;
+  return Py_BuildValue("");
+}
 
-  // free workspace
-  free(fws); free(upd); free(upd_size);
+static char doc_ccoo_add[] =
+  "Adds a chunk of entries of a sparse symmetric matrix in coordinate\n"
+  "format (original ordering) to a cspmatrix: X[I[t],J[t]] += alpha*V[t].\n"
+  "Duplicate entries are summed. Either all entries of the chunk are\n"
+  "added, or none (ValueError if an entry is out of range or not in the\n"
+  "sparsity pattern).\n"
+  "\n"
+  ":param X:      :py:class:`cspmatrix` (not a factor)\n"
+  ":param I, J:   row and column indices ('i' matrices or buffers of integers)\n"
+  ":param V:      values ('d' matrix or buffer of doubles)\n"
+  ":param alpha:  float (default: 1.0)\n"
+  ":param uplo:   'L' (entries above the diagonal are ignored), 'U' (entries\n"
+  "               below the diagonal are ignored), or 'A' (every entry is\n"
+  "               added to the lower triangle); default: 'L'\n";
 
-  // set cspmatrix factor flag to False
-  PyObject_SetAttrString(A, str_is_factor, Py_False);
+static PyObject* ccoo_add
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  PyObject *X, *Py_I, *Py_J, *Py_V, *PyObj, *symb, *Py_colsn, *Py_sncolptr, *Py_snrowidx, *Py_blkptr, *Py_ip;
+  ibuffer Ib, Jb;
+  dbuffer Vb, blk;
+  double alpha = 1.0;
+  int uplo = 'L';
+  int_t n, nnz, t, *off, info = 0;
+  int busy;
+  char *kwlist[] = {"X","I","J","V","alpha","uplo",NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|dC", kwlist, &X, &Py_I, &Py_J, &Py_V, &alpha, &uplo)) return NULL;
+  if (uplo != 'L' && uplo != 'U' && uplo != 'A') return PyErr_Format(PyExc_ValueError,"uplo must be 'L', 'U' or 'A'");
+  PyObj = PyObject_GetAttrString(X, "is_factor");
+  if (PyObj != Py_False) {
+    Py_XDECREF(PyObj);
+    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix (not a factor)");
+  }
+  Py_DECREF(PyObj);
 
-  // check for errors
-  if (info) return PyErr_Format(PyExc_ArithmeticError,"partial inverse failed");
+  if (ibuffer_get(Py_I, &Ib, "I")) return NULL;
+  if (ibuffer_get(Py_J, &Jb, "J")) {
+    ibuffer_release(&Ib);
+    return NULL;
+  }
+  if (dbuffer_get(Py_V, &Vb, 0, 1, "V")) {
+    ibuffer_release(&Ib); ibuffer_release(&Jb);
+    return NULL;
+  }
+  nnz = Ib.len;
+  if (Jb.len != nnz || Vb.nrows*Vb.ncols != nnz) {
+    ibuffer_release(&Ib); ibuffer_release(&Jb); dbuffer_release(&Vb);
+    return PyErr_Format(PyExc_ValueError,"I, J and V must have the same length");
+  }
+  if (blkval_get(X, &blk)) {
+    ibuffer_release(&Ib); ibuffer_release(&Jb); dbuffer_release(&Vb);
+    return NULL;
+  }
+
+  // supernode of each column (computed once per symbolic factorization)
+  symb = PyObject_GetAttrString(X, "symb");
+  PyObj = PyObject_GetAttrString(symb, "n");
+  n = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  Py_colsn = PyObject_GetAttrString(symb, "_colsn");
+  if (Py_colsn == Py_None) {
+    PyObject *Py_snptr = PyObject_GetAttrString(symb, "snptr"), *Py_snode = PyObject_GetAttrString(symb, "snode");
+    Py_DECREF(Py_colsn);
+    PyObj = PyObject_GetAttrString(symb, "Nsn");
+    if ((Py_colsn = (PyObject *) Matrix_New((int) n, 1, INT))) {
+      spmap_colsn(PYINT_AS_LONG(PyObj), MAT_BUFI(Py_snptr), MAT_BUFI(Py_snode), MAT_BUFI(Py_colsn));
+      if (PyObject_SetAttrString(symb, "_colsn", Py_colsn)) PyErr_Clear();
+    }
+    Py_DECREF(PyObj); Py_DECREF(Py_snptr); Py_DECREF(Py_snode);
+  }
+  Py_sncolptr = PyObject_GetAttrString(symb, "sncolptr");
+  Py_snrowidx = PyObject_GetAttrString(symb, "snrowidx");
+  Py_blkptr = PyObject_GetAttrString(symb, "blkptr");
+  Py_ip = PyObject_GetAttrString(symb, "ip");
+  Py_DECREF(symb);
+
+  if (!Py_colsn || !(off = malloc((nnz+1)*sizeof(int_t)))) {
+    Py_XDECREF(Py_colsn); Py_DECREF(Py_sncolptr); Py_DECREF(Py_snrowidx);
+    Py_DECREF(Py_blkptr); Py_DECREF(Py_ip);
+    ibuffer_release(&Ib); ibuffer_release(&Jb); dbuffer_release(&Vb); dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
 
+  // map the chunk, then accumulate
+  if (!(busy = guard_acquire(X, 1))) {
+    KERNEL_BEGIN
+    info = spmap_coo(n, MAT_BUFI(Py_colsn), MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_snrowidx),
+		     MAT_BUFI(Py_blkptr), MAT_BUFI(Py_ip), (char) uplo, nnz, Ib.buf, Jb.buf, off);
+    if (!info) {
+      for (t=0;t<nnz;t++) if (off[t] >= 0) blk.buf[off[t]] += alpha*Vb.buf[t];
+    }
+    KERNEL_END
+    guard_release(X, 1);
+  }
+  if (info) {
+    t = info-1;
+    if (Ib.buf[t] < 0 || Ib.buf[t] >= n || Jb.buf[t] < 0 || Jb.buf[t] >= n)
+      PyErr_Format(PyExc_ValueError,"entry %i is out of range", (int) t);
+    else
+      PyErr_Format(PyExc_ValueError,"entry %i (%i,%i) is not contained in the chordal embedding",
+		   (int) t, (int) Ib.buf[t], (int) Jb.buf[t]);
+  }
+
+  free(off);
+  Py_DECREF(Py_colsn); Py_DECREF(Py_sncolptr); Py_DECREF(Py_snrowidx);
+  Py_DECREF(Py_blkptr); Py_DECREF(Py_ip);
+  ibuffer_release(&Ib); ibuffer_release(&Jb); dbuffer_release(&Vb); dbuffer_release(&blk);
+  if (busy || info) return NULL;
   return Py_BuildValue("");
 }
 
-static char doc_ccompletion[] =
-  "Supernodal multifrontal maximum determinant positive definite\n"
-  "matrix completion. The routine computes the Cholesky factor\n"
-  ":math:`L` of the inverse of the maximum determinant positive\n"
-  "definite matrix completion of :math:`X`:, i.e.,\n"
+static char doc_cblock_convert[] =
+  "Converts the columns of a sparse matrix X with dim^2 rows (vectorized\n"
+  "symmetric matrices, lower triangular part) to the block-diagonal\n"
+  "representation of the clique conversion of symb.\n"
+  "\n"
+  ":param symb:  :py:class:`symbolic`\n"
+  ":param X:     :py:class:`spmatrix`\n";
+
+static PyObject* cblock_convert
+(PyObject *self, PyObject *args)
+{
+  int_t n, nsn, m, nnz, t, cnt;
+  int_t *colsn = NULL, *boff = NULL;
+  PyObject *symb, *X, *PyObj, *Py_snptr, *Py_snode, *Py_sncolptr, *Py_snrowidx, *Py_ip;
+  matrix *Im = NULL, *Jm = NULL, *Vm = NULL;
+  spmatrix *ret;
+  char str_n[] = "n",
+    str_nsn[] = "Nsn",
+    str_snptr[] = "snptr",
+    str_snode[] = "snode",
+    str_sncolptr[] = "sncolptr",
+    str_snrowidx[] = "snrowidx",
+    str_ip[] = "ip";
+
+  if (!PyArg_ParseTuple(args, "OO", &symb, &X)) return NULL;  // borrowed references
+
+  PyObj = PyObject_GetAttrString(symb, str_n);
+  n = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+
+  if (!SpMatrix_Check(X) || SP_NROWS(X) != n*n || SP_ID(X) == INT)
+    return PyErr_Format(PyExc_TypeError,"X must be a sparse matrix with %i rows", (int) (n*n));
+  m = SP_NCOLS(X);
+
+  // number of triplets: two for each strictly lower triangular entry
+  nnz = 0;
+  for (t=0;t<SP_NNZ(X);t++) {
+    if (SP_ROW(X)[t] % n > SP_ROW(X)[t] / n) nnz += 2;
+    else if (SP_ROW(X)[t] % n == SP_ROW(X)[t] / n) nnz += 1;
+  }
+
+  colsn = malloc(n*sizeof(int_t));
+  boff = malloc((nsn+1)*sizeof(int_t));
+  Im = Matrix_New(nnz, 1, INT);
+  Jm = Matrix_New(nnz, 1, INT);
+  Vm = Matrix_New(nnz, 1, SP_ID(X));
+  if (!colsn || !boff || !Im || !Jm || !Vm) {
+    free(colsn); free(boff);
+    Py_XDECREF(Im); Py_XDECREF(Jm); Py_XDECREF(Vm);
+    return PyErr_NoMemory();
+  }
+
+  Py_snptr = PyObject_GetAttrString(symb, str_snptr);
+  Py_snode = PyObject_GetAttrString(symb, str_snode);
+  Py_sncolptr = PyObject_GetAttrString(symb, str_sncolptr);
+  Py_snrowidx = PyObject_GetAttrString(symb, str_snrowidx);
+  Py_ip = PyObject_GetAttrString(symb, str_ip);
+
+  spmap_colsn(nsn, MAT_BUFI(Py_snptr), MAT_BUFI(Py_snode), colsn);
+  block_offsets(nsn, MAT_BUFI(Py_sncolptr), boff);
+  cnt = block_convert(n, m, SP_COL(X), SP_ROW(X), SP_VALD(X), SP_ID(X) == COMPLEX,
+		      MAT_BUFI(Py_ip), colsn, MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_snrowidx), boff,
+		      MAT_BUFI(Im), MAT_BUFI(Jm), MAT_BUFD(Vm));
+
+  Py_DECREF(Py_snptr); Py_DECREF(Py_snode); Py_DECREF(Py_sncolptr);
+  Py_DECREF(Py_snrowidx); Py_DECREF(Py_ip);
+
+  if (cnt < 0) {
+    Py_DECREF(Im); Py_DECREF(Jm); Py_DECREF(Vm);
+    free(colsn); free(boff);
+    return PyErr_Format(PyExc_ValueError,"sparsity pattern of X is not contained in the chordal embedding");
+  }
+
+  ret = SpMatrix_NewFromIJV(Im, Jm, Vm, boff[nsn], m, SP_ID(X));
+  Py_DECREF(Im); Py_DECREF(Jm); Py_DECREF(Vm);
+  free(colsn); free(boff);
+  return (PyObject *) ret;
+}
+
+static char doc_cblock_coupling[] =
+  "Returns the coupling constraints of the clique conversion of symb as\n"
+  "a sparse matrix with one column per constraint.\n"
+  "\n"
+  ":param symb:      :py:class:`symbolic`\n"
+  ":param coupling:  :py:class:`spmatrix` with the (reordered, lower triangular)\n"
+  "                  coupling pattern, or None for full coupling\n"
+  ":param tc:        'd' or 'z'\n";
+
+static PyObject* cblock_coupling
+(PyObject *self, PyObject *args)
+{
+  int_t nsn, nnz, ncon;
+  int_t *boff;
+  int cplx;
+  char tc;
+  PyObject *symb, *coupling, *PyObj, *Py_snptr, *Py_snpar, *Py_sncolptr, *Py_snrowidx, *Py_relptr, *Py_relidx;
+  matrix *Im, *Jm, *Vm;
+  spmatrix *ret;
+  char str_nsn[] = "Nsn",
+    str_snptr[] = "snptr",
+    str_snpar[] = "snpar",
+    str_sncolptr[] = "sncolptr",
+    str_snrowidx[] = "snrowidx",
+    str_relptr[] = "relptr",
+    str_relidx[] = "relidx";
+
+#if PY_MAJOR_VERSION >= 3
+  int tc_;
+  if (!PyArg_ParseTuple(args, "OOC", &symb, &coupling, &tc_)) return NULL;
+  tc = (char) tc_;
+#else
+  if (!PyArg_ParseTuple(args, "OOc", &symb, &coupling, &tc)) return NULL;
+#endif
+  if (coupling != Py_None && !SpMatrix_Check(coupling))
+    return PyErr_Format(PyExc_TypeError,"coupling must be a sparse matrix or None");
+  cplx = (tc == 'z');
+
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  Py_snptr = PyObject_GetAttrString(symb, str_snptr);
+  Py_snpar = PyObject_GetAttrString(symb, str_snpar);
+  Py_sncolptr = PyObject_GetAttrString(symb, str_sncolptr);
+  Py_snrowidx = PyObject_GetAttrString(symb, str_snrowidx);
+  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
+  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
+
+  if (!(boff = malloc((nsn+1)*sizeof(int_t)))) {
+    ret = NULL;
+    PyErr_NoMemory();
+    goto cleanup;
+  }
+  block_offsets(nsn, MAT_BUFI(Py_sncolptr), boff);
+
+#define BLOCK_COUPLING(Im,Jm,Vm) block_coupling(nsn, MAT_BUFI(Py_snptr), MAT_BUFI(Py_snpar), \
+    MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_snrowidx), MAT_BUFI(Py_relptr), MAT_BUFI(Py_relidx), boff, \
+    (coupling == Py_None) ? NULL : SP_COL(coupling), (coupling == Py_None) ? NULL : SP_ROW(coupling), \
+    cplx, Im, Jm, Vm, &ncon)
+
+  // count triplets, then compute them
+  nnz = BLOCK_COUPLING(NULL, NULL, NULL);
+  Im = Matrix_New(nnz, 1, INT);
+  Jm = Matrix_New(nnz, 1, INT);
+  Vm = Matrix_New(nnz, 1, cplx ? COMPLEX : DOUBLE);
+  if (!Im || !Jm || !Vm) {
+    Py_XDECREF(Im); Py_XDECREF(Jm); Py_XDECREF(Vm);
+    ret = NULL;
+    PyErr_NoMemory();
+    goto cleanup;
+  }
+  BLOCK_COUPLING(MAT_BUFI(Im), MAT_BUFI(Jm), MAT_BUFD(Vm));
+#undef BLOCK_COUPLING
+
+  ret = SpMatrix_NewFromIJV(Im, Jm, Vm, boff[nsn], ncon, cplx ? COMPLEX : DOUBLE);
+  Py_DECREF(Im); Py_DECREF(Jm); Py_DECREF(Vm);
+
+ cleanup:
+  Py_DECREF(Py_snptr); Py_DECREF(Py_snpar); Py_DECREF(Py_sncolptr);
+  Py_DECREF(Py_snrowidx); Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
+  free(boff);
+  return (PyObject *) ret;
+}
+
+typedef struct {
+  int_t n, nsn, clique_number;
+  int factor;
+  PyObject *X;            // borrowed reference
+  PyObject *snptr, *snode, *sncolptr, *snrowidx, *blkptr, *p;
+  dbuffer blkval;
+} csc_args;
+
+static int csc_args_get(PyObject *X, int reordered, csc_args *a)
+{
+  /*
+    Extracts the arrays used by csc_colptr() and csc_fill() from the
+    cspmatrix X (new references, released by csc_args_release()).
+  */
+  PyObject *symb, *PyObj;
+
+  a->X = X;
+  if (blkval_get(X, &a->blkval)) return -1;
+  if (!(symb = PyObject_GetAttrString(X, "symb"))) {
+    dbuffer_release(&a->blkval);
+    return -1;
+  }
+  PyObj = PyObject_GetAttrString(X, "is_factor");
+  a->factor = (PyObj == Py_True); Py_XDECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, "n");
+  a->n = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, "Nsn");
+  a->nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, "clique_number");
+  a->clique_number = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  a->snptr = PyObject_GetAttrString(symb, "snptr");
+  a->snode = PyObject_GetAttrString(symb, "snode");
+  a->sncolptr = PyObject_GetAttrString(symb, "sncolptr");
+  a->snrowidx = PyObject_GetAttrString(symb, "snrowidx");
+  a->blkptr = PyObject_GetAttrString(symb, "blkptr");
+  a->p = PyObject_GetAttrString(symb, "p");
+  Py_DECREF(symb);
+  if (reordered && a->p) {
+    Py_DECREF(a->p);
+    a->p = Py_None; Py_INCREF(Py_None);
+  }
+  return 0;
+}
+
+static void csc_args_release(csc_args *a)
+{
+  Py_XDECREF(a->snptr); Py_XDECREF(a->snode); Py_XDECREF(a->sncolptr); Py_XDECREF(a->snrowidx);
+  Py_XDECREF(a->blkptr); Py_XDECREF(a->p); dbuffer_release(&a->blkval);
+}
+
+#define CSC_P(a) (((a).p == Py_None) ? NULL : MAT_BUFI((a).p))
+
+static int csc_fill_args(csc_args *a, char uplo, int_t c0, int_t c1, int_t *colptr, int_t *rowidx, double *val)
+{
+  /*
+    Calls csc_fill() for the cspmatrix a->X. Returns -1 and raises an
+    exception on failure.
+  */
+  int_t *pos;
+  double *ws = NULL;
+  int busy;
+
+  if (!(pos = malloc((c1-c0+1)*sizeof(int_t)))) {
+    PyErr_NoMemory();
+    return -1;
+  }
+  if (a->factor && !(ws = malloc((a->clique_number*a->clique_number+1)*sizeof(double)))) {
+    free(pos);
+    PyErr_NoMemory();
+    return -1;
+  }
+  if (!(busy = guard_acquire(a->X, 0))) {
+    csc_fill(a->n, a->nsn, MAT_BUFI(a->snptr), MAT_BUFI(a->snode), MAT_BUFI(a->sncolptr),
+	     MAT_BUFI(a->snrowidx), MAT_BUFI(a->blkptr), CSC_P(*a), uplo, a->factor, a->blkval.buf,
+	     c0, c1, colptr, rowidx, val, pos, ws);
+    guard_release(a->X, 0);
+  }
+  free(pos); free(ws);
+  return busy;
+}
+
+static char doc_ccsc[] =
+  "Converts a cspmatrix to a sparse matrix in compressed column storage.\n"
+  "\n"
+  ":param X:          :py:class:`cspmatrix`\n"
+  ":param uplo:       'L' (lower triangle), 'U' (upper triangle), or 'S'\n"
+  "                   (symmetric) (default: 'L')\n"
+  ":param reordered:  boolean (default: True)\n";
+
+static PyObject* ccsc
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  PyObject *X;
+  spmatrix *ret;
+  csc_args a;
+  int_t nnz, *colptr;
+  int reordered = 1;
+  char uplo = 'L';
+  char *kwlist[] = {"X","uplo","reordered",NULL};
+
+#if PY_MAJOR_VERSION >= 3
+  int uplo_ = 'L';
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O|Ci", kwlist, &X, &uplo_, &reordered)) return NULL;
+  uplo = (char) uplo_;
+#else
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O|ci", kwlist, &X, &uplo, &reordered)) return NULL;
+#endif
+  if (uplo != 'L' && uplo != 'U' && uplo != 'S') return PyErr_Format(PyExc_ValueError,"uplo must be 'L', 'U', or 'S'");
+  if (csc_args_get(X, reordered, &a)) return NULL;
+
+  if (!(colptr = malloc((a.n+1)*sizeof(int_t)))) {
+    csc_args_release(&a);
+    return PyErr_NoMemory();
+  }
+  nnz = csc_colptr(a.n, a.nsn, MAT_BUFI(a.snptr), MAT_BUFI(a.snode), MAT_BUFI(a.sncolptr),
+		   MAT_BUFI(a.snrowidx), CSC_P(a), uplo, colptr);
+  if (!(ret = SpMatrix_New(a.n, a.n, nnz, DOUBLE))) {
+    free(colptr); csc_args_release(&a);
+    return PyErr_NoMemory();
+  }
+  memcpy(SP_COL(ret), colptr, (a.n+1)*sizeof(int_t));
+  free(colptr);
+  if (csc_fill_args(&a, uplo, 0, a.n, SP_COL(ret), SP_ROW(ret), SP_VALD(ret))) {
+    Py_DECREF(ret); csc_args_release(&a);
+    return NULL;
+  }
+  csc_args_release(&a);
+  return (PyObject *) ret;
+}
+
+static char doc_ccsc_colptr[] =
+  "Returns the column pointer (an 'i' matrix of length n+1) of the\n"
+  "compressed column storage of a cspmatrix (see :py:func:`csc_fill`).\n"
+  "\n"
+  ":param X:          :py:class:`cspmatrix`\n"
+  ":param uplo:       'L', 'U', or 'S' (default: 'L')\n"
+  ":param reordered:  boolean (default: True)\n";
+
+static PyObject* ccsc_colptr
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  PyObject *X;
+  matrix *colptr;
+  csc_args a;
+  int reordered = 1;
+  char uplo = 'L';
+  char *kwlist[] = {"X","uplo","reordered",NULL};
+
+#if PY_MAJOR_VERSION >= 3
+  int uplo_ = 'L';
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O|Ci", kwlist, &X, &uplo_, &reordered)) return NULL;
+  uplo = (char) uplo_;
+#else
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O|ci", kwlist, &X, &uplo, &reordered)) return NULL;
+#endif
+  if (uplo != 'L' && uplo != 'U' && uplo != 'S') return PyErr_Format(PyExc_ValueError,"uplo must be 'L', 'U', or 'S'");
+  if (csc_args_get(X, reordered, &a)) return NULL;
+
+  if (!(colptr = Matrix_New(a.n+1, 1, INT))) {
+    csc_args_release(&a);
+    return PyErr_NoMemory();
+  }
+  csc_colptr(a.n, a.nsn, MAT_BUFI(a.snptr), MAT_BUFI(a.snode), MAT_BUFI(a.sncolptr),
+	     MAT_BUFI(a.snrowidx), CSC_P(a), uplo, MAT_BUFI(colptr));
+  csc_args_release(&a);
+  return (PyObject *) colptr;
+}
+
+static char doc_ccsc_fill[] =
+  "Fills columns c0 to c1-1 of the compressed column storage of a\n"
+  "cspmatrix into preallocated buffers: the row indices and values of\n"
+  "column c are stored in `rowidx` and `val` at positions\n"
+  "colptr[c]-colptr[c0] to colptr[c+1]-colptr[c0]-1, sorted by row\n"
+  "index. Calling it for consecutive column ranges with the same buffers\n"
+  "streams the matrix without storing it.\n"
+  "\n"
+  ":param X:          :py:class:`cspmatrix`\n"
+  ":param colptr:     column pointer computed by :py:func:`csc_colptr`\n"
+  ":param rowidx:     'i' matrix of length at least colptr[c1]-colptr[c0]\n"
+  ":param val:        'd' matrix of length at least colptr[c1]-colptr[c0]\n"
+  ":param uplo:       'L', 'U', or 'S' (default: 'L')\n"
+  ":param reordered:  boolean (default: True)\n"
+  ":param c0:         integer (default: 0)\n"
+  ":param c1:         integer (default: n)\n";
+
+static PyObject* ccsc_fill
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  PyObject *X, *colptr, *rowidx, *val;
+  csc_args a;
+  int reordered = 1;
+  Py_ssize_t c0 = 0, c1 = -1;
+  char uplo = 'L';
+  char *kwlist[] = {"X","colptr","rowidx","val","uplo","reordered","c0","c1",NULL};
+
+#if PY_MAJOR_VERSION >= 3
+  int uplo_ = 'L';
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|Cinn", kwlist, &X, &colptr, &rowidx, &val,
+				   &uplo_, &reordered, &c0, &c1)) return NULL;
+  uplo = (char) uplo_;
+#else
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|cinn", kwlist, &X, &colptr, &rowidx, &val,
+				   &uplo, &reordered, &c0, &c1)) return NULL;
+#endif
+  if (uplo != 'L' && uplo != 'U' && uplo != 'S') return PyErr_Format(PyExc_ValueError,"uplo must be 'L', 'U', or 'S'");
+  if (csc_args_get(X, reordered, &a)) return NULL;
+  if (c1 < 0) c1 = a.n;
+
+  if (!Matrix_Check(colptr) || MAT_ID(colptr) != INT || MAT_LGT(colptr) != a.n+1) {
+    csc_args_release(&a);
+    return PyErr_Format(PyExc_TypeError,"colptr must be an 'i' matrix of length n+1");
+  }
+  if (c0 < 0 || c0 > c1 || c1 > a.n) {
+    csc_args_release(&a);
+    return PyErr_Format(PyExc_ValueError,"invalid column range");
+  }
+  if (!Matrix_Check(rowidx) || MAT_ID(rowidx) != INT ||
+      MAT_LGT(rowidx) < MAT_BUFI(colptr)[c1]-MAT_BUFI(colptr)[c0] ||
+      !Matrix_Check(val) || MAT_ID(val) != DOUBLE ||
+      MAT_LGT(val) < MAT_BUFI(colptr)[c1]-MAT_BUFI(colptr)[c0]) {
+    csc_args_release(&a);
+    return PyErr_Format(PyExc_TypeError,"rowidx and val must be 'i' and 'd' matrices of length at least colptr[c1]-colptr[c0]");
+  }
+
+  if (csc_fill_args(&a, uplo, c0, c1, MAT_BUFI(colptr), MAT_BUFI(rowidx), MAT_BUFD(val))) {
+    csc_args_release(&a);
+    return NULL;
+  }
+  csc_args_release(&a);
+  return Py_BuildValue("");
+}
+
+static char doc_cblock_to_sparse[] =
+  "Returns the map (blki, I, J, N) from the block-diagonal representation\n"
+  "of the clique conversion of symb to the lower triangular part of the\n"
+  "filled pattern in the original ordering.\n"
+  "\n"
+  ":param symb:  :py:class:`symbolic`\n";
+
+static PyObject* cblock_to_sparse
+(PyObject *self, PyObject *args)
+{
+  int_t n, nsn, nnz;
+  int_t *boff;
+  PyObject *symb, *PyObj, *Py_snptr, *Py_sncolptr, *Py_snrowidx, *Py_p;
+  matrix *blki, *Im, *Jm;
+  char str_n[] = "n",
+    str_nsn[] = "Nsn",
+    str_snptr[] = "snptr",
+    str_sncolptr[] = "sncolptr",
+    str_snrowidx[] = "snrowidx",
+    str_p[] = "p";
+
+  if (!PyArg_ParseTuple(args, "O", &symb)) return NULL;  // borrowed reference
+
+  PyObj = PyObject_GetAttrString(symb, str_n);
+  n = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  Py_snptr = PyObject_GetAttrString(symb, str_snptr);
+  Py_sncolptr = PyObject_GetAttrString(symb, str_sncolptr);
+  Py_snrowidx = PyObject_GetAttrString(symb, str_snrowidx);
+  Py_p = PyObject_GetAttrString(symb, str_p);
+
+  boff = malloc((nsn+1)*sizeof(int_t));
+  if (boff) block_offsets(nsn, MAT_BUFI(Py_sncolptr), boff);
+  nnz = block_to_sparse(n, nsn, MAT_BUFI(Py_snptr), MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_snrowidx),
+			boff, MAT_BUFI(Py_p), NULL, NULL, NULL);
+  blki = Matrix_New(nnz, 1, INT);
+  Im = Matrix_New(nnz, 1, INT);
+  Jm = Matrix_New(nnz, 1, INT);
+  if (!boff || !blki || !Im || !Jm ||
+      block_to_sparse(n, nsn, MAT_BUFI(Py_snptr), MAT_BUFI(Py_sncolptr), MAT_BUFI(Py_snrowidx),
+		      boff, MAT_BUFI(Py_p), MAT_BUFI(blki), MAT_BUFI(Im), MAT_BUFI(Jm)) < 0) {
+    Py_XDECREF(blki); Py_XDECREF(Im); Py_XDECREF(Jm);
+    blki = NULL;
+    PyErr_NoMemory();
+  }
+
+  Py_DECREF(Py_snptr); Py_DECREF(Py_sncolptr); Py_DECREF(Py_snrowidx); Py_DECREF(Py_p);
+  if (!blki) {
+    free(boff);
+    return NULL;
+  }
+  nnz = boff[nsn];
+  free(boff);
+  return Py_BuildValue("NNNn", blki, Im, Jm, nnz);
+}
+
+static char doc_cchol[] =
+  "Supernodal multifrontal Cholesky factorization:\n"
+  "\n"
+  ".. math::\n"
+  "     X = LL^T\n"
+  "\n"
+  "where :math:`L` is lower-triangular. On exit, the argument :math:`X`\n"
+  "contains the Cholesky factor :math:`L`.\n"
+  "\n"
+  "If `delta` is given, a pivot :math:`d` that is not greater than `tol`\n"
+  "(after the updates from the preceding columns) is replaced by\n"
+  ":math:`\\max(\\delta, -d)` and the factorization continues, so that\n"
+  ":math:`LL^T = X + E` with :math:`E` diagonal. The factorization then\n"
+  "returns a tuple (I, V) with the perturbed columns (in the original\n"
+  "ordering, in the order in which they were perturbed) and the\n"
+  "diagonal entries of :math:`E`.\n"
+  "\n"
+  ":param X:    :py:class:`cspmatrix`\n"
+  ":param nthreads:  number of threads used for the tiled factorization of\n"
+  "                  large frontal matrices (default: 1; 0 means all\n"
+  "                  available). Without OpenMP, the tiled factorization\n"
+  "                  runs sequentially for nthreads > 1.\n"
+  ":param delta:  float (optional)\n"
+  ":param tol:    float (default: `delta`)\n";
+
+static PyObject* cchol
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  int info = 0, nthreads = 1, busy;
+  int_t k, n, nsn, stack_depth, stack_mem, frontal_mem;
+  int_t *upd_size=NULL;
+  double * restrict fws=NULL, * restrict upd=NULL;
+  double delta = -1.0, tol = -1.0;
+  dbuffer blk;
+  cholesky_reg reg;
+  char str_symb[] = "symb",
+    str_snpost[] = "snpost",
+    str_snptr[] = "snptr",
+    str_relptr[] = "relptr",
+    str_relidx[] = "relidx",
+    str_chptr[] = "chptr",
+    str_chidx[] = "chidx",
+    str_blkptr[] = "blkptr",
+    str_memory[] = "memory",
+    str_stack_depth[] = "stack_depth",
+    str_stack_mem[] = "stack_mem",
+    str_frontal_mem[] = "frontal_mem",
+    str_is_factor[] = "is_factor",
+    str_n[] = "n",
+    str_nsn[] = "Nsn",
+    str_p[] = "p";
+
+  PyObject *A, *symb, *Py_snpost, *Py_snptr, *Py_relptr, *Py_relidx,
+    *Py_chptr, *Py_chidx, *Py_blkptr, *PyObj, *Py_memory,
+    *Py_delta = Py_None, *Py_tol = Py_None, *Py_I = NULL, *Py_V = NULL;
+
+  char *kwlist[] = {"X","nthreads","delta","tol",NULL};
+
+  // extract pointers from cspmatrix A
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O|iOO", kwlist, &A, &nthreads, &Py_delta, &Py_tol)) return NULL;  // A : borrowed reference
+  if (Py_delta != Py_None) {
+    delta = PyFloat_AsDouble(Py_delta);
+    tol = (Py_tol == Py_None) ? delta : PyFloat_AsDouble(Py_tol);
+    if (PyErr_Occurred()) return NULL;
+    if (!(delta > 0.0)) return PyErr_Format(PyExc_ValueError,"delta must be positive");
+  }
+#ifdef _OPENMP
+  if (nthreads < 1) nthreads = omp_get_max_threads();
+#else
+  // without OpenMP, nthreads > 1 runs the tiled factorization in order
+  if (nthreads < 1) nthreads = 1;
+#endif
+
+  // check that cspmatrix factor flag is False
+  PyObj = PyObject_GetAttrString(A,str_is_factor);
+  if (PyObj == Py_False) {
+    Py_DECREF(PyObj);
+  }
+  else {
+    Py_DECREF(PyObj);
+    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix");
+  }
+  if (blkval_get(A, &blk)) return NULL;
+
+  // extract pointers and values from symbolic object
+  symb = PyObject_GetAttrString(A,str_symb);
+  Py_snpost = PyObject_GetAttrString(symb, str_snpost);
+  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
+  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
+  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
+  Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
+  Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
+  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
+  PyObj = PyObject_GetAttrString(symb, str_n);
+  n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  Py_memory = PyObject_GetAttrString(symb, str_memory);
+  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
+  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
+  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
+  Py_DECREF(Py_memory);
+  Py_DECREF(symb);
+
+  // allocate workspace
+  if (!(upd = malloc(stack_mem*sizeof(double)))) {
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+  if (!(fws = malloc(frontal_mem*sizeof(double)))) {
+    free(upd);
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+  if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
+    free(upd);
+    free(fws);
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+  if (delta > 0.0) {
+    reg.tol = tol; reg.delta = delta; reg.npert = 0;
+    reg.col = malloc(n*sizeof(int_t));
+    reg.val = malloc(n*sizeof(double));
+    if (!reg.col || !reg.val) {
+      free(reg.col); free(reg.val);
+      free(upd); free(fws); free(upd_size);
+      dbuffer_release(&blk);
+      return PyErr_NoMemory();
+    }
+  }
+
+  // call numerical cholesky
+  if (!(busy = guard_acquire(A, 1))) {
+    KERNEL_BEGIN
+    blkval_advise(&blk, ADVISE_BOTTOM_UP);
+    info = cholesky(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
+		    MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
+		    MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
+		    MAT_BUFI(Py_blkptr),blk.buf,
+		    fws,upd,upd_size,nthreads,(delta > 0.0) ? &reg : NULL);
+    blkval_advise(&blk, ADVISE_NORMAL);
+    KERNEL_END
+    guard_release(A, 1);
+  }
+
+  // update reference counts
+  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr);
+  Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
+  Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
+  Py_DECREF(Py_blkptr); dbuffer_release(&blk);
+
+  // free workspace
+  free(fws); free(upd); free(upd_size);
+  if (busy) {
+    if (delta > 0.0) { free(reg.col); free(reg.val); }
+    return NULL;
+  }
+
+  // set cspmatrix factor flag to True
+  PyObject_SetAttrString(A, str_is_factor, Py_True);
+
+  if (delta > 0.0) {
+    // perturbed columns (in the original ordering) and perturbations
+    Py_I = (PyObject *) Matrix_New(reg.npert,1,INT);
+    Py_V = (PyObject *) Matrix_New(reg.npert,1,DOUBLE);
+    if (Py_I && Py_V) {
+      symb = PyObject_GetAttrString(A,str_symb);
+      PyObj = PyObject_GetAttrString(symb, str_p);
+      for (k=0;k<reg.npert;k++) {
+	MAT_BUFI(Py_I)[k] = MAT_BUFI(PyObj)[reg.col[k]];
+	MAT_BUFD(Py_V)[k] = reg.val[k];
+      }
+      Py_DECREF(PyObj);
+      Py_DECREF(symb);
+    }
+    free(reg.col); free(reg.val);
+    if (!Py_I || !Py_V) {
+      Py_XDECREF(Py_I); Py_XDECREF(Py_V);
+      return PyErr_NoMemory();
+    }
+    return Py_BuildValue("NN", Py_I, Py_V);
+  }
+
+  // check for errors
+  if (info) return PyErr_Format(PyExc_ArithmeticError,"factorization failed");
+
+  return Py_BuildValue("");
+}
+
+
+static char doc_cllt[] =
+  "Supernodal multifrontal Cholesky product:\n"
+  "\n"
+  ".. math::\n"
+  "     X = LL^T\n"
+  "\n"
+  "where :math:`L` is lower-triangular. On exit, the argument `L`\n"
+  "contains the product :math:`X`.\n"
+  "\n"
+  ":param L:    :py:class:`cspmatrix` (factor)";
+
+static PyObject* cllt
+(PyObject *self, PyObject *args)
+{
+  int_t n, nsn, stack_depth, stack_mem, frontal_mem;
+  int_t *upd_size=NULL;
+  int busy;
+  dbuffer blk;
+  double * restrict fws=NULL, * restrict upd=NULL;
+  char str_symb[] = "symb",
+    str_snpost[] = "snpost",
+    str_snptr[] = "snptr",
+    str_relptr[] = "relptr",
+    str_relidx[] = "relidx",
+    str_chptr[] = "chptr",
+    str_chidx[] = "chidx",
+    str_blkptr[] = "blkptr",
+    str_memory[] = "memory",
+    str_stack_depth[] = "stack_depth",
+    str_stack_mem[] = "stack_mem",
+    str_frontal_mem[] = "frontal_mem",
+    str_is_factor[] = "is_factor",
+    str_n[] = "n",
+    str_nsn[] = "Nsn";
+
+  PyObject *A, *symb, *Py_snpost, *Py_snptr, *Py_relptr, *Py_relidx,
+    *Py_chptr, *Py_chidx, *Py_blkptr, *PyObj, *Py_memory;
+
+  // extract pointers from cspmatrix A
+  if (!PyArg_ParseTuple(args, "O", &A)) return NULL;  // A : borrowed reference
+  if (blkval_get(A, &blk)) return NULL;
+
+  // extract pointers and values from symbolic object
+  symb = PyObject_GetAttrString(A,str_symb);
+  Py_snpost = PyObject_GetAttrString(symb, str_snpost);
+  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
+  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
+  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
+  Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
+  Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
+  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
+  PyObj = PyObject_GetAttrString(symb, str_n);
+  n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  Py_memory = PyObject_GetAttrString(symb, str_memory);
+  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
+  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
+  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
+  Py_DECREF(Py_memory);
+  Py_DECREF(symb);
+
+  // check that cspmatrix factor flag is True
+  PyObj = PyObject_GetAttrString(A,str_is_factor);
+  if (PyObj == Py_True) {
+    Py_DECREF(PyObj);
+  }
+  else {
+    Py_DECREF(PyObj);
+    dbuffer_release(&blk);
+    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix");
+  }
+
+  // allocate workspace
+  if (!(upd = malloc(stack_mem*sizeof(double)))) {
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+  if (!(fws = malloc(frontal_mem*sizeof(double)))) {
+    free(upd);
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+  if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
+    free(upd);
+    free(fws);
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+
+  // call llt
+  if (!(busy = guard_acquire(A, 1))) {
+    KERNEL_BEGIN
+    blkval_advise(&blk, ADVISE_BOTTOM_UP);
+    llt(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
+	MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
+	MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
+	MAT_BUFI(Py_blkptr),blk.buf,
+	fws,upd,upd_size);
+    blkval_advise(&blk, ADVISE_NORMAL);
+    KERNEL_END
+    guard_release(A, 1);
+  }
+
+  // update reference counts
+  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr);
+  Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
+  Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
+  Py_DECREF(Py_blkptr); dbuffer_release(&blk);
+
+  // free workspace
+  free(fws); free(upd); free(upd_size);
+  if (busy) return NULL;
+
+  // set cspmatrix factor flag to False
+  PyObject_SetAttrString(A, str_is_factor, Py_False);
+
+  return Py_BuildValue("");
+}
+
+
+static char doc_cprojected_inverse[] =
+  "Supernodal multifrontal projected inverse. The routine computes the projected inverse\n"
+  "\n"
+  ".. math::\n"
+  "     Y = P(L^{-T}L^{-1}) \n"
+  "\n"
+  "where :math:`L` is a Cholesky factor. On exit, the argument :math:`L` contains the\n"
+  "projected inverse :math:`Y`.\n"
+  "\n"
+  ":param L:            :py:class:`cspmatrix` (factor)";
+
+static PyObject* cprojected_inverse
+(PyObject *self, PyObject *args)
+{
+  int info = 0, busy;
+  int_t n, nsn, stack_depth, stack_mem, frontal_mem;
+  int_t *upd_size=NULL;
+  dbuffer blk;
+  double * restrict fws=NULL, * restrict upd=NULL;
+  char str_symb[] = "symb",
+    str_snpost[] = "snpost",
+    str_snptr[] = "snptr",
+    str_relptr[] = "relptr",
+    str_relidx[] = "relidx",
+    str_chptr[] = "chptr",
+    str_chidx[] = "chidx",
+    str_blkptr[] = "blkptr",
+    str_memory[] = "memory",
+    str_stack_depth[] = "stack_depth",
+    str_stack_mem[] = "stack_mem",
+    str_frontal_mem[] = "frontal_mem",
+    str_is_factor[] = "is_factor",
+    str_n[] = "n",
+    str_nsn[] = "Nsn";
+
+  PyObject *A, *symb, *Py_snpost, *Py_snptr, *Py_relptr, *Py_relidx,
+    *Py_chptr, *Py_chidx, *Py_blkptr, *PyObj, *Py_memory;
+
+  // extract pointers from cspmatrix A
+  if (!PyArg_ParseTuple(args, "O", &A)) return NULL;  // A : borrowed reference
+  if (blkval_get(A, &blk)) return NULL;
+
+  // extract pointers and values from symbolic object
+  symb = PyObject_GetAttrString(A,str_symb);
+  Py_snpost = PyObject_GetAttrString(symb, str_snpost);
+  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
+  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
+  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
+  Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
+  Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
+  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
+  PyObj = PyObject_GetAttrString(symb, str_n);
+  n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  Py_memory = PyObject_GetAttrString(symb, str_memory);
+  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
+  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
+  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
+  Py_DECREF(Py_memory);
+  Py_DECREF(symb);
+
+  // check that cspmatrix factor flag is True
+  PyObj = PyObject_GetAttrString(A,str_is_factor);
+  if (PyObj == Py_True) {
+    Py_DECREF(PyObj);
+  }
+  else {
+    Py_DECREF(PyObj);
+    dbuffer_release(&blk);
+    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix");
+  }
+
+  // allocate workspace
+  if (!(upd = malloc(stack_mem*sizeof(double)))) {
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+  if (!(fws = malloc(frontal_mem*sizeof(double)))) {
+    free(upd);
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+  if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
+    free(upd);
+    free(fws);
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+
+  // call projected_inverse
+  if (!(busy = guard_acquire(A, 1))) {
+    KERNEL_BEGIN
+    blkval_advise(&blk, ADVISE_TOP_DOWN);
+    info = projected_inverse(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
+			     MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
+			     MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
+			     MAT_BUFI(Py_blkptr),blk.buf,
+			     fws,upd,upd_size);
+    blkval_advise(&blk, ADVISE_NORMAL);
+    KERNEL_END
+    guard_release(A, 1);
+  }
+
+  // update reference counts
+  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr);
+  Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
+  Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
+  Py_DECREF(Py_blkptr); dbuffer_release(&blk);
+
+  // free workspace
+  free(fws); free(upd); free(upd_size);
+  if (busy) return NULL;
+
+  // set cspmatrix factor flag to False
+  PyObject_SetAttrString(A, str_is_factor, Py_False);
+
+  // check for errors
+  if (info) return PyErr_Format(PyExc_ArithmeticError,"partial inverse failed");
+
+  return Py_BuildValue("");
+}
+
+static char doc_ccompletion[] =
+  "Supernodal multifrontal maximum determinant positive definite\n"
+  "matrix completion. The routine computes the Cholesky factor\n"
+  ":math:`L` of the inverse of the maximum determinant positive\n"
+  "definite matrix completion of :math:`X`:, i.e.,\n"
+  "\n"
+  ".. math::\n"
+  "     P( S^{-1} ) = X\n"
+  "\n"
+  "where :math:`S = LL^T`. On exit, the argument `X` contains the\n"
+  "lower-triangular Cholesky factor :math:`L`.\n"
+  "\n"
+  "The optional argument `factored_updates` can be used to enable (if\n"
+  "True) or disable (if False) updating of intermediate\n"
+  "factorizations.\n"
+  "\n"
+  ":param X:                 :py:class:`cspmatrix`\n"
+  ":param factored_updates:  boolean";
+
+static PyObject* ccompletion
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  int info = 0, factored_updates = 0, busy;
+  int_t n, nsn, stack_depth, stack_mem, frontal_mem, update_factor_mem;
+  int_t *upd_size=NULL;
+  dbuffer blk;
+  double * restrict fws=NULL, * restrict upd=NULL, * restrict ws=NULL;
+  char str_symb[] = "symb",
+    str_snpost[] = "snpost",
+    str_snptr[] = "snptr",
+    str_relptr[] = "relptr",
+    str_relidx[] = "relidx",
+    str_chptr[] = "chptr",
+    str_chidx[] = "chidx",
+    str_blkptr[] = "blkptr",
+    str_memory[] = "memory",
+    str_stack_depth[] = "stack_depth",
+    str_stack_mem[] = "stack_mem",
+    str_frontal_mem[] = "frontal_mem",
+    str_update_factor_mem[] = "update_factor_mem",
+    str_clique_number[] = "clique_number",
+    str_is_factor[] = "is_factor",
+    str_n[] = "n",
+    str_nsn[] = "Nsn";
+  char *kwlist[] = {"X","factored_updates",NULL};
+
+  PyObject *A, *symb, *Py_snpost, *Py_snptr, *Py_relptr, *Py_relidx,
+    *Py_chptr, *Py_chidx, *Py_blkptr, *Py_memory, *PyObj;
+  PyObj = Py_True;
+
+  // extract pointers from arguments
+  if(!PyArg_ParseTupleAndKeywords(args, kwrds, "O|O", kwlist, &A, &PyObj)) return NULL;
+  if (PyObj == Py_True) factored_updates = 1;
+  else factored_updates = 0;
+  if (blkval_get(A, &blk)) return NULL;
+
+  // extract pointers and values from symbolic object
+  symb = PyObject_GetAttrString(A,str_symb);
+  Py_snpost = PyObject_GetAttrString(symb, str_snpost);
+  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
+  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
+  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
+  Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
+  Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
+  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
+  PyObj = PyObject_GetAttrString(symb, str_n);
+  n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  Py_memory = PyObject_GetAttrString(symb, str_memory);
+  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
+  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
+  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
+  update_factor_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_update_factor_mem));
+  PyObj = PyObject_GetAttrString(symb, str_clique_number);
+  update_factor_mem = UPDATE_FACTOR_WS(update_factor_mem, PYINT_AS_LONG(PyObj));
+  Py_DECREF(PyObj);
+  Py_DECREF(Py_memory);
+  Py_DECREF(symb);
+
+  // check that cspmatrix factor flag is True
+  PyObj = PyObject_GetAttrString(A,str_is_factor);
+  if (PyObj == Py_False) {
+    Py_DECREF(PyObj);
+  }
+  else {
+    Py_DECREF(PyObj);
+    dbuffer_release(&blk);
+    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix");
+  }
+
+  // allocate workspace
+  if (!(upd = malloc(stack_mem*sizeof(double)))) {
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+  if (!(fws = malloc(frontal_mem*sizeof(double)))) {
+    free(upd);
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+  if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
+    free(upd);
+    free(fws);
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+  if (factored_updates && !(ws = malloc(update_factor_mem*sizeof(double)))) {
+    free(upd);
+    free(fws);
+    free(upd_size);
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
+
+  // call completion
+  if (!(busy = guard_acquire(A, 1))) {
+    KERNEL_BEGIN
+    blkval_advise(&blk, ADVISE_TOP_DOWN);
+    info = completion(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
+		      MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
+		      MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
+		      MAT_BUFI(Py_blkptr),blk.buf,
+		      fws,upd,upd_size,ws,factored_updates);
+    blkval_advise(&blk, ADVISE_NORMAL);
+    KERNEL_END
+    guard_release(A, 1);
+  }
+
+  // update reference counts
+  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr);
+  Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
+  Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
+  Py_DECREF(Py_blkptr); dbuffer_release(&blk);
+
+  // free workspace
+  free(fws); free(upd); free(upd_size); free(ws);
+  if (busy) return NULL;
+
+  // set cspmatrix factor flag to False
+  PyObject_SetAttrString(A, str_is_factor, Py_True);
+
+  // check for errors
+  if (info) return PyErr_Format(PyExc_ArithmeticError,"completion failed");
+
+  return Py_BuildValue("");
+}
+
+static char doc_chessian[] =
+  "Supernodal multifrontal Hessian mapping.\n"
+  "\n"
+  "The mapping \n"
+  "\n"
+  ".. math:: \n"
+  "     \\mathcal H_X(U) = P(X^{-1}UX^{-1}) \n"
+  "\n"
+  "is the Hessian of the log-det barrier at a positive definite chordal \n"
+  "matrix :math:`X`, applied to a symmetric chordal matrix :math:`U`. The Hessian operator \n"
+  "can be factored as \n"
+  "\n"
+  ".. math:: \n"
+  "     \\mathcal H_X(U) = \\mathcal G_X^{\\mathrm adj}( \\mathcal G_X(U) ) \n"
+  "\n"
+  "where the mappings on the right-hand side are adjoint mappings \n"
+  "that map chordal symmetric matrices to chordal symmetric matrices. \n"
+  "\n"
+  "This routine evaluates the mapping :math:`G_X` and its adjoint \n"
+  ":math:`G_X^{\\mathrm adj}` as well as the corresponding inverse \n"
+  "mappings. The inputs `adj` and `inv` control the action as \n"
+  "follows: \n"
+  "\n"
+  "   +--------------------------------------------------+--------+-------+ \n"
+  "   | Action                                           |`adj`   | `inv` | \n"
+  "   +==================================================+========+=======+ \n"
+  "   | :math:`U = \\mathcal G_X(U)`                      | False  | False | \n"
+  "   +--------------------------------------------------+--------+-------+ \n"
+  "   | :math:`U = \\mathcal G_X^{\\mathrm adj}(U)`        | True   | False | \n"
+  "   +--------------------------------------------------+--------+-------+ \n"
+  "   | :math:`U = \\mathcal G_X^{-1}(U)`                 | False  | True  | \n"
+  "   +--------------------------------------------------+--------+-------+ \n"
+  "   | :math:`U = \\mathcal (G_X^{\\mathrm adj})^{-1}(U)` | True   | True  | \n"
+  "   +--------------------------------------------------+--------+-------+ \n"
+  "\n"
+  "The input argument :math:`L` is the Cholesky factor of \n"
+  ":math:`X`. The input argument :math:`Y` is the projected inverse of \n"
+  ":math:`X`. The input argument :math:`U` is either a chordal matrix (a \n"
+  ":py:class:`cspmatrix`) of a list of chordal matrices with the same \n"
+  "sparsity pattern as :math:`L` and :math:`Y`. \n"
+  "\n"
+  "The optional argument `factored_updates` can be used to enable (if \n"
+  "True) or disable (if False) updating of intermediate \n"
+  "factorizations. \n"
+  "\n"
+  ":param L:                 :py:class:`cspmatrix` (factor) \n"
+  ":param Y:                 :py:class:`cspmatrix` \n"
+  ":param U:                 :py:class:`cspmatrix` or list of :py:class:`cspmatrix` objects \n"
+  ":param adj:               boolean\n"
+  ":param inv:               boolean\n"
+  ":param factored_updates:  boolean \n";
+
+static PyObject* chessian
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  int i, info = 0, factored_updates = 0, adj = 0, inv = 0, busy, ng;
+  int *gwrite=NULL;
+  int_t n, nsn, stack_depth, stack_mem, frontal_mem, update_factor_mem, nu = 0;
+  int_t *upd_size=NULL;
+  double *restrict fws=NULL, *restrict upd=NULL, *restrict ws=NULL;
+  double ** ublkval;
+  PyObject **gobj=NULL, *Py_ublkval;
+  char str_symb[] = "symb",
+    str_snpost[] = "snpost",
+    str_snptr[] = "snptr",
+    str_relptr[] = "relptr",
+    str_relidx[] = "relidx",
+    str_chptr[] = "chptr",
+    str_chidx[] = "chidx",
+    str_blkptr[] = "blkptr",
+    str_blkval[] = "blkval",
+    str_memory[] = "memory",
+    str_stack_depth[] = "stack_depth",
+    str_stack_mem[] = "stack_mem",
+    str_frontal_mem[] = "frontal_mem",
+    str_update_factor_mem[] = "update_factor_mem",
+    str_clique_number[] = "clique_number",
+    str_is_factor[] = "is_factor",
+    str_n[] = "n",
+    str_nsn[] = "Nsn";
+  char *kwlist[] = {"L","Y","U","adj","inv","factored_updates",NULL};
+
+  PyObject *L,*Y,*U,*Adj,*Inv,*symb,*symb_test,*Py_snpost, *Py_snptr, *Py_relptr, *Py_relidx,
+    *Py_chptr, *Py_chidx, *Py_blkptr, *Py_lblkval, *Py_yblkval, *Py_Ui, *Py_memory, *PyObj;
+  PyObj = Py_True;
+
+  // extract pointers from arguments
+  if(!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|OOO", kwlist, &L, &Y, &U, &Adj, &Inv, &PyObj)) return NULL;
+
+  // set optional parameters
+  if (Inv == Py_True) inv = 1;
+  if (Adj == Py_True)
+    adj = 1;
+  else if (Adj == Py_None)
+    adj = inv;
+  if (PyObj == Py_True) factored_updates = 1;
+
+  // extract pointers and values from symbolic object
+  symb = PyObject_GetAttrString(L,str_symb);
+
+  PyObj = PyObject_GetAttrString(symb, str_n);
+  n   = PYINT_AS_LONG(PyObj);
+  Py_DECREF(PyObj);
+
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj);
+  Py_DECREF(PyObj);
+
+  Py_memory = PyObject_GetAttrString(symb, str_memory);
+  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
+  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
+  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
+  update_factor_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_update_factor_mem));
+  PyObj = PyObject_GetAttrString(symb, str_clique_number);
+  update_factor_mem = UPDATE_FACTOR_WS(update_factor_mem, PYINT_AS_LONG(PyObj));
+  Py_DECREF(PyObj);
+  Py_DECREF(Py_memory);
+
+  Py_lblkval = PyObject_GetAttrString(L, str_blkval);
+  Py_yblkval = PyObject_GetAttrString(Y, str_blkval);
+
+  // check Y and L point to same symbolic object
+  symb_test = PyObject_GetAttrString(Y,str_symb);
+  if (symb_test != symb) info += 1;
+  Py_DECREF(symb_test);
+
+  // keep references to the blkval arrays of U while the GIL is released
+  Py_ublkval = PyList_New(0);
+
+  if (PyList_CheckExact(U)) {
+    // build list and check symbolic object
+    nu = PyList_Size(U);
+    ublkval = malloc((nu+1)*sizeof(double *));
+    for (i=0;i<nu;i++) {
+      Py_Ui = PyList_GetItem(U,i);
+      symb_test = PyObject_GetAttrString(Py_Ui,str_symb);
+      if (symb == symb_test) {
+	PyObj = PyObject_GetAttrString(Py_Ui, str_blkval);
+	ublkval[i] = MAT_BUFD(PyObj);
+	PyList_Append(Py_ublkval, PyObj);
+	Py_DECREF(PyObj);
+      }
+      else {
+	info += 1;
+      }
+      Py_DECREF(symb_test);
+    }
+    ublkval[nu] = NULL;
+  }
+  else {
+    // check that U is an cspmatrix with same symbolic object as L
+    symb_test = PyObject_GetAttrString(U,str_symb);
+    if (symb != symb_test) info += 1;
+    Py_DECREF(symb_test);
+
+    ublkval = malloc(2*sizeof(double *));
+    PyObj = PyObject_GetAttrString(U, str_blkval);
+    ublkval[0] = MAT_BUFD(PyObj);
+    PyList_Append(Py_ublkval, PyObj);
+    Py_DECREF(PyObj);
+    ublkval[1] = NULL;
+  }
+
+  // throw exception if all symbolic objects are not the same
+  if (info) {
+    Py_DECREF(symb);
+    if (nu > 0) free(ublkval);
+    Py_DECREF(Py_ublkval);
+    return PyErr_Format(PyExc_ValueError,"symbolic factorizations must be the same");
+  }
+
+  // L: check that cspmatrix factor flag is True
+  PyObj = PyObject_GetAttrString(L,str_is_factor);
+  if (PyObj == Py_False) {
+    Py_DECREF(PyObj);
+    Py_DECREF(symb);
+    if (nu > 0) free(ublkval);
+    Py_DECREF(Py_ublkval);
+    return PyErr_Format(PyExc_ValueError,"L must be a cspmatrix factor");
+  }
+  Py_DECREF(PyObj);
+
+  // Y: check that cspmatrix factor flag is False
+  PyObj = PyObject_GetAttrString(Y,str_is_factor);
+  if (PyObj == Py_True) {
+    Py_DECREF(PyObj);
+    Py_DECREF(symb);
+    if (nu > 0) free(ublkval);
+    Py_DECREF(Py_ublkval);
+    return PyErr_Format(PyExc_ValueError,"Y must be a cspmatrix");
+  }
+  Py_DECREF(PyObj);
+
+  // allocate workspace
+  if (!(upd = malloc(stack_mem*sizeof(double)))) {
+    Py_DECREF(symb);
+    if (nu > 0) free(ublkval);
+    Py_DECREF(Py_ublkval);
+    return PyErr_NoMemory();
+  }
+  if (!(fws = malloc(frontal_mem*sizeof(double)))) {
+    free(upd);
+    Py_DECREF(Py_ublkval);
+    Py_DECREF(symb);
+    if (nu > 0) free(ublkval);
+    return PyErr_NoMemory();
+  }
+  if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
+    free(upd);
+    free(fws);
+    if (nu > 0) free(ublkval);
+    Py_DECREF(symb); Py_DECREF(Py_ublkval);
+    return PyErr_NoMemory();
+  }
+  if (factored_updates && !(ws = malloc(update_factor_mem*sizeof(double)))) {
+    free(upd);
+    free(fws);
+    free(upd_size);
+    if (nu > 0) free(ublkval);
+    Py_DECREF(symb); Py_DECREF(Py_ublkval);
+    return PyErr_NoMemory();
+  }
+
+  // extract arrays from symbolic factorization
+  Py_snpost = PyObject_GetAttrString(symb, str_snpost);
+  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
+  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
+  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
+  Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
+  Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
+  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
+  Py_DECREF(symb);
+
+  // guard L and Y (read) and U (modified)
+  ng = (int) PyList_GET_SIZE(Py_ublkval) + 2;
+  gobj = malloc(ng*sizeof(PyObject *));
+  gwrite = malloc(ng*sizeof(int));
+  if (gobj && gwrite) {
+    gobj[0] = L; gobj[1] = Y; gwrite[0] = gwrite[1] = 0;
+    for (i=2;i<ng;i++) {
+      gobj[i] = PyList_CheckExact(U) ? PyList_GET_ITEM(U,i-2) : U;
+      gwrite[i] = 1;
+    }
+    busy = guard_acquire_all(gobj, gwrite, ng);
+  }
+  else {
+    PyErr_NoMemory();
+    busy = 1;
+  }
+
+  // call hessian
+  if (!busy) {
+    KERNEL_BEGIN
+    info = hessian(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
+		   MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
+		   MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
+		   MAT_BUFI(Py_blkptr),MAT_BUFD(Py_lblkval),
+		   MAT_BUFD(Py_yblkval),ublkval,
+		   fws,upd,upd_size,ws,inv,adj,factored_updates);
+    if (Adj == Py_None) { // apply adjoint operator
+      adj = 1^adj; // toggle flag with XOR
+      info = hessian(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
+		     MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
+		     MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
+		     MAT_BUFI(Py_blkptr),MAT_BUFD(Py_lblkval),
+		     MAT_BUFD(Py_yblkval),ublkval,
+		     fws,upd,upd_size,ws,inv,adj,factored_updates);
+    }
+    KERNEL_END
+    guard_release_all(gobj, gwrite, ng);
+  }
+
+  // update reference counts
+  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr);
+  Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
+  Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
+  Py_DECREF(Py_blkptr);
+  Py_DECREF(Py_lblkval); Py_DECREF(Py_yblkval);
+
+  // free workspace
+  free(fws); free(upd); free(upd_size); free(ws);
+  if (nu > 0) free(ublkval);
+  free(gobj); free(gwrite);
+  Py_DECREF(Py_ublkval);
+  if (busy) return NULL;
+
+  // check for errors
+  if (info) return PyErr_Format(PyExc_ArithmeticError,"hessian failed");
+
+  return Py_BuildValue("");
+}
+
+static char doc_pfchol[] =
+  "/n";
+
+static PyObject* pfchol
+(PyObject *self, PyObject *args)
+{
+
+  int k,n,rc;
+  PyObject *V,*L,*B,*alpha;
+
+  // extract pointers from arguments
+  if (!PyArg_ParseTuple(args, "OOOO", &alpha, &V, &L, &B)) return NULL;
+
+  n = MAT_NROWS(V);
+  k = MAT_NCOLS(V);
+
+  rc = dpftrf(&n,&k,MAT_BUFD(alpha),MAT_BUFD(V),&n,MAT_BUFD(L),&n,MAT_BUFD(B),&n);
+  if (rc == 0)
+    return Py_BuildValue("");
+  else
+    return PyErr_Format(PyExc_ArithmeticError,"factorization failed");
+}
+
+static char doc_pftrsm[] =
+  "/n";
+
+static PyObject* pftrsm
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  char *kwlist[] = {"V","L","B","U","trans",NULL};
+
+  int k,n,i;
+  PyObject *V,*L,*B,*U;
+  char trans='N';
+
+#if PY_MAJOR_VERSION >= 3
+  int trans_ = 'N';
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|C", kwlist, &V, &L, &B, &U, &trans_)) return NULL;
+  trans = (char) trans_;
+#else
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|c", kwlist, &V, &L, &B, &U, &trans)) return NULL;
+#endif
+
+  if (trans != 'N' && trans != 'T') return PyErr_Format(PyExc_ValueError,"trans must be 'N' or 'T'");
+
+  n = MAT_NROWS(V);
+  k = MAT_NCOLS(V);
+
+  for (i=0;i<MAT_NCOLS(U);i++)
+    dpfsv(&n,&k,&trans,MAT_BUFD(V),&n,MAT_BUFD(L),&n,MAT_BUFD(B),&n,MAT_BUFD(U)+i*MAT_NROWS(U));
+
+  return Py_BuildValue("");
+}
+
+static char doc_pftrmm[] =
+  "/n";
+
+static PyObject* pftrmm
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  char *kwlist[] = {"V","L","B","U","trans",NULL};
+
+  int k,n,i;
+  PyObject *V,*L,*B,*U;
+  char trans='N';
+
+#if PY_MAJOR_VERSION >= 3
+  int trans_;
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|C", kwlist, &V, &L, &B, &U, &trans_)) return NULL;
+  trans = (char) trans_;
+#else
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|c", kwlist, &V, &L, &B, &U, &trans)) return NULL;
+#endif
+
+  if (trans != 'N' && trans != 'T') return PyErr_Format(PyExc_ValueError,"trans must be 'N' or 'T'");
+
+  n = MAT_NROWS(V);
+  k = MAT_NCOLS(V);
+
+  for (i=0;i<MAT_NCOLS(U);i++)
+    dpfmv(&n,&k,&trans,MAT_BUFD(V),&n,MAT_BUFD(L),&n,MAT_BUFD(B),&n,MAT_BUFD(U)+i*MAT_NROWS(U));
+
+  return Py_BuildValue("");
+}
+
+
+static char doc_cprofile[] =
+  "profile(enable = True)\n"
+  "\n"
+  "Enables or disables per-supernode instrumentation of the\n"
+  "multifrontal kernels and discards all recorded data. Raises\n"
+  "NotImplementedError if the extension was built without\n"
+  "CHOMPACK_PROFILE.\n";
+
+static PyObject* cprofile
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  int enable = 1;
+  char *kwlist[] = {"enable",NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "|i", kwlist, &enable)) return NULL;
+#ifdef CHOMPACK_PROFILE
+  if (nogil_kernels > 0)
+    return PyErr_Format(PyExc_RuntimeError,"profiling cannot be changed while kernels are running");
+  prof_reset();
+  prof_enabled = enable;
+  return Py_BuildValue("");
+#else
+  return PyErr_Format(PyExc_NotImplementedError,"chompack was built without CHOMPACK_PROFILE");
+#endif
+}
+
+static char doc_cprofile_data[] =
+  "D = profile_data()\n"
+  "\n"
+  "Returns the recorded instrumentation data as a dictionary of\n"
+  "matrices with one entry per (kernel, supernode) record: 'kernel',\n"
+  "'supernode', 'nn', 'na', 'stack_depth', 'stack_bytes' (integer), and\n"
+  "'start' (seconds relative to the first record), 'flops', and the\n"
+  "phase timings 'assembly', 'factor', 'trsm', 'syrk', 'extend_add',\n"
+  "and 'copy' (double).\n";
+
+static PyObject* cprofile_data
+(PyObject *self, PyObject *args)
+{
+#ifdef CHOMPACK_PROFILE
+  const char *phases[PROF_NPHASES] = {"assembly","factor","trsm","syrk","extend_add","copy"};
+  const char *inames[6] = {"kernel","supernode","nn","na","stack_depth","stack_bytes"};
+  const char *dnames[2] = {"start","flops"};
+  const prof_record *rec;
+  matrix *M[6+2+PROF_NPHASES];
+  PyObject *D;
+  int_t len, t;
+  int i, nm = 6+2+PROF_NPHASES;
+  double t0;
+
+  rec = prof_records(&len);
+  t0 = len ? rec[0].start : 0.0;
+  for (i=0;i<nm;i++) {
+    if (!(M[i] = Matrix_New((int) len, 1, (i < 6) ? INT : DOUBLE))) {
+      while (i--) Py_DECREF(M[i]);
+      return PyErr_NoMemory();
+    }
+  }
+  for (t=0;t<len;t++) {
+    MAT_BUFI(M[0])[t] = rec[t].kernel;
+    MAT_BUFI(M[1])[t] = rec[t].sn;
+    MAT_BUFI(M[2])[t] = rec[t].nn;
+    MAT_BUFI(M[3])[t] = rec[t].na;
+    MAT_BUFI(M[4])[t] = rec[t].stack_depth;
+    MAT_BUFI(M[5])[t] = rec[t].stack_words*sizeof(double);
+    MAT_BUFD(M[6])[t] = rec[t].start - t0;
+    MAT_BUFD(M[7])[t] = rec[t].flops;
+    for (i=0;i<PROF_NPHASES;i++) MAT_BUFD(M[8+i])[t] = rec[t].t[i];
+  }
+  if (!(D = PyDict_New())) {
+    for (i=0;i<nm;i++) Py_DECREF(M[i]);
+    return PyErr_NoMemory();
+  }
+  for (i=0;i<nm;i++) {
+    PyDict_SetItemString(D, (i < 6) ? inames[i] : ((i < 8) ? dnames[i-6] : phases[i-8]), (PyObject *) M[i]);
+    Py_DECREF(M[i]);
+  }
+  return D;
+#else
+  return PyErr_Format(PyExc_NotImplementedError,"chompack was built without CHOMPACK_PROFILE");
+#endif
+}
+
+static int merge_callback(const int_t cp, const int_t ck, const int_t np, const int_t nk, void *data)
+{
+  int ret;
+  PyObject *r = PyObject_CallFunction((PyObject *) data, "nnnn", cp, ck, np, nk);
+  if (!r) return -2;
+  ret = PyObject_IsTrue(r);
+  Py_DECREF(r);
+  return (ret < 0) ? -2 : ret;
+}
+
+static int merge_model_from_dict(PyObject *D, merge_model *M)
+{
+  /*
+    Reads a cost model as returned by merge_calibrate() into M; the
+    arrays of M must be freed with free(M->size).
+   */
+  const char *keys[4] = {"size","potrf","trsm","syrk"};
+  double *arr[4];
+  PyObject *obj, *seq = NULL;
+  int i, k;
+
+  if (!PyDict_Check(D)) {
+    PyErr_Format(PyExc_TypeError,"cost model must be a dictionary");
+    return -1;
+  }
+  if (!(obj = PyDict_GetItemString(D, "size")) || (M->nb = (int) PySequence_Size(obj)) < 1) {
+    PyErr_Format(PyExc_ValueError,"cost model must have a nonempty list 'size'");
+    return -1;
+  }
+  if (!(M->size = malloc(4*M->nb*sizeof(double)))) {
+    PyErr_NoMemory();
+    return -1;
+  }
+  for (k=0;k<4;k++) {
+    arr[k] = M->size + k*M->nb;
+    if (!(obj = PyDict_GetItemString(D, keys[k])) || !(seq = PySequence_Fast(obj, "")) ||
+	PySequence_Fast_GET_SIZE(seq) != M->nb) {
+      if (obj && seq) Py_DECREF(seq);
+      free(M->size);
+      PyErr_Clear();
+      PyErr_Format(PyExc_ValueError,"cost model must have a list '%s' of length %i", keys[k], M->nb);
+      return -1;
+    }
+    for (i=0;i<M->nb;i++) arr[k][i] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(seq, i));
+    Py_DECREF(seq);
+  }
+  M->potrf = arr[1]; M->trsm = arr[2]; M->syrk = arr[3];
+  M->overhead = (obj = PyDict_GetItemString(D, "overhead")) ? PyFloat_AsDouble(obj) : 0.0;
+  M->extend_add = (obj = PyDict_GetItemString(D, "extend_add")) ? PyFloat_AsDouble(obj) : 0.0;
+  if (PyErr_Occurred()) {
+    free(M->size);
+    return -1;
+  }
+  for (i=0;i<M->nb;i++) {
+    if (M->size[i] < 1.0 || (i && M->size[i] <= M->size[i-1]) ||
+	!(M->potrf[i] > 0.0) || !(M->trsm[i] > 0.0) || !(M->syrk[i] > 0.0)) {
+      free(M->size);
+      PyErr_Format(PyExc_ValueError,"cost model must have increasing block sizes and positive rates");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static char doc_camalgamate[] =
+  "colcount, snode, snptr, snpar, snpost = \n"
+  "    amalgamate(colcount, snode, snptr, snpar, snpost, merge_function)\n"
+  "\n"
+  "Supernodal amalgamation (see chompack.symbolic.amalgamate). The\n"
+  "merge heuristics returned by chompack.symbolic.merge_size_fill and\n"
+  "chompack.symbolic.merge_auto are evaluated without calling back into\n"
+  "Python (they carry their parameters in the attributes 'size_fill'\n"
+  "and 'cost_model', respectively).\n";
+
+static PyObject* camalgamate
+(PyObject *self, PyObject *args)
+{
+  int ret;
+  int_t nsn, n, N, t[2];
+  PyObject *Py_colcount, *Py_snode, *Py_snptr, *Py_snpar, *Py_snpost, *fun, *attr;
+  matrix *cc, *sn, *ptr, *par, *post, *ptr_, *par_, *post_;
+  merge_model M;
+  merge_fun merge = merge_callback;
+  void *data;
+
+  if (!PyArg_ParseTuple(args, "OOOOOO", &Py_colcount, &Py_snode, &Py_snptr, &Py_snpar, &Py_snpost, &fun))
+    return NULL;
+  if (!Matrix_Check(Py_colcount) || MAT_ID(Py_colcount) != INT || !Matrix_Check(Py_snode) || MAT_ID(Py_snode) != INT ||
+      !Matrix_Check(Py_snptr) || MAT_ID(Py_snptr) != INT || !Matrix_Check(Py_snpar) || MAT_ID(Py_snpar) != INT ||
+      !Matrix_Check(Py_snpost) || MAT_ID(Py_snpost) != INT)
+    return PyErr_Format(PyExc_TypeError,"colcount, snode, snptr, snpar, and snpost must be integer matrices");
+  n = MAT_LGT(Py_snode);
+  nsn = MAT_LGT(Py_snpar);
+  if (MAT_LGT(Py_colcount) != n || MAT_LGT(Py_snptr) != nsn+1 || MAT_LGT(Py_snpost) != nsn)
+    return PyErr_Format(PyExc_ValueError,"incompatible dimensions");
+
+  data = fun;
+  M.size = NULL;
+  if (PyObject_HasAttrString(fun, "size_fill")) {
+    attr = PyObject_GetAttrString(fun, "size_fill");
+    ret = PyArg_ParseTuple(attr, "nn", t, t+1);
+    Py_DECREF(attr);
+    if (!ret) return NULL;
+    merge = merge_size_fill;
+    data = t;
+  }
+  else if (PyObject_HasAttrString(fun, "cost_model")) {
+    attr = PyObject_GetAttrString(fun, "cost_model");
+    ret = merge_model_from_dict(attr, &M);
+    Py_DECREF(attr);
+    if (ret) return NULL;
+    merge = merge_cost;
+    data = &M;
+  }
+
+  cc = Matrix_NewFromMatrix((matrix *) Py_colcount, INT);
+  sn = Matrix_NewFromMatrix((matrix *) Py_snode, INT);
+  ptr = Matrix_NewFromMatrix((matrix *) Py_snptr, INT);
+  par = Matrix_NewFromMatrix((matrix *) Py_snpar, INT);
+  post = Matrix_NewFromMatrix((matrix *) Py_snpost, INT);
+  if (!cc || !sn || !ptr || !par || !post) {
+    ret = -1;
+    PyErr_NoMemory();
+  }
+  else {
+    ret = amalgamate(nsn, MAT_BUFI(cc), MAT_BUFI(sn), MAT_BUFI(ptr), MAT_BUFI(par), MAT_BUFI(post),
+		     merge, data, &N);
+    if (ret == -1) PyErr_NoMemory();
+  }
+  free(M.size);
+  if (ret) {
+    Py_XDECREF(cc); Py_XDECREF(sn); Py_XDECREF(ptr); Py_XDECREF(par); Py_XDECREF(post);
+    return NULL;
+  }
+
+  ptr_ = Matrix_New((int) N+1, 1, INT);
+  par_ = Matrix_New((int) N, 1, INT);
+  post_ = Matrix_New((int) N, 1, INT);
+  if (!ptr_ || !par_ || !post_) {
+    Py_XDECREF(ptr_); Py_XDECREF(par_); Py_XDECREF(post_);
+    Py_DECREF(cc); Py_DECREF(sn); Py_DECREF(ptr); Py_DECREF(par); Py_DECREF(post);
+    return PyErr_NoMemory();
+  }
+  memcpy(MAT_BUFI(ptr_), MAT_BUFI(ptr), (N+1)*sizeof(int_t));
+  memcpy(MAT_BUFI(par_), MAT_BUFI(par), N*sizeof(int_t));
+  memcpy(MAT_BUFI(post_), MAT_BUFI(post), N*sizeof(int_t));
+  Py_DECREF(ptr); Py_DECREF(par); Py_DECREF(post);
+  return Py_BuildValue("NNNNN", cc, sn, ptr_, par_, post_);
+}
+
+static char doc_cmerge_calibrate[] =
+  "model = merge_calibrate(sizes, tmin = 0.01)\n"
+  "\n"
+  "Measures the flop rates of dpotrf, dtrsm, and dsyrk at the given\n"
+  "block sizes, and the per-supernode overhead and the time per\n"
+  "extend-add entry. Each measurement takes at least tmin seconds.\n"
+  "Returns the cost model used by chompack.symbolic.merge_auto as a\n"
+  "dictionary with the keys 'size', 'potrf', 'trsm', 'syrk' (lists),\n"
+  "'overhead', and 'extend_add'.\n";
+
+static PyObject* cmerge_calibrate
+(PyObject *self, PyObject *args, PyObject *kwrds)
+{
+  int i, k;
+  double tmin = 0.01, *arr[4];
+  const char *keys[4] = {"size","potrf","trsm","syrk"};
+  PyObject *sizes, *seq, *D, *L;
+  merge_model M;
+  char *kwlist[] = {"sizes","tmin",NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "O|d", kwlist, &sizes, &tmin)) return NULL;
+  if (!(seq = PySequence_Fast(sizes, "sizes must be a sequence"))) return NULL;
+  if ((M.nb = (int) PySequence_Fast_GET_SIZE(seq)) < 1) {
+    Py_DECREF(seq);
+    return PyErr_Format(PyExc_ValueError,"sizes must be nonempty");
+  }
+  if (!(M.size = malloc(4*M.nb*sizeof(double)))) {
+    Py_DECREF(seq);
+    return PyErr_NoMemory();
+  }
+  for (k=0;k<4;k++) arr[k] = M.size + k*M.nb;
+  M.potrf = arr[1]; M.trsm = arr[2]; M.syrk = arr[3];
+  for (i=0;i<M.nb;i++) {
+    M.size[i] = (double) PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+    if ((i && M.size[i] <= M.size[i-1]) || M.size[i] < 1.0) {
+      Py_DECREF(seq); free(M.size);
+      if (!PyErr_Occurred()) PyErr_Format(PyExc_ValueError,"sizes must be positive and increasing");
+      return NULL;
+    }
+  }
+  Py_DECREF(seq);
+
+  if (merge_calibrate(&M, tmin) || !(D = PyDict_New())) {
+    free(M.size);
+    return PyErr_NoMemory();
+  }
+  for (k=0;k<4;k++) {
+    L = PyList_New(M.nb);
+    for (i=0;i<M.nb;i++) PyList_SET_ITEM(L, i, (k == 0) ? PyLong_FromLong((long) M.size[i]) : PyFloat_FromDouble(arr[k][i]));
+    PyDict_SetItemString(D, keys[k], L);
+    Py_DECREF(L);
+  }
+  PyDict_SetItemString(D, "overhead", L = PyFloat_FromDouble(M.overhead)); Py_DECREF(L);
+  PyDict_SetItemString(D, "extend_add", L = PyFloat_FromDouble(M.extend_add)); Py_DECREF(L);
+  free(M.size);
+  return D;
+}
+
+static char doc_ctrsm[] =
+  "Solves a triangular system of equations with multiple right-hand\n"
+  "sides. Computes\n"
   "\n"
   ".. math::\n"
-  "     P( S^{-1} ) = X\n"
   "\n"
-  "where :math:`S = LL^T`. On exit, the argument `X` contains the\n"
-  "lower-triangular Cholesky factor :math:`L`.\n"
+  "     B &:= \alpha L^{-1} B  \text{ if trans is 'N'}\n"
   "\n"
-  "The optional argument `factored_updates` can be used to enable (if\n"
-  "True) or disable (if False) updating of intermediate\n"
-  "factorizations.\n"
+  "     B &:= \alpha L^{-T} B  \text{ if trans is 'T'}\n"
   "\n"
-  ":param X:                 :py:class:`cspmatrix`\n"
-  ":param factored_updates:  boolean";
+  "where :math:`L` is a :py:class:`cspmatrix` factor.\n"
+  "\n"
+  ":param L:  :py:class:`cspmatrix` factor\n"
+  ":param B:  matrix\n"
+  ":param alpha:  float (default: 1.0)\n"
+  ":param trans:  'N' or 'T' (default: 'N')\n"
+  ":param nrhs:   number of right-hand sides (default: number of columns in :math:`B`)\n"
+  ":param offsetB: integer (default: 0)\n"
+  ":param ldB:   leading dimension of :math:`B` (default: number of rows in :math:`B`)\n";
 
-static PyObject* ccompletion
+static PyObject* ctrsm
 (PyObject *self, PyObject *args, PyObject *kwrds)
 {
-  int info = 0, factored_updates = 0;
   int_t n, nsn, stack_depth, stack_mem, frontal_mem;
   int_t *upd_size=NULL;
+  dbuffer blk, Bb;
+  int busy;
+  int nrhs = -1, ldb = -1, offsetb = 0;
   double * restrict fws=NULL, * restrict upd=NULL;
   char str_symb[] = "symb",
     str_snpost[] = "snpost",
     str_snptr[] = "snptr",
+    str_snode[] = "snode",
     str_relptr[] = "relptr",
     str_relidx[] = "relidx",
     str_chptr[] = "chptr",
     str_chidx[] = "chidx",
     str_blkptr[] = "blkptr",
-    str_blkval[] = "blkval",
     str_memory[] = "memory",
     str_stack_depth[] = "stack_depth",
-    str_stack_mem[] = "stack_mem",
-    str_frontal_mem[] = "frontal_mem",
+    str_stack_mem[] = "stack_solve",
+    str_clique_number[] = "clique_number",
     str_is_factor[] = "is_factor",
     str_n[] = "n",
-    str_nsn[] = "Nsn";
-  char *kwlist[] = {"X","factored_updates",NULL};
+    str_nsn[] = "Nsn",
+    str_p[] = "p";
+  char trans = 'N';
 
-  PyObject *A, *symb, *Py_snpost, *Py_snptr, *Py_relptr, *Py_relidx,
-    *Py_chptr, *Py_chidx, *Py_blkptr, *Py_blkval, *Py_memory, *PyObj;
-  PyObj = Py_True;
+  PyObject *L, *B, *symb, *Py_snpost, *Py_snptr, *Py_snode, *Py_relptr, *Py_relidx, *Py_p,
+    *Py_chptr, *Py_chidx, *Py_blkptr, *PyObj, *Py_memory;
 
-  // extract pointers from arguments
-  if(!PyArg_ParseTupleAndKeywords(args, kwrds, "O|O", kwlist, &A, &PyObj)) return NULL;
-  if (PyObj == Py_True) factored_updates = 1;
-  else factored_updates = 0;
-  Py_blkval = PyObject_GetAttrString(A, str_blkval);
+  double alpha = 1.0;
+  char *kwlist[] = {"L","B","alpha","trans","nrhs","offsetB","ldB",NULL};
+
+#if PY_MAJOR_VERSION >= 3
+  int trans_  = 'N';
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|dCiii", kwlist, &L, &B, &alpha, &trans_, &nrhs, &offsetb, &ldb)) return NULL;
+  trans = (char) trans_;
+#else
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|dciii", kwlist, &L, &B, &alpha, &trans, &nrhs, &offsetb, &ldb)) return NULL;
+#endif
+
+  // check that cspmatrix factor flag is True
+  PyObj = PyObject_GetAttrString(L,str_is_factor);
+  if (PyObj == Py_True) {
+    Py_DECREF(PyObj);
+  }
+  else {
+    Py_DECREF(PyObj);
+    return PyErr_Format(PyExc_ValueError,"L must be a cspmatrix factor");
+  }
+  if (blkval_get(L, &blk)) return NULL;
+  if (dbuffer_get(B, &Bb, 1, 0, "B")) {
+    dbuffer_release(&blk);
+    return NULL;
+  }
+
+  // check optional inputs
+  if (nrhs == -1) nrhs = (int) Bb.ncols; // default value
+  if (ldb == -1) ldb = (int) Bb.ld;      // default value
 
   // extract pointers and values from symbolic object
-  symb = PyObject_GetAttrString(A,str_symb);
+  symb = PyObject_GetAttrString(L,str_symb);
   Py_snpost = PyObject_GetAttrString(symb, str_snpost);
   Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
+  Py_snode  = PyObject_GetAttrString(symb, str_snode);
   Py_relptr = PyObject_GetAttrString(symb, str_relptr);
   Py_relidx = PyObject_GetAttrString(symb, str_relidx);
   Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
@@ -566,407 +2928,424 @@ static PyObject* ccompletion
   n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
   PyObj = PyObject_GetAttrString(symb, str_nsn);
   nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  Py_p  = PyObject_GetAttrString(symb, str_p);
   Py_memory = PyObject_GetAttrString(symb, str_memory);
   stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
-  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
-  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
+  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem))*nrhs;
+  PyObj = PyObject_GetAttrString(symb, str_clique_number);
+  frontal_mem = PYINT_AS_LONG(PyObj)*nrhs;
+  Py_DECREF(PyObj);
   Py_DECREF(Py_memory);
   Py_DECREF(symb);
 
-  // check that cspmatrix factor flag is True
-  PyObj = PyObject_GetAttrString(A,str_is_factor);
-  if (PyObj == Py_False) {
-    Py_DECREF(PyObj);
-  }
-  else {
-    Py_DECREF(PyObj);
-    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix");
-  }
-
   // allocate workspace
-  if (!(upd = malloc(stack_mem*sizeof(double)))) return PyErr_NoMemory();
+  if (!(upd = malloc(stack_mem*sizeof(double)))) {
+    dbuffer_release(&blk); dbuffer_release(&Bb);
+    return PyErr_NoMemory();
+  }
   if (!(fws = malloc(frontal_mem*sizeof(double)))) {
     free(upd);
+    dbuffer_release(&blk); dbuffer_release(&Bb);
     return PyErr_NoMemory();
   }
   if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
     free(upd);
     free(fws);
+    dbuffer_release(&blk); dbuffer_release(&Bb);
     return PyErr_NoMemory();
   }
 
-  // call completion
-  info = completion(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
-		    MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
-		    MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
-		    MAT_BUFI(Py_blkptr),MAT_BUFD(Py_blkval),
-		    fws,upd,upd_size,factored_updates);
+  // call trsm
+  if (!(busy = guard_acquire(L, 0))) {
+    KERNEL_BEGIN
+    blkval_advise(&blk, (trans == 'N') ? ADVISE_BOTTOM_UP : ADVISE_TOP_DOWN);
+    trsm(trans,nrhs,alpha,n,nsn,
+	 MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),MAT_BUFI(Py_snode),
+	 MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
+	 MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
+	 MAT_BUFI(Py_blkptr),MAT_BUFI(Py_p),
+	 blk.buf,Bb.buf+offsetb,&ldb,
+	 fws,upd,upd_size);
+    blkval_advise(&blk, ADVISE_NORMAL);
+    KERNEL_END
+    guard_release(L, 0);
+  }
 
   // update reference counts
-  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr);
+  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr); Py_DECREF(Py_snode);
   Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
   Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
-  Py_DECREF(Py_blkptr); Py_DECREF(Py_blkval);
+  Py_DECREF(Py_blkptr); dbuffer_release(&blk);
+  Py_DECREF(Py_p);
+  dbuffer_release(&Bb);
 
   // free workspace
   free(fws); free(upd); free(upd_size);
-
-  // set cspmatrix factor flag to False
-  PyObject_SetAttrString(A, str_is_factor, Py_True);
-
-  // check for errors
-  if (info) return PyErr_Format(PyExc_ArithmeticError,"completion failed");
+  if (busy) return NULL;
 
   return Py_BuildValue("");
 }
 
-static char doc_chessian[] =
-  "Supernodal multifrontal Hessian mapping.\n"
-  "\n"
-  "The mapping \n"
-  "\n"
-  ".. math:: \n"
-  "     \\mathcal H_X(U) = P(X^{-1}UX^{-1}) \n"
-  "\n"
-  "is the Hessian of the log-det barrier at a positive definite chordal \n"
-  "matrix :math:`X`, applied to a symmetric chordal matrix :math:`U`. The Hessian operator \n"
-  "can be factored as \n"
-  "\n"
-  ".. math:: \n"
-  "     \\mathcal H_X(U) = \\mathcal G_X^{\\mathrm adj}( \\mathcal G_X(U) ) \n"
-  "\n"
-  "where the mappings on the right-hand side are adjoint mappings \n"
-  "that map chordal symmetric matrices to chordal symmetric matrices. \n"
+
+
+static char doc_csolve[] =
+  "Solves a system of equations\n"
   "\n"
-  "This routine evaluates the mapping :math:`G_X` and its adjoint \n"
-  ":math:`G_X^{\\mathrm adj}` as well as the corresponding inverse \n"
-  "mappings. The inputs `adj` and `inv` control the action as \n"
-  "follows: \n"
+  ".. math::\n"
+  "     AX = B\n"
   "\n"
-  "   +--------------------------------------------------+--------+-------+ \n"
-  "   | Action                                           |`adj`   | `inv` | \n"
-  "   +==================================================+========+=======+ \n"
-  "   | :math:`U = \\mathcal G_X(U)`                      | False  | False | \n"
-  "   +--------------------------------------------------+--------+-------+ \n"
-  "   | :math:`U = \\mathcal G_X^{\\mathrm adj}(U)`        | True   | False | \n"
-  "   +--------------------------------------------------+--------+-------+ \n"
-  "   | :math:`U = \\mathcal G_X^{-1}(U)`                 | False  | True  | \n"
-  "   +--------------------------------------------------+--------+-------+ \n"
-  "   | :math:`U = \\mathcal (G_X^{\\mathrm adj})^{-1}(U)` | True   | True  | \n"
-  "   +--------------------------------------------------+--------+-------+ \n"
+  "with the Cholesky factor :math:`L` of :math:`A` (or of a perturbation\n"
+  "of :math:`A`, e.g., computed with dynamic regularization), followed by\n"
+  "at most `refine` steps of iterative refinement\n"
   "\n"
-  "The input argument :math:`L` is the Cholesky factor of \n"
-  ":math:`X`. The input argument :math:`Y` is the projected inverse of \n"
-  ":math:`X`. The input argument :math:`U` is either a chordal matrix (a \n"
-  ":py:class:`cspmatrix`) of a list of chordal matrices with the same \n"
-  "sparsity pattern as :math:`L` and :math:`Y`. \n"
+  ".. math::\n"
+  "     R := B - AX, \\quad X := X + L^{-T}L^{-1}R\n"
   "\n"
-  "The optional argument `factored_updates` can be used to enable (if \n"
-  "True) or disable (if False) updating of intermediate \n"
-  "factorizations. \n"
+  "where the residual is computed with the :py:class:`cspmatrix` :math:`A`.\n"
+  "Refinement stops when :math:`\\|r_j\\|_2 \\leq \\mathrm{tol}\\,\\|b_j\\|_2`\n"
+  "for all columns, or when a step fails to halve the largest relative\n"
+  "residual; a step that does not reduce it is undone. On exit,\n"
+  ":math:`B` is overwritten by :math:`X`. Returns a 'd' matrix with the\n"
+  "residual norms :math:`\\|b_j - Ax_j\\|_2`.\n"
   "\n"
-  ":param L:                 :py:class:`cspmatrix` (factor) \n"
-  ":param Y:                 :py:class:`cspmatrix` \n"
-  ":param U:                 :py:class:`cspmatrix` or list of :py:class:`cspmatrix` objects \n"
-  ":param adj:               boolean\n"
-  ":param inv:               boolean\n"
-  ":param factored_updates:  boolean \n";
+  ":param A:       :py:class:`cspmatrix`\n"
+  ":param L:       :py:class:`cspmatrix` factor with the same symbolic factorization\n"
+  ":param B:       'd' matrix with n rows\n"
+  ":param refine:  maximum number of refinement steps (default: 0)\n"
+  ":param tol:     relative residual tolerance (default: 0.0)\n";
 
-static PyObject* chessian
+static PyObject* csolve
 (PyObject *self, PyObject *args, PyObject *kwrds)
 {
-  int i, info = 0, factored_updates = 0, adj = 0, inv = 0;
-  int_t n, nsn, stack_depth, stack_mem, frontal_mem, nu = 0;
+  int_t n, nsn, stack_depth, stack_solve, clique_number;
   int_t *upd_size=NULL;
-  double *restrict fws=NULL, *restrict upd=NULL;
-  double ** ublkval;
-  char str_symb[] = "symb",
-    str_snpost[] = "snpost",
-    str_snptr[] = "snptr",
-    str_relptr[] = "relptr",
-    str_relidx[] = "relidx",
-    str_chptr[] = "chptr",
-    str_chidx[] = "chidx",
-    str_blkptr[] = "blkptr",
-    str_blkval[] = "blkval",
-    str_memory[] = "memory",
-    str_stack_depth[] = "stack_depth",
-    str_stack_mem[] = "stack_mem",
-    str_frontal_mem[] = "frontal_mem",
-    str_is_factor[] = "is_factor",
-    str_n[] = "n",
-    str_nsn[] = "Nsn";
-  char *kwlist[] = {"L","Y","U","adj","inv","factored_updates",NULL};
-
-  PyObject *L,*Y,*U,*Adj,*Inv,*symb,*symb_test,*Py_snpost, *Py_snptr, *Py_relptr, *Py_relidx,
-    *Py_chptr, *Py_chidx, *Py_blkptr, *Py_lblkval, *Py_yblkval, *Py_Ui, *Py_memory, *PyObj;
-  PyObj = Py_True;
-
-  // extract pointers from arguments
-  if(!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|OOO", kwlist, &L, &Y, &U, &Adj, &Inv, &PyObj)) return NULL;
-
-  // set optional parameters
-  if (Inv == Py_True) inv = 1;
-  if (Adj == Py_True)
-    adj = 1;
-  else if (Adj == Py_None)
-    adj = inv;
-  if (PyObj == Py_True) factored_updates = 1;
-
-  // extract pointers and values from symbolic object
-  symb = PyObject_GetAttrString(L,str_symb);
-
-  PyObj = PyObject_GetAttrString(symb, str_n);
-  n   = PYINT_AS_LONG(PyObj);
-  Py_DECREF(PyObj);
-
-  PyObj = PyObject_GetAttrString(symb, str_nsn);
-  nsn = PYINT_AS_LONG(PyObj);
-  Py_DECREF(PyObj);
-
-  Py_memory = PyObject_GetAttrString(symb, str_memory);
-  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
-  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
-  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
-  Py_DECREF(Py_memory);
-
-  Py_lblkval = PyObject_GetAttrString(L, str_blkval);
-  Py_yblkval = PyObject_GetAttrString(Y, str_blkval);
-
-  // check Y and L point to same symbolic object
-  symb_test = PyObject_GetAttrString(Y,str_symb);
-  if (symb_test != symb) info += 1;
-  Py_DECREF(symb_test);
-
-  if (PyList_CheckExact(U)) {
-    // build list and check symbolic object
-    nu = PyList_Size(U);
-    ublkval = malloc((nu+1)*sizeof(double *));
-    for (i=0;i<nu;i++) {
-      Py_Ui = PyList_GetItem(U,i);
-      symb_test = PyObject_GetAttrString(Py_Ui,str_symb);
-      if (symb == symb_test) {
-	PyObj = PyObject_GetAttrString(Py_Ui, str_blkval);
-	ublkval[i] = MAT_BUFD(PyObj);
-	Py_DECREF(PyObj);
-      }
-      else {
-	info += 1;
-      }
-      Py_DECREF(symb_test);
-    }
-    ublkval[nu] = NULL;
-  }
-  else {
-    // check that U is an cspmatrix with same symbolic object as L
-    symb_test = PyObject_GetAttrString(U,str_symb);
-    if (symb != symb_test) info += 1;
-    Py_DECREF(symb_test);
-
-    ublkval = malloc(2*sizeof(double *));
-    PyObj = PyObject_GetAttrString(U, str_blkval);
-    ublkval[0] = MAT_BUFD(PyObj);
+  int nrhs, ldb, refine = 0, busy, gwrite[2] = {0, 0};
+  double tol = 0.0, *work=NULL;
+  dbuffer Aval, Lval, Bb;
+  PyObject *A, *L, *B, *symb, *PyObj, *Py_memory, *resnrm,
+    *Py_snpost, *Py_snptr, *Py_snode, *Py_relptr, *Py_relidx, *Py_chptr, *Py_chidx,
+    *Py_blkptr, *Py_sncolptr, *Py_snrowidx, *Py_p;
+  PyObject *gobj[2];
+  char *kwlist[] = {"A","L","B","refine","tol",NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|id", kwlist, &A, &L, &B, &refine, &tol)) return NULL;
+
+  // check factor flags and symbolic factorizations
+  PyObj = PyObject_GetAttrString(A,"is_factor");
+  if (PyObj == Py_False) {
     Py_DECREF(PyObj);
-    ublkval[1] = NULL;
   }
-
-  // throw exception if all symbolic objects are not the same
-  if (info) {
-    Py_DECREF(symb);
-    if (nu > 0) free(ublkval);
-    return PyErr_Format(PyExc_ValueError,"symbolic factorizations must be the same");
+  else {
+    Py_XDECREF(PyObj);
+    return PyErr_Format(PyExc_ValueError,"A must be a cspmatrix (not a factor)");
   }
-
-  // L: check that cspmatrix factor flag is True
-  PyObj = PyObject_GetAttrString(L,str_is_factor);
-  if (PyObj == Py_False) {
+  PyObj = PyObject_GetAttrString(L,"is_factor");
+  if (PyObj == Py_True) {
     Py_DECREF(PyObj);
-    Py_DECREF(symb);
-    if (nu > 0) free(ublkval);
+  }
+  else {
+    Py_XDECREF(PyObj);
     return PyErr_Format(PyExc_ValueError,"L must be a cspmatrix factor");
   }
+  symb = PyObject_GetAttrString(L,"symb");
+  PyObj = PyObject_GetAttrString(A,"symb");
   Py_DECREF(PyObj);
+  if (PyObj != symb) {
+    Py_DECREF(symb);
+    return PyErr_Format(PyExc_ValueError,"Symbolic factorization mismatch");
+  }
 
-  // Y: check that cspmatrix factor flag is False
-  PyObj = PyObject_GetAttrString(Y,str_is_factor);
-  if (PyObj == Py_True) {
-    Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, "n");
+  n = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  if (dbuffer_get(B, &Bb, 1, 0, "B")) {
     Py_DECREF(symb);
-    if (nu > 0) free(ublkval);
-    return PyErr_Format(PyExc_ValueError,"Y must be a cspmatrix");
+    return NULL;
   }
-  Py_DECREF(PyObj);
+  if (Bb.nrows != n) {
+    Py_DECREF(symb); dbuffer_release(&Bb);
+    return PyErr_Format(PyExc_TypeError,"B must be a 'd' matrix with n rows");
+  }
+  nrhs = (int) Bb.ncols;
+  ldb = (int) Bb.ld;
+  if (blkval_get(A, &Aval)) {
+    Py_DECREF(symb); dbuffer_release(&Bb);
+    return NULL;
+  }
+  if (blkval_get(L, &Lval)) {
+    Py_DECREF(symb); dbuffer_release(&Bb); dbuffer_release(&Aval);
+    return NULL;
+  }
+  if (!(resnrm = (PyObject *) Matrix_New(nrhs, 1, DOUBLE))) {
+    Py_DECREF(symb); dbuffer_release(&Bb); dbuffer_release(&Aval); dbuffer_release(&Lval);
+    return PyErr_NoMemory();
+  }
+
+  PyObj = PyObject_GetAttrString(symb, "Nsn");
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  PyObj = PyObject_GetAttrString(symb, "clique_number");
+  clique_number = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  Py_memory = PyObject_GetAttrString(symb, "memory");
+  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, "stack_depth"));
+  stack_solve = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, "stack_solve"));
+  Py_DECREF(Py_memory);
 
   // allocate workspace
-  if (!(upd = malloc(stack_mem*sizeof(double)))) return PyErr_NoMemory();
-  if (!(fws = malloc(frontal_mem*sizeof(double)))) {
-    free(upd);
-    Py_DECREF(symb);
-    if (nu > 0) free(ublkval);
+  if (!(work = malloc(((3*n + 2*clique_number + stack_solve + 1)*nrhs + 1)*sizeof(double)))) {
+    Py_DECREF(symb); Py_DECREF(resnrm);
+    dbuffer_release(&Bb); dbuffer_release(&Aval); dbuffer_release(&Lval);
     return PyErr_NoMemory();
   }
-  if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
-    free(upd);
-    free(fws);
-    if (nu > 0) free(ublkval);
-    Py_DECREF(symb);
+  if (!(upd_size = malloc((stack_depth+1)*sizeof(int_t)))) {
+    free(work);
+    Py_DECREF(symb); Py_DECREF(resnrm);
+    dbuffer_release(&Bb); dbuffer_release(&Aval); dbuffer_release(&Lval);
     return PyErr_NoMemory();
   }
 
-  // extract arrays from symbolic factorization
-  Py_snpost = PyObject_GetAttrString(symb, str_snpost);
-  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
-  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
-  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
-  Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
-  Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
-  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
+  Py_snpost = PyObject_GetAttrString(symb, "snpost");
+  Py_snptr  = PyObject_GetAttrString(symb, "snptr");
+  Py_snode  = PyObject_GetAttrString(symb, "snode");
+  Py_relptr = PyObject_GetAttrString(symb, "relptr");
+  Py_relidx = PyObject_GetAttrString(symb, "relidx");
+  Py_chptr  = PyObject_GetAttrString(symb, "chptr");
+  Py_chidx  = PyObject_GetAttrString(symb, "chidx");
+  Py_blkptr = PyObject_GetAttrString(symb, "blkptr");
+  Py_sncolptr = PyObject_GetAttrString(symb, "sncolptr");
+  Py_snrowidx = PyObject_GetAttrString(symb, "snrowidx");
+  Py_p  = PyObject_GetAttrString(symb, "p");
   Py_DECREF(symb);
 
-  // call hessian
-  info = hessian(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
-		 MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
-		 MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
-		 MAT_BUFI(Py_blkptr),MAT_BUFD(Py_lblkval),
-		 MAT_BUFD(Py_yblkval),ublkval,
-		 fws,upd,upd_size,inv,adj,factored_updates);
-  if (Adj == Py_None) { // apply adjoint operator
-    adj = 1^adj; // toggle flag with XOR
-    info = hessian(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),
-		   MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
-		   MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
-		   MAT_BUFI(Py_blkptr),MAT_BUFD(Py_lblkval),
-		   MAT_BUFD(Py_yblkval),ublkval,
-		   fws,upd,upd_size,inv,adj,factored_updates);
+  gobj[0] = A; gobj[1] = L;
+  if (!(busy = guard_acquire_all(gobj, gwrite, 2))) {
+    KERNEL_BEGIN
+    solve(n,nsn,
+	  MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),MAT_BUFI(Py_snode),
+	  MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
+	  MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
+	  MAT_BUFI(Py_blkptr),MAT_BUFI(Py_sncolptr),MAT_BUFI(Py_snrowidx),MAT_BUFI(Py_p),
+	  clique_number,stack_solve,
+	  Aval.buf,Lval.buf,
+	  nrhs,Bb.buf,&ldb,refine,tol,MAT_BUFD(resnrm),work,upd_size);
+    KERNEL_END
+    guard_release_all(gobj, gwrite, 2);
   }
 
   // update reference counts
-  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr);
+  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr); Py_DECREF(Py_snode);
   Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
   Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
-  Py_DECREF(Py_blkptr);
+  Py_DECREF(Py_blkptr); Py_DECREF(Py_sncolptr); Py_DECREF(Py_snrowidx);
+  Py_DECREF(Py_p);
+  dbuffer_release(&Aval); dbuffer_release(&Lval); dbuffer_release(&Bb);
 
   // free workspace
-  free(fws); free(upd); free(upd_size);
-  if (nu > 0) free(ublkval);
-
-  // check for errors
-  if (info) return PyErr_Format(PyExc_ArithmeticError,"hessian failed");
+  free(work); free(upd_size);
+  if (busy) {
+    Py_DECREF(resnrm);
+    return NULL;
+  }
 
-  return Py_BuildValue("");
+  return resnrm;
 }
 
-static char doc_pfchol[] =
-  "/n";
-
-static PyObject* pfchol
-(PyObject *self, PyObject *args)
-{
-
-  int k,n,rc;
-  PyObject *V,*L,*B,*alpha;
-
-  // extract pointers from arguments
-  if (!PyArg_ParseTuple(args, "OOOO", &alpha, &V, &L, &B)) return NULL;
-
-  n = MAT_NROWS(V);
-  k = MAT_NCOLS(V);
 
-  rc = dpftrf(&n,&k,MAT_BUFD(alpha),MAT_BUFD(V),&n,MAT_BUFD(L),&n,MAT_BUFD(B),&n);
-  if (rc == 0)
-    return Py_BuildValue("");
-  else
-    return PyErr_Format(PyExc_ArithmeticError,"factorization failed");
-}
 
-static char doc_pftrsm[] =
-  "/n";
+static char doc_cldl[] =
+  "Supernodal multifrontal LDL factorization of a symmetric matrix:\n"
+  "\n"
+  ".. math::\n"
+  "     X = WDW^T\n"
+  "\n"
+  "where :math:`W` is unit lower-triangular and :math:`D` is block\n"
+  "diagonal with one block per supernode, :math:`D_k = P_k L_k T_k\n"
+  "L_k^T P_k^T`. The diagonal blocks are factored with Bunch-Kaufman\n"
+  "pivoting within the supernode, so the ordering and sparsity pattern\n"
+  "of :math:`W` are those of the Cholesky factor.\n"
+  "\n"
+  "If `signs` is given, the diagonal blocks are instead factored\n"
+  "without pivoting (:math:`P_k = I`, :math:`T_k` diagonal), and a\n"
+  "pivot :math:`d_i` with :math:`s_i d_i < \\delta` is replaced by\n"
+  ":math:`s_i\\delta` (static regularization of quasidefinite matrices).\n"
+  "\n"
+  "An :py:exc:`ArithmeticError` is raised if a pivot is zero and the\n"
+  "factorization cannot be completed. Without `signs`, a zero pivot in\n"
+  "a root supernode is not an error and is counted in the inertia; with\n"
+  "`signs` and :math:`\\delta = 0`, every zero pivot is an error.\n"
+  "\n"
+  "On exit, the argument :math:`X` contains the factorization, and\n"
+  "`ipiv` the pivots of the diagonal blocks. Returns the inertia\n"
+  "(number of positive, negative, and zero eigenvalues) of :math:`D`\n"
+  "and the number of regularized pivots.\n"
+  "\n"
+  ":param X:      :py:class:`cspmatrix`\n"
+  ":param ipiv:   'i' matrix of length n\n"
+  ":param signs:  'i' matrix of length n with the expected signs (+1 or -1) of the pivots (optional)\n"
+  ":param delta:  float (default: 0.0)";
 
-static PyObject* pftrsm
+static PyObject* cldl
 (PyObject *self, PyObject *args, PyObject *kwrds)
 {
-  char *kwlist[] = {"V","L","B","U","trans",NULL};
-
-  int k,n,i;
-  PyObject *V,*L,*B,*U;
-  char trans='N';
-
-#if PY_MAJOR_VERSION >= 3
-  int trans_ = 'N';
-  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|C", kwlist, &V, &L, &B, &U, &trans_)) return NULL;
-  trans = (char) trans_;
-#else
-  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|c", kwlist, &V, &L, &B, &U, &trans)) return NULL;
-#endif
+  dbuffer blk;
+  int info = 0, lwork;
+  int busy;
+  int_t n, nsn, stack_depth, stack_mem, frontal_mem, nreg, inertia[3];
+  int_t *upd_size=NULL;
+  int *iws=NULL;
+  double * restrict fws=NULL, * restrict upd=NULL, * restrict work=NULL;
+  double delta = 0.0;
+  char str_symb[] = "symb",
+    str_snpost[] = "snpost",
+    str_snptr[] = "snptr",
+    str_snode[] = "snode",
+    str_relptr[] = "relptr",
+    str_relidx[] = "relidx",
+    str_chptr[] = "chptr",
+    str_chidx[] = "chidx",
+    str_blkptr[] = "blkptr",
+    str_memory[] = "memory",
+    str_stack_depth[] = "stack_depth",
+    str_stack_mem[] = "stack_mem",
+    str_frontal_mem[] = "frontal_mem",
+    str_is_factor[] = "is_factor",
+    str_n[] = "n",
+    str_nsn[] = "Nsn",
+    str_p[] = "p";
 
-  if (trans != 'N' && trans != 'T') return PyErr_Format(PyExc_ValueError,"trans must be 'N' or 'T'");
+  PyObject *A, *ipiv, *signs = Py_None, *symb, *Py_snpost, *Py_snptr, *Py_snode, *Py_relptr, *Py_relidx,
+    *Py_chptr, *Py_chidx, *Py_blkptr, *Py_p, *PyObj, *Py_memory;
 
-  n = MAT_NROWS(V);
-  k = MAT_NCOLS(V);
+  char *kwlist[] = {"X","ipiv","signs","delta",NULL};
 
-  for (i=0;i<MAT_NCOLS(U);i++)
-    dpfsv(&n,&k,&trans,MAT_BUFD(V),&n,MAT_BUFD(L),&n,MAT_BUFD(B),&n,MAT_BUFD(U)+i*MAT_NROWS(U));
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|Od", kwlist, &A, &ipiv, &signs, &delta)) return NULL;
 
-  return Py_BuildValue("");
-}
+  // check that cspmatrix factor flag is False
+  PyObj = PyObject_GetAttrString(A,str_is_factor);
+  if (PyObj == Py_False) {
+    Py_DECREF(PyObj);
+  }
+  else {
+    Py_DECREF(PyObj);
+    return PyErr_Format(PyExc_ValueError,"X must be a cspmatrix");
+  }
+  if (blkval_get(A, &blk)) return NULL;
 
-static char doc_pftrmm[] =
-  "/n";
+  // extract pointers and values from symbolic object
+  symb = PyObject_GetAttrString(A,str_symb);
+  PyObj = PyObject_GetAttrString(symb, str_n);
+  n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  if (!Matrix_Check(ipiv) || MAT_ID(ipiv) != INT || MAT_LGT(ipiv) != n) {
+    Py_DECREF(symb);
+    dbuffer_release(&blk);
+    return PyErr_Format(PyExc_TypeError,"ipiv must be an 'i' matrix of length n");
+  }
+  if (signs != Py_None && (!Matrix_Check(signs) || MAT_ID(signs) != INT || MAT_LGT(signs) != n)) {
+    Py_DECREF(symb);
+    dbuffer_release(&blk);
+    return PyErr_Format(PyExc_TypeError,"signs must be an 'i' matrix of length n");
+  }
+  Py_snpost = PyObject_GetAttrString(symb, str_snpost);
+  Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
+  Py_snode  = PyObject_GetAttrString(symb, str_snode);
+  Py_relptr = PyObject_GetAttrString(symb, str_relptr);
+  Py_relidx = PyObject_GetAttrString(symb, str_relidx);
+  Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
+  Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
+  Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
+  Py_p      = PyObject_GetAttrString(symb, str_p);
+  PyObj = PyObject_GetAttrString(symb, str_nsn);
+  nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  Py_memory = PyObject_GetAttrString(symb, str_memory);
+  stack_depth = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_depth));
+  stack_mem   = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_stack_mem));
+  frontal_mem = PYINT_AS_LONG(PyDict_GetItemString(Py_memory, str_frontal_mem));
+  Py_DECREF(Py_memory);
+  Py_DECREF(symb);
 
-static PyObject* pftrmm
-(PyObject *self, PyObject *args, PyObject *kwrds)
-{
-  char *kwlist[] = {"V","L","B","U","trans",NULL};
+  // allocate workspace (frontal_mem >= nn*na for all supernodes is
+  // also enough for dsytrf)
+  lwork = (frontal_mem > 0) ? (int) frontal_mem : 1;
+  upd = malloc(stack_mem*sizeof(double));
+  fws = malloc(frontal_mem*sizeof(double));
+  work = malloc(lwork*sizeof(double));
+  upd_size = malloc(stack_depth*sizeof(int_t));
+  iws = malloc(n*sizeof(int));
+  if (!upd || !fws || !work || !upd_size || !iws) {
+    free(upd); free(fws); free(work); free(upd_size); free(iws);
+    Py_DECREF(Py_snpost); Py_DECREF(Py_snptr); Py_DECREF(Py_snode);
+    Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
+    Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
+    Py_DECREF(Py_blkptr); Py_DECREF(Py_p);
+    dbuffer_release(&blk);
+    return PyErr_NoMemory();
+  }
 
-  int k,n,i;
-  PyObject *V,*L,*B,*U;
-  char trans='N';
+  // call numerical LDL factorization
+  if (!(busy = guard_acquire(A, 1))) {
+    KERNEL_BEGIN
+    blkval_advise(&blk, ADVISE_BOTTOM_UP);
+    info = ldl(n,nsn,MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),MAT_BUFI(Py_snode),
+	       MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
+	       MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
+	       MAT_BUFI(Py_blkptr),MAT_BUFI(Py_p),blk.buf,
+	       MAT_BUFI(ipiv),(signs == Py_None) ? NULL : MAT_BUFI(signs),delta,
+	       inertia,&nreg,fws,upd,upd_size,work,lwork,iws);
+    blkval_advise(&blk, ADVISE_NORMAL);
+    KERNEL_END
+    guard_release(A, 1);
+  }
 
-#if PY_MAJOR_VERSION >= 3
-  int trans_;
-  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|C", kwlist, &V, &L, &B, &U, &trans_)) return NULL;
-  trans = (char) trans_;
-#else
-  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOOO|c", kwlist, &V, &L, &B, &U, &trans)) return NULL;
-#endif
+  // update reference counts
+  Py_DECREF(Py_snpost); Py_DECREF(Py_snptr); Py_DECREF(Py_snode);
+  Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
+  Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
+  Py_DECREF(Py_blkptr); dbuffer_release(&blk);
+  Py_DECREF(Py_p);
 
-  if (trans != 'N' && trans != 'T') return PyErr_Format(PyExc_ValueError,"trans must be 'N' or 'T'");
+  // free workspace
+  free(fws); free(upd); free(upd_size); free(work); free(iws);
+  if (busy) return NULL;
 
-  n = MAT_NROWS(V);
-  k = MAT_NCOLS(V);
+  // set cspmatrix factor flag to True
+  PyObject_SetAttrString(A, str_is_factor, Py_True);
 
-  for (i=0;i<MAT_NCOLS(U);i++)
-    dpfmv(&n,&k,&trans,MAT_BUFD(V),&n,MAT_BUFD(L),&n,MAT_BUFD(B),&n,MAT_BUFD(U)+i*MAT_NROWS(U));
+  // check for errors
+  if (info) return PyErr_Format(PyExc_ArithmeticError,"factorization failed");
 
-  return Py_BuildValue("");
+  return Py_BuildValue("(nnn)n", inertia[0], inertia[1], inertia[2], nreg);
 }
 
-
-static char doc_ctrsm[] =
-  "Solves a triangular system of equations with multiple right-hand\n"
-  "sides. Computes\n"
+static char doc_cldltrsm[] =
+  "Solves a system of equations with the factors of an LDL\n"
+  "factorization :math:`X = WDW^T` computed by :py:func:`ldl`.\n"
+  "Computes\n"
   "\n"
   ".. math::\n"
   "\n"
-  "     B &:= \alpha L^{-1} B  \text{ if trans is 'N'}\n"
+  "     B &:= W^{-1} B  \\text{ if trans is 'N'}\n"
   "\n"
-  "     B &:= \alpha L^{-T} B  \text{ if trans is 'T'}\n"
+  "     B &:= D^{-1} B  \\text{ if trans is 'D'}\n"
   "\n"
-  "where :math:`L` is a :py:class:`cspmatrix` factor.\n"
+  "     B &:= W^{-T} B  \\text{ if trans is 'T'}\n"
   "\n"
-  ":param L:  :py:class:`cspmatrix` factor\n"
+  "so that :math:`X^{-1}B` is computed by three calls with trans\n"
+  "equal to 'N', 'D', and 'T'.\n"
+  "\n"
+  ":param L:  :py:class:`cspmatrix` factor computed by :py:func:`ldl`\n"
+  ":param ipiv:  pivots returned by :py:func:`ldl`\n"
   ":param B:  matrix\n"
-  ":param alpha:  float (default: 1.0)\n"
-  ":param trans:  'N' or 'T' (default: 'N')\n"
+  ":param trans:  'N', 'D', or 'T' (default: 'N')\n"
   ":param nrhs:   number of right-hand sides (default: number of columns in :math:`B`)\n"
   ":param offsetB: integer (default: 0)\n"
   ":param ldB:   leading dimension of :math:`B` (default: number of rows in :math:`B`)\n";
 
-static PyObject* ctrsm
+static PyObject* cldltrsm
 (PyObject *self, PyObject *args, PyObject *kwrds)
 {
+  dbuffer blk, Bb;
+  int busy;
   int_t n, nsn, stack_depth, stack_mem, frontal_mem;
   int_t *upd_size=NULL;
+  int *iws=NULL;
   int nrhs = -1, ldb = -1, offsetb = 0;
   double * restrict fws=NULL, * restrict upd=NULL;
   char str_symb[] = "symb",
@@ -978,7 +3357,6 @@ static PyObject* ctrsm
     str_chptr[] = "chptr",
     str_chidx[] = "chidx",
     str_blkptr[] = "blkptr",
-    str_blkval[] = "blkval",
     str_memory[] = "memory",
     str_stack_depth[] = "stack_depth",
     str_stack_mem[] = "stack_solve",
@@ -989,19 +3367,20 @@ static PyObject* ctrsm
     str_p[] = "p";
   char trans = 'N';
 
-  PyObject *L, *B, *symb, *Py_snpost, *Py_snptr, *Py_snode, *Py_relptr, *Py_relidx, *Py_p,
-    *Py_chptr, *Py_chidx, *Py_blkptr, *Py_blkval, *PyObj, *Py_memory;
+  PyObject *L, *ipiv, *B, *symb, *Py_snpost, *Py_snptr, *Py_snode, *Py_relptr, *Py_relidx, *Py_p,
+    *Py_chptr, *Py_chidx, *Py_blkptr, *PyObj, *Py_memory;
 
-  double alpha = 1.0;
-  char *kwlist[] = {"L","B","alpha","trans","nrhs","offsetB","ldB",NULL};
+  char *kwlist[] = {"L","ipiv","B","trans","nrhs","offsetB","ldB",NULL};
 
 #if PY_MAJOR_VERSION >= 3
   int trans_  = 'N';
-  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|dCiii", kwlist, &L, &B, &alpha, &trans_, &nrhs, &offsetb, &ldb)) return NULL;
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|Ciii", kwlist, &L, &ipiv, &B, &trans_, &nrhs, &offsetb, &ldb)) return NULL;
   trans = (char) trans_;
 #else
-  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OO|dciii", kwlist, &L, &B, &alpha, &trans, &nrhs, &offsetb, &ldb)) return NULL;
+  if (!PyArg_ParseTupleAndKeywords(args, kwrds, "OOO|ciii", kwlist, &L, &ipiv, &B, &trans, &nrhs, &offsetb, &ldb)) return NULL;
 #endif
+  if (trans != 'N' && trans != 'D' && trans != 'T')
+    return PyErr_Format(PyExc_ValueError,"trans must be 'N', 'D', or 'T'");
 
   // check that cspmatrix factor flag is True
   PyObj = PyObject_GetAttrString(L,str_is_factor);
@@ -1012,13 +3391,25 @@ static PyObject* ctrsm
     Py_DECREF(PyObj);
     return PyErr_Format(PyExc_ValueError,"L must be a cspmatrix factor");
   }
+  if (blkval_get(L, &blk)) return NULL;
+  if (dbuffer_get(B, &Bb, 1, 0, "B")) {
+    dbuffer_release(&blk);
+    return NULL;
+  }
 
   // check optional inputs
-  if (nrhs == -1) nrhs = MAT_NCOLS(B); // default value
-  if (ldb == -1) ldb = MAT_NROWS(B);   // default value
+  if (nrhs == -1) nrhs = (int) Bb.ncols; // default value
+  if (ldb == -1) ldb = (int) Bb.ld;      // default value
 
   // extract pointers and values from symbolic object
   symb = PyObject_GetAttrString(L,str_symb);
+  PyObj = PyObject_GetAttrString(symb, str_n);
+  n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
+  if (!Matrix_Check(ipiv) || MAT_ID(ipiv) != INT || MAT_LGT(ipiv) != n) {
+    Py_DECREF(symb);
+    dbuffer_release(&blk); dbuffer_release(&Bb);
+    return PyErr_Format(PyExc_TypeError,"ipiv must be an 'i' matrix of length n");
+  }
   Py_snpost = PyObject_GetAttrString(symb, str_snpost);
   Py_snptr  = PyObject_GetAttrString(symb, str_snptr);
   Py_snode  = PyObject_GetAttrString(symb, str_snode);
@@ -1027,8 +3418,6 @@ static PyObject* ctrsm
   Py_chptr  = PyObject_GetAttrString(symb, str_chptr);
   Py_chidx  = PyObject_GetAttrString(symb, str_chidx);
   Py_blkptr = PyObject_GetAttrString(symb, str_blkptr);
-  PyObj = PyObject_GetAttrString(symb, str_n);
-  n   = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
   PyObj = PyObject_GetAttrString(symb, str_nsn);
   nsn = PYINT_AS_LONG(PyObj); Py_DECREF(PyObj);
   Py_p  = PyObject_GetAttrString(symb, str_p);
@@ -1042,42 +3431,51 @@ static PyObject* ctrsm
   Py_DECREF(symb);
 
   // allocate workspace
-  if (!(upd = malloc(stack_mem*sizeof(double)))) return PyErr_NoMemory();
-  if (!(fws = malloc(frontal_mem*sizeof(double)))) {
-    free(upd);
-    return PyErr_NoMemory();
-  }
-  if (!(upd_size = malloc(stack_depth*sizeof(int_t)))) {
-    free(upd);
-    free(fws);
+  upd = malloc(stack_mem*sizeof(double));
+  fws = malloc(frontal_mem*sizeof(double));
+  upd_size = malloc(stack_depth*sizeof(int_t));
+  iws = malloc(n*sizeof(int));
+  if (!upd || !fws || !upd_size || !iws) {
+    free(upd); free(fws); free(upd_size); free(iws);
+    Py_DECREF(Py_snpost); Py_DECREF(Py_snptr); Py_DECREF(Py_snode);
+    Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
+    Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
+    Py_DECREF(Py_blkptr); Py_DECREF(Py_p);
+    dbuffer_release(&blk); dbuffer_release(&Bb);
     return PyErr_NoMemory();
   }
 
-  // call trsm
-  Py_blkval = PyObject_GetAttrString(L, str_blkval);
-  trsm(trans,nrhs,alpha,n,nsn,
-       MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),MAT_BUFI(Py_snode),
-       MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
-       MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
-       MAT_BUFI(Py_blkptr),MAT_BUFI(Py_p),
-       MAT_BUFD(Py_blkval),MAT_BUFD(B)+offsetb,&ldb,
-       fws,upd,upd_size);
+  // call ldltrsm
+  if (!(busy = guard_acquire(L, 0))) {
+    KERNEL_BEGIN
+    blkval_advise(&blk, (trans == 'T') ? ADVISE_TOP_DOWN : ADVISE_BOTTOM_UP);
+    ldltrsm(trans,nrhs,n,nsn,
+	    MAT_BUFI(Py_snpost),MAT_BUFI(Py_snptr),MAT_BUFI(Py_snode),
+	    MAT_BUFI(Py_relptr),MAT_BUFI(Py_relidx),
+	    MAT_BUFI(Py_chptr),MAT_BUFI(Py_chidx),
+	    MAT_BUFI(Py_blkptr),MAT_BUFI(Py_p),
+	    blk.buf,MAT_BUFI(ipiv),Bb.buf+offsetb,&ldb,
+	    fws,upd,upd_size,iws);
+    blkval_advise(&blk, ADVISE_NORMAL);
+    KERNEL_END
+    guard_release(L, 0);
+  }
 
   // update reference counts
   Py_DECREF(Py_snpost); Py_DECREF(Py_snptr); Py_DECREF(Py_snode);
   Py_DECREF(Py_relptr); Py_DECREF(Py_relidx);
   Py_DECREF(Py_chptr); Py_DECREF(Py_chidx);
-  Py_DECREF(Py_blkptr); Py_DECREF(Py_blkval);
+  Py_DECREF(Py_blkptr); dbuffer_release(&blk);
   Py_DECREF(Py_p);
+  dbuffer_release(&Bb);
 
   // free workspace
-  free(fws); free(upd); free(upd_size);
+  free(fws); free(upd); free(upd_size); free(iws);
+  if (busy) return NULL;
 
   return Py_BuildValue("");
 }
 
-
-
 static PyMethodDef cbase_functions[] = {
 
   {"frontal_add_update", (PyCFunction)frontal_add_update,
@@ -1092,8 +3490,56 @@ static PyMethodDef cbase_functions[] = {
   {"dot", (PyCFunction)cdot,
    METH_VARARGS, doc_cdot},
 
+  {"gram", (PyCFunction)cgram,
+   METH_VARARGS, doc_cgram},
+
+  {"syr2", (PyCFunction)csyr2,
+   METH_VARARGS|METH_KEYWORDS, doc_csyr2},
+
+  {"syrk", (PyCFunction)csyrk,
+   METH_VARARGS|METH_KEYWORDS, doc_csyrk},
+
+  {"symm", (PyCFunction)csymm,
+   METH_VARARGS|METH_KEYWORDS, doc_csymm},
+
+  {"spmap_build", (PyCFunction)cspmap_build,
+   METH_VARARGS, doc_cspmap_build},
+
+  {"spmap_dot", (PyCFunction)cspmap_dot,
+   METH_VARARGS, doc_cspmap_dot},
+
+  {"spmap_axpy", (PyCFunction)cspmap_axpy,
+   METH_VARARGS|METH_KEYWORDS, doc_cspmap_axpy},
+
+  {"coo_add", (PyCFunction)ccoo_add,
+   METH_VARARGS|METH_KEYWORDS, doc_ccoo_add},
+
+  {"block_convert", (PyCFunction)cblock_convert,
+   METH_VARARGS, doc_cblock_convert},
+
+  {"block_coupling", (PyCFunction)cblock_coupling,
+   METH_VARARGS, doc_cblock_coupling},
+
+  {"block_to_sparse", (PyCFunction)cblock_to_sparse,
+   METH_VARARGS, doc_cblock_to_sparse},
+
+  {"csc", (PyCFunction)ccsc,
+   METH_VARARGS|METH_KEYWORDS, doc_ccsc},
+
+  {"csc_colptr", (PyCFunction)ccsc_colptr,
+   METH_VARARGS|METH_KEYWORDS, doc_ccsc_colptr},
+
+  {"csc_fill", (PyCFunction)ccsc_fill,
+   METH_VARARGS|METH_KEYWORDS, doc_ccsc_fill},
+
+  {"amalgamate", (PyCFunction)camalgamate,
+   METH_VARARGS, doc_camalgamate},
+
+  {"merge_calibrate", (PyCFunction)cmerge_calibrate,
+   METH_VARARGS|METH_KEYWORDS, doc_cmerge_calibrate},
+
   {"cholesky", (PyCFunction)cchol,
-   METH_VARARGS, doc_cchol},
+   METH_VARARGS|METH_KEYWORDS, doc_cchol},
 
   {"llt", (PyCFunction)cllt,
    METH_VARARGS, doc_cllt},
@@ -1119,6 +3565,21 @@ static PyMethodDef cbase_functions[] = {
   {"trsm", (PyCFunction)ctrsm,
    METH_VARARGS|METH_KEYWORDS, doc_ctrsm},
 
+  {"solve", (PyCFunction)csolve,
+   METH_VARARGS|METH_KEYWORDS, doc_csolve},
+
+  {"ldl", (PyCFunction)cldl,
+   METH_VARARGS|METH_KEYWORDS, doc_cldl},
+
+  {"ldltrsm", (PyCFunction)cldltrsm,
+   METH_VARARGS|METH_KEYWORDS, doc_cldltrsm},
+
+  {"profile", (PyCFunction)cprofile,
+   METH_VARARGS|METH_KEYWORDS, doc_cprofile},
+
+  {"profile_data", (PyCFunction)cprofile_data,
+   METH_NOARGS, doc_cprofile_data},
+
   {NULL}  /* Sentinel */
 };
 
@@ -1139,6 +3600,8 @@ PyMODINIT_FUNC PyInit_cbase(void) {
     return NULL;
   if (import_cvxopt() < 0)
     return NULL;
+  // block size of update_factor() (see symbolic.cost())
+  PyModule_AddIntConstant(cbase_mod, "UPDATE_FACTOR_NB", UPDATE_FACTOR_NB);
   return cbase_mod;
 }
 #else
@@ -1148,5 +3611,6 @@ PyMODINIT_FUNC initcbase(void) {
   m = Py_InitModule3("cbase", cbase_functions, cbase__doc__);
   if (import_cvxopt() < 0)
     return;
+  PyModule_AddIntConstant(m, "UPDATE_FACTOR_NB", UPDATE_FACTOR_NB);
 }
 #endif
@@ -1,25 +1,31 @@
 #include "chompack.h"
+#include "generic.h"
+#include "small.h"
 
-int cholesky(const int_t n,         // order of matrix
-	     const int_t nsn,       // number of supernodes/cliques
-	     const int_t *snpost,   // post-ordering of supernodes
-	     const int_t *snptr,    // supernode pointer
-	     const int_t *relptr,
-	     const int_t *relidx,
-	     const int_t *chptr,
-	     const int_t *chidx,
-	     const int_t *blkptr,
-	     double * restrict blkval,
-	     double * restrict fws,  // frontal matrix workspace
-	     double * restrict upd,  // update matrix workspace
-	     int_t * restrict upd_size
-	     ) {
+int GENERIC(cholesky)(const int_t n,           // order of matrix
+		      const int_t nsn,         // number of supernodes/cliques
+		      const index_t *snpost,   // post-ordering of supernodes
+		      const index_t *snptr,    // supernode pointer
+		      const index_t *relptr,
+		      const index_t *relidx,
+		      const index_t *chptr,
+		      const index_t *chidx,
+		      const int_t *blkptr,
+		      scalar_t * restrict blkval,
+		      scalar_t * restrict fws,  // frontal matrix workspace
+		      scalar_t * restrict upd,  // update matrix workspace
+		      int_t * restrict upd_size,
+		      const int nthreads,       // threads for the tiled factorization of large fronts
+		      cholesky_reg *reg         // dynamic regularization of the pivots (NULL: none)
+		      ) {
 
-  int nn,na,nj,offset,info,i,j,k,ki,l,N,nup=0;
-  double * restrict U;
+  int nn,na,nj,info,k,ki,l,N,nup=0,small;
+  int_t offset,i,j;
+  scalar_t * restrict U;
   int iOne=1;
-  double dOne=1.0,dNegOne=-1.0;
+  scalar_t One=1.0,NegOne=-1.0;
   char cL='L',cT='T',cR='R',cN='N';
+  PROF_DECL;
 
   U = upd;   // pointer to top of update storage
 
@@ -28,14 +34,18 @@ int cholesky(const int_t n,         // order of matrix
     nn = snptr[k+1]-snptr[k];
     na = relptr[k+1]-relptr[k];
     nj = na + nn;
+    small = (!reg && nn <= SMALL_NN && na <= SMALL_NA);
+    PROF_BEGIN(PROF_CHOLESKY, k, nn, na);
 
     // build frontal matrix
-    dlacpy_(&cL, &nj, &nn, blkval+blkptr[k], &nj, fws, &nj);
+    if (small) small_lacpy(nj, nn, blkval+blkptr[k], nj, fws, nj);
+    else BLAS(lacpy)(&cL, &nj, &nn, blkval+blkptr[k], &nj, fws, &nj);
     for (j=nn;j<nj;j++) {
       for (i=j;i<nj;i++) {
 	fws[nj*j+i] = 0.0; // zero out (2,2) block of frontal matrix
       }
     }
+    PROF_PHASE(PHASE_ASSEMBLY);
 
     // add update matrices to frontal matrix
     for (l=chptr[k+1]-1;l>=chptr[k];l--) {
@@ -46,39 +56,76 @@ int cholesky(const int_t n,         // order of matrix
       N = relptr[chidx[l]+1] - offset;
       for (j=0; j<N; j++) {
 	for (i=j; i<N; i++) {
-	  fws[nj*relidx[offset+j]+relidx[offset+i]] += U[N*j+i];
+	  fws[(int_t)nj*relidx[offset+j]+relidx[offset+i]] += U[N*j+i];
 	}
       }
     }
+    PROF_PHASE(PHASE_EXTEND_ADD);
 
-    // factor L_{Nk,Nk}
-    dpotrf_(&cL, &nn, fws, &nj, &info);
-    if (info) return info;
+    if (small) {
+      // fused inline kernel for small fronts (see small.h)
+      SMALL_DISPATCH(nn, info = small_cholesky(NN, nj, fws));
+      PROF_PHASE(PHASE_FACTOR);
+      PROF_FLOPS(nn*(double)nn*nn/3.0 + 2.0*na*(double)nn*nn + na*(double)na*nn);
+      if (info) { PROF_ABORT(PHASE_FACTOR, nup, U-upd); return info; }
+    }
+#ifndef CHOMPACK_SINGLE
+    else if (!reg && nthreads > 1 && nj >= FRONT_TILE_MIN) {
+      // tiled factorization of large fronts (see front_cholesky())
+      info = front_cholesky(nn, nj, fws, nj, FRONT_TILE_NB, nthreads);
+      PROF_PHASE(PHASE_FACTOR);
+      PROF_FLOPS(nn*(double)nn*nn/3.0 + 2.0*na*(double)nn*nn + na*(double)na*nn);
+      if (info) { PROF_ABORT(PHASE_FACTOR, nup, U-upd); return info; }
+    }
+#endif
+    else {
+      // factor L_{Nk,Nk}
+#ifndef CHOMPACK_SINGLE
+      if (reg) {
+	dpotrf_reg(nn, fws, nj, reg, snptr[k]);
+	info = 0;
+      }
+      else
+#endif
+      BLAS(potrf)(&cL, &nn, fws, &nj, &info);
+      PROF_PHASE(PHASE_FACTOR);
+      PROF_FLOPS(nn*(double)nn*nn/3.0);
+      if (info) { PROF_ABORT(PHASE_FACTOR, nup, U-upd); return info; }
 
-    // if supernode k is not a root node, compute and push update matrix onto stack
-    if (na > 0) {
-      // compute L_{Ak,Nk} := A_{Ak,Nk}*inv(L_{Nk,Nk}')
-      dtrsm_(&cR, &cL, &cT, &cN, &na, &nn, &dOne, fws, &nj, fws+nn, &nj);
+      if (na > 0) {
+	// compute L_{Ak,Nk} := A_{Ak,Nk}*inv(L_{Nk,Nk}')
+	BLAS(trsm)(&cR, &cL, &cT, &cN, &na, &nn, &One, fws, &nj, fws+nn, &nj);
+	PROF_PHASE(PHASE_TRSM);
 
-      // compute Uk = Uk - L_{Ak,Nk}*inv(D_{Nk,Nk})*L_{Ak,Nk}'
-      if (nn == 1) {
-	dsyr_(&cL, &na, &dNegOne, fws+nn, &iOne, fws+nn*nj+nn, &nj);
-      }
-      else {
-	dsyrk_(&cL, &cN, &na, &nn, &dNegOne, fws+nn, &nj, &dOne, fws+nn*nj+nn, &nj);
-      }
+	// compute Uk = Uk - L_{Ak,Nk}*inv(D_{Nk,Nk})*L_{Ak,Nk}'
+	if (nn == 1) {
+	  BLAS(syr)(&cL, &na, &NegOne, fws+nn, &iOne, fws+(int_t)nn*nj+nn, &nj);
+	}
+	else {
+	  BLAS(syrk)(&cL, &cN, &na, &nn, &NegOne, fws+nn, &nj, &One, fws+(int_t)nn*nj+nn, &nj);
+	}
+	PROF_PHASE(PHASE_SYRK);
 
-      // compute L_{Ak,Nk} := L_{Ak,Nk}*inv(L_{Nk,Nk})
-      dtrsm_(&cR, &cL, &cN, &cN, &na, &nn, &dOne, fws, &nj, fws+nn, &nj);
+	// compute L_{Ak,Nk} := L_{Ak,Nk}*inv(L_{Nk,Nk})
+	BLAS(trsm)(&cR, &cL, &cN, &cN, &na, &nn, &One, fws, &nj, fws+nn, &nj);
+	PROF_PHASE(PHASE_TRSM);
+	PROF_FLOPS(2.0*na*(double)nn*nn + na*(double)na*nn);
+      }
+    }
 
-      // copy update matrix to stack
+    // if supernode k is not a root node, push update matrix onto stack
+    if (na > 0) {
       upd_size[nup++] = na;
-      dlacpy_(&cL, &na, &na, fws+nn*nj+nn, &nj, U, &na);
-      U += na*na;
+      if (small) small_lacpy(na, na, fws+(int_t)nn*nj+nn, nj, U, na);
+      else BLAS(lacpy)(&cL, &na, &na, fws+(int_t)nn*nj+nn, &nj, U, &na);
+      U += (int_t)na*na;
     }
 
     // copy the leading nn columns of frontal matrix to blkval
-    dlacpy_(&cL, &nj, &nn, fws, &nj, blkval+blkptr[k], &nj);
+    if (small) small_lacpy(nj, nn, fws, nj, blkval+blkptr[k], nj);
+    else BLAS(lacpy)(&cL, &nj, &nn, fws, &nj, blkval+blkptr[k], &nj);
+    PROF_PHASE(PHASE_COPY);
+    PROF_END(nup, U-upd);
   }
   return 0;
 }
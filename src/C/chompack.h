@@ -19,7 +19,11 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifdef CHOMPACK_NO_PYTHON
+#include <stddef.h>
+#else
 #include "Python.h"
+#endif
 
 #ifndef __CHOMPACK__
 #define __CHOMPACK__
@@ -29,8 +33,109 @@
 #define restrict
 #endif
 
+#ifdef CHOMPACK_NO_PYTHON
+#define int_t     ptrdiff_t
+#include "blas_redefines.h"
+#else
 #define int_t     Py_ssize_t
+#endif
+
+// In the multifrontal kernels, the supernode dimensions nn, na and nj
+// are int (as in BLAS/LAPACK), but offsets into the index arrays, into
+// blkval, and into the update stack, as well as the loop counters that
+// multiply a front dimension, are int_t.
+
+// block size used in update_factor(); the workspace must be of length
+// UPDATE_FACTOR_WS(symb.memory['update_factor_mem'], symb.clique_number)
+#define UPDATE_FACTOR_NB 32
+#define UPDATE_FACTOR_WS(mem,cln) ((mem) + UPDATE_FACTOR_NB*(UPDATE_FACTOR_NB+(cln)))
+
+// tile size and minimum front order for the tiled factorization of
+// large fronts in cholesky() (see front_cholesky())
+#define FRONT_TILE_NB 128
+#define FRONT_TILE_MIN 512
+
+// supernodal symbolic factorization (see symbolic_new() and chompack.symbolic)
+typedef struct {
+  int_t n;            // order of matrix
+  int_t nsn;          // number of supernodes/cliques
+  int_t *p, *ip;      // permutation and its inverse
+  int_t *snode, *snptr, *snpar, *snpost;
+  int_t *sncolptr, *snrowidx;
+  int_t *relptr, *relidx;
+  int_t *chptr, *chidx;
+  int_t *blkptr;
+  int_t clique_number;
+  int_t stack_depth, stack_mem, stack_solve, update_factor_mem;
+} symbolic;
+
+// merge criterion for amalgamate(): returns a positive value to merge
+// supernode k with its parent, zero to not merge, and a negative value
+// to abort
+typedef int (*merge_fun)(const int_t cp, const int_t ck, const int_t np, const int_t nk, void *data);
+
+// dynamic regularization in cholesky() (see dpotrf_reg())
+typedef struct {
+  double tol, delta;         // a pivot d <= tol is replaced by max(delta, -d)
+  int_t npert;               // number of perturbed pivots
+  int_t *col;                // perturbed columns (permuted ordering)
+  double *val;               // perturbations max(delta, -d) - d
+} cholesky_reg;
+
+// cost model used by merge_cost() (see chompack.symbolic.merge_auto)
+typedef struct {
+  int nb;                    // number of calibrated block sizes
+  double *size;              // block sizes (increasing)
+  double *potrf, *trsm, *syrk;  // flop rates (flops/s) at each block size
+  double overhead;           // time per supernode (seconds)
+  double extend_add;         // time per update matrix entry (seconds)
+} merge_model;
+
+// per-supernode instrumentation (compile with -DCHOMPACK_PROFILE); the
+// PROF_* macros expand to nothing otherwise
+enum {PROF_CHOLESKY, PROF_LLT, PROF_PROJECTED_INVERSE, PROF_COMPLETION,
+      PROF_HESSIAN_Y2K, PROF_HESSIAN_M2T, PROF_HESSIAN_SCALE, PROF_TRSM_N, PROF_TRSM_T, PROF_NKERNELS};
+enum {PHASE_ASSEMBLY, PHASE_FACTOR, PHASE_TRSM, PHASE_SYRK, PHASE_EXTEND_ADD, PHASE_COPY, PROF_NPHASES};
+
+typedef struct {
+  int kernel;                // PROF_CHOLESKY, ...
+  int_t sn;                  // supernode
+  int nn, na;                // supernode and separator order
+  double start;              // start time (seconds)
+  double t[PROF_NPHASES];    // time spent in each phase (seconds)
+  double flops;              // nominal flop count
+  int_t stack_depth;         // number of update matrices on stack after supernode
+  int_t stack_words;         // size of update stack (doubles) after supernode
+} prof_record;
 
+#ifdef CHOMPACK_PROFILE
+extern int prof_enabled;
+double prof_time(void);
+prof_record * prof_begin(int kernel, int_t sn, int nn, int na);
+void prof_reset(void);
+const prof_record * prof_records(int_t *len);
+#define PROF_DECL        prof_record *prof_rec = NULL; double prof_tic = 0.0
+#define PROF_BEGIN(kern,k,nn,na) \
+  if (prof_enabled && (prof_rec = prof_begin(kern,k,nn,na))) prof_tic = prof_rec->start
+#define PROF_PHASE(ph) \
+  if (prof_rec) { double prof_toc = prof_time(); prof_rec->t[ph] += prof_toc-prof_tic; prof_tic = prof_toc; }
+#define PROF_FLOPS(f)    if (prof_rec) prof_rec->flops += (double) (f)
+#define PROF_END(depth,words) \
+  if (prof_rec) { prof_rec->stack_depth = (depth); prof_rec->stack_words = (words); prof_rec = NULL; }
+// closes the record before an early return, charging the time since
+// the last PROF_PHASE to phase ph
+#define PROF_ABORT(ph,depth,words) \
+  if (prof_rec) { prof_rec->t[ph] += prof_time()-prof_tic; PROF_END(depth,words); }
+#else
+#define PROF_DECL
+#define PROF_BEGIN(kern,k,nn,na)
+#define PROF_PHASE(ph)
+#define PROF_FLOPS(f)
+#define PROF_END(depth,words)
+#define PROF_ABORT(ph,depth,words)
+#endif
+
+#ifndef CHOMPACK_NO_PYTHON
 #if PY_MAJOR_VERSION >= 3
 #define PYINT_CHECK(value) PyLong_Check(value)
 #define PYINT_AS_LONG(value) PyLong_AS_LONG(value)
@@ -44,11 +149,15 @@
 #define PYSTRING_CHECK(a) PyString_Check(a)
 #define PYSTRING_COMPARE(a,b) strcmp(PyString_AsString(a), b)
 #endif
+#endif
 
 extern double ddot_(int *n, double *dx, int *incx, double *dy, int *incy);
+extern double dnrm2_(int *n, double *x, int *incx);
 extern void dscal_(int *n, double *alpha, double *x, int *incx);
 extern void dlacpy_(char *uplo, int *m, int *n, double *A, int *lda, double *B, int *ldb);
 extern void dpotrf_(char *uplo, int *n, double *A, int *lda, int *info);
+extern void dsytrf_(char *uplo, int *n, double *A, int *lda, int *ipiv, double *work, int *lwork, int *info);
+extern void dsytrs_(char *uplo, int *n, int *nrhs, double *A, int *lda, int *ipiv, double *B, int *ldb, int *info);
 extern void dtrtri_(char *uplo, char *diag, int *n, double *A, int *lda, int *info);
 extern void dtrtrs_(char *uplo, char *trans, char *diag, int *n, int *nrhs, double *A, int *lda, double *B, int *ldb, int *info);
 extern void dtrsm_(char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb);
@@ -56,9 +165,14 @@ extern void dtrmm_(char *side, char *uplo, char *transa, char *diag, int *m, int
 extern void dsymm_(char *side, char *uplo, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
 extern void dgemm_(char *transa, char *transb, int *m, int *n, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
 extern void dsyrk_(char *uplo, char *trans, int *n, int *k, double *alpha, double *A, int *lda, double *beta, double *B, int *ldb);
+extern void dsyr2k_(char *uplo, char *trans, int *n, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
 extern void dsyr_(char *uplo, int *n, double *alpha, double *x, int *incx, double *A, int *lda);
+extern void dgemv_(char *trans, int *m, int *n, double *alpha, double *A, int *lda, double *x, int *incx, double *beta, double *y, int *incy);
 extern void dlarfg_(int *n, double *alpha, double *x, int *incx, double *tau);
 extern int dlarfx_(char *side, int *m, int *n, double *v, double *tau, double *C, int *ldc, double *work);
+extern void dgeql2_(int *m, int *n, double *A, int *lda, double *tau, double *work, int *info);
+extern void dlarft_(char *direct, char *storev, int *n, int *k, double *V, int *ldv, double *tau, double *T, int *ldt);
+extern void dlarfb_(char *side, char *trans, char *direct, char *storev, int *m, int *n, int *k, double *V, int *ldv, double *T, int *ldt, double *C, int *ldc, double *work, int *ldwork);
 
 int cholesky(const int_t n,         // order of matrix
 	     const int_t nsn,       // number of supernodes/cliques
@@ -72,7 +186,58 @@ int cholesky(const int_t n,         // order of matrix
 	     double * restrict blkval,
 	     double * restrict fws,     // frontal matrix workspace
 	     double * restrict upd,     // update matrix workspace
-	     int_t * restrict upd_size
+	     int_t * restrict upd_size,
+	     const int nthreads,
+	     cholesky_reg *reg          // dynamic regularization (NULL: none)
+	     );
+void dpotrf_reg(const int n, double * restrict a, const int lda, cholesky_reg *reg, const int_t col);
+int front_cholesky(const int nn, const int nj, double * restrict F, const int ldf, const int nb, const int nthreads);
+
+int ldl(const int_t n,         // order of matrix
+	const int_t nsn,       // number of supernodes/cliques
+	const int_t *snpost,   // post-ordering of supernodes
+	const int_t *snptr,    // supernode pointer
+	const int_t *snode,    // supernode array
+	const int_t *relptr,
+	const int_t *relidx,
+	const int_t *chptr,
+	const int_t *chidx,
+	const int_t *blkptr,
+	const int_t *p,
+	double * restrict blkval,
+	int_t * restrict ipiv,
+	const int_t *sign,
+	const double delta,
+	int_t * restrict inertia,
+	int_t * restrict nreg,
+	double * restrict fws,     // frontal matrix workspace
+	double * restrict upd,     // update matrix workspace
+	int_t * restrict upd_size,
+	double * restrict work,
+	const int lwork,
+	int * restrict iws
+	);
+void ldltrsm(const char trans,
+	     int nrhs,
+	     const int_t n,         // order of matrix
+	     const int_t nsn,       // number of supernodes/cliques
+	     const int_t *snpost,   // post-ordering of supernodes
+	     const int_t *snptr,    // supernode pointer
+	     const int_t *snode,    // supernode array
+	     const int_t *relptr,
+	     const int_t *relidx,
+	     const int_t *chptr,
+	     const int_t *chidx,
+	     const int_t *blkptr,
+	     const int_t *p,
+	     double * restrict blkval,
+	     const int_t *ipiv,
+	     double * restrict a,
+	     int * lda,
+	     double * restrict fws,  // frontal matrix workspace : must be >= clique number * nrhs
+	     double * restrict upd,  // update matrix workspace
+	     int_t * restrict upd_size,
+	     int * restrict iws
 	     );
 
 void llt(const int_t n,         // order of matrix
@@ -119,6 +284,7 @@ int completion(const int_t n,         // order of matrix
 	       double * restrict fws,  // frontal matrix workspace
 	       double * restrict upd,  // update matrix workspace
 	       int_t * restrict upd_size,
+	       double * restrict ws,   // update_factor workspace (only if factored_updates)
 	       int factored_updates);
 
 void _Y2K(const int_t n,         // order of matrix
@@ -168,6 +334,7 @@ int _scale(const int_t n,         // order of matrix
 	   double * restrict fws,  // frontal matrix workspace
 	   double * restrict upd,  // update matrix workspace
 	   int_t * restrict upd_size,
+	   double * restrict ws,   // update_factor workspace (only if factored_updates)
 	   int inv,
 	   int adj,
 	   int factored_updates);
@@ -187,6 +354,7 @@ int hessian(const int_t n,         // order of matrix
 	    double * restrict fws,  // frontal matrix workspace
 	    double * restrict upd,  // update matrix workspace
 	    int_t * restrict upd_size,
+	    double * restrict ws,   // update_factor workspace (only if factored_updates)
 	    int inv,
 	    int adj,
 	    int factored_updates);
@@ -198,7 +366,9 @@ int update_factor(const int_t *ri,
 		  int *ldu,
 		  double * restrict f,
 		  int *ldf,
-		  double *ws);
+		  double * restrict ws);
+
+int drpotrf(const int *n, double * restrict a, const int *lda);
 
 void ddrsv(const int *n, const char *trans, double * restrict v, double * restrict l, double * restrict b, double * restrict x);
 void ddrmv(const int *n, const char *trans, double * restrict v, double * restrict l, double * restrict b, double * restrict x);
@@ -208,6 +378,64 @@ void dpfmv(const int *n, const int *k, const char *trans, double * restrict V, c
 
 double dot(int_t *Nsn, int_t *snptr, int_t *sncolptr, int_t *blkptr, double * restrict blkval_x, double * restrict blkval_y);
 
+void gram(int_t *Nsn, int_t *snptr, int_t *sncolptr, int_t *blkptr,
+	  int mx, double ** xblkval, int my, double ** yblkval,
+	  double * restrict G, int *ldg, double * restrict ws, int nr);
+
+void syr2k(int_t *Nsn, int_t *snptr, int_t *sncolptr, int_t *snrowidx, int_t *blkptr, int_t *p,
+	   int m, double * restrict U, int ldu, double * restrict V, int ldv, double * restrict w,
+	   double alpha, double beta, double * restrict blkval, double * restrict ws, int_t ldws, int nthreads);
+void symm(const int_t n, const int_t nsn, const int_t *snptr, const int_t *sncolptr, const int_t *snrowidx,
+	  const int_t *blkptr, const int_t *p, int m, double * restrict B, int ldb, double * restrict C, int ldc,
+	  double alpha, double beta, double * restrict blkval, double * restrict ws, int_t ldws, int nthreads);
+
+int_t csc_colptr(const int_t n, const int_t nsn, const int_t *snptr, const int_t *snode,
+		 const int_t *sncolptr, const int_t *snrowidx, const int_t *p, const char uplo,
+		 int_t * restrict colptr);
+void csc_fill(const int_t n, const int_t nsn, const int_t *snptr, const int_t *snode,
+	      const int_t *sncolptr, const int_t *snrowidx, const int_t *blkptr, const int_t *p,
+	      const char uplo, const int factor, double * restrict blkval, const int_t c0, const int_t c1,
+	      const int_t *colptr, int_t * restrict rowidx, double * restrict val,
+	      int_t * restrict pos, double * restrict ws);
+
+void spmap_colsn(const int_t nsn, const int_t *snptr, const int_t *snode, int_t * restrict colsn);
+int_t spmap(const int_t n, const int_t *colsn, const int_t *sncolptr,
+	    const int_t *snrowidx, const int_t *blkptr, const int_t *ip,
+	    const int_t *colptr, const int_t *rowidx, const double *val,
+	    int_t * restrict off, double * restrict v, double * restrict wv);
+int_t spmap_coo(const int_t n, const int_t *colsn, const int_t *sncolptr,
+		const int_t *snrowidx, const int_t *blkptr, const int_t *ip,
+		const char uplo, const int_t nnz, const int_t *row, const int_t *col,
+		int_t * restrict off);
+void spmap_dot(const int m, const int_t *ptr, const int_t *off, const double *wv,
+	       const double *blkval, double * restrict y);
+void spmap_axpy(const int m, const int_t *ptr, const int_t *off, const double *v,
+		const double *y, const double alpha, double * restrict blkval);
+
+void block_offsets(const int_t nsn, const int_t *sncolptr, int_t * restrict boff);
+int_t block_convert(const int_t dim, const int_t m, const int_t *colptr, const int_t *rowidx,
+		    const double *val, const int cplx, const int_t *ip, const int_t *colsn,
+		    const int_t *sncolptr, const int_t *snrowidx, const int_t *boff,
+		    int_t * restrict I, int_t * restrict J, double * restrict V);
+int_t block_coupling(const int_t nsn, const int_t *snptr, const int_t *snpar, const int_t *sncolptr,
+		     const int_t *snrowidx, const int_t *relptr, const int_t *relidx, const int_t *boff,
+		     const int_t *ccolptr, const int_t *crowidx, const int cplx,
+		     int_t * restrict I, int_t * restrict J, double * restrict V, int_t *ncon);
+int_t block_to_sparse(const int_t n, const int_t nsn, const int_t *snptr, const int_t *sncolptr,
+		      const int_t *snrowidx, const int_t *boff, const int_t *p,
+		      int_t * restrict blki, int_t * restrict I, int_t * restrict J);
+
+int symbolic_new(const int_t n, const int_t *colptr, const int_t *rowidx, const int_t *perm, symbolic **symb);
+void symbolic_free(symbolic *symb);
+void tree_postorder(const int_t n, const int_t *parent, int_t * restrict post, int_t * restrict work);
+
+int amalgamate(const int_t nsn, int_t * restrict colcount, int_t * restrict snode, int_t * restrict snptr,
+	       int_t * restrict snpar, int_t * restrict snpost, merge_fun merge, void *data, int_t *nsn_out);
+int merge_size_fill(const int_t cp, const int_t ck, const int_t np, const int_t nk, void *data);
+int merge_cost(const int_t cp, const int_t ck, const int_t np, const int_t nk, void *data);
+double front_time(const merge_model *M, const int_t nn, const int_t na);
+int merge_calibrate(merge_model *M, const double tmin);
+
 void trsm(const char trans, 
 	  int nrhs,
 	  const double alpha,
@@ -230,4 +458,31 @@ void trsm(const char trans,
 	  int_t * restrict upd_size
 	  );
 
+int solve(const int_t n,         // order of matrix
+	  const int_t nsn,       // number of supernodes/cliques
+	  const int_t *snpost,   // post-ordering of supernodes
+	  const int_t *snptr,    // supernode pointer
+	  const int_t *snode,    // supernode array
+	  const int_t *relptr,
+	  const int_t *relidx,
+	  const int_t *chptr,
+	  const int_t *chidx,
+	  const int_t *blkptr,
+	  const int_t *sncolptr,
+	  const int_t *snrowidx,
+	  const int_t *p,
+	  const int_t clique_number,
+	  const int_t stack_solve,
+	  double * restrict Aval,
+	  double * restrict Lval,
+	  int nrhs,
+	  double * restrict a,
+	  int * lda,
+	  int refine,
+	  double tol,
+	  double * restrict resnrm,
+	  double * restrict work,  // workspace : must be >= (3*n + 2*clique number + stack_solve + 1) * nrhs
+	  int_t * restrict upd_size
+	  );
+
 #endif
@@ -0,0 +1,397 @@
+/*
+ * Copyright 2012-2018 M. Andersen and L. Vandenberghe.
+ * Copyright 2010-2011 L. Vandenberghe.
+ * Copyright 2004-2009 J. Dahl and L. Vandenberghe.
+ *
+ * This file is part of CHOMPACK.
+ *
+ * CHOMPACK is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CHOMPACK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  Header-only C++11 interface of libchompack (see libchompack.h),
+  templated on the scalar type T (float or double) and the index type
+  I (std::int32_t or std::int64_t):
+
+    chompack::symbolic<I> S(n, colptr, rowidx);      // or (..., perm)
+    chompack::matrix<T,I> A(S);
+    A.add(colptr, rowidx, val);
+    chompack::matrix<T,I> L(A);
+    chompack::cholesky(L);
+    chompack::solve(L, x, 1, n);
+
+  The symbolic factorization is computed by chompack_analyze(), and
+  its index arrays are copied to symbolic<I>::index_type (std::int32_t,
+  or chompack_int for std::int64_t; std::overflow_error if they do not
+  fit); blkptr is 64-bit (offset_type) for either I. The handle of
+  chompack_analyze() is then freed, so the structure is stored once,
+  and std::int32_t halves the memory and bandwidth of the index arrays
+  (e.g., relidx in the extend-add) without limiting the number of
+  nonzeros of the factor; completion() and hessian() load a temporary
+  handle (symbolic<I>::handle()). cholesky(), solve() and
+  projected_inverse() call the kernels of libchompack compiled for T
+  and the index arrays of I (cholesky.c, trsm.c and projected_inverse.c
+  with the inline kernels for small supernodes of small.h; see
+  generic.h). completion() and hessian() are available for T = double
+  only and call libchompack. Errors are reported as chompack::error.
+
+  matrix<T,I> owns its values, and every routine owns its workspace.
+  A matrix refers to the symbolic factorization it was created with,
+  which must outlive it.
+*/
+
+#ifndef CHOMPACK_HPP
+#define CHOMPACK_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "libchompack.h"
+
+namespace chompack {
+
+// value offsets (blkptr and the update stack) are chompack_int (int_t in
+// the kernels) for either index type, so a factor with 32-bit indices
+// may have more than 2^31 entries
+typedef chompack_int offset_type;
+
+class error : public std::runtime_error {
+public:
+  error(int code, const char *what) : std::runtime_error(what), code_(code) { }
+  int code() const { return code_; }   // CHOMPACK_ERR_* (libchompack.h)
+private:
+  int code_;
+};
+
+namespace detail {
+
+inline void check(int info) {
+  switch (info) {
+  case CHOMPACK_OK: return;
+  case CHOMPACK_ERR_MEMORY: throw std::bad_alloc();
+  case CHOMPACK_ERR_PATTERN: throw error(info, "chompack: entry outside the sparsity pattern");
+  case CHOMPACK_ERR_NUMERIC: throw error(info, "chompack: matrix is not positive definite");
+  default: throw error(info, "chompack: invalid argument");
+  }
+}
+
+/*
+  kernels<T,J>::cholesky(), trsm() and projected_inverse() call the
+  kernels of libchompack for values of type T and index arrays of type
+  J (see generic.h); reg of cholesky() is a cholesky_reg* (NULL for
+  T = float).
+*/
+template<typename T, typename J> struct kernels;
+
+#define CHOMPACK_KERNELS(T, J, x)					\
+  extern "C" {								\
+    int cholesky##x(chompack_int n, chompack_int nsn, const J *snpost, const J *snptr, \
+		    const J *relptr, const J *relidx, const J *chptr, const J *chidx, \
+		    const chompack_int *blkptr, T *blkval, T *fws, T *upd, chompack_int *upd_size, \
+		    int nthreads, void *reg);				\
+    void trsm##x(char trans, int nrhs, T alpha, chompack_int n, chompack_int nsn, \
+		 const J *snpost, const J *snptr, const J *snode, const J *relptr, \
+		 const J *relidx, const J *chptr, const J *chidx, const chompack_int *blkptr, \
+		 const J *p, T *blkval, T *a, int *lda, T *fws, T *upd, chompack_int *upd_size); \
+    int projected_inverse##x(chompack_int n, chompack_int nsn, const J *snpost, const J *snptr, \
+			     const J *relptr, const J *relidx, const J *chptr, const J *chidx, \
+			     const chompack_int *blkptr, T *blkval, T *fws, T *upd, \
+			     chompack_int *upd_size);			\
+  }									\
+  template<> struct kernels<T, J> {					\
+    template<typename... A> static int cholesky(A... a) { return detail::cholesky##x(a...); } \
+    template<typename... A> static void trsm(A... a) { detail::trsm##x(a...); } \
+    template<typename... A> static int projected_inverse(A... a) { return detail::projected_inverse##x(a...); } \
+  };
+CHOMPACK_KERNELS(double, chompack_int, )
+CHOMPACK_KERNELS(float, chompack_int, _s)
+CHOMPACK_KERNELS(double, std::int32_t, _d32)
+CHOMPACK_KERNELS(float, std::int32_t, _s32)
+#undef CHOMPACK_KERNELS
+
+// type of the index arrays of symbolic<I>
+template<typename I> struct index { typedef chompack_int type; };
+template<> struct index<std::int32_t> { typedef std::int32_t type; };
+
+template<typename J>
+inline const chompack_int *widen(const std::vector<J>& x, std::vector<chompack_int>& y) {
+  // x as chompack_int, converted in y unless J is chompack_int
+  if (std::is_same<J, chompack_int>::value) return reinterpret_cast<const chompack_int*>(x.data());
+  y.assign(x.begin(), x.end());
+  return y.data();
+}
+
+template<typename J>
+inline void narrow(std::vector<J>& y, const chompack_int *x, chompack_int len) {
+  y.resize(len);
+  for (chompack_int i=0; i<len; i++) {
+    if (x[i] > static_cast<chompack_int>(std::numeric_limits<J>::max()))
+      throw std::overflow_error("chompack: index does not fit in the index type");
+    y[i] = static_cast<J>(x[i]);
+  }
+}
+
+struct symbolic_deleter {
+  void operator()(chompack_symbolic *symb) const { chompack_symbolic_free(symb); }
+};
+
+} // namespace detail
+
+/*
+  Symbolic factorization of the sparsity pattern of a symmetric matrix
+  of order n in CCS format (lower triangle, original ordering), with
+  the fill-reducing permutation perm (NULL: natural ordering).
+*/
+template<typename I>
+class symbolic {
+  static_assert(std::is_same<I, std::int32_t>::value || std::is_same<I, std::int64_t>::value,
+		"chompack::symbolic: the index type must be std::int32_t or std::int64_t");
+public:
+  typedef typename detail::index<I>::type index_type;
+
+  symbolic(I n, const I *colptr, const I *rowidx, const I *perm = nullptr) {
+    std::vector<chompack_int> cp(colptr, colptr+n+1), ri(rowidx, rowidx+colptr[n]), pm;
+    if (perm) pm.assign(perm, perm+n);
+    chompack_symbolic *symb;
+    detail::check(chompack_analyze(n, cp.data(), ri.data(), perm ? pm.data() : nullptr, &symb));
+    std::unique_ptr<chompack_symbolic, detail::symbolic_deleter> H(symb);
+
+    chompack_structure s;
+    chompack_symbolic_structure(symb, &s);
+    n_ = s.n; nsn_ = s.nsn; clique_number_ = s.clique_number;
+    stack_depth_ = s.stack_depth; stack_mem_ = s.stack_mem; stack_solve_ = s.stack_solve;
+    update_factor_mem_ = s.update_factor_mem;
+    detail::narrow(p, s.p, n_);
+    detail::narrow(ip, s.ip, n_);
+    detail::narrow(snode, s.snode, n_);
+    detail::narrow(snptr, s.snptr, nsn_+1);
+    detail::narrow(snpar, s.snpar, nsn_);
+    detail::narrow(snpost, s.snpost, nsn_);
+    detail::narrow(sncolptr, s.sncolptr, nsn_+1);
+    detail::narrow(snrowidx, s.snrowidx, s.sncolptr[nsn_]);
+    detail::narrow(relptr, s.relptr, nsn_+1);
+    detail::narrow(relidx, s.relidx, s.relptr[nsn_]);
+    detail::narrow(chptr, s.chptr, nsn_+1);
+    detail::narrow(chidx, s.chidx, s.chptr[nsn_]);
+    blkptr.assign(s.blkptr, s.blkptr+nsn_+1);
+    colsn.resize(n_);
+    for (I k=0; k<nsn_; k++)
+      for (I i=snptr[k]; i<snptr[k+1]; i++) colsn[snode[i]] = k;
+  }
+
+  I order() const { return n_; }
+  I supernodes() const { return nsn_; }
+  I clique_number() const { return clique_number_; }
+  offset_type size() const { return blkptr[nsn_]; }    // length of the values of a matrix
+  I stack_depth() const { return stack_depth_; }
+  offset_type stack_mem() const { return stack_mem_; }
+  offset_type stack_solve() const { return stack_solve_; }
+
+  // new libchompack handle of the structure (see chompack_symbolic_load()),
+  // to be freed by chompack_symbolic_free()
+  chompack_symbolic *handle() const {
+    std::vector<chompack_int> w[13];
+    chompack_structure s;
+    s.n = n_; s.nsn = nsn_; s.clique_number = clique_number_;
+    s.stack_depth = stack_depth_; s.stack_mem = stack_mem_; s.stack_solve = stack_solve_;
+    s.update_factor_mem = update_factor_mem_;
+    s.p = detail::widen(p, w[0]); s.ip = detail::widen(ip, w[1]);
+    s.snode = detail::widen(snode, w[2]); s.snptr = detail::widen(snptr, w[3]);
+    s.snpar = detail::widen(snpar, w[4]); s.snpost = detail::widen(snpost, w[5]);
+    s.sncolptr = detail::widen(sncolptr, w[6]); s.snrowidx = detail::widen(snrowidx, w[7]);
+    s.relptr = detail::widen(relptr, w[8]); s.relidx = detail::widen(relidx, w[9]);
+    s.chptr = detail::widen(chptr, w[10]); s.chidx = detail::widen(chidx, w[11]);
+    s.blkptr = detail::widen(blkptr, w[12]);
+    chompack_symbolic *symb;
+    detail::check(chompack_symbolic_load(&s, &symb));
+    return symb;
+  }
+
+  // supernodal structure (see chompack.symbolic); colsn[j] is the
+  // supernode of column j
+  std::vector<index_type> p, ip, snode, snptr, snpar, snpost, sncolptr, snrowidx;
+  std::vector<index_type> relptr, relidx, chptr, chidx, colsn;
+  std::vector<offset_type> blkptr;
+
+private:
+  I n_, nsn_, clique_number_, stack_depth_;
+  offset_type stack_mem_, stack_solve_, update_factor_mem_;
+};
+
+/*
+  Chordal matrix (or Cholesky factor, or projected inverse) with the
+  sparsity pattern of a symbolic factorization; the values are stored
+  as in cspmatrix.blkval.
+*/
+template<typename T, typename I>
+class matrix {
+  static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+		"chompack::matrix: the scalar type must be float or double");
+public:
+  explicit matrix(const symbolic<I>& symb) : symb_(&symb), val_(symb.size(), T(0)), factor_(false) { }
+
+  const symbolic<I>& symb() const { return *symb_; }
+  T *data() { return val_.data(); }
+  const T *data() const { return val_.data(); }
+  std::size_t size() const { return val_.size(); }
+  bool is_factor() const { return factor_; }
+  void set_factor(bool factor) { factor_ = factor; }
+
+  // X := X + alpha*A for a sparse symmetric A in CCS format (lower
+  // triangle, original ordering) with the pattern of X
+  void add(const I *colptr, const I *rowidx, const T *val, T alpha = 1) {
+    const symbolic<I>& S = *symb_;
+    if (factor_) detail::check(CHOMPACK_ERR_ARGUMENT);
+    for (I j=0; j<S.order(); j++) {
+      for (I t=colptr[j]; t<colptr[j+1]; t++) {
+	I i = rowidx[t];
+	if (i < j) continue;
+	I ii = S.ip[i], jj = S.ip[j];
+	if (ii < jj) std::swap(ii, jj);
+	const I k = S.colsn[jj];
+	const auto *first = S.snrowidx.data() + S.sncolptr[k], *last = S.snrowidx.data() + S.sncolptr[k+1];
+	const auto *r = std::lower_bound(first, last, ii);
+	if (r == last || *r != ii) detail::check(CHOMPACK_ERR_PATTERN);
+	const I nj = S.sncolptr[k+1]-S.sncolptr[k];
+	val_[S.blkptr[k] + static_cast<std::size_t>(nj)*(jj-*first) + (r-first)] += alpha*val[t];
+      }
+    }
+  }
+
+private:
+  const symbolic<I> *symb_;
+  std::vector<T> val_;
+  bool factor_;
+};
+
+namespace detail {
+
+// multifrontal workspace: frontal matrix and stack of update matrices
+template<typename T>
+struct workspace {
+  workspace(std::size_t nfws, std::size_t nupd, std::size_t depth)
+    : fws(nfws+1), upd(nupd+1), upd_size(depth+1) { }
+  std::vector<T> fws, upd;
+  std::vector<chompack_int> upd_size;
+};
+
+template<typename T, typename I>
+class handle {
+  // libchompack handle of the values of a double precision matrix
+public:
+  handle(const chompack_symbolic *symb, matrix<T,I>& X) : X_(nullptr) {
+    static_assert(std::is_same<T, double>::value, "chompack: only available in double precision");
+    check(chompack_matrix_wrap(symb, X.data(), X.is_factor(), &X_));
+  }
+  ~handle() { chompack_matrix_free(X_); }
+  chompack_matrix *get() const { return X_; }
+private:
+  handle(const handle&);
+  handle& operator=(const handle&);
+  chompack_matrix *X_;
+};
+
+} // namespace detail
+
+// X := L where X = L*L' (Cholesky factorization, in place; see cholesky.c);
+// on failure, X is not marked as a factor and its values are undefined
+template<typename T, typename I>
+void cholesky(matrix<T,I>& X) {
+  typedef detail::kernels<T, typename symbolic<I>::index_type> K;
+  const symbolic<I>& S = X.symb();
+  if (X.is_factor()) detail::check(CHOMPACK_ERR_ARGUMENT);
+  detail::workspace<T> W(static_cast<std::size_t>(S.clique_number())*S.clique_number(), S.stack_mem(),
+			 S.stack_depth());
+  if (K::cholesky(S.order(), S.supernodes(), S.snpost.data(), S.snptr.data(), S.relptr.data(),
+		  S.relidx.data(), S.chptr.data(), S.chidx.data(), S.blkptr.data(), X.data(),
+		  W.fws.data(), W.upd.data(), W.upd_size.data(), 1, nullptr))
+    detail::check(CHOMPACK_ERR_NUMERIC);
+  X.set_factor(true);
+}
+
+// B := inv(X)*B, where L is the Cholesky factor of X and B is n-by-nrhs
+// with leading dimension ldb (see trsm.c)
+template<typename T, typename I>
+void solve(const matrix<T,I>& L, T *B, int nrhs, std::size_t ldb) {
+  typedef detail::kernels<T, typename symbolic<I>::index_type> K;
+  const symbolic<I>& S = L.symb();
+  if (!L.is_factor() || nrhs < 0 || ldb < static_cast<std::size_t>(S.order()) ||
+      ldb > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+    detail::check(CHOMPACK_ERR_ARGUMENT);
+  detail::workspace<T> W(static_cast<std::size_t>(S.clique_number())*nrhs,
+			 static_cast<std::size_t>(S.stack_solve())*nrhs, S.stack_depth());
+  int ld = static_cast<int>(ldb);
+  T *blkval = const_cast<T*>(L.data());    // not modified by trsm()
+  const char trans[] = {'N', 'T'};
+  for (int t=0; t<2; t++)
+    K::trsm(trans[t], nrhs, T(1), S.order(), S.supernodes(), S.snpost.data(), S.snptr.data(),
+	    S.snode.data(), S.relptr.data(), S.relidx.data(), S.chptr.data(), S.chidx.data(),
+	    S.blkptr.data(), S.p.data(), blkval, B, &ld, W.fws.data(), W.upd.data(), W.upd_size.data());
+}
+
+// L := P(inv(L*L')), the projection of the inverse on the pattern (see
+// projected_inverse.c)
+template<typename T, typename I>
+void projected_inverse(matrix<T,I>& L) {
+  typedef detail::kernels<T, typename symbolic<I>::index_type> K;
+  const symbolic<I>& S = L.symb();
+  if (!L.is_factor()) detail::check(CHOMPACK_ERR_ARGUMENT);
+  detail::workspace<T> W(static_cast<std::size_t>(S.clique_number())*S.clique_number(), S.stack_mem(),
+			 S.stack_depth());
+  if (K::projected_inverse(S.order(), S.supernodes(), S.snpost.data(), S.snptr.data(), S.relptr.data(),
+			   S.relidx.data(), S.chptr.data(), S.chidx.data(), S.blkptr.data(), L.data(),
+			   W.fws.data(), W.upd.data(), W.upd_size.data()))
+    detail::check(CHOMPACK_ERR_NUMERIC);
+  L.set_factor(false);
+}
+
+// X := L, the Cholesky factor of the inverse of the maximum determinant
+// positive definite completion of X (double precision only)
+template<typename I>
+void completion(matrix<double,I>& X, bool factored_updates = false) {
+  std::unique_ptr<chompack_symbolic, detail::symbolic_deleter> symb(X.symb().handle());
+  detail::handle<double,I> H(symb.get(), X);
+  detail::check(chompack_completion(H.get(), factored_updates));
+  X.set_factor(true);
+}
+
+// U[i] := G(U[i]), G'(U[i]) or G'(G(U[i])), or the inverse mappings (see
+// chompack_hessian(); double precision only)
+template<typename I>
+void hessian(const matrix<double,I>& L, const matrix<double,I>& Y, std::vector<matrix<double,I>*>& U,
+	     int adj, bool inv = false) {
+  if (&Y.symb() != &L.symb()) detail::check(CHOMPACK_ERR_ARGUMENT);
+  for (std::size_t i=0; i<U.size(); i++)
+    if (&U[i]->symb() != &L.symb()) detail::check(CHOMPACK_ERR_ARGUMENT);
+  std::unique_ptr<chompack_symbolic, detail::symbolic_deleter> symb(L.symb().handle());
+  detail::handle<double,I> HL(symb.get(), const_cast<matrix<double,I>&>(L));
+  detail::handle<double,I> HY(symb.get(), const_cast<matrix<double,I>&>(Y));
+  std::vector<std::unique_ptr<detail::handle<double,I> > > HU;
+  std::vector<chompack_matrix*> u;
+  for (std::size_t i=0; i<U.size(); i++) {
+    HU.emplace_back(new detail::handle<double,I>(symb.get(), *U[i]));
+    u.push_back(HU.back()->get());
+  }
+  detail::check(chompack_hessian(HL.get(), HY.get(), u.data(), static_cast<int>(u.size()), adj, inv));
+}
+
+} // namespace chompack
+
+#endif
@@ -13,13 +13,16 @@ int completion(const int_t n,         // order of matrix
 	       double * restrict fws,  // frontal matrix workspace
 	       double * restrict upd,  // update matrix workspace
 	       int_t * restrict upd_size,
+	       double * restrict ws,   // update_factor workspace (only if factored_updates)
 	       int factored_updates) {
 
-  int nn,na,nj,offset,info,N,i,j,k,ki,l,nup=0,iOne=1;
-  double * restrict U, * restrict ws=NULL;
+  int nn,na,nj,info,N,k,ki,l,nup=0,iOne=1;
+  int_t offset,i,j;
+  double * restrict U;
   double dOne=1.0,dNegOne=-1.0;
-  char cL='L',cU='U',cT='T',cN='N';
+  char cL='L',cT='T',cN='N';
   char *trL1, *trL2;
+  PROF_DECL;
 
   U = upd;   // pointer to top of update storage
 
@@ -28,6 +31,7 @@ int completion(const int_t n,         // order of matrix
     nn = snptr[k+1]-snptr[k];
     na = relptr[k+1]-relptr[k];
     nj = na + nn;
+    PROF_BEGIN(PROF_COMPLETION, k, nn, na);
 
     // copy L_{Jk,Nk} to leading columns of F
     dlacpy_(&cL, &nj, &nn, blkval+blkptr[k], &nj, fws, &nj);
@@ -39,10 +43,7 @@ int completion(const int_t n,         // order of matrix
       U -= upd_size[nup]*upd_size[nup];
       dlacpy_(&cL, &na, &na, U, &na, fws+nn*nj+nn, &nj);
     }
-
-    if ((chptr[k+1]-chptr[k]>0) && (factored_updates)) {
-      ws = malloc(na*(na+1)*sizeof(double)); // allocate workspace
-    }
+    PROF_PHASE(PHASE_ASSEMBLY);
 
     // extract update matrices if supernode k has any children
     for (l=chptr[k];l<chptr[k+1];l++) {
@@ -53,10 +54,7 @@ int completion(const int_t n,         // order of matrix
 
       if (factored_updates) {
 	info = update_factor(relidx+offset, &nn, &na, U, &N, fws, &nj, ws);
-	if (info) {
-	  free(ws);
-	  return info;
-	}
+	if (info) { PROF_ABORT(PHASE_EXTEND_ADD, nup, U-upd); return info; }
       }
       else {
 	/* extract unfactored update */
@@ -68,11 +66,7 @@ int completion(const int_t n,         // order of matrix
       }
       U += N*N;
     }
-
-    // free workspace if node has any children and factored_updates
-    if ((chptr[k+1]-chptr[k]>0) && (factored_updates)) {
-      free(ws);
-    }
+    PROF_PHASE(PHASE_EXTEND_ADD);
 
     // if supernode k is not a root node:
     if (na>0) {
@@ -84,36 +78,35 @@ int completion(const int_t n,         // order of matrix
       else {
 	// factorize Vk
 	dpotrf_(&cL, &na, fws+nj*nn+nn, &nj, &info);
-	if (info) return info;
+	PROF_PHASE(PHASE_FACTOR);
+	PROF_FLOPS(na*(double)na*na/3.0);
+	if (info) { PROF_ABORT(PHASE_FACTOR, nup, U-upd); return info; }
 	// In this case we have Vk = Lk*Lk'
 	trL1 = &cN;
 	trL2 = &cT;
       }
       // compute L_{Ak,Nk} and inv(D_{Nk,Nk}) = S_{Nk,Nk} - S_{Ak,Nk}'*L_{Ak,Nk}
       dtrtrs_(&cL, trL1, &cN, &na, &nn, fws+nj*nn+nn, &nj, blkval+blkptr[k]+nn, &nj, &info);
-      if (info) return info;
+      PROF_PHASE(PHASE_TRSM);
+      if (info) { PROF_ABORT(PHASE_TRSM, nup, U-upd); return info; }
       dsyrk_(&cL, &cT, &nn, &na, &dNegOne, blkval+blkptr[k]+nn, &nj, &dOne, blkval+blkptr[k], &nj);
+      PROF_PHASE(PHASE_SYRK);
       dtrtrs_(&cL, trL2, &cN, &na, &nn, fws+nj*nn+nn, &nj, blkval+blkptr[k]+nn, &nj, &info);
-      if (info) return info;
+      if (info) { PROF_ABORT(PHASE_TRSM, nup, U-upd); return info; }
       for (j=0;j<nn;j++) dscal_(&na, &dNegOne, blkval+blkptr[k] + j*nj + nn, &iOne);
+      PROF_PHASE(PHASE_TRSM);
+      PROF_FLOPS(2.0*na*(double)na*nn + na*(double)nn*nn);
     }
 
     // factorize inv(D_{Nk,Nk}) as R*R' so that D_{Nk,Nk} = L*L' with L = inv(R)'
-    for (j=0;j<nn;j++) { // reverse-copy
-      for (i=j;i<nn;i++) {
-	fws[(nn-j)*nn-1-i] = blkval[blkptr[k]+j*nj+i];
-      }
-    }
-    dpotrf_(&cU, &nn, fws, &nn, &info);
-    if (info) return info;
-    for (j=0;j<nn;j++) { // reverse-copy
-      for (i=j;i<nn;i++) {
-	blkval[blkptr[k]+j*nj+i] = fws[(nn-j)*nn-1-i];
-      }
-    }
+    info = drpotrf(&nn, blkval+blkptr[k], &nj);
+    if (info) { PROF_ABORT(PHASE_FACTOR, nup, U-upd); return info; }
 
     // compute L = inv(R')
     dtrtri_(&cL, &cN, &nn, blkval+blkptr[k], &nj, &info);
+    PROF_PHASE(PHASE_FACTOR);
+    PROF_FLOPS(2.0*nn*(double)nn*nn/3.0);
+    PROF_END(nup, U-upd);
     if (info) return info;
   }
   return 0;
@@ -0,0 +1,271 @@
+#include <stdlib.h>
+#include "chompack.h"
+
+/*
+  Clique conversion of a sparse semidefinite block. The block-diagonal
+  representation stores clique k as a dense wk-by-wk matrix at offset
+  boff[k] = sum_{l<k} wl^2, where wk = sncolptr[k+1]-sncolptr[k].
+*/
+
+void block_offsets(const int_t nsn, const int_t *sncolptr, int_t * restrict boff) {
+  int_t k,wk;
+  boff[0] = 0;
+  for (k=0;k<nsn;k++) {
+    wk = sncolptr[k+1]-sncolptr[k];
+    boff[k+1] = boff[k] + wk*wk;
+  }
+}
+
+static int_t block_index(const int_t ii, const int_t jj, const int_t *colsn, const int_t *sncolptr,
+			 const int_t *snrowidx, const int_t *boff, int_t *up) {
+  /*
+    Returns the block-diagonal index of the entry (ii,jj), ii >= jj, of
+    the reordered filled pattern, and the index of its transpose in up.
+    Returns -1 if (ii,jj) is not in the filled pattern.
+   */
+  int_t k,wk,lo,hi,mid,j;
+  k = colsn[jj];
+  wk = sncolptr[k+1]-sncolptr[k];
+  lo = sncolptr[k]; hi = sncolptr[k+1];
+  while (lo < hi) {
+    mid = lo + (hi-lo)/2;
+    if (snrowidx[mid] < ii) lo = mid+1;
+    else hi = mid;
+  }
+  if (lo == sncolptr[k+1] || snrowidx[lo] != ii) return -1;
+  lo -= sncolptr[k];
+  j = jj - snrowidx[sncolptr[k]];
+  *up = boff[k] + lo*wk + j;
+  return boff[k] + j*wk + lo;
+}
+
+int_t block_convert(const int_t dim, const int_t m, const int_t *colptr, const int_t *rowidx,
+		    const double *val, const int cplx, const int_t *ip, const int_t *colsn,
+		    const int_t *sncolptr, const int_t *snrowidx, const int_t *boff,
+		    int_t * restrict I, int_t * restrict J, double * restrict V) {
+  /*
+    Converts the columns of a dim^2-by-m sparse matrix (each column is a
+    vectorized dim-by-dim symmetric/Hermitian matrix of which only the
+    lower triangular part is accessed) to the block-diagonal
+    representation. The triplets are written to I, J, and V (V has
+    stride 2 if cplx is nonzero, i.e., interleaved real and imaginary
+    parts); I, J, and V must be of length at least 2*colptr[m].
+
+    Returns the number of triplets, or -(t+1) if the t'th nonzero is
+    not in the filled pattern.
+   */
+  int_t c,t,r,s,k1,k2,lo,up,cnt = 0;
+  int inc = cplx ? 2 : 1;
+  double re,im;
+
+  for (c=0;c<m;c++) {
+    for (t=colptr[c];t<colptr[c+1];t++) {
+      r = rowidx[t] % dim;
+      s = rowidx[t] / dim;
+      if (r < s) continue;    // ignore upper triangular entries
+      k1 = ip[r];
+      k2 = ip[s];
+      lo = block_index((k1 > k2) ? k1 : k2, (k1 > k2) ? k2 : k1, colsn, sncolptr, snrowidx, boff, &up);
+      if (lo < 0) return -(t+1);
+      re = val[inc*t];
+      im = cplx ? val[inc*t+1] : 0.0;
+      I[cnt] = lo; J[cnt] = c;
+      V[inc*cnt] = re;
+      if (cplx) V[inc*cnt+1] = (k1 >= k2) ? im : -im;
+      cnt++;
+      if (k1 != k2) {
+	I[cnt] = up; J[cnt] = c;
+	V[inc*cnt] = re;
+	if (cplx) V[inc*cnt+1] = (k1 > k2) ? -im : im;
+	cnt++;
+      }
+    }
+  }
+  return cnt;
+}
+
+static int_t coupling_emit(int_t cnt, const int_t ncon, const int_t i1, const int_t j1, const int_t i2, const int_t j2,
+			   const int cplx, int_t * restrict I, int_t * restrict J, double * restrict V, int_t *nc) {
+  /*
+    Adds the coupling constraint(s) that equate the block entries i1
+    (and i2) with j1 (and j2). If I is NULL, the triplets are only
+    counted.
+   */
+  int inc = cplx ? 2 : 1, l;
+  int_t idx[4] = {i1, i2, j1, j2};
+  double re[4] = {1.0, 1.0, -1.0, -1.0}, im[4] = {1.0, -1.0, -1.0, 1.0};
+
+  if (i2 < 0) {   // diagonal entry
+    if (I) {
+      I[cnt] = i1; J[cnt] = ncon; V[inc*cnt] = 1.0;
+      I[cnt+1] = j1; J[cnt+1] = ncon; V[inc*cnt+inc] = -1.0;
+      if (cplx) { V[inc*cnt+1] = 0.0; V[inc*cnt+inc+1] = 0.0; }
+    }
+    *nc = 1;
+    return cnt+2;
+  }
+  if (I) {
+    for (l=0;l<4;l++) {
+      I[cnt+l] = idx[l]; J[cnt+l] = ncon; V[inc*(cnt+l)] = re[l];
+      if (cplx) V[inc*(cnt+l)+1] = 0.0;
+    }
+    if (cplx) {
+      for (l=0;l<4;l++) {
+	I[cnt+4+l] = idx[l]; J[cnt+4+l] = ncon+1;
+	V[inc*(cnt+4+l)] = 0.0; V[inc*(cnt+4+l)+1] = im[l];
+      }
+    }
+  }
+  *nc = cplx ? 2 : 1;
+  return cnt + (cplx ? 8 : 4);
+}
+
+int_t block_coupling(const int_t nsn, const int_t *snptr, const int_t *snpar, const int_t *sncolptr,
+		     const int_t *snrowidx, const int_t *relptr, const int_t *relidx, const int_t *boff,
+		     const int_t *ccolptr, const int_t *crowidx, const int cplx,
+		     int_t * restrict I, int_t * restrict J, double * restrict V, int_t *ncon) {
+  /*
+    Computes the coupling constraints between each clique and its parent
+    clique as triplets (I, J, V) of a sparse matrix with one column per
+    constraint. If ccolptr/crowidx is NULL, all entries of the separator
+    blocks are coupled (full coupling); otherwise only the entries that
+    are in the lower triangular (reordered) coupling pattern are
+    coupled. If I is NULL, the number of triplets is returned without
+    writing the triplets.
+
+    On exit, ncon is the number of constraints.
+   */
+  int_t k,p,nk,wk,wp,na,i,j,t,lo,hi,mid,c,nc,cnt = 0;
+  const int_t *ri, *rows;
+
+  *ncon = 0;
+  for (k=0;k<nsn;k++) {
+    p = snpar[k];
+    if (p == k || p < 0) continue;   // skip root supernodes
+    nk = snptr[k+1]-snptr[k];
+    wk = sncolptr[k+1]-sncolptr[k];
+    wp = sncolptr[p+1]-sncolptr[p];
+    na = wk-nk;
+    ri = relidx + relptr[k];
+    rows = snrowidx + sncolptr[k] + nk;   // separator
+
+    for (j=0;j<na;j++) {
+      if (ccolptr == NULL) {
+	for (i=j;i<na;i++) {
+	  cnt = coupling_emit(cnt, *ncon,
+			      boff[k] + (j+nk)*wk + i+nk, boff[p] + ri[j]*wp + ri[i],
+			      (i == j) ? -1 : boff[k] + (i+nk)*wk + j+nk, boff[p] + ri[i]*wp + ri[j],
+			      cplx, I, J, V, &nc);
+	  *ncon += nc;
+	}
+      }
+      else {
+	c = rows[j];
+	for (t=ccolptr[c];t<ccolptr[c+1];t++) {
+	  if (crowidx[t] < c) continue;
+	  // find crowidx[t] in separator
+	  lo = j; hi = na;
+	  while (lo < hi) {
+	    mid = lo + (hi-lo)/2;
+	    if (rows[mid] < crowidx[t]) lo = mid+1;
+	    else hi = mid;
+	  }
+	  if (lo == na || rows[lo] != crowidx[t]) continue;
+	  i = lo;
+	  cnt = coupling_emit(cnt, *ncon,
+			      boff[k] + (j+nk)*wk + i+nk, boff[p] + ri[j]*wp + ri[i],
+			      (i == j) ? -1 : boff[k] + (i+nk)*wk + j+nk, boff[p] + ri[i]*wp + ri[j],
+			      cplx, I, J, V, &nc);
+	  *ncon += nc;
+	}
+      }
+    }
+  }
+  return cnt;
+}
+
+typedef struct {
+  int_t i, b;
+} idxpair;
+
+static int idxpair_cmp(const void *x, const void *y) {
+  int_t a = ((const idxpair *) x)->i, b = ((const idxpair *) y)->i;
+  return (a > b) - (a < b);
+}
+
+int_t block_to_sparse(const int_t n, const int_t nsn, const int_t *snptr, const int_t *sncolptr,
+		      const int_t *snrowidx, const int_t *boff, const int_t *p,
+		      int_t * restrict blki, int_t * restrict I, int_t * restrict J) {
+  /*
+    Computes the map from the block-diagonal representation to the
+    lower triangular part of the filled pattern in the original
+    ordering: entry l is (I[l],J[l]) and it is stored at blki[l] in the
+    block-diagonal representation. The entries are sorted in
+    column-major order.
+
+    Returns the number of entries, or -1 if memory allocation fails. If
+    blki is NULL, the number of entries is returned without computing
+    the map.
+   */
+  int_t k,nk,wk,i,j,l,r,s,cnt;
+  int_t *colptr;
+  idxpair *pr;
+
+  cnt = 0;
+  for (k=0;k<nsn;k++) {
+    nk = snptr[k+1]-snptr[k];
+    wk = sncolptr[k+1]-sncolptr[k];
+    cnt += nk*wk - nk*(nk-1)/2;
+  }
+  if (blki == NULL) return cnt;
+  if (!(colptr = calloc(n+1,sizeof(int_t)))) return -1;
+  if (!(pr = malloc((cnt+1)*sizeof(idxpair)))) {
+    free(colptr);
+    return -1;
+  }
+
+  // count entries in each column (original ordering)
+  for (k=0;k<nsn;k++) {
+    nk = snptr[k+1]-snptr[k];
+    wk = sncolptr[k+1]-sncolptr[k];
+    for (j=0;j<nk;j++) {
+      for (i=j;i<wk;i++) {
+	r = p[snrowidx[sncolptr[k]+i]];
+	s = p[snrowidx[sncolptr[k]+j]];
+	colptr[((r < s) ? r : s)+1] += 1;
+      }
+    }
+  }
+  for (j=0;j<n;j++) colptr[j+1] += colptr[j];
+
+  // scatter entries to columns
+  for (k=0;k<nsn;k++) {
+    nk = snptr[k+1]-snptr[k];
+    wk = sncolptr[k+1]-sncolptr[k];
+    for (j=0;j<nk;j++) {
+      for (i=j;i<wk;i++) {
+	r = p[snrowidx[sncolptr[k]+i]];
+	s = p[snrowidx[sncolptr[k]+j]];
+	l = colptr[(r < s) ? r : s]++;
+	pr[l].i = (r > s) ? r : s;
+	pr[l].b = boff[k] + j*wk + i;
+      }
+    }
+  }
+  for (j=n;j>0;j--) colptr[j] = colptr[j-1];
+  colptr[0] = 0;
+
+  // sort each column by row index
+  for (j=0;j<n;j++) {
+    qsort(pr+colptr[j], colptr[j+1]-colptr[j], sizeof(idxpair), idxpair_cmp);
+    for (l=colptr[j];l<colptr[j+1];l++) {
+      blki[l] = pr[l].b;
+      I[l] = pr[l].i;
+      J[l] = j;
+    }
+  }
+
+  free(colptr);
+  free(pr);
+  return cnt;
+}
@@ -1,3 +1,4 @@
+#include <string.h>
 #include "chompack.h"
 
 double dot(int_t *Nsn, int_t *snptr, int_t *sncolptr, int_t *blkptr, double * restrict blkval_x, double * restrict blkval_y) {
@@ -21,3 +22,90 @@ double dot(int_t *Nsn, int_t *snptr, int_t *sncolptr, int_t *blkptr, double * re
   return val;
 }
 
+static void gram_flush(int r, int nr, double alpha, int mx, double * restrict xp, int my, double * restrict yp, double * restrict G, int *ldg) {
+  /*
+    G := G + alpha*Xp'*Yp where Xp and Yp are the leading r rows of the
+    nr-by-mx and nr-by-my panels (lower triangle only if yp is NULL,
+    i.e., Yp = Xp)
+   */
+  double dOne = 1.0;
+  char cL='L', cT='T', cN='N';
+  if (r == 0) return;
+  if (yp == NULL)
+    dsyrk_(&cL, &cT, &mx, &r, &alpha, xp, &nr, &dOne, G, ldg);
+  else
+    dgemm_(&cT, &cN, &mx, &my, &r, &alpha, xp, &nr, yp, &nr, &dOne, G, ldg);
+}
+
+void gram(int_t *Nsn, int_t *snptr, int_t *sncolptr, int_t *blkptr,
+	  int mx, double ** xblkval, int my, double ** yblkval,
+	  double * restrict G, int *ldg, double * restrict ws, int nr) {
+  /*
+    Computes the matrix of trace products G[i,j] = tr(X_i*Y_j) where
+    xblkval[i] and yblkval[j] are the block values of cspmatrix objects
+    with a common symbolic factorization. If yblkval is NULL, the
+    symmetric matrix G[i,j] = tr(X_i*X_j) is computed.
+
+    The lower triangular entries are packed into nr-by-mx and nr-by-my
+    panels (ws must be of length at least nr*(mx+my), or nr*mx if
+    yblkval is NULL) such that
+
+       G = 2*Xo'*Yo + Xd'*Yd
+
+    where the rows of Xo/Yo are the strictly lower triangular entries
+    and the rows of Xd/Yd are the diagonal entries.
+   */
+  int i,r,pass,len;
+  int_t j,k,offset,nk,ck,pos;
+  double * restrict xp = ws, * restrict yp = NULL;
+
+  if (yblkval) yp = ws + ((int_t) nr)*mx;
+
+  for (j=0;j<my;j++) {
+    for (i=0;i<mx;i++) G[j*(*ldg)+i] = 0.0;
+  }
+
+  for (pass=0;pass<2;pass++) {  // pass 0: diagonal entries, pass 1: strictly lower entries
+    r = 0;
+    for (k=0;k<*Nsn;k++) {
+      offset = blkptr[k];
+      nk = snptr[k+1]-snptr[k];
+      ck = sncolptr[k+1]-sncolptr[k];
+      for (j=0;j<nk;j++) {
+	if (pass == 0) {
+	  for (i=0;i<mx;i++) xp[i*nr+r] = xblkval[i][offset];
+	  if (yp) for (i=0;i<my;i++) yp[i*nr+r] = yblkval[i][offset];
+	  if (++r == nr) {
+	    gram_flush(r, nr, 1.0, mx, xp, my, yp, G, ldg);
+	    r = 0;
+	  }
+	}
+	else {
+	  // copy column segment, possibly split across panels
+	  pos = offset + 1;
+	  while (pos < offset + ck - j) {
+	    len = (int) (offset + ck - j - pos);
+	    if (len > nr - r) len = nr - r;
+	    for (i=0;i<mx;i++) memcpy(xp+i*nr+r, xblkval[i]+pos, len*sizeof(double));
+	    if (yp) for (i=0;i<my;i++) memcpy(yp+i*nr+r, yblkval[i]+pos, len*sizeof(double));
+	    r += len;
+	    pos += len;
+	    if (r == nr) {
+	      gram_flush(r, nr, 2.0, mx, xp, my, yp, G, ldg);
+	      r = 0;
+	    }
+	  }
+	}
+	offset += ck + 1;
+      }
+    }
+    gram_flush(r, nr, (pass == 0) ? 1.0 : 2.0, mx, xp, my, yp, G, ldg);
+  }
+
+  // symmetrize
+  if (yp == NULL) {
+    for (j=0;j<mx;j++) {
+      for (i=j+1;i<mx;i++) G[i*(*ldg)+j] = G[j*(*ldg)+i];
+    }
+  }
+}
@@ -0,0 +1,65 @@
+#include <math.h>
+#include "chompack.h"
+
+#define NB 32
+
+static void dpotf2_reg(const int n, double * restrict a, const int lda, cholesky_reg *reg, const int_t col) {
+  /*
+    Unblocked right-looking Cholesky factorization with dynamic
+    regularization of the pivots (see dpotrf_reg()).
+   */
+  int i,j,k;
+  double ajj,d,c;
+
+  for (j=0;j<n;j++) {
+    ajj = a[j*lda+j];
+    if (!(ajj > reg->tol)) {
+      d = (-ajj > reg->delta) ? -ajj : reg->delta;
+      reg->col[reg->npert] = col + j;
+      reg->val[reg->npert++] = d - ajj;
+      ajj = d;
+    }
+    ajj = sqrt(ajj);
+    a[j*lda+j] = ajj;
+    ajj = 1.0/ajj;
+    for (i=j+1;i<n;i++) a[j*lda+i] *= ajj;
+    for (k=j+1;k<n;k++) {
+      c = a[j*lda+k];
+      for (i=k;i<n;i++) a[k*lda+i] -= a[j*lda+i]*c;
+    }
+  }
+}
+
+void dpotrf_reg(const int n, double * restrict a, const int lda, cholesky_reg *reg, const int_t col) {
+  /*
+    Computes a lower triangular matrix L such that A + E = L*L', where
+    E is diagonal: a pivot d that is not greater than reg->tol (after
+    the updates from the preceding columns) is replaced by
+    max(reg->delta, -d). (Replacing a large negative pivot by delta
+    would make the following pivots more negative and the entries of L
+    grow without bound.) The column (col + j for column j of A) and
+    the perturbation E[j,j] = max(reg->delta, -d) - d are appended to
+    reg->col and reg->val. Only the lower triangular part of A is
+    referenced, and on exit it is overwritten by L. The factorization
+    cannot fail if reg->delta > 0.
+   */
+  int j0,jb,m;
+  double dOne=1.0,dNegOne=-1.0;
+  char cL='L',cN='N',cR='R',cT='T';
+
+  for (j0=0;j0<n;j0+=jb) {
+    jb = (n-j0 < NB) ? n-j0 : NB;
+    m = n-j0-jb;
+
+    // A_{11} := A_{11} - L_{10}*L_{10}' and factor it
+    dsyrk_(&cL, &cN, &jb, &j0, &dNegOne, a+j0, (int *) &lda, &dOne, a+j0*lda+j0, (int *) &lda);
+    dpotf2_reg(jb, a+j0*lda+j0, lda, reg, col+j0);
+
+    if (m > 0) {
+      // L_{21} := (A_{21} - L_{20}*L_{10}')*inv(L_{11}')
+      dgemm_(&cN, &cT, &m, &jb, &j0, &dNegOne, a+j0+jb, (int *) &lda, a+j0, (int *) &lda,
+	     &dOne, a+j0*lda+j0+jb, (int *) &lda);
+      dtrsm_(&cR, &cL, &cT, &cN, &m, &jb, &dOne, a+j0*lda+j0, (int *) &lda, a+j0*lda+j0+jb, (int *) &lda);
+    }
+  }
+}
@@ -0,0 +1,66 @@
+#include <math.h>
+#include "chompack.h"
+
+#define NB 32
+
+static int drpotf2(const int n, double * restrict a, const int lda) {
+  /*
+    Unblocked reverse Cholesky factorization A = L'*L; rows of L are
+    computed bottom-up.
+   */
+  int j,m,iOne=1;
+  double ajj,dOne=1.0,dNegOne=-1.0;
+  char cT='T';
+
+  for (j=n-1;j>=0;j--) {
+    m = n-1-j;
+    ajj = a[j*lda+j];
+    if (m > 0) ajj -= ddot_(&m, a+j*lda+j+1, &iOne, a+j*lda+j+1, &iOne);
+    if (!(ajj > 0.0)) return j+1;
+    ajj = sqrt(ajj);
+    a[j*lda+j] = ajj;
+
+    // compute L_{j,0:j} := (A_{j,0:j} - L_{j+1:n,j}'*L_{j+1:n,0:j})/L_{j,j}
+    if (j > 0) {
+      if (m > 0)
+	dgemv_(&cT, &m, &j, &dNegOne, a+j+1, (int *) &lda, a+j*lda+j+1, &iOne, &dOne, a+j, (int *) &lda);
+      ajj = 1.0/ajj;
+      dscal_(&j, &ajj, a+j, (int *) &lda);
+    }
+  }
+  return 0;
+}
+
+int drpotrf(const int *n, double * restrict a, const int *lda) {
+  /*
+    Computes a lower triangular matrix L such that A = L'*L, i.e., a
+    Cholesky factorization that proceeds from the bottom-right corner
+    of A. Only the lower triangular part of A is referenced, and on
+    exit it is overwritten by L. This is equivalent to reversing the
+    rows and columns of A, calling dpotrf with uplo = 'U', and reversing
+    the result, but no data is moved.
+
+    Returns 0 on success, and otherwise the (one-based) index of the
+    column in which a nonpositive pivot was encountered.
+   */
+  int k,jb,j0,info;
+  double dOne=1.0,dNegOne=-1.0;
+  char cL='L',cT='T',cN='N';
+
+  for (k=*n;k>0;k-=jb) {
+    jb = (k < NB) ? k : NB;
+    j0 = k - jb;
+
+    // factor trailing diagonal block A_{22} = L_{22}'*L_{22}
+    info = drpotf2(jb, a+j0*(*lda)+j0, *lda);
+    if (info) return info + j0;
+
+    if (j0 > 0) {
+      // L_{21} := inv(L_{22})'*A_{21}
+      dtrsm_(&cL, &cL, &cT, &cN, &jb, &j0, &dOne, a+j0*(*lda)+j0, (int *) lda, a+j0, (int *) lda);
+      // A_{11} := A_{11} - L_{21}'*L_{21}
+      dsyrk_(&cL, &cT, &j0, &jb, &dNegOne, a+j0, (int *) lda, &dOne, a, (int *) lda);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include "chompack.h"
+
+/*
+  Export of a cspmatrix to compressed column storage (CSC).
+
+  The stored entries are the lower triangle of the reordered matrix:
+  column i of supernode k is column j = snode[snptr[k]+i], with rows
+  snrowidx[sncolptr[k]+i:sncolptr[k+1]] and values
+  blkval[blkptr[k]+nj*i+i:blkptr[k]+nj*(i+1)]. An entry (r,j) is
+  placed at (p[r],p[j]) (at (r,j) if p is NULL) and then in the lower
+  triangle (uplo = 'L'), the upper triangle (uplo = 'U'), or both
+  triangles (uplo = 'S') of the result.
+ */
+
+#define CSC_TARGET(a, b, row, col) {		\
+    if (uplo == 'U') {				\
+      row = (a < b) ? a : b; col = (a < b) ? b : a; \
+    } else {					\
+      row = (a < b) ? b : a; col = (a < b) ? a : b; \
+    }						\
+  }
+
+int_t csc_colptr(const int_t n, const int_t nsn, const int_t *snptr, const int_t *snode,
+		 const int_t *sncolptr, const int_t *snrowidx, const int_t *p, const char uplo,
+		 int_t * restrict colptr) {
+  /*
+    Computes the column pointer (length n+1) of the CSC export and
+    returns the number of nonzeros.
+   */
+  int_t k, i, t, a, b, row, col;
+
+  for (i=0;i<=n;i++) colptr[i] = 0;
+  for (k=0;k<nsn;k++) {
+    for (i=0;i<snptr[k+1]-snptr[k];i++) {
+      b = snode[snptr[k]+i];
+      if (p) b = p[b];
+      for (t=sncolptr[k]+i;t<sncolptr[k+1];t++) {
+	a = p ? p[snrowidx[t]] : snrowidx[t];
+	CSC_TARGET(a, b, row, col);
+	colptr[col+1]++;
+	if (uplo == 'S' && row != col) colptr[row+1]++;
+      }
+    }
+  }
+  for (i=0;i<n;i++) colptr[i+1] += colptr[i];
+  return colptr[n];
+}
+
+static void sort_column(const int_t m, int_t * restrict ri, double * restrict v) {
+  /*
+    Sorts (ri, v) by row index in place (heapsort) unless it is already
+    sorted.
+   */
+  int_t i, j, k, nh, r;
+  double x;
+
+  for (i=1;i<m;i++) if (ri[i] < ri[i-1]) break;
+  if (i >= m) return;
+
+  for (nh=m, k=m/2-1; ; ) {
+    if (k >= 0) i = k--;               // build heap
+    else if (--nh > 0) {               // move maximum to the end
+      r = ri[0]; ri[0] = ri[nh]; ri[nh] = r;
+      x = v[0]; v[0] = v[nh]; v[nh] = x;
+      i = 0;
+    }
+    else break;
+    // sift down
+    r = ri[i]; x = v[i];
+    while ((j = 2*i+1) < nh) {
+      if (j+1 < nh && ri[j+1] > ri[j]) j++;
+      if (ri[j] <= r) break;
+      ri[i] = ri[j]; v[i] = v[j];
+      i = j;
+    }
+    ri[i] = r; v[i] = x;
+  }
+}
+
+void csc_fill(const int_t n, const int_t nsn, const int_t *snptr, const int_t *snode,
+	      const int_t *sncolptr, const int_t *snrowidx, const int_t *blkptr, const int_t *p,
+	      const char uplo, const int factor, double * restrict blkval, const int_t c0, const int_t c1,
+	      const int_t *colptr, int_t * restrict rowidx, double * restrict val,
+	      int_t * restrict pos, double * restrict ws) {
+  /*
+    Fills columns c0 to c1-1 of the CSC export, with the column pointer
+    computed by csc_colptr(). The row indices and values of column c
+    are stored in rowidx and val at positions colptr[c]-colptr[c0] to
+    colptr[c+1]-colptr[c0]-1, so the buffers must be of length at least
+    colptr[c1]-colptr[c0]. The row indices in each column are sorted.
+
+    If factor is nonzero, blkval is a Cholesky factor (as computed by
+    cholesky()), and the subdiagonal block of each supernode is
+    multiplied by the diagonal block to obtain L_{Ak,Nk} (ws must then
+    be of length at least clique_number^2). pos is a workspace of
+    length c1-c0.
+
+    Each call scans the index structure; supernodes that contribute no
+    entries to the column range are skipped without reading blkval
+    when p is NULL.
+   */
+  int_t k, i, t, a, b, row, col, lo, hi, f0, f1;
+  int nn, na, nj;
+  double dOne=1.0, v;
+  const double *Lk;
+  char cR='R', cL='L', cN='N';
+
+  for (i=c0;i<c1;i++) pos[i-c0] = colptr[i]-colptr[c0];
+
+  for (k=0;k<nsn;k++) {
+    nn = (int) (snptr[k+1]-snptr[k]);
+    nj = (int) (sncolptr[k+1]-sncolptr[k]);
+    na = nj-nn;
+
+    if (!p) {
+      // target columns: the columns of supernode k ('L'), its rows ('U'), or both ('S')
+      f0 = snode[snptr[k]]; f1 = f0;
+      for (i=0;i<nn;i++) {
+	t = snode[snptr[k]+i];
+	if (t < f0) f0 = t;
+	if (t > f1) f1 = t;
+      }
+      lo = f0; hi = f1;
+      for (t=sncolptr[k];t<sncolptr[k+1];t++) {
+	if (snrowidx[t] < lo) lo = snrowidx[t];
+	if (snrowidx[t] > hi) hi = snrowidx[t];
+      }
+      if (uplo == 'L' && (f1 < c0 || f0 >= c1)) continue;
+      if (uplo != 'L' && (hi < c0 || lo >= c1)) continue;
+    }
+
+    Lk = blkval+blkptr[k]+nn;
+    if (factor && na > 0) {
+      // L_{Ak,Nk} := L_{Ak,Nk}*L_{Nk,Nk}
+      for (i=0;i<nn;i++)
+	for (t=0;t<na;t++) ws[i*na+t] = blkval[blkptr[k]+i*nj+nn+t];
+      dtrmm_(&cR, &cL, &cN, &cN, &na, &nn, &dOne, blkval+blkptr[k], &nj, ws, &na);
+      Lk = ws;
+    }
+
+    for (i=0;i<nn;i++) {
+      b = snode[snptr[k]+i];
+      if (p) b = p[b];
+      for (t=i;t<nj;t++) {
+	a = snrowidx[sncolptr[k]+t];
+	if (p) a = p[a];
+	CSC_TARGET(a, b, row, col);
+	if ((col < c0 || col >= c1) && (uplo != 'S' || row < c0 || row >= c1)) continue;
+	v = (t < nn) ? blkval[blkptr[k]+i*nj+t] : Lk[(factor && na > 0) ? i*na+t-nn : i*nj+t-nn];
+	if (col >= c0 && col < c1) {
+	  rowidx[pos[col-c0]] = row;
+	  val[pos[col-c0]++] = v;
+	}
+	if (uplo == 'S' && row != col && row >= c0 && row < c1) {
+	  rowidx[pos[row-c0]] = col;
+	  val[pos[row-c0]++] = v;
+	}
+      }
+    }
+  }
+
+  for (i=c0;i<c1;i++) {
+    t = colptr[i]-colptr[c0];
+    sort_column(colptr[i+1]-colptr[i], rowidx+t, val+t);
+  }
+}
@@ -0,0 +1,151 @@
+#include <stdlib.h>
+#include "chompack.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+  Tiled partial Cholesky factorization of a frontal matrix for large
+  fronts. The dense operations of cholesky() on the nj-by-nj frontal
+  matrix F = [F11 F21'; F21 F22] (with F11 of order nn),
+
+     F11 := L11 = chol(F11)
+     F21 := F21*inv(L11')
+     F22 := F22 - F21*F21'
+     F21 := F21*inv(L11)
+
+  are split into tasks on nb-by-nb tiles (the tiles are aligned with
+  the partitioning of F) with OpenMP task dependencies. If called from
+  within a parallel region, the tasks are created in the enclosing
+  team, so the front shares the threads of a tree-level scheduler;
+  otherwise a team of nthreads threads is created. Without OpenMP, the
+  tasks are executed in order.
+*/
+
+#define T(i,j) (F + off[j]*ldf + off[i])
+
+static void front_tasks(const int nt1, const int nt, const int *off, double *F, int ldf, char *dep, int *info) {
+  /*
+    Creates the tasks of the factorization. dep[j*nt+i] represents
+    tile (i,j); tiles 0, ..., nt1-1 cover the columns of F11.
+   */
+  int i, j, k;
+
+  for (k=0; k<nt1; k++) {
+#ifdef _OPENMP
+    #pragma omp task depend(inout: dep[k*nt+k])
+#endif
+    {
+      int nk = off[k+1]-off[k], inf = 0;
+      char cL = 'L';
+      dpotrf_(&cL, &nk, T(k,k), &ldf, &inf);
+      if (inf) {
+	// the first failing column over all diagonal tiles
+#ifdef _OPENMP
+	#pragma omp critical (front_info)
+#endif
+	if (!*info || off[k] + inf < *info) *info = off[k] + inf;
+      }
+    }
+    for (i=k+1; i<nt; i++) {
+#ifdef _OPENMP
+      #pragma omp task depend(in: dep[k*nt+k]) depend(inout: dep[k*nt+i])
+#endif
+      {
+	int ni = off[i+1]-off[i], nk = off[k+1]-off[k];
+	double dOne = 1.0;
+	char cR = 'R', cL = 'L', cT = 'T', cN = 'N';
+	dtrsm_(&cR, &cL, &cT, &cN, &ni, &nk, &dOne, T(k,k), &ldf, T(i,k), &ldf);
+      }
+    }
+    for (j=k+1; j<nt; j++) {
+#ifdef _OPENMP
+      #pragma omp task depend(in: dep[k*nt+j]) depend(inout: dep[j*nt+j])
+#endif
+      {
+	int nj = off[j+1]-off[j], nk = off[k+1]-off[k];
+	double dOne = 1.0, dNegOne = -1.0;
+	char cL = 'L', cN = 'N';
+	dsyrk_(&cL, &cN, &nj, &nk, &dNegOne, T(j,k), &ldf, &dOne, T(j,j), &ldf);
+      }
+      for (i=j+1; i<nt; i++) {
+#ifdef _OPENMP
+	#pragma omp task depend(in: dep[k*nt+i], dep[k*nt+j]) depend(inout: dep[j*nt+i])
+#endif
+	{
+	  int ni = off[i+1]-off[i], nj = off[j+1]-off[j], nk = off[k+1]-off[k];
+	  double dOne = 1.0, dNegOne = -1.0;
+	  char cN = 'N', cT = 'T';
+	  dgemm_(&cN, &cT, &ni, &nj, &nk, &dNegOne, T(i,k), &ldf, T(j,k), &ldf, &dOne, T(i,j), &ldf);
+	}
+      }
+    }
+  }
+
+  // F21 := F21*inv(L11), one block row of F21 at a time (backward over
+  // the block columns of L11)
+  for (i=nt1; i<nt; i++) {
+    for (k=nt1-1; k>=0; k--) {
+      for (j=k+1; j<nt1; j++) {
+#ifdef _OPENMP
+	#pragma omp task depend(in: dep[j*nt+i], dep[k*nt+j]) depend(inout: dep[k*nt+i])
+#endif
+	{
+	  int ni = off[i+1]-off[i], nj = off[j+1]-off[j], nk = off[k+1]-off[k];
+	  double dOne = 1.0, dNegOne = -1.0;
+	  char cN = 'N';
+	  dgemm_(&cN, &cN, &ni, &nk, &nj, &dNegOne, T(i,j), &ldf, T(j,k), &ldf, &dOne, T(i,k), &ldf);
+	}
+      }
+#ifdef _OPENMP
+      #pragma omp task depend(in: dep[k*nt+k]) depend(inout: dep[k*nt+i])
+#endif
+      {
+	int ni = off[i+1]-off[i], nk = off[k+1]-off[k];
+	double dOne = 1.0;
+	char cR = 'R', cL = 'L', cN = 'N';
+	dtrsm_(&cR, &cL, &cN, &cN, &ni, &nk, &dOne, T(k,k), &ldf, T(i,k), &ldf);
+      }
+    }
+  }
+#ifdef _OPENMP
+  #pragma omp taskwait
+#endif
+}
+
+int front_cholesky(const int nn, const int nj, double * restrict F, const int ldf, const int nb, const int nthreads) {
+  /*
+    Tiled factorization of the frontal matrix F (see above). Returns 0
+    on success, the dpotrf info value (relative to the first column of
+    F) if F11 is not positive definite, and -1 if memory allocation
+    fails.
+   */
+  int k, nt1, nt, info = 0, *off;
+  char *dep;
+
+  nt1 = (nn + nb - 1)/nb;
+  nt = nt1 + (nj - nn + nb - 1)/nb;
+  if (!(off = malloc((nt+1)*sizeof(int)))) return -1;
+  if (!(dep = malloc(nt*nt))) {
+    free(off);
+    return -1;
+  }
+  for (k=0; k<nt1; k++) off[k] = k*nb;
+  for (k=nt1; k<nt; k++) off[k] = nn + (k-nt1)*nb;
+  off[nt] = nj;
+
+#ifdef _OPENMP
+  if (omp_in_parallel())
+    front_tasks(nt1, nt, off, F, ldf, dep, &info);
+  else {
+    #pragma omp parallel num_threads(nthreads)
+    #pragma omp single
+    front_tasks(nt1, nt, off, F, ldf, dep, &info);
+  }
+#else
+  front_tasks(nt1, nt, off, F, ldf, dep, &info);
+#endif
+
+  free(off); free(dep);
+  return info;
+}
@@ -0,0 +1,55 @@
+/*
+ * Scalar and index types of the type-generic kernels cholesky.c,
+ * trsm.c, projected_inverse.c and small.h.
+ *
+ * By default, the kernels are compiled in double precision with int_t
+ * index arrays, under the names declared in chompack.h. libchompack
+ * also compiles them with CHOMPACK_SINGLE (float values) and/or
+ * CHOMPACK_INDEX32 (int32_t index arrays; blkptr and the stack sizes
+ * upd_size remain int_t) defined, with the names suffixed by _s, _d32
+ * or _s32 (see kernels_s.c, kernels_d32.c and kernels_s32.c). These are
+ * the kernels of the C++ interface (chompack.hpp). Dynamic
+ * regularization and the tiled factorization of large fronts in
+ * cholesky() are available in double precision only.
+ */
+
+#ifndef __CHOMPACK_GENERIC__
+#define __CHOMPACK_GENERIC__
+
+#ifdef CHOMPACK_INDEX32
+#include <stdint.h>
+#define index_t int32_t
+#else
+#define index_t int_t
+#endif
+
+#ifdef CHOMPACK_SINGLE
+#define scalar_t float
+#define BLAS(name) s##name##_
+#else
+#define scalar_t double
+#define BLAS(name) d##name##_
+#endif
+
+#if defined(CHOMPACK_SINGLE) && defined(CHOMPACK_INDEX32)
+#define GENERIC(name) name##_s32
+#elif defined(CHOMPACK_SINGLE)
+#define GENERIC(name) name##_s
+#elif defined(CHOMPACK_INDEX32)
+#define GENERIC(name) name##_d32
+#else
+#define GENERIC(name) name
+#endif
+
+#ifdef CHOMPACK_SINGLE
+extern void slacpy_(char *uplo, int *m, int *n, float *A, int *lda, float *B, int *ldb);
+extern void spotrf_(char *uplo, int *n, float *A, int *lda, int *info);
+extern void strtri_(char *uplo, char *diag, int *n, float *A, int *lda, int *info);
+extern void strsm_(char *side, char *uplo, char *transa, char *diag, int *m, int *n, float *alpha, float *A, int *lda, float *B, int *ldb);
+extern void ssymm_(char *side, char *uplo, int *m, int *n, float *alpha, float *A, int *lda, float *B, int *ldb, float *beta, float *C, int *ldc);
+extern void sgemm_(char *transa, char *transb, int *m, int *n, int *k, float *alpha, float *A, int *lda, float *B, int *ldb, float *beta, float *C, int *ldc);
+extern void ssyrk_(char *uplo, char *trans, int *n, int *k, float *alpha, float *A, int *lda, float *beta, float *B, int *ldb);
+extern void ssyr_(char *uplo, int *n, float *alpha, float *x, int *incx, float *A, int *lda);
+#endif
+
+#endif
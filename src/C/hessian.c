@@ -16,10 +16,12 @@ void _Y2K(const int_t n,   // order of matrix
 	  int_t * restrict upd_size,
 	  int inv) {
 
-  int nn,na,nj,offset,i,j,k,ki,l,N,nup=0,uk=0;
+  int nn,na,nj,k,ki,l,N,nup=0,uk=0;
+  int_t offset,i,j;
   double * restrict U, * restrict ublkvalk;
   double dOne=1.0,alpha=-1.0;
   char cL='L',cT='T',cR='R',cN='N';
+  PROF_DECL;
 
   if (inv) alpha = 1.0;
 
@@ -32,6 +34,7 @@ void _Y2K(const int_t n,   // order of matrix
       nn = snptr[k+1]-snptr[k];
       na = relptr[k+1]-relptr[k];
       nj = na + nn;
+      PROF_BEGIN(PROF_HESSIAN_Y2K, k, nn, na);
 
       // copy Ut_{Jk,Nk} to leading columns of fws
       dlacpy_(&cL, &nj, &nn, ublkvalk+blkptr[k], &nj, fws, &nj);
@@ -40,6 +43,7 @@ void _Y2K(const int_t n,   // order of matrix
 	  fws[nj*j+i] = 0.0; // zero out (2,2) block of frontal matrix
 	}
       }
+      PROF_PHASE(PHASE_ASSEMBLY);
 
       if (!inv) {
 	// add update matrices to frontal matrix
@@ -55,6 +59,7 @@ void _Y2K(const int_t n,   // order of matrix
 	    }
 	  }
 	}
+	PROF_PHASE(PHASE_EXTEND_ADD);
       }
 
       if (na > 0) {
@@ -65,6 +70,8 @@ void _Y2K(const int_t n,   // order of matrix
 	dsymm_(&cR, &cL, &na, &nn, &alpha, fws, &nj, lblkval+blkptr[k]+nn, &nj, &dOne, fws+nn, &nj);
 	// F_{Ak,Ak} := F_{Ak,Ak} + alpha*F_{Ak,Nk}*L_{Ak,Nk}'
 	dgemm_(&cN, &cT, &na, &na, &nn, &alpha, fws+nn, &nj, lblkval+blkptr[k]+nn, &nj, &dOne, fws+(nj+1)*nn, &nj);
+	PROF_PHASE(PHASE_SYRK);
+	PROF_FLOPS(4.0*na*(double)na*nn + 2.0*na*(double)nn*nn);
       }
 
       if (inv) {
@@ -81,6 +88,7 @@ void _Y2K(const int_t n,   // order of matrix
 	    }
 	  }
 	}
+	PROF_PHASE(PHASE_EXTEND_ADD);
       }
 
       if (na > 0) {
@@ -92,6 +100,8 @@ void _Y2K(const int_t n,   // order of matrix
 
       // copy the leading nn columns of frontal matrix to Ut
       dlacpy_(&cL, &nj, &nn, fws, &nj, ublkvalk+blkptr[k], &nj);
+      PROF_PHASE(PHASE_COPY);
+      PROF_END(nup, U-upd);
 
     }
   }
@@ -115,10 +125,12 @@ void _M2T(const int_t n,         // order of matrix
 	  int_t * restrict upd_size,
 	  int inv) {
 
-  int nn,na,nj,offset,i,j,k,ki,l,N,nup=0,uk=0;
+  int nn,na,nj,k,ki,l,N,nup=0,uk=0;
+  int_t offset,i,j;
   double * restrict U, * restrict ublkvalk;
   double dOne=1.0,alpha=-1.0;
   char cL='L',cT='T',cN='N';
+  PROF_DECL;
 
   if (inv) alpha = 1.0;
 
@@ -131,6 +143,7 @@ void _M2T(const int_t n,         // order of matrix
       nn = snptr[k+1]-snptr[k];
       na = relptr[k+1]-relptr[k];
       nj = na + nn;
+      PROF_BEGIN(PROF_HESSIAN_M2T, k, nn, na);
 
       // copy Ut_{Jk,Nk} to leading columns of F
       dlacpy_(&cL, &nj, &nn, ublkvalk+blkptr[k], &nj, fws, &nj);
@@ -142,6 +155,7 @@ void _M2T(const int_t n,         // order of matrix
 	U -= upd_size[nup]*upd_size[nup];
 	dlacpy_(&cL, &na, &na, U, &na, fws+(nj+1)*nn, &nj);
       }
+      PROF_PHASE(PHASE_ASSEMBLY);
 
       /*
 	Compute T_{Jk,Nk} (stored in leading columns of fws)
@@ -160,6 +174,7 @@ void _M2T(const int_t n,         // order of matrix
 	  }
 	  U += N*N;
 	}
+	PROF_PHASE(PHASE_EXTEND_ADD);
       }
 
       // if supernode k is not a root node:
@@ -170,10 +185,13 @@ void _M2T(const int_t n,         // order of matrix
 	dsymm_(&cL, &cL, &na, &nn, &alpha, fws+(nj+1)*nn, &nj, lblkval+blkptr[k]+nn, &nj, &dOne, fws+nn, &nj);
 	// F_{Nk,Nk} := F_{Nk,Nk} + alpha*L_{Ak,Nk}'*F_{Ak,Nk}
 	dgemm_(&cT, &cN, &nn, &nn, &na, &alpha, lblkval+blkptr[k]+nn, &nj, fws+nn, &nj, &dOne, fws, &nj);
+	PROF_PHASE(PHASE_SYRK);
+	PROF_FLOPS(4.0*nn*(double)nn*na + 2.0*na*(double)na*nn);
       }
 
       // copy the leading nn columns of frontal matrix to Ut
       dlacpy_(&cL, &nj, &nn, fws, &nj, ublkvalk+blkptr[k], &nj);
+      PROF_PHASE(PHASE_COPY);
 
       if (!inv) {
 	// extract update matrices if supernode k has any children
@@ -188,7 +206,9 @@ void _M2T(const int_t n,         // order of matrix
 	  }
 	  U += N*N;
 	}
+	PROF_PHASE(PHASE_EXTEND_ADD);
       }
+      PROF_END(nup, U-upd);
 
     }
   }
@@ -212,15 +232,18 @@ int _scale(const int_t n,         // order of matrix
 	   double * restrict fws,  // frontal matrix workspace
 	   double * restrict upd,  // update matrix workspace
 	   int_t * restrict upd_size,
+	   double * restrict ws,   // update_factor workspace (only if factored_updates)
 	   int inv,
 	   int adj,
 	   int factored_updates) {
 
-  int nn,na,nj,offset,info,i,j,k,ki,l,N,nup=0,uk=0;
-  double * restrict U, * restrict ublkvalk, * restrict ws=NULL;
+  int nn,na,nj,info,k,ki,l,N,nup=0,uk=0;
+  int_t offset,i,j;
+  double * restrict U, * restrict ublkvalk;
   double dOne=1.0,alpha=-1.0;
   char cL='L',cT='T',cR='R',cN='N';
   char *tr1, *tr2, *tr3=NULL;
+  PROF_DECL;
 
   if (inv) alpha = 1.0;
 
@@ -231,6 +254,7 @@ int _scale(const int_t n,         // order of matrix
     nn = snptr[k+1]-snptr[k];
     na = relptr[k+1]-relptr[k];
     nj = na + nn;
+    PROF_BEGIN(PROF_HESSIAN_SCALE, k, nn, na);
 
     // copy Y_{Jk,Nk} to leading columns of F
     dlacpy_(&cL, &nj, &nn, yblkval+blkptr[k], &nj, fws, &nj);
@@ -247,10 +271,7 @@ int _scale(const int_t n,         // order of matrix
       U -= upd_size[nup]*upd_size[nup];
       dlacpy_(&cL, &na, &na, U, &na, fws+nn*nj+nn, &nj);
     }
-
-    if ((chptr[k+1]-chptr[k]>0) && (factored_updates)) {
-      ws = malloc(na*(na+1)*sizeof(double)); // allocate workspace
-    }
+    PROF_PHASE(PHASE_ASSEMBLY);
 
     // extract update matrices if supernode k has any children
     for (l=chptr[k];l<chptr[k+1];l++) {
@@ -261,10 +282,7 @@ int _scale(const int_t n,         // order of matrix
 
       if (factored_updates) {
 	info = update_factor(relidx+offset, &nn, &na, U, &N, fws, &nj, ws);
-	if (info) {
-	  free(ws);
-	  return info;
-	}
+	if (info) { PROF_ABORT(PHASE_EXTEND_ADD, nup, U-upd); return info; }
       }
       else {
 	/* extract unfactored update */
@@ -276,11 +294,7 @@ int _scale(const int_t n,         // order of matrix
       }
       U += N*N;
     }
-
-    // free workspace if node has any children and factored_updates
-    if ((chptr[k+1]-chptr[k]>0) && (factored_updates)) {
-      free(ws);
-    }
+    PROF_PHASE(PHASE_EXTEND_ADD);
 
     // if supernode k is not a root node:
     if (na > 0) {
@@ -292,7 +306,9 @@ int _scale(const int_t n,         // order of matrix
       else {
 	// factorize Vk
 	dpotrf_(&cL, &na, fws+(nj+1)*nn, &nj, &info);
-	if (info) return info;
+	PROF_PHASE(PHASE_FACTOR);
+	PROF_FLOPS(na*(double)na*na/3.0);
+	if (info) { PROF_ABORT(PHASE_FACTOR, nup, U-upd); return info; }
 	// In this case we have Vk = Lk*Lk'
 	if (adj) tr3 = &cN;
 	else tr3 = &cT;
@@ -340,7 +356,10 @@ int _scale(const int_t n,         // order of matrix
 	  dtrsm_(&cL, &cL, tr3, &cN, &na, &nn, &dOne, fws+(nj+1)*nn, &nj, ublkvalk+blkptr[k]+nn, &nj);
 	}
       }
+      PROF_FLOPS(nj*(double)nn*nn + nn*(double)nn*nn + na*(double)na*nn);
     }
+    PROF_PHASE(PHASE_TRSM);
+    PROF_END(nup, U-upd);
   }
 
   return 0;
@@ -361,14 +380,15 @@ int hessian(const int_t n,
 	    double * restrict fws,
 	    double * restrict upd,
 	    int_t * restrict upd_size,
+	    double * restrict ws,
 	    int inv,
 	    int adj,
 	    int factored_updates) {
 
-  if (adj != inv) _scale(n,nsn,snpost,snptr,relptr,relidx,chptr,chidx,blkptr,lblkval,yblkval,ublkval,fws,upd,upd_size,inv,adj,factored_updates);
+  if (adj != inv) _scale(n,nsn,snpost,snptr,relptr,relidx,chptr,chidx,blkptr,lblkval,yblkval,ublkval,fws,upd,upd_size,ws,inv,adj,factored_updates);
   if (adj) _M2T(n,nsn,snpost,snptr,relptr,relidx,chptr,chidx,blkptr,lblkval,ublkval,fws,upd,upd_size,inv);
   else     _Y2K(n,nsn,snpost,snptr,relptr,relidx,chptr,chidx,blkptr,lblkval,ublkval,fws,upd,upd_size,inv);
-  if (adj == inv) _scale(n,nsn,snpost,snptr,relptr,relidx,chptr,chidx,blkptr,lblkval,yblkval,ublkval,fws,upd,upd_size,inv,adj,factored_updates);
+  if (adj == inv) _scale(n,nsn,snpost,snptr,relptr,relidx,chptr,chidx,blkptr,lblkval,yblkval,ublkval,fws,upd,upd_size,ws,inv,adj,factored_updates);
 
   return 0;
 }
@@ -0,0 +1,12 @@
+/*
+  Double precision variant with 32-bit index arrays of the type-generic
+  kernels (see generic.h): cholesky_d32(), trsm_d32() and
+  projected_inverse_d32(), for libchompack only.
+*/
+
+#ifdef CHOMPACK_NO_PYTHON
+#define CHOMPACK_INDEX32
+#include "cholesky.c"
+#include "trsm.c"
+#include "projected_inverse.c"
+#endif
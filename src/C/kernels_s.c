@@ -0,0 +1,11 @@
+/*
+  Single precision variant of the type-generic kernels (see generic.h):
+  cholesky_s(), trsm_s() and projected_inverse_s(), for libchompack only.
+*/
+
+#ifdef CHOMPACK_NO_PYTHON
+#define CHOMPACK_SINGLE
+#include "cholesky.c"
+#include "trsm.c"
+#include "projected_inverse.c"
+#endif
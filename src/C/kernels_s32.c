@@ -0,0 +1,13 @@
+/*
+  Single precision variant with 32-bit index arrays of the type-generic
+  kernels (see generic.h): cholesky_s32(), trsm_s32() and
+  projected_inverse_s32(), for libchompack only.
+*/
+
+#ifdef CHOMPACK_NO_PYTHON
+#define CHOMPACK_SINGLE
+#define CHOMPACK_INDEX32
+#include "cholesky.c"
+#include "trsm.c"
+#include "projected_inverse.c"
+#endif
@@ -0,0 +1,365 @@
+#include "chompack.h"
+
+/*
+  Supernodal multifrontal LDL' factorization of a symmetric (indefinite
+  or quasidefinite) cspmatrix X,
+
+     X = W D W'
+
+  where W is unit lower triangular with identity diagonal blocks and
+  D = diag(D_1, ..., D_nsn) is block diagonal with one block per
+  supernode. With F the frontal matrix of supernode k,
+
+     D_k = F11,   W_{Ak,Nk} = F21*inv(F11),   U_k = F22 - F21*inv(F11)*F21'.
+
+  D_k is factored as F11 = P L_k T_k L_k' P' (dsytrf, Bunch-Kaufman
+  pivoting within the supernode), so the ordering and the sparsity
+  pattern of the factor are those of cholesky(). In the regularized
+  mode (sign != NULL), F11 is instead factored without pivoting and a
+  pivot d with sign[i]*d < delta, where sign[i] = +1 or -1 is the
+  expected sign of pivot i (e.g. +1 for the primal and -1 for the dual
+  block of a quasidefinite matrix), is replaced by sign[i]*delta.
+
+  On exit, blkval contains the factorization of D_k in the Nk-by-Nk
+  block (as returned by dsytrf) and W_{Ak,Nk} in the Ak-by-Nk block of
+  each supernode, and ipiv contains the dsytrf pivots (relative to the
+  first column of the supernode).
+*/
+
+static int ldl_unpivoted(const int nn, double * restrict F, const int ldf, const int_t * restrict sgn,
+			 const double delta, int * restrict ipiv, int_t * restrict nreg) {
+  /*
+    Right-looking LDL' factorization of F (order nn) with 1x1 pivots and
+    static regularization; sgn[i] is the expected sign of pivot i.
+    Returns 0 on success and k+1 if pivot k is zero.
+   */
+  int i, j, k;
+  double d, c;
+
+  for (k=0; k<nn; k++) {
+    ipiv[k] = k+1;
+    d = F[k*ldf+k];
+    if (sgn[k]*d < delta) {
+      if (delta > 0.0) {
+	d = sgn[k]*delta;
+	(*nreg)++;
+      }
+    }
+    if (d == 0.0) return k+1;
+    F[k*ldf+k] = d;
+    for (j=k+1; j<nn; j++) {
+      c = F[k*ldf+j]/d;
+      for (i=j; i<nn; i++) F[j*ldf+i] -= F[k*ldf+i]*c;
+    }
+    d = 1.0/F[k*ldf+k];
+    for (i=k+1; i<nn; i++) F[k*ldf+i] *= d;
+  }
+  return 0;
+}
+
+static void ldl_inertia(const int nn, const double *F, const int ldf, const int *ipiv, int_t *inertia) {
+  /*
+    Adds the inertia of the block diagonal factor T computed by dsytrf
+    to inertia = {positive, negative, zero}.
+   */
+  int k;
+  double a, b, c, det;
+
+  for (k=0; k<nn; k++) {
+    if (ipiv[k] > 0) {
+      a = F[k*ldf+k];
+      inertia[(a > 0.0) ? 0 : ((a < 0.0) ? 1 : 2)]++;
+    }
+    else {
+      // 2x2 block
+      a = F[k*ldf+k]; b = F[k*ldf+k+1]; c = F[(k+1)*ldf+k+1];
+      det = a*c - b*b;
+      if (det < 0.0) {
+	inertia[0]++; inertia[1]++;
+      }
+      else if (det > 0.0) inertia[(a > 0.0) ? 0 : 1] += 2;
+      else {
+	inertia[2]++;
+	inertia[(a + c > 0.0) ? 0 : ((a + c < 0.0) ? 1 : 2)]++;
+      }
+      k++;
+    }
+  }
+}
+
+int ldl(const int_t n,         // order of matrix
+	const int_t nsn,       // number of supernodes/cliques
+	const int_t *snpost,   // post-ordering of supernodes
+	const int_t *snptr,    // supernode pointer
+	const int_t *snode,    // supernode array
+	const int_t *relptr,
+	const int_t *relidx,
+	const int_t *chptr,
+	const int_t *chidx,
+	const int_t *blkptr,
+	const int_t *p,
+	double * restrict blkval,
+	int_t * restrict ipiv,     // pivots (length n)
+	const int_t *sign,         // expected signs of pivots (original order), or NULL
+	const double delta,        // regularization
+	int_t * restrict inertia,  // {positive, negative, zero}
+	int_t * restrict nreg,     // number of regularized pivots
+	double * restrict fws,     // frontal matrix workspace
+	double * restrict upd,     // update matrix workspace
+	int_t * restrict upd_size,
+	double * restrict work,    // workspace of length lwork >= max(nn*na, 1) over all supernodes
+	const int lwork,
+	int * restrict iws         // integer workspace of length max(nn) over all supernodes
+	) {
+  /*
+    Returns 0 on success, k+1 if the pivot of column k (in the permuted
+    ordering) is zero and the factorization cannot be completed, and -1
+    if lwork is too small. Without sign, a zero pivot in a root
+    supernode is not an error and only shows up in the inertia (dsytrf
+    completes the factorization of a singular block). With sign, every
+    zero pivot is an error, also in a root supernode: the unpivoted
+    factorization stops at the zero pivot, which can only remain for
+    delta = 0.
+   */
+  int nn,na,nj,info,k,ki,l,N,nup=0,lw=lwork;
+  int_t offset,i,j;
+  double * restrict U;
+  double dOne=1.0,dNegOne=-1.0;
+  char cL='L',cN='N';
+
+  U = upd;   // pointer to top of update storage
+  inertia[0] = inertia[1] = inertia[2] = 0;
+  *nreg = 0;
+
+  for (ki=0;ki<nsn;ki++) {
+    k = snpost[ki];
+    nn = snptr[k+1]-snptr[k];
+    na = relptr[k+1]-relptr[k];
+    nj = na + nn;
+    if (nn*na > lwork) return -1;
+
+    // build frontal matrix
+    dlacpy_(&cL, &nj, &nn, blkval+blkptr[k], &nj, fws, &nj);
+    for (j=nn;j<nj;j++) {
+      for (i=j;i<nj;i++) {
+	fws[nj*j+i] = 0.0; // zero out (2,2) block of frontal matrix
+      }
+    }
+
+    // add update matrices to frontal matrix
+    for (l=chptr[k+1]-1;l>=chptr[k];l--) {
+      nup--;
+      U -= upd_size[nup]*upd_size[nup];
+      // extend-add
+      offset = relptr[chidx[l]];
+      N = relptr[chidx[l]+1] - offset;
+      for (j=0; j<N; j++) {
+	for (i=j; i<N; i++) {
+	  fws[nj*relidx[offset+j]+relidx[offset+i]] += U[N*j+i];
+	}
+      }
+    }
+
+    // factor D_k = F11
+    if (sign) {
+      // the expected signs of the pivots are stored in ipiv until the
+      // pivots are known
+      for (i=0;i<nn;i++) ipiv[snptr[k]+i] = (sign[p[snode[snptr[k]+i]]] < 0) ? -1 : 1;
+      info = ldl_unpivoted(nn, fws, nj, ipiv+snptr[k], delta, iws, nreg);
+    }
+    else
+      dsytrf_(&cL, &nn, fws, &nj, iws, work, &lw, &info);
+    for (i=0;i<nn;i++) ipiv[snptr[k]+i] = iws[i];
+    if (info && (sign || na > 0)) return snptr[k] + info;
+    ldl_inertia(nn, fws, nj, iws, inertia);
+
+    if (na > 0) {
+      // compute W' := inv(F11)*F21'
+      for (j=0;j<na;j++) {
+	for (i=0;i<nn;i++) work[nn*j+i] = fws[nj*i+nn+j];
+      }
+      dsytrs_(&cL, &nn, &na, fws, &nj, iws, work, &nn, &info);
+
+      // compute Uk = F22 - F21*W' (the lower triangle is used)
+      dgemm_(&cN, &cN, &na, &na, &nn, &dNegOne, fws+nn, &nj, work, &nn, &dOne, fws+nn*nj+nn, &nj);
+
+      // F21 := W
+      for (j=0;j<na;j++) {
+	for (i=0;i<nn;i++) fws[nj*i+nn+j] = work[nn*j+i];
+      }
+
+      // push update matrix onto stack
+      upd_size[nup++] = na;
+      dlacpy_(&cL, &na, &na, fws+nn*nj+nn, &nj, U, &na);
+      U += na*na;
+    }
+
+    // copy the leading nn columns of frontal matrix to blkval
+    dlacpy_(&cL, &nj, &nn, fws, &nj, blkval+blkptr[k], &nj);
+  }
+  return 0;
+}
+
+void ldltrsm(const char trans,
+	     int nrhs,
+	     const int_t n,         // order of matrix
+	     const int_t nsn,       // number of supernodes/cliques
+	     const int_t *snpost,   // post-ordering of supernodes
+	     const int_t *snptr,    // supernode pointer
+	     const int_t *snode,    // supernode array
+	     const int_t *relptr,
+	     const int_t *relidx,
+	     const int_t *chptr,
+	     const int_t *chidx,
+	     const int_t *blkptr,
+	     const int_t *p,
+	     double * restrict blkval,
+	     const int_t *ipiv,
+	     double * restrict a,
+	     int * lda,
+	     double * restrict fws,  // frontal matrix workspace : must be >= clique number * nrhs
+	     double * restrict upd,  // update matrix workspace
+	     int_t * restrict upd_size,
+	     int * restrict iws      // integer workspace of length max(nn) over all supernodes
+	     ) {
+  /*
+    Solves with the factors of an LDL' factorization computed by ldl():
+
+       a := inv(W)*a   (trans = 'N')
+       a := inv(D)*a   (trans = 'D')
+       a := inv(W')*a  (trans = 'T')
+
+    The sweeps for trans = 'N' and 'T' are those of trsm() with an
+    identity diagonal block.
+   */
+  int nn,na,nj,info,k,ki,ir,l,N,nup=0;
+  int_t offset,i,j;
+  double * restrict U;
+  double dOne=1.0,dNegOne=-1.0;
+  char cL = 'L', cT = 'T', cN = 'N';
+
+  U = upd;   // pointer to top of update storage
+
+  if (trans == 'D') {
+    for (k=0;k<nsn;k++) {
+      nn = snptr[k+1]-snptr[k];
+      nj = nn + relptr[k+1]-relptr[k];
+      for (j=0;j<nrhs;j++) {
+	for (i=0;i<nn;i++) {
+	  ir = snode[snptr[k]+i];
+	  fws[nn*j+i] = a[j*(*lda)+p[ir]];
+	}
+      }
+      for (i=0;i<nn;i++) iws[i] = (int) ipiv[snptr[k]+i];
+      dsytrs_(&cL, &nn, &nrhs, blkval+blkptr[k], &nj, iws, fws, &nn, &info);
+      for (j=0;j<nrhs;j++) {
+	for (i=0;i<nn;i++) {
+	  ir = snode[snptr[k]+i];
+	  a[j*(*lda)+p[ir]] = fws[nn*j+i];
+	}
+      }
+    }
+  }
+  else if (trans == 'N') {
+    for (ki=0;ki<nsn;ki++) {
+      k = snpost[ki];
+      nn = snptr[k+1]-snptr[k];
+      na = relptr[k+1]-relptr[k];
+      nj = na + nn;
+
+      // extract block from rhs
+      for (j=0;j<nrhs;j++) {
+	offset = nj*j;
+	for (i=0;i<nn;i++) {
+	  ir = snode[snptr[k]+i];
+	  fws[offset+i] = a[j*(*lda)+p[ir]];
+	}
+	for (i=nn;i<nj;i++) {
+	  fws[offset+i] = 0.0;
+	}
+      }
+
+      // add contributions from children
+      for (l=chptr[k+1]-1;l>=chptr[k];l--) {
+	nup--;
+	U -= upd_size[nup]*nrhs;
+	offset = relptr[chidx[l]];
+	N = relptr[chidx[l]+1] - offset;
+	for (j=0;j<nrhs;j++) {
+	  for (i=0; i<N; i++) {
+	    fws[nj*j+relidx[offset+i]] += U[N*j+i];
+	  }
+	}
+      }
+
+      // if k is not a root node
+      if (na > 0) {
+	dgemm_(&cN,&cN,&na,&nrhs,&nn,&dNegOne,blkval+blkptr[k]+nn,&nj,fws,&nj,&dOne,fws+nn,&nj);
+	upd_size[nup++] = na;
+	for (j=0;j<nrhs;j++) {
+	  for (i=0;i<na;i++) U[na*j+i] = fws[nj*j+nn+i];
+	}
+	U += na*nrhs;
+      }
+
+      // copy block to rhs
+      for (j=0;j<nrhs;j++) {
+	offset = nj*j;
+	for (i=0;i<nn;i++) {
+	  ir = snode[snptr[k]+i];
+	  a[j*(*lda) + p[ir]] = fws[offset+i];
+	}
+      }
+    }
+  }
+  else if (trans == 'T') {
+    for (ki=nsn-1;ki>=0;ki--) {
+      k = snpost[ki];
+      nn = snptr[k+1]-snptr[k];
+      na = relptr[k+1]-relptr[k];
+      nj = na + nn;
+
+      // extract block from rhs
+      for (j=0;j<nrhs;j++) {
+	offset = nj*j;
+	for (i=0;i<nn;i++) {
+	  ir = snode[snptr[k]+i];
+	  fws[offset+i] = a[j*(*lda)+p[ir]];
+	}
+      }
+
+      // if k is not a root node
+      if (na > 0) {
+	nup--;
+	U -= upd_size[nup]*nrhs;
+	for (j=0;j<nrhs;j++) {
+	  for (i=0;i<na;i++) fws[nj*j+nn+i] = U[na*j+i];
+	}
+	dgemm_(&cT,&cN,&nn,&nrhs,&na,&dNegOne,blkval+blkptr[k]+nn,&nj,fws+nn,&nj,&dOne,fws,&nj);
+      }
+
+      // stack contributions for children
+      for (l=chptr[k];l<chptr[k+1];l++) {
+	offset = relptr[chidx[l]];
+	N = relptr[chidx[l]+1]-offset;
+	upd_size[nup++] = N;
+	for (j=0;j<nrhs;j++) {
+	  for (i=0; i<N; i++) {
+	    U[N*j+i] = fws[nj*j+relidx[offset+i]];
+	  }
+	}
+	U += N*nrhs;
+      }
+
+      // copy block to rhs
+      for (j=0;j<nrhs;j++) {
+	offset = nj*j;
+	for (i=0;i<nn;i++) {
+	  ir = snode[snptr[k]+i];
+	  a[j*(*lda) + p[ir]] = fws[offset+i];
+	}
+      }
+    }
+  }
+  return;
+}
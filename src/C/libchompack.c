@@ -0,0 +1,375 @@
+/*
+  Opaque-handle interface of libchompack (see libchompack.h). The
+  handles wrap the native symbolic factorization (symbolic_new()) and
+  a blkval array; each call allocates the workspace of the kernel it
+  runs. Only built with CHOMPACK_NO_PYTHON (the Python extension uses
+  the kernels directly).
+*/
+
+#ifdef CHOMPACK_NO_PYTHON
+
+#include <stdlib.h>
+#include <string.h>
+#include "chompack.h"
+#include "libchompack.h"
+
+struct chompack_symbolic {
+  symbolic *S;
+  int_t *colsn;        // supernode of each (permuted) column
+};
+
+struct chompack_matrix {
+  const chompack_symbolic *symb;
+  double *blkval;
+  int is_factor;
+  int owner;           // blkval is freed by chompack_matrix_free()
+};
+
+static int ccs_check(int_t n, const int_t *colptr, const int_t *rowidx) {
+  /*
+    Checks a CCS pattern of order n: CHOMPACK_ERR_ARGUMENT if colptr is
+    not a valid column pointer, and CHOMPACK_ERR_PATTERN if a row index
+    is out of range.
+  */
+  int_t j, t;
+
+  if (!colptr || !rowidx || colptr[0] != 0) return CHOMPACK_ERR_ARGUMENT;
+  for (j=0;j<n;j++) if (colptr[j+1] < colptr[j]) return CHOMPACK_ERR_ARGUMENT;
+  for (t=0;t<colptr[n];t++) if (rowidx[t] < 0 || rowidx[t] >= n) return CHOMPACK_ERR_PATTERN;
+  return CHOMPACK_OK;
+}
+
+static int perm_check(int_t n, const int_t *perm) {
+  /*
+    Returns CHOMPACK_ERR_ARGUMENT if perm is not a permutation of
+    0, ..., n-1 (or CHOMPACK_ERR_MEMORY).
+  */
+  int_t j;
+  char *flag;
+  int info = CHOMPACK_OK;
+
+  if (!(flag = calloc(n+1, 1))) return CHOMPACK_ERR_MEMORY;
+  for (j=0;j<n;j++) {
+    if (perm[j] < 0 || perm[j] >= n || flag[perm[j]]) {
+      info = CHOMPACK_ERR_ARGUMENT;
+      break;
+    }
+    flag[perm[j]] = 1;
+  }
+  free(flag);
+  return info;
+}
+
+int chompack_analyze(chompack_int n, const chompack_int *colptr, const chompack_int *rowidx,
+		     const chompack_int *perm, chompack_symbolic **symb) {
+  chompack_symbolic *H;
+  int info;
+
+  *symb = NULL;
+  if (n < 0) return CHOMPACK_ERR_ARGUMENT;
+  if ((info = ccs_check(n, colptr, rowidx)) == CHOMPACK_ERR_PATTERN) return CHOMPACK_ERR_ARGUMENT;
+  if (info || (perm && (info = perm_check(n, perm)))) return info;
+  if (!(H = calloc(1, sizeof(chompack_symbolic)))) return CHOMPACK_ERR_MEMORY;
+  // the input is valid, so symbolic_new() only fails if memory allocation fails
+  if (symbolic_new(n, colptr, rowidx, perm, &H->S) || !(H->colsn = malloc((n+1)*sizeof(int_t)))) {
+    chompack_symbolic_free(H);
+    return CHOMPACK_ERR_MEMORY;
+  }
+  spmap_colsn(H->S->nsn, H->S->snptr, H->S->snode, H->colsn);
+  *symb = H;
+  return CHOMPACK_OK;
+}
+
+void chompack_symbolic_free(chompack_symbolic *symb) {
+  if (!symb) return;
+  symbolic_free(symb->S);
+  free(symb->colsn);
+  free(symb);
+}
+
+chompack_int chompack_symbolic_order(const chompack_symbolic *symb) { return symb->S->n; }
+
+chompack_int chompack_symbolic_supernodes(const chompack_symbolic *symb) { return symb->S->nsn; }
+
+chompack_int chompack_symbolic_clique_number(const chompack_symbolic *symb) { return symb->S->clique_number; }
+
+chompack_int chompack_symbolic_nnz(const chompack_symbolic *symb) {
+  const symbolic *S = symb->S;
+  int_t k, nn, nnz = 0;
+  for (k=0;k<S->nsn;k++) {
+    nn = S->snptr[k+1]-S->snptr[k];
+    nnz += nn*(S->sncolptr[k+1]-S->sncolptr[k]) - nn*(nn-1)/2;
+  }
+  return nnz;
+}
+
+const chompack_int *chompack_symbolic_perm(const chompack_symbolic *symb) { return symb->S->p; }
+
+void chompack_symbolic_structure(const chompack_symbolic *symb, chompack_structure *s) {
+  const symbolic *S = symb->S;
+  s->n = S->n; s->nsn = S->nsn; s->clique_number = S->clique_number;
+  s->stack_depth = S->stack_depth; s->stack_mem = S->stack_mem;
+  s->stack_solve = S->stack_solve; s->update_factor_mem = S->update_factor_mem;
+  s->p = S->p; s->ip = S->ip;
+  s->snode = S->snode; s->snptr = S->snptr; s->snpar = S->snpar; s->snpost = S->snpost;
+  s->sncolptr = S->sncolptr; s->snrowidx = S->snrowidx;
+  s->relptr = S->relptr; s->relidx = S->relidx;
+  s->chptr = S->chptr; s->chidx = S->chidx;
+  s->blkptr = S->blkptr;
+}
+
+static int_t *array_copy(const int_t *x, int_t len) {
+  int_t *y = malloc((len > 0 ? len : 1)*sizeof(int_t));
+  if (y && len > 0) memcpy(y, x, len*sizeof(int_t));
+  return y;
+}
+
+int chompack_symbolic_load(const chompack_structure *s, chompack_symbolic **symb) {
+  chompack_symbolic *H;
+  symbolic *S;
+
+  *symb = NULL;
+  if (!s || s->n < 0 || s->nsn < 0) return CHOMPACK_ERR_ARGUMENT;
+  if (!(H = calloc(1, sizeof(chompack_symbolic)))) return CHOMPACK_ERR_MEMORY;
+  if (!(H->S = S = calloc(1, sizeof(symbolic)))) {
+    free(H);
+    return CHOMPACK_ERR_MEMORY;
+  }
+  S->n = s->n; S->nsn = s->nsn; S->clique_number = s->clique_number;
+  S->stack_depth = s->stack_depth; S->stack_mem = s->stack_mem;
+  S->stack_solve = s->stack_solve; S->update_factor_mem = s->update_factor_mem;
+  S->p = array_copy(s->p, s->n); S->ip = array_copy(s->ip, s->n);
+  S->snode = array_copy(s->snode, s->n); S->snptr = array_copy(s->snptr, s->nsn+1);
+  S->snpar = array_copy(s->snpar, s->nsn); S->snpost = array_copy(s->snpost, s->nsn);
+  S->sncolptr = array_copy(s->sncolptr, s->nsn+1);
+  S->snrowidx = array_copy(s->snrowidx, s->sncolptr[s->nsn]);
+  S->relptr = array_copy(s->relptr, s->nsn+1); S->relidx = array_copy(s->relidx, s->relptr[s->nsn]);
+  S->chptr = array_copy(s->chptr, s->nsn+1); S->chidx = array_copy(s->chidx, s->chptr[s->nsn]);
+  S->blkptr = array_copy(s->blkptr, s->nsn+1);
+  H->colsn = malloc((s->n+1)*sizeof(int_t));
+  if (!S->p || !S->ip || !S->snode || !S->snptr || !S->snpar || !S->snpost || !S->sncolptr ||
+      !S->snrowidx || !S->relptr || !S->relidx || !S->chptr || !S->chidx || !S->blkptr || !H->colsn) {
+    chompack_symbolic_free(H);
+    return CHOMPACK_ERR_MEMORY;
+  }
+  spmap_colsn(S->nsn, S->snptr, S->snode, H->colsn);
+  *symb = H;
+  return CHOMPACK_OK;
+}
+
+int chompack_matrix_new(const chompack_symbolic *symb, chompack_matrix **X) {
+  chompack_matrix *M;
+
+  *X = NULL;
+  if (!symb) return CHOMPACK_ERR_ARGUMENT;
+  if (!(M = malloc(sizeof(chompack_matrix)))) return CHOMPACK_ERR_MEMORY;
+  if (!(M->blkval = calloc(symb->S->blkptr[symb->S->nsn]+1, sizeof(double)))) {
+    free(M);
+    return CHOMPACK_ERR_MEMORY;
+  }
+  M->symb = symb;
+  M->is_factor = 0;
+  M->owner = 1;
+  *X = M;
+  return CHOMPACK_OK;
+}
+
+int chompack_matrix_wrap(const chompack_symbolic *symb, double *blkval, int is_factor, chompack_matrix **X) {
+  chompack_matrix *M;
+
+  *X = NULL;
+  if (!symb || !blkval) return CHOMPACK_ERR_ARGUMENT;
+  if (!(M = malloc(sizeof(chompack_matrix)))) return CHOMPACK_ERR_MEMORY;
+  M->symb = symb;
+  M->blkval = blkval;
+  M->is_factor = is_factor ? 1 : 0;
+  M->owner = 0;
+  *X = M;
+  return CHOMPACK_OK;
+}
+
+int chompack_matrix_copy(const chompack_matrix *X, chompack_matrix **Y) {
+  int info;
+
+  if ((info = chompack_matrix_new(X->symb, Y))) return info;
+  memcpy((*Y)->blkval, X->blkval, X->symb->S->blkptr[X->symb->S->nsn]*sizeof(double));
+  (*Y)->is_factor = X->is_factor;
+  return CHOMPACK_OK;
+}
+
+void chompack_matrix_free(chompack_matrix *X) {
+  if (!X) return;
+  if (X->owner) free(X->blkval);
+  free(X);
+}
+
+int chompack_matrix_is_factor(const chompack_matrix *X) { return X->is_factor; }
+
+double *chompack_matrix_values(chompack_matrix *X, chompack_int *len) {
+  if (len) *len = X->symb->S->blkptr[X->symb->S->nsn];
+  return X->blkval;
+}
+
+int chompack_matrix_add(chompack_matrix *X, const chompack_int *colptr, const chompack_int *rowidx,
+			const double *val, double alpha) {
+  const symbolic *S = X->symb->S;
+  int_t t, nnz, *off;
+  double *v, *wv;
+  int info;
+
+  if (X->is_factor || !val) return CHOMPACK_ERR_ARGUMENT;
+  if ((info = ccs_check(S->n, colptr, rowidx))) return info;
+  nnz = colptr[S->n];
+  off = malloc((nnz+1)*sizeof(int_t));
+  v = malloc((nnz+1)*sizeof(double));
+  wv = malloc((nnz+1)*sizeof(double));
+  if (!off || !v || !wv) {
+    free(off); free(v); free(wv);
+    return CHOMPACK_ERR_MEMORY;
+  }
+  if ((nnz = spmap(S->n, X->symb->colsn, S->sncolptr, S->snrowidx, S->blkptr, S->ip,
+		   colptr, rowidx, val, off, v, wv)) < 0) {
+    free(off); free(v); free(wv);
+    return CHOMPACK_ERR_PATTERN;
+  }
+  for (t=0;t<nnz;t++) X->blkval[off[t]] += alpha*v[t];
+  free(off); free(v); free(wv);
+  return CHOMPACK_OK;
+}
+
+int chompack_matrix_add_coo(chompack_matrix *X, chompack_int nnz, const chompack_int *row,
+			    const chompack_int *col, const double *val, double alpha, char uplo) {
+  const symbolic *S = X->symb->S;
+  int_t t, *off;
+
+  if (X->is_factor || nnz < 0 || (uplo != 'L' && uplo != 'U' && uplo != 'A')) return CHOMPACK_ERR_ARGUMENT;
+  if (!(off = malloc((nnz+1)*sizeof(int_t)))) return CHOMPACK_ERR_MEMORY;
+  if (spmap_coo(S->n, X->symb->colsn, S->sncolptr, S->snrowidx, S->blkptr, S->ip, uplo, nnz, row, col, off)) {
+    free(off);
+    return CHOMPACK_ERR_PATTERN;
+  }
+  for (t=0;t<nnz;t++) if (off[t] >= 0) X->blkval[off[t]] += alpha*val[t];
+  free(off);
+  return CHOMPACK_OK;
+}
+
+/*
+  Workspace of the multifrontal kernels: the frontal matrix (fws), the
+  stack of update matrices (upd and upd_size), and the update_factor()
+  workspace (ws, only if nws > 0).
+*/
+typedef struct {
+  double *fws, *upd, *ws;
+  int_t *upd_size;
+} workspace;
+
+static int workspace_new(workspace *W, const symbolic *S, int_t nfws, int_t nupd, int_t nws) {
+  W->fws = malloc((nfws+1)*sizeof(double));
+  W->upd = malloc((nupd+1)*sizeof(double));
+  W->upd_size = malloc((S->stack_depth+1)*sizeof(int_t));
+  W->ws = (nws > 0) ? malloc(nws*sizeof(double)) : NULL;
+  if (!W->fws || !W->upd || !W->upd_size || (nws > 0 && !W->ws)) {
+    free(W->fws); free(W->upd); free(W->upd_size); free(W->ws);
+    return CHOMPACK_ERR_MEMORY;
+  }
+  return CHOMPACK_OK;
+}
+
+static void workspace_free(workspace *W) {
+  free(W->fws); free(W->upd); free(W->upd_size); free(W->ws);
+}
+
+int chompack_factor(chompack_matrix *X, int nthreads) {
+  const symbolic *S = X->symb->S;
+  workspace W;
+  int info;
+
+  if (X->is_factor) return CHOMPACK_ERR_ARGUMENT;
+  if (workspace_new(&W, S, S->clique_number*S->clique_number, S->stack_mem, 0)) return CHOMPACK_ERR_MEMORY;
+  info = cholesky(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+		  S->blkptr, X->blkval, W.fws, W.upd, W.upd_size, (nthreads > 0) ? nthreads : 1, NULL);
+  workspace_free(&W);
+  if (info) return CHOMPACK_ERR_NUMERIC;
+  X->is_factor = 1;
+  return CHOMPACK_OK;
+}
+
+int chompack_solve(const chompack_matrix *L, int nrhs, double *B, int ldb) {
+  const symbolic *S = L->symb->S;
+  workspace W;
+
+  if (!L->is_factor || nrhs < 0 || ldb < S->n) return CHOMPACK_ERR_ARGUMENT;
+  if (workspace_new(&W, S, S->clique_number*nrhs, S->stack_solve*nrhs, 0)) return CHOMPACK_ERR_MEMORY;
+  trsm('N', nrhs, 1.0, S->n, S->nsn, S->snpost, S->snptr, S->snode, S->relptr, S->relidx,
+       S->chptr, S->chidx, S->blkptr, S->p, L->blkval, B, &ldb, W.fws, W.upd, W.upd_size);
+  trsm('T', nrhs, 1.0, S->n, S->nsn, S->snpost, S->snptr, S->snode, S->relptr, S->relidx,
+       S->chptr, S->chidx, S->blkptr, S->p, L->blkval, B, &ldb, W.fws, W.upd, W.upd_size);
+  workspace_free(&W);
+  return CHOMPACK_OK;
+}
+
+int chompack_projected_inverse(chompack_matrix *L) {
+  const symbolic *S = L->symb->S;
+  workspace W;
+  int info;
+
+  if (!L->is_factor) return CHOMPACK_ERR_ARGUMENT;
+  if (workspace_new(&W, S, S->clique_number*S->clique_number, S->stack_mem, 0)) return CHOMPACK_ERR_MEMORY;
+  info = projected_inverse(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+			   S->blkptr, L->blkval, W.fws, W.upd, W.upd_size);
+  workspace_free(&W);
+  if (info) return CHOMPACK_ERR_NUMERIC;
+  L->is_factor = 0;
+  return CHOMPACK_OK;
+}
+
+int chompack_completion(chompack_matrix *X, int factored_updates) {
+  const symbolic *S = X->symb->S;
+  workspace W;
+  int info;
+
+  if (X->is_factor) return CHOMPACK_ERR_ARGUMENT;
+  if (workspace_new(&W, S, S->clique_number*S->clique_number, S->stack_mem,
+		    factored_updates ? UPDATE_FACTOR_WS(S->update_factor_mem, S->clique_number) : 0))
+    return CHOMPACK_ERR_MEMORY;
+  info = completion(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+		    S->blkptr, X->blkval, W.fws, W.upd, W.upd_size, W.ws, factored_updates);
+  workspace_free(&W);
+  if (info) return CHOMPACK_ERR_NUMERIC;
+  X->is_factor = 1;
+  return CHOMPACK_OK;
+}
+
+int chompack_hessian(const chompack_matrix *L, const chompack_matrix *Y, chompack_matrix **U, int nu,
+		     int adj, int inv) {
+  const symbolic *S = L->symb->S;
+  workspace W;
+  double **ublkval;
+  int i, info;
+
+  if (!L->is_factor || Y->is_factor || Y->symb != L->symb || nu < 0 || adj < -1 || adj > 1)
+    return CHOMPACK_ERR_ARGUMENT;
+  for (i=0;i<nu;i++)
+    if (U[i]->symb != L->symb || U[i]->is_factor) return CHOMPACK_ERR_ARGUMENT;
+  if (!(ublkval = malloc((nu+1)*sizeof(double *)))) return CHOMPACK_ERR_MEMORY;
+  if (workspace_new(&W, S, S->clique_number*S->clique_number, S->stack_mem, 0)) {
+    free(ublkval);
+    return CHOMPACK_ERR_MEMORY;
+  }
+  for (i=0;i<nu;i++) ublkval[i] = U[i]->blkval;
+  ublkval[nu] = NULL;
+
+  // adj = -1: G followed by its adjoint (or the inverse mappings in reverse order)
+  info = hessian(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+		 S->blkptr, L->blkval, Y->blkval, ublkval, W.fws, W.upd, W.upd_size, W.ws,
+		 inv, (adj < 0) ? inv : adj, 0);
+  if (!info && adj < 0)
+    info = hessian(S->n, S->nsn, S->snpost, S->snptr, S->relptr, S->relidx, S->chptr, S->chidx,
+		   S->blkptr, L->blkval, Y->blkval, ublkval, W.fws, W.upd, W.upd_size, W.ws,
+		   inv, !inv, 0);
+  workspace_free(&W);
+  free(ublkval);
+  return info ? CHOMPACK_ERR_NUMERIC : CHOMPACK_OK;
+}
+
+#endif
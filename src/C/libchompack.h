@@ -0,0 +1,140 @@
+/*
+ * Copyright 2012-2018 M. Andersen and L. Vandenberghe.
+ * Copyright 2010-2011 L. Vandenberghe.
+ * Copyright 2004-2009 J. Dahl and L. Vandenberghe.
+ *
+ * This file is part of CHOMPACK.
+ *
+ * CHOMPACK is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CHOMPACK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  Public interface of libchompack, the numeric kernels built as a C
+  library without Python (see lib/Makefile). The header depends only
+  on the C standard library, and the symbolic factorization and the
+  chordal matrices are opaque handles.
+
+  Matrices are given in compressed column storage (CCS) with 0-based
+  indices, in the original ordering; for symmetric matrices, only the
+  lower triangular entries are used. Dense matrices are column-major.
+
+  A chompack_matrix refers to the symbolic factorization it was
+  created with, which must outlive it. Different matrices may be used
+  concurrently from different threads; a single matrix may not.
+*/
+
+#ifndef LIBCHOMPACK_H
+#define LIBCHOMPACK_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHOMPACK_API_VERSION 1
+
+typedef ptrdiff_t chompack_int;     // index type (int_t in the kernels)
+
+// return values
+enum {
+  CHOMPACK_OK = 0,
+  CHOMPACK_ERR_MEMORY = -1,         // memory allocation failed
+  CHOMPACK_ERR_ARGUMENT = -2,       // invalid argument (e.g., a factor where a matrix is expected)
+  CHOMPACK_ERR_PATTERN = -3,        // entry out of range or outside the sparsity pattern
+  CHOMPACK_ERR_NUMERIC = -4         // matrix is not positive definite (completable)
+};
+
+typedef struct chompack_symbolic chompack_symbolic;
+typedef struct chompack_matrix chompack_matrix;
+
+// symbolic factorization of the sparsity pattern of A with the
+// fill-reducing permutation perm (NULL: natural ordering);
+// CHOMPACK_ERR_ARGUMENT if the pattern or perm is invalid
+int chompack_analyze(chompack_int n, const chompack_int *colptr, const chompack_int *rowidx,
+		     const chompack_int *perm, chompack_symbolic **symb);
+void chompack_symbolic_free(chompack_symbolic *symb);
+chompack_int chompack_symbolic_order(const chompack_symbolic *symb);
+chompack_int chompack_symbolic_supernodes(const chompack_symbolic *symb);
+chompack_int chompack_symbolic_clique_number(const chompack_symbolic *symb);
+chompack_int chompack_symbolic_nnz(const chompack_symbolic *symb);     // lower triangle of L
+const chompack_int *chompack_symbolic_perm(const chompack_symbolic *symb);
+
+// read-only view of the supernodal structure (see chompack.symbolic);
+// the arrays belong to symb
+typedef struct {
+  chompack_int n, nsn, clique_number;
+  chompack_int stack_depth, stack_mem, stack_solve, update_factor_mem;
+  const chompack_int *p, *ip;
+  const chompack_int *snode, *snptr, *snpar, *snpost;
+  const chompack_int *sncolptr, *snrowidx;
+  const chompack_int *relptr, *relidx;
+  const chompack_int *chptr, *chidx;
+  const chompack_int *blkptr;
+} chompack_structure;
+void chompack_symbolic_structure(const chompack_symbolic *symb, chompack_structure *s);
+// symbolic factorization with a copy of the structure s (as returned
+// by chompack_symbolic_structure(), e.g. of a handle that was freed)
+int chompack_symbolic_load(const chompack_structure *s, chompack_symbolic **symb);
+
+// chordal matrices (initialized to zero)
+int chompack_matrix_new(const chompack_symbolic *symb, chompack_matrix **X);
+int chompack_matrix_copy(const chompack_matrix *X, chompack_matrix **Y);
+// handle for an existing array of values (not copied, and not freed
+// by chompack_matrix_free())
+int chompack_matrix_wrap(const chompack_symbolic *symb, double *blkval, int is_factor, chompack_matrix **X);
+void chompack_matrix_free(chompack_matrix *X);
+int chompack_matrix_is_factor(const chompack_matrix *X);
+double *chompack_matrix_values(chompack_matrix *X, chompack_int *len);
+
+// X := X + alpha*A for a sparse symmetric A with the pattern of X;
+// X is not modified if an entry is out of range or not in the pattern
+int chompack_matrix_add(chompack_matrix *X, const chompack_int *colptr, const chompack_int *rowidx,
+			const double *val, double alpha);
+
+// X := X + alpha*A for a chunk of nnz entries of A in coordinate format
+// (duplicates are summed); uplo = 'L' ('U') ignores the entries above
+// (below) the diagonal, and uplo = 'A' adds every entry to the lower
+// triangle. Either all entries are added or none.
+int chompack_matrix_add_coo(chompack_matrix *X, chompack_int nnz, const chompack_int *row,
+			    const chompack_int *col, const double *val, double alpha, char uplo);
+
+// X := L where X = L*L' (Cholesky factorization, in place); on
+// failure, the values of X are undefined and it is not marked as a
+// factor (the same holds for chompack_projected_inverse() and
+// chompack_completion())
+int chompack_factor(chompack_matrix *X, int nthreads);
+
+// B := inv(X)*B, where L is the Cholesky factor of X
+int chompack_solve(const chompack_matrix *L, int nrhs, double *B, int ldb);
+
+// L := P(inv(L*L')), the projection of the inverse on the pattern
+int chompack_projected_inverse(chompack_matrix *L);
+
+// X := L, the Cholesky factor of the inverse of the maximum
+// determinant positive definite completion of X
+int chompack_completion(chompack_matrix *X, int factored_updates);
+
+// U[i] := G(U[i]) (adj = 0), G'(U[i]) (adj = 1), or G'(G(U[i])) =
+// P(inv(X)*U[i]*inv(X)) (adj = -1), or the inverse mappings if inv is
+// nonzero; L is the Cholesky factor of X and Y = P(inv(X)) (see
+// chompack.hessian)
+int chompack_hessian(const chompack_matrix *L, const chompack_matrix *Y, chompack_matrix **U, int nu,
+		     int adj, int inv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,10 +15,12 @@ void llt(const int_t n,         // order of matrix
 	 int_t * restrict upd_size  
 	 ) {
 
-  int nn,na,nj,offset,i,j,k,ki,l,N,nup=0;
+  int nn,na,nj,k,ki,l,N,nup=0;
+  int_t offset,i,j;
   double * restrict U;
   double dOne=1.0,dZero=0.0;
   char cL='L',cR='R',cN='N';
+  PROF_DECL;
 
   U = upd;   // pointer to top of update storage
 
@@ -27,10 +29,14 @@ void llt(const int_t n,         // order of matrix
     nn = snptr[k+1]-snptr[k];
     na = relptr[k+1]-relptr[k];
     nj = na + nn;        
+    PROF_BEGIN(PROF_LLT, k, nn, na);
 
     // compute [I; L_{Ak,Nk}]*D_k*[I;L_{Ak,Nk}]'; store in frontal workspace
     dtrmm_(&cR, &cL, &cN, &cN, &na, &nn, &dOne, blkval+blkptr[k], &nj, blkval+blkptr[k]+nn, &nj);
+    PROF_PHASE(PHASE_TRSM);
     dsyrk_(&cL, &cN, &nj, &nn, &dOne, blkval+blkptr[k], &nj, &dZero, fws, &nj);
+    PROF_PHASE(PHASE_SYRK);
+    PROF_FLOPS(na*(double)nn*nn + nj*(double)nj*nn);
     
     // add update matrices to frontal matrix
     for (l=chptr[k+1]-1;l>=chptr[k];l--) {
@@ -44,6 +50,7 @@ void llt(const int_t n,         // order of matrix
 	  fws[nj*relidx[offset+j]+relidx[offset+i]] += U[N*j+i];
       }
     }
+    PROF_PHASE(PHASE_EXTEND_ADD);
 
     // if supernode k is not a root node, push update matrix onto stack
     if (na > 0) {   
@@ -54,6 +61,8 @@ void llt(const int_t n,         // order of matrix
 
     // copy the leading nn columns of frontal matrix to blkval
     dlacpy_(&cL, &nj, &nn, fws, &nj, blkval+blkptr[k], &nj);
+    PROF_PHASE(PHASE_COPY);
+    PROF_END(nup, U-upd);
   }
 
   return;
@@ -0,0 +1,63 @@
+#if defined(CHOMPACK_NO_PYTHON) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "chompack.h"
+
+/*
+  Per-supernode instrumentation of the multifrontal kernels. The
+  kernels append one record per supernode (see PROF_BEGIN) while
+  prof_enabled is nonzero; the records are kept until prof_reset() is
+  called. Without CHOMPACK_PROFILE, this file is empty and the PROF_*
+  macros in chompack.h expand to nothing.
+*/
+
+#ifdef CHOMPACK_PROFILE
+
+int prof_enabled = 0;
+
+static prof_record *prof_buf = NULL;
+static int_t prof_len = 0, prof_cap = 0;
+
+double prof_time(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+prof_record * prof_begin(int kernel, int_t sn, int nn, int na) {
+  /*
+    Appends a new record and returns a pointer to it, or NULL if memory
+    allocation fails. The pointer is valid until the next call.
+   */
+  prof_record *r;
+  if (prof_len == prof_cap) {
+    int_t cap = prof_cap ? 2*prof_cap : 1024;
+    if (!(r = realloc(prof_buf, cap*sizeof(prof_record)))) return NULL;
+    prof_buf = r;
+    prof_cap = cap;
+  }
+  r = prof_buf + prof_len++;
+  memset(r, 0, sizeof(prof_record));
+  r->kernel = kernel;
+  r->sn = sn;
+  r->nn = nn;
+  r->na = na;
+  r->start = prof_time();
+  return r;
+}
+
+void prof_reset(void) {
+  free(prof_buf);
+  prof_buf = NULL;
+  prof_len = prof_cap = 0;
+}
+
+const prof_record * prof_records(int_t *len) {
+  *len = prof_len;
+  return prof_buf;
+}
+
+#endif
@@ -1,24 +1,28 @@
 #include "chompack.h"
+#include "generic.h"
+#include "small.h"
 
-int projected_inverse(const int_t n,         // order of matrix
-		      const int_t nsn,       // number of supernodes/cliques
-		      const int_t *snpost,   // post-ordering of supernodes
-		      const int_t *snptr,    // supernode pointer
-		      const int_t *relptr,
-		      const int_t *relidx,
-		      const int_t *chptr,
-		      const int_t *chidx,
-		      const int_t *blkptr,
-		      double * restrict blkval,
-		      double * restrict fws,  // frontal matrix workspace
-		      double * restrict upd,  // update matrix workspace
-		      int_t * restrict upd_size
-		      ) {
+int GENERIC(projected_inverse)(const int_t n,           // order of matrix
+			       const int_t nsn,         // number of supernodes/cliques
+			       const index_t *snpost,   // post-ordering of supernodes
+			       const index_t *snptr,    // supernode pointer
+			       const index_t *relptr,
+			       const index_t *relidx,
+			       const index_t *chptr,
+			       const index_t *chidx,
+			       const int_t *blkptr,
+			       scalar_t * restrict blkval,
+			       scalar_t * restrict fws,  // frontal matrix workspace
+			       scalar_t * restrict upd,  // update matrix workspace
+			       int_t * restrict upd_size
+			       ) {
 
-  int nn,na,nj,offset,info,i,j,k,l,N,ki,nup=0;
-  double * restrict U;
-  double dOne=1.0,dNegOne=-1.0,dZero=0.0;
+  int nn,na,nj,info,k,l,N,ki,nup=0;
+  int_t offset,i,j;
+  scalar_t * restrict U;
+  scalar_t One=1.0,NegOne=-1.0,Zero=0.0;
   char cL='L',cT='T',cN='N';
+  PROF_DECL;
 
   U = upd;   // pointer to top of update storage
 
@@ -27,33 +31,53 @@ int projected_inverse(const int_t n,         // order of matrix
     nn = snptr[k+1]-snptr[k];
     na = relptr[k+1]-relptr[k];
     nj = na + nn;
+    PROF_BEGIN(PROF_PROJECTED_INVERSE, k, nn, na);
 
-    // invert factor of D_{Nk,Nk}
-    dtrtri_(&cL, &cN, &nn, blkval+blkptr[k], &nj, &info);
-    if (info) return info;
-
-    // zero-out strict upper triangular part of {Nj,Nj} block (just in case!)
-    for (j=1;j<nn;j++) {
-      for (i=0;i<j;i++) blkval[blkptr[k]+j*nj+i] = 0.0;
+    if (nn <= SMALL_NN && na <= SMALL_NA) {
+      // inline kernel for small supernodes (see small.h)
+      if (na > 0) {
+	nup--;
+	U -= upd_size[nup]*upd_size[nup];
+      }
+      SMALL_DISPATCH(nn, info = small_projected_inverse(NN, na, blkval+blkptr[k], nj, U, fws));
+      PROF_PHASE(PHASE_FACTOR);
+      PROF_FLOPS(4.0*nn*(double)nn*nn/3.0 + 2.0*na*(double)na*nn + 2.0*nn*(double)nn*na);
+      if (info) { PROF_ABORT(PHASE_FACTOR, nup, U-upd); return info; }
     }
+    else {
+      // invert factor of D_{Nk,Nk}
+      BLAS(trtri)(&cL, &cN, &nn, blkval+blkptr[k], &nj, &info);
+      PROF_PHASE(PHASE_FACTOR);
+      if (info) { PROF_ABORT(PHASE_FACTOR, nup, U-upd); return info; }
 
-    // compute inv(D_{Nk,Nk}) (store in 1,1 block of frontal matrix)
-    dsyrk_(&cL, &cT, &nn, &nn, &dOne, blkval+blkptr[k], &nj, &dZero, fws, &nj);
+      // zero-out strict upper triangular part of {Nj,Nj} block (just in case!)
+      for (j=1;j<nn;j++) {
+	for (i=0;i<j;i++) blkval[blkptr[k]+j*nj+i] = 0.0;
+      }
 
-    // if supernode k is not a root node:
-    if (na>0) {
-      // copy update matrix to 2,2 block of frontal matrix
-      nup--;
-      U -= upd_size[nup]*upd_size[nup];
-      dlacpy_(&cL, &na, &na, U, &na, fws+nn*nj+nn, &nj);
+      // compute inv(D_{Nk,Nk}) (store in 1,1 block of frontal matrix)
+      BLAS(syrk)(&cL, &cT, &nn, &nn, &One, blkval+blkptr[k], &nj, &Zero, fws, &nj);
+      PROF_PHASE(PHASE_SYRK);
+      PROF_FLOPS(4.0*nn*(double)nn*nn/3.0);
 
-      // compute S_{Ak,Nk} = -Vk*L_{Ak,Nk}; store in 2,1 block of F
-      dsymm_(&cL, &cL, &na, &nn, &dNegOne, fws+nn*nj+nn, &nj,
-	     blkval+blkptr[k]+nn, &nj, &dZero, fws+nn, &nj);
+      // if supernode k is not a root node:
+      if (na>0) {
+	// copy update matrix to 2,2 block of frontal matrix
+	nup--;
+	U -= upd_size[nup]*upd_size[nup];
+	BLAS(lacpy)(&cL, &na, &na, U, &na, fws+(int_t)nn*nj+nn, &nj);
+	PROF_PHASE(PHASE_COPY);
 
-      // compute S_nn = inv(D_{Nk,Nk}) - S_{Ak,Nk}'*L_{Ak,Nk}; store in 1,1 block of F
-      dgemm_(&cT, &cN, &nn, &nn, &na, &dNegOne, fws+nn, &nj,
-	     blkval+blkptr[k]+nn, &nj, &dOne, fws, &nj);
+	// compute S_{Ak,Nk} = -Vk*L_{Ak,Nk}; store in 2,1 block of F
+	BLAS(symm)(&cL, &cL, &na, &nn, &NegOne, fws+(int_t)nn*nj+nn, &nj,
+		   blkval+blkptr[k]+nn, &nj, &Zero, fws+nn, &nj);
+
+	// compute S_nn = inv(D_{Nk,Nk}) - S_{Ak,Nk}'*L_{Ak,Nk}; store in 1,1 block of F
+	BLAS(gemm)(&cT, &cN, &nn, &nn, &na, &NegOne, fws+nn, &nj,
+		   blkval+blkptr[k]+nn, &nj, &One, fws, &nj);
+	PROF_PHASE(PHASE_SYRK);
+	PROF_FLOPS(2.0*na*(double)na*nn + 2.0*nn*(double)nn*na);
+      }
     }
 
     // extract update matrices if supernode k has any children
@@ -63,13 +87,16 @@ int projected_inverse(const int_t n,         // order of matrix
       upd_size[nup++] = N;
       for (j=0; j<N; j++) {
 				for (i=j; i<N; i++) {
-	  			U[N*j+i] = fws[nj*relidx[offset+j]+relidx[offset+i]];
+	  			U[N*j+i] = fws[(int_t)nj*relidx[offset+j]+relidx[offset+i]];
 				}
       }
-      U += N*N;
+      U += (int_t)N*N;
     }
+    PROF_PHASE(PHASE_EXTEND_ADD);
     // copy S_{Jk,Nk} (i.e., 1,1 and 2,1 blocks of frontal matrix) to blkval
-    dlacpy_(&cL, &nj, &nn, fws, &nj, blkval+blkptr[k], &nj);
+    BLAS(lacpy)(&cL, &nj, &nn, fws, &nj, blkval+blkptr[k], &nj);
+    PROF_PHASE(PHASE_COPY);
+    PROF_END(nup, U-upd);
   }
   return 0;
 }
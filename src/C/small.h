@@ -0,0 +1,236 @@
+/*
+ * Inline kernels for small supernodes (nn <= SMALL_NN, na <= SMALL_NA).
+ *
+ * For such supernodes, the argument checking and call overhead of the
+ * BLAS/LAPACK routines exceeds the arithmetic. The kernels below are
+ * written for a fixed supernode order: SMALL_DISPATCH() calls them with
+ * a literal nn, so that the compiler unrolls the loops over nn, and
+ * the innermost loops run over contiguous rows (na or nj) so that they
+ * can be vectorized. The kernels are type-generic (see generic.h).
+ */
+
+#ifndef __CHOMPACK_SMALL__
+#define __CHOMPACK_SMALL__
+
+#include <math.h>
+#include "generic.h"
+
+// limits on nn (at most 8; 0 disables the kernels) and na
+#ifndef SMALL_NN
+#define SMALL_NN 8
+#endif
+#ifndef SMALL_NA
+#define SMALL_NA 32
+#endif
+
+#if defined(__GNUC__)
+#define SMALL_INLINE static inline __attribute__((always_inline))
+#else
+#define SMALL_INLINE static inline
+#endif
+
+// calls stmt with the macro argument NN set to the literal value of nn
+// (1 <= nn <= SMALL_NN)
+#define SMALL_DISPATCH(nn, stmt) do {			\
+    switch (nn) {					\
+    case 1: { enum {NN = 1}; stmt; break; }		\
+    case 2: { enum {NN = 2}; stmt; break; }		\
+    case 3: { enum {NN = 3}; stmt; break; }		\
+    case 4: { enum {NN = 4}; stmt; break; }		\
+    case 5: { enum {NN = 5}; stmt; break; }		\
+    case 6: { enum {NN = 6}; stmt; break; }		\
+    case 7: { enum {NN = 7}; stmt; break; }		\
+    default: { enum {NN = 8}; stmt; break; }		\
+    }							\
+  } while (0)
+
+SMALL_INLINE void small_lacpy(const int m, const int n, const scalar_t * restrict A, const int lda,
+			      scalar_t * restrict B, const int ldb) {
+  /*
+    Copies the lower trapezoidal part of the m-by-n matrix A to B
+    (dlacpy with uplo = 'L').
+   */
+  int i, j;
+  for (j=0; j<n; j++)
+    for (i=j; i<m; i++) B[j*ldb+i] = A[j*lda+i];
+}
+
+SMALL_INLINE int small_cholesky(const int nn, const int nj, scalar_t * restrict F) {
+  /*
+    Fused dense part of cholesky() for a frontal matrix F of order nj
+    (leading dimension nj):
+
+       F11 := chol(F11), F21 := F21*inv(L11'), F22 := F22 - F21*F21',
+       F21 := F21*inv(L11).
+
+    Returns 0 on success and k+1 if the leading minor of order k+1 of
+    F11 is not positive definite (as dpotrf).
+   */
+  const int na = nj - nn;
+  int i, j, k;
+  scalar_t d, c;
+
+  // right-looking factorization of the first nn columns
+  for (k=0; k<nn; k++) {
+    d = F[k*nj+k];
+    if (!(d > 0.0)) return k+1;
+    d = sqrt(d);
+    F[k*nj+k] = d;
+    d = 1.0/d;
+    for (i=k+1; i<nj; i++) F[k*nj+i] *= d;
+    for (j=k+1; j<nn; j++) {
+      c = F[k*nj+j];
+      for (i=j; i<nj; i++) F[j*nj+i] -= F[k*nj+i]*c;
+    }
+  }
+  if (na == 0) return 0;
+
+  // F22 := F22 - F21*F21'
+  for (j=0; j<na; j++) {
+    scalar_t * restrict Fj = F + (nn+j)*nj + nn;
+    for (k=0; k<nn; k++) {
+      const scalar_t * restrict Lk = F + k*nj + nn;
+      c = Lk[j];
+      for (i=j; i<na; i++) Fj[i] -= Lk[i]*c;
+    }
+  }
+
+  // F21 := F21*inv(L11)
+  for (k=nn-1; k>=0; k--) {
+    scalar_t * restrict Fk = F + k*nj + nn;
+    for (j=k+1; j<nn; j++) {
+      c = F[k*nj+j];
+      for (i=0; i<na; i++) Fk[i] -= F[j*nj+nn+i]*c;
+    }
+    d = 1.0/F[k*nj+k];
+    for (i=0; i<na; i++) Fk[i] *= d;
+  }
+  return 0;
+}
+
+SMALL_INLINE void small_trsm(const int nn, const char trans, const scalar_t * restrict L, const int ldl,
+			     scalar_t * restrict X, const int ldx, const int nrhs) {
+  /*
+    X := inv(L)*X (trans = 'N') or X := inv(L')*X (trans = 'T'), where
+    L is lower triangular of order nn and X is nn-by-nrhs.
+   */
+  int i, j, k;
+  scalar_t s;
+  for (j=0; j<nrhs; j++) {
+    scalar_t * restrict x = X + j*ldx;
+    if (trans == 'N') {
+      for (k=0; k<nn; k++) {
+	x[k] /= L[k*ldl+k];
+	for (i=k+1; i<nn; i++) x[i] -= L[k*ldl+i]*x[k];
+      }
+    }
+    else {
+      for (k=nn-1; k>=0; k--) {
+	s = x[k];
+	for (i=k+1; i<nn; i++) s -= L[k*ldl+i]*x[i];
+	x[k] = s/L[k*ldl+k];
+      }
+    }
+  }
+}
+
+SMALL_INLINE void small_gemm(const int nn, const char trans, const int na, const int nrhs,
+			     const scalar_t * restrict A, const int lda, scalar_t * restrict X1,
+			     scalar_t * restrict X2, const int ldx) {
+  /*
+    X2 := X2 - A*X1 (trans = 'N') or X1 := X1 - A'*X2 (trans = 'T'),
+    where A is na-by-nn, X1 is nn-by-nrhs, and X2 is na-by-nrhs.
+   */
+  int i, j, k;
+  scalar_t s;
+  for (j=0; j<nrhs; j++) {
+    scalar_t * restrict x1 = X1 + j*ldx, * restrict x2 = X2 + j*ldx;
+    for (k=0; k<nn; k++) {
+      const scalar_t * restrict a = A + k*lda;
+      if (trans == 'N') {
+	s = x1[k];
+	for (i=0; i<na; i++) x2[i] -= a[i]*s;
+      }
+      else {
+	s = 0.0;
+	for (i=0; i<na; i++) s += a[i]*x2[i];
+	x1[k] -= s;
+      }
+    }
+  }
+}
+
+SMALL_INLINE int small_projected_inverse(const int nn, const int na, scalar_t * restrict L, const int nj,
+					 const scalar_t * restrict U, scalar_t * restrict F) {
+  /*
+    Dense part of projected_inverse() for a supernode of order nn: with
+    L the nj-by-nn block column of the factor (nj = nn+na) and U the
+    na-by-na update matrix (lower triangle, leading dimension na),
+    computes
+
+       F11 := inv(L11)'*inv(L11) - F21'*L21,   F21 := -U*L21
+
+    in the frontal matrix F (leading dimension nj); F22 := U. L11 is
+    overwritten by its inverse. Returns 0 on success and k+1 if
+    L11[k,k] is zero (as dtrtri).
+   */
+  int i, j, k;
+  scalar_t s, t;
+
+  // L11 := inv(L11)
+  for (k=0; k<nn; k++) {
+    if (L[k*nj+k] == 0.0) return k+1;
+  }
+  for (k=0; k<nn; k++) {
+    L[k*nj+k] = 1.0/L[k*nj+k];
+    for (i=k+1; i<nn; i++) {
+      s = 0.0;
+      for (j=k; j<i; j++) s += L[j*nj+i]*L[k*nj+j];
+      L[k*nj+i] = -s/L[i*nj+i];
+    }
+  }
+  for (j=1; j<nn; j++)
+    for (i=0; i<j; i++) L[j*nj+i] = 0.0;
+
+  // F11 := inv(L11)'*inv(L11) (lower triangle)
+  for (j=0; j<nn; j++) {
+    for (i=j; i<nn; i++) {
+      s = 0.0;
+      for (k=i; k<nn; k++) s += L[i*nj+k]*L[j*nj+k];
+      F[j*nj+i] = s;
+    }
+  }
+  if (na == 0) return 0;
+
+  // F22 := U, F21 := -U*L21 (U symmetric, lower triangle stored)
+  small_lacpy(na, na, U, na, F+nn*nj+nn, nj);
+  for (k=0; k<nn; k++) {
+    const scalar_t * restrict l = L + k*nj + nn;
+    scalar_t * restrict f = F + k*nj + nn;
+    for (i=0; i<na; i++) f[i] = 0.0;
+    for (j=0; j<na; j++) {
+      const scalar_t * restrict u = U + j*na;
+      t = l[j];
+      s = u[j]*t;
+      for (i=j+1; i<na; i++) {
+	f[i] -= u[i]*t;
+	s += u[i]*l[i];
+      }
+      f[j] -= s;
+    }
+  }
+
+  // F11 := F11 - F21'*L21 (lower triangle)
+  for (j=0; j<nn; j++) {
+    const scalar_t * restrict l = L + j*nj + nn;
+    for (i=j; i<nn; i++) {
+      const scalar_t * restrict f = F + i*nj + nn;
+      s = 0.0;
+      for (k=0; k<na; k++) s += f[k]*l[k];
+      F[j*nj+i] -= s;
+    }
+  }
+  return 0;
+}
+
+#endif
@@ -0,0 +1,120 @@
+#include <math.h>
+#include "chompack.h"
+
+static int residual(const int_t n, const int_t nsn, const int_t *snptr, const int_t *sncolptr,
+		    const int_t *snrowidx, const int_t *blkptr, const int_t *p, double * restrict Aval,
+		    int nrhs, double * restrict b, double * restrict x, int ldx, double * restrict r,
+		    double * restrict ws, int_t ldws, double tol, double * restrict resnrm, double *relres) {
+  /*
+    r := b - A*x and resnrm[j] := ||r_j||_2. Returns 1 if ||r_j||_2 <=
+    tol*||b_j||_2 for all columns j, and 0 otherwise. On exit, *relres
+    is max_j ||r_j||_2/||b_j||_2.
+   */
+  int_t i;
+  int j,N=(int) n,iOne=1,conv=1;
+  double bn;
+
+  for (i=0;i<n*nrhs;i++) r[i] = b[i];
+  symm(n, nsn, snptr, sncolptr, snrowidx, blkptr, p, nrhs, x, ldx, r, N, -1.0, 1.0, Aval, ws, ldws, 1);
+
+  *relres = 0.0;
+  for (j=0;j<nrhs;j++) {
+    resnrm[j] = dnrm2_(&N, r+j*n, &iOne);
+    bn = dnrm2_(&N, b+j*n, &iOne);
+    if (resnrm[j] > tol*bn) conv = 0;
+    if (bn > 0.0) {
+      if (resnrm[j]/bn > *relres) *relres = resnrm[j]/bn;
+    }
+    else if (resnrm[j] > 0.0) *relres = INFINITY;
+  }
+  return conv;
+}
+
+int solve(const int_t n,         // order of matrix
+	  const int_t nsn,       // number of supernodes/cliques
+	  const int_t *snpost,   // post-ordering of supernodes
+	  const int_t *snptr,    // supernode pointer
+	  const int_t *snode,    // supernode array
+	  const int_t *relptr,
+	  const int_t *relidx,
+	  const int_t *chptr,
+	  const int_t *chidx,
+	  const int_t *blkptr,
+	  const int_t *sncolptr,
+	  const int_t *snrowidx,
+	  const int_t *p,
+	  const int_t clique_number,
+	  const int_t stack_solve,
+	  double * restrict Aval,  // blkval of A
+	  double * restrict Lval,  // blkval of the Cholesky factor of A (or of a perturbation of A)
+	  int nrhs,
+	  double * restrict a,
+	  int * lda,
+	  int refine,
+	  double tol,
+	  double * restrict resnrm,
+	  double * restrict work,  // length >= (3*n + 2*clique_number + stack_solve + 1)*nrhs
+	  int_t * restrict upd_size
+	  ) {
+  /*
+    Solves A*X = B given the factor L of L*L' ~= A, i.e., computes X
+    := inv(L')*inv(L)*B, followed by at most `refine` steps of
+    iterative refinement
+
+       R := B - A*X,  X := X + inv(L')*inv(L)*R
+
+    with the residual computed from the cspmatrix A. Refinement stops
+    when ||r_j||_2 <= tol*||b_j||_2 for all columns, or when a step
+    fails to halve the largest relative residual (as in LAPACK's
+    xPORFS); a step that does not reduce it is undone. On exit, a
+    contains X and resnrm[j] = ||b_j - A*x_j||_2 for the returned X.
+    All sweeps share the workspace in work, which holds a copy of B,
+    the residual, the frontal/update storage used by trsm() and the
+    product workspace used by symm(), and the previous iterate and its
+    residual norms. Returns the number of refinement steps applied to
+    the returned X.
+   */
+  int_t i;
+  int j,k,ldr=(int) n;
+  double relres, lstres;
+  double * restrict b, * restrict r, * restrict fws, * restrict upd, * restrict xp, * restrict rnp;
+
+  b = work;
+  r = b + n*nrhs;
+  fws = r + n*nrhs;            // 2*clique_number*nrhs: trsm front or symm workspace
+  upd = fws + 2*clique_number*nrhs;
+  xp = upd + stack_solve*nrhs;
+  rnp = xp + n*nrhs;
+
+  for (j=0;j<nrhs;j++)
+    for (i=0;i<n;i++) b[j*n+i] = a[j*(*lda)+i];
+
+  trsm('N',nrhs,1.0,n,nsn,snpost,snptr,snode,relptr,relidx,chptr,chidx,blkptr,p,Lval,a,lda,fws,upd,upd_size);
+  trsm('T',nrhs,1.0,n,nsn,snpost,snptr,snode,relptr,relidx,chptr,chidx,blkptr,p,Lval,a,lda,fws,upd,upd_size);
+  if (residual(n,nsn,snptr,sncolptr,snrowidx,blkptr,p,Aval,nrhs,b,a,*lda,r,fws,2*clique_number*nrhs,
+	       tol,resnrm,&relres)) return 0;
+
+  for (k=0;k<refine;k++) {
+    lstres = relres;
+    for (j=0;j<nrhs;j++) {
+      for (i=0;i<n;i++) xp[j*n+i] = a[j*(*lda)+i];
+      rnp[j] = resnrm[j];
+    }
+    trsm('N',nrhs,1.0,n,nsn,snpost,snptr,snode,relptr,relidx,chptr,chidx,blkptr,p,Lval,r,&ldr,fws,upd,upd_size);
+    trsm('T',nrhs,1.0,n,nsn,snpost,snptr,snode,relptr,relidx,chptr,chidx,blkptr,p,Lval,r,&ldr,fws,upd,upd_size);
+    for (j=0;j<nrhs;j++)
+      for (i=0;i<n;i++) a[j*(*lda)+i] += r[j*n+i];
+    if (residual(n,nsn,snptr,sncolptr,snrowidx,blkptr,p,Aval,nrhs,b,a,*lda,r,fws,2*clique_number*nrhs,
+		 tol,resnrm,&relres)) return k+1;
+    if (!(2.0*relres <= lstres)) {
+      if (relres < lstres) return k+1;
+      // the step did not reduce the residual: return the previous iterate
+      for (j=0;j<nrhs;j++) {
+	for (i=0;i<n;i++) a[j*(*lda)+i] = xp[j*n+i];
+	resnrm[j] = rnp[j];
+      }
+      return k;
+    }
+  }
+  return refine;
+}
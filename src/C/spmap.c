@@ -0,0 +1,131 @@
+#include "chompack.h"
+
+void spmap_colsn(const int_t nsn, const int_t *snptr, const int_t *snode, int_t * restrict colsn) {
+  /*
+    Computes the supernode colsn[j] that contains column j.
+   */
+  int_t k,i;
+  for (k=0;k<nsn;k++) {
+    for (i=snptr[k];i<snptr[k+1];i++) colsn[snode[i]] = k;
+  }
+}
+
+static inline int_t spmap_offset(const int_t ii, const int_t jj, const int_t *colsn, const int_t *sncolptr,
+				 const int_t *snrowidx, const int_t *blkptr) {
+  /*
+    Returns the blkval offset of entry (ii,jj), ii >= jj, of the
+    permuted matrix, or -1 if it is not in the sparsity pattern. The
+    entries of each clique are sorted (and the first entries are the
+    consecutive columns of the supernode), so rows are found by
+    bisection.
+   */
+  int_t k,lo,hi,mid;
+
+  k = colsn[jj];
+  lo = sncolptr[k]; hi = sncolptr[k+1];
+  while (lo < hi) {
+    mid = lo + (hi-lo)/2;
+    if (snrowidx[mid] < ii) lo = mid+1;
+    else hi = mid;
+  }
+  if (lo == sncolptr[k+1] || snrowidx[lo] != ii) return -1;
+  return blkptr[k] + (sncolptr[k+1]-sncolptr[k])*(jj-snrowidx[sncolptr[k]]) + lo-sncolptr[k];
+}
+
+int_t spmap(const int_t n, const int_t *colsn, const int_t *sncolptr,
+	    const int_t *snrowidx, const int_t *blkptr, const int_t *ip,
+	    const int_t *colptr, const int_t *rowidx, const double *val,
+	    int_t * restrict off, double * restrict v, double * restrict wv) {
+  /*
+    Maps the lower triangular entries of a sparse symmetric matrix A
+    (CCS format, original ordering) to offsets into blkval. Strictly
+    upper triangular entries of A are ignored.
+
+    On exit, off[t] is the blkval offset of the t'th entry, v[t] is its
+    value, and wv[t] is its weight in a trace product, i.e., v[t] if
+    the entry is on the diagonal and 2*v[t] otherwise.
+
+    Returns the number of entries mapped, or -(t+1) if entry t of A is
+    not in the sparsity pattern.
+   */
+  int_t j,t,i,ii,jj,k,cnt = 0;
+
+  for (j=0;j<n;j++) {
+    for (t=colptr[j];t<colptr[j+1];t++) {
+      i = rowidx[t];
+      if (i < j) continue;
+      ii = ip ? ip[i] : i;
+      jj = ip ? ip[j] : j;
+      if (ii < jj) { k = ii; ii = jj; jj = k; }
+      if ((off[cnt] = spmap_offset(ii, jj, colsn, sncolptr, snrowidx, blkptr)) < 0) return -(t+1);
+      v[cnt] = val[t];
+      wv[cnt] = (ii == jj) ? val[t] : 2.0*val[t];
+      cnt++;
+    }
+  }
+  return cnt;
+}
+
+int_t spmap_coo(const int_t n, const int_t *colsn, const int_t *sncolptr,
+		const int_t *snrowidx, const int_t *blkptr, const int_t *ip,
+		const char uplo, const int_t nnz, const int_t *row, const int_t *col,
+		int_t * restrict off) {
+  /*
+    Maps the entries (row[t], col[t]) of a sparse symmetric matrix in
+    coordinate format (original ordering) to offsets into blkval. With
+    uplo = 'L' ('U'), the entries above (below) the diagonal are
+    ignored (off[t] = -1); with uplo = 'A', every entry is mapped to
+    the lower triangle. Duplicate entries map to the same offset.
+
+    Returns 0, or t+1 if entry t is out of range or not in the
+    sparsity pattern.
+   */
+  int_t t,i,j,ii,jj;
+
+  for (t=0;t<nnz;t++) {
+    i = row[t]; j = col[t];
+    if (i < 0 || i >= n || j < 0 || j >= n) return t+1;
+    if ((uplo == 'L' && i < j) || (uplo == 'U' && i > j)) {
+      off[t] = -1;
+      continue;
+    }
+    ii = ip ? ip[i] : i;
+    jj = ip ? ip[j] : j;
+    if (ii < jj) { i = ii; ii = jj; jj = i; }
+    if ((off[t] = spmap_offset(ii, jj, colsn, sncolptr, snrowidx, blkptr)) < 0) return t+1;
+  }
+  return 0;
+}
+
+void spmap_dot(const int m, const int_t *ptr, const int_t *off, const double *wv,
+	       const double *blkval, double * restrict y) {
+  /*
+    Computes y[i] = tr(A_i*X) for i = 0, ..., m-1.
+   */
+  int i;
+  int_t t;
+  double s;
+#ifdef _OPENMP
+  #pragma omp parallel for private(i,t,s) schedule(static)
+#endif
+  for (i=0;i<m;i++) {
+    s = 0.0;
+    for (t=ptr[i];t<ptr[i+1];t++) s += wv[t]*blkval[off[t]];
+    y[i] = s;
+  }
+}
+
+void spmap_axpy(const int m, const int_t *ptr, const int_t *off, const double *v,
+		const double *y, const double alpha, double * restrict blkval) {
+  /*
+    Computes X := X + alpha*sum_i y[i]*A_i.
+   */
+  int i;
+  int_t t;
+  double a;
+  for (i=0;i<m;i++) {
+    a = alpha*y[i];
+    if (a == 0.0) continue;
+    for (t=ptr[i];t<ptr[i+1];t++) blkval[off[t]] += a*v[t];
+  }
+}
@@ -0,0 +1,337 @@
+#include <stdlib.h>
+#include <string.h>
+#include "chompack.h"
+
+/*
+  Native symbolic factorization (no Python). This mirrors the
+  supernodal structure computed by chompack.symbolic without
+  amalgamation: maximal supernodes (Pothen-Sun), renumbered such that
+  the columns of each supernode are consecutive and the supernodes are
+  postordered.
+*/
+
+static int_t * adjacency(const int_t n, const int_t *colptr, const int_t *rowidx, const int_t *ip,
+			 int lower, int_t **ptr) {
+  /*
+    Computes the adjacency lists of the (permuted) graph of A: if lower
+    is nonzero, list j contains the neighbors i > j, and otherwise the
+    neighbors i < j. Returns the index array and the pointer array in
+    ptr, or NULL if memory allocation fails.
+   */
+  int_t i,j,k,t,ii,jj,*cnt,*idx;
+  if (!(cnt = calloc(n+1,sizeof(int_t)))) return NULL;
+  for (j=0;j<n;j++) {
+    for (t=colptr[j];t<colptr[j+1];t++) {
+      i = rowidx[t];
+      if (i == j) continue;
+      ii = ip[i]; jj = ip[j];
+      k = lower ? ((ii < jj) ? ii : jj) : ((ii > jj) ? ii : jj);
+      cnt[k+1]++;
+    }
+  }
+  for (j=0;j<n;j++) cnt[j+1] += cnt[j];
+  if (!(idx = malloc((cnt[n]+1)*sizeof(int_t)))) {
+    free(cnt);
+    return NULL;
+  }
+  for (j=0;j<n;j++) {
+    for (t=colptr[j];t<colptr[j+1];t++) {
+      i = rowidx[t];
+      if (i == j) continue;
+      ii = ip[i]; jj = ip[j];
+      if (lower) idx[cnt[(ii < jj) ? ii : jj]++] = (ii > jj) ? ii : jj;
+      else idx[cnt[(ii > jj) ? ii : jj]++] = (ii < jj) ? ii : jj;
+    }
+  }
+  for (j=n;j>0;j--) cnt[j] = cnt[j-1];
+  cnt[0] = 0;
+  *ptr = cnt;
+  return idx;
+}
+
+static int etree(const int_t n, const int_t *colptr, const int_t *rowidx, const int_t *ip,
+		 int_t * restrict parent, int_t * restrict colcount) {
+  /*
+    Computes the elimination tree (parent[j] = j for roots) and the
+    column counts (including the diagonal) of the Cholesky factor of
+    P*A*P' where ip is the inverse permutation.
+   */
+  int_t i,j,k,t,inext,*ptr = NULL,*idx,*ancestor,*mark;
+
+  if (!(idx = adjacency(n, colptr, rowidx, ip, 0, &ptr))) return -1;
+  ancestor = malloc(n*sizeof(int_t));
+  mark = malloc(n*sizeof(int_t));
+  if (!ancestor || !mark) {
+    free(ancestor); free(mark); free(ptr); free(idx);
+    return -1;
+  }
+
+  // Liu's algorithm with path compression
+  for (k=0;k<n;k++) {
+    parent[k] = k;
+    ancestor[k] = -1;
+    for (t=ptr[k];t<ptr[k+1];t++) {
+      for (i=idx[t];i != -1 && i < k;i=inext) {
+	inext = ancestor[i];
+	ancestor[i] = k;
+	if (inext == -1) parent[i] = k;
+      }
+    }
+  }
+
+  // column counts: traverse row subtrees
+  for (j=0;j<n;j++) { colcount[j] = 1; mark[j] = -1; }
+  for (k=0;k<n;k++) {
+    mark[k] = k;
+    for (t=ptr[k];t<ptr[k+1];t++) {
+      for (j=idx[t];mark[j] != k;j=parent[j]) {
+	colcount[j]++;
+	mark[j] = k;
+      }
+    }
+  }
+
+  free(ancestor); free(mark); free(ptr); free(idx);
+  return 0;
+}
+
+void tree_postorder(const int_t n, const int_t *parent, int_t * restrict post, int_t * restrict work) {
+  /*
+    Postorders a forest given by parent (parent[j] = j for roots). work
+    must be of length 3*n.
+   */
+  int_t j,k,top,p,*head = work, *next = work+n, *stack = work+2*n;
+  for (j=0;j<n;j++) head[j] = -1;
+  for (j=n-1;j>=0;j--) {
+    if (parent[j] == j) continue;
+    next[j] = head[parent[j]];
+    head[parent[j]] = j;
+  }
+  k = 0;
+  for (j=0;j<n;j++) {
+    if (parent[j] != j) continue;
+    top = 0;
+    stack[0] = j;
+    while (top >= 0) {
+      p = stack[top];
+      if (head[p] == -1) {
+	top--;
+	post[k++] = p;
+      }
+      else {
+	stack[++top] = head[p];
+	head[p] = next[head[p]];
+      }
+    }
+  }
+}
+
+int symbolic_new(const int_t n, const int_t *colptr, const int_t *rowidx, const int_t *perm, symbolic **symb) {
+  /*
+    Computes a symbolic factorization of a sparse symmetric matrix A of
+    order n with the given fill-reducing permutation (identity if perm
+    is NULL). Only the sparsity pattern (CCS format) of A is accessed,
+    and it may contain the lower, upper, or both triangular parts.
+
+    Returns 0 on success and -1 if memory allocation fails.
+   */
+  int_t i,j,k,l,t,r,nn,na,nj,nsn,cnt,top,*parent,*colcount,*work,*q,*flag,*lp,*li,*sn,*mark;
+  symbolic *S;
+
+  *symb = NULL;
+  if (!(S = calloc(1,sizeof(symbolic)))) return -1;
+  S->n = n;
+  parent = malloc(n*sizeof(int_t));
+  colcount = malloc(n*sizeof(int_t));
+  work = malloc((3*n+1)*sizeof(int_t));
+  q = malloc(n*sizeof(int_t));
+  flag = malloc((n+1)*sizeof(int_t));
+  S->p = malloc(n*sizeof(int_t));
+  S->ip = calloc(n,sizeof(int_t));
+  lp = li = sn = NULL;
+  if (!parent || !colcount || !work || !q || !flag || !S->p || !S->ip) goto fail;
+
+  // initial ordering followed by a postordering of the elimination tree
+  for (j=0;j<n;j++) S->p[j] = perm ? perm[j] : j;
+  for (j=0;j<n;j++) S->ip[S->p[j]] = j;
+  if (etree(n, colptr, rowidx, S->ip, parent, colcount)) goto fail;
+  tree_postorder(n, parent, q, work);
+  for (j=0;j<n;j++) q[j] = S->p[q[j]];
+  memcpy(S->p, q, n*sizeof(int_t));
+  for (j=0;j<n;j++) S->ip[S->p[j]] = j;
+  if (etree(n, colptr, rowidx, S->ip, parent, colcount)) goto fail;
+
+  // maximal supernodes (Pothen-Sun); flag[j] < 0 if j is a representative
+  for (j=0;j<n;j++) flag[j] = -1;
+  for (j=0;j<n;j++) {
+    k = parent[j];
+    if (k != j && colcount[j]-1 == colcount[k] && flag[k] == -1)
+      flag[k] = (flag[j] < 0) ? j : flag[j];
+  }
+
+  // supernodal elimination tree over representatives (q[r] is the
+  // representative of the parent supernode) and its postorder
+  for (j=0;j<n;j++) {
+    q[j] = j;
+    if (flag[j] >= 0) continue;
+    for (t=j;parent[t] != t && flag[parent[t]] == j;t=parent[t]);   // top of chain
+    if (parent[t] != t) q[j] = (flag[parent[t]] < 0) ? parent[t] : flag[parent[t]];
+  }
+  tree_postorder(n, q, colcount, work);
+
+  // new ordering: members of each supernode (in chain order) in supernodal postorder
+  cnt = 0;
+  for (k=0;k<n;k++) {
+    r = colcount[k];
+    if (flag[r] >= 0) continue;
+    for (j=r;;j=parent[j]) {
+      q[cnt++] = S->p[j];
+      if (parent[j] == j || flag[parent[j]] != r) break;
+    }
+  }
+  memcpy(S->p, q, n*sizeof(int_t));
+  for (j=0;j<n;j++) S->ip[S->p[j]] = j;
+  if (etree(n, colptr, rowidx, S->ip, parent, colcount)) goto fail;
+
+  // structure of L (rows in each column are sorted by construction)
+  lp = malloc((n+1)*sizeof(int_t));
+  mark = flag;
+  if (!lp) goto fail;
+  lp[0] = 0;
+  for (j=0;j<n;j++) lp[j+1] = lp[j] + colcount[j];
+  if (!(li = malloc((lp[n]+1)*sizeof(int_t)))) goto fail;
+  {
+    int_t *ptr = NULL, *idx, *pos = work;
+    if (!(idx = adjacency(n, colptr, rowidx, S->ip, 0, &ptr))) goto fail;
+    for (j=0;j<n;j++) { pos[j] = lp[j]; mark[j] = -1; }
+    for (k=0;k<n;k++) {
+      mark[k] = k;
+      li[pos[k]++] = k;
+      for (t=ptr[k];t<ptr[k+1];t++) {
+	for (j=idx[t];mark[j] != k;j=parent[j]) {
+	  li[pos[j]++] = k;
+	  mark[j] = k;
+	}
+      }
+    }
+    free(ptr); free(idx);
+  }
+
+  // supernodes: j+1 continues the supernode of j if it is the parent of j
+  // and the column counts differ by one
+  nsn = 0;
+  for (j=0;j<n;j++) {
+    if (j == 0 || !(parent[j-1] == j && colcount[j-1] == colcount[j]+1)) nsn++;
+  }
+  S->nsn = nsn;
+  S->snode = malloc(n*sizeof(int_t));
+  S->snptr = malloc((nsn+1)*sizeof(int_t));
+  S->snpar = malloc(nsn*sizeof(int_t));
+  S->snpost = malloc(nsn*sizeof(int_t));
+  S->sncolptr = malloc((nsn+1)*sizeof(int_t));
+  S->relptr = malloc((nsn+1)*sizeof(int_t));
+  S->chptr = malloc((nsn+2)*sizeof(int_t));
+  S->chidx = malloc((nsn+1)*sizeof(int_t));
+  S->blkptr = malloc((nsn+1)*sizeof(int_t));
+  sn = malloc(n*sizeof(int_t));
+  if (!S->snode || !S->snptr || !S->snpar || !S->snpost || !S->sncolptr || !S->relptr ||
+      !S->chptr || !S->chidx || !S->blkptr || !sn) goto fail;
+
+  k = -1;
+  for (j=0;j<n;j++) {
+    S->snode[j] = j;
+    if (j == 0 || !(parent[j-1] == j && colcount[j-1] == colcount[j]+1)) S->snptr[++k] = j;
+    sn[j] = k;
+  }
+  S->snptr[nsn] = n;
+
+  // supernodal tree, cliques, and block pointers
+  S->sncolptr[0] = 0;
+  S->blkptr[0] = 0;
+  S->clique_number = 0;
+  for (k=0;k<nsn;k++) {
+    S->snpost[k] = k;
+    j = S->snptr[k+1]-1;
+    S->snpar[k] = (parent[j] == j) ? k : sn[parent[j]];
+    nj = colcount[S->snptr[k]];
+    nn = S->snptr[k+1]-S->snptr[k];
+    S->sncolptr[k+1] = S->sncolptr[k] + nj;
+    S->blkptr[k+1] = S->blkptr[k] + nn*nj;
+    if (nj > S->clique_number) S->clique_number = nj;
+  }
+  if (!(S->snrowidx = malloc((S->sncolptr[nsn]+1)*sizeof(int_t)))) goto fail;
+  for (k=0;k<nsn;k++)
+    memcpy(S->snrowidx+S->sncolptr[k], li+lp[S->snptr[k]], (S->sncolptr[k+1]-S->sncolptr[k])*sizeof(int_t));
+
+  // relative indices of the separator of each clique in the parent clique
+  S->relptr[0] = 0;
+  for (k=0;k<nsn;k++) {
+    nn = S->snptr[k+1]-S->snptr[k];
+    S->relptr[k+1] = S->relptr[k] + ((S->snpar[k] != k) ? S->sncolptr[k+1]-S->sncolptr[k]-nn : 0);
+  }
+  if (!(S->relidx = malloc((S->relptr[nsn]+1)*sizeof(int_t)))) goto fail;
+  for (k=0;k<nsn;k++) {
+    if (S->snpar[k] == k) continue;
+    nn = S->snptr[k+1]-S->snptr[k];
+    l = S->sncolptr[S->snpar[k]];
+    for (t=0,i=0;t<S->relptr[k+1]-S->relptr[k];t++) {
+      while (S->snrowidx[l+i] != S->snrowidx[S->sncolptr[k]+nn+t]) i++;
+      S->relidx[S->relptr[k]+t] = i;
+    }
+  }
+
+  // children of each supernode (in postorder)
+  for (k=0;k<=nsn;k++) S->chptr[k] = 0;
+  for (k=0;k<nsn;k++) if (S->snpar[k] != k) S->chptr[S->snpar[k]+1]++;
+  for (k=0;k<nsn;k++) S->chptr[k+1] += S->chptr[k];
+  for (k=0;k<nsn;k++) work[k] = S->chptr[k];
+  for (k=0;k<nsn;k++) if (S->snpar[k] != k) S->chidx[work[S->snpar[k]]++] = k;
+
+  // storage requirements (see chompack.symbolic)
+  top = 0;
+  S->stack_depth = S->stack_mem = S->stack_solve = S->update_factor_mem = 0;
+  {
+    int_t stack_tmp = 0, stack_stmp = 0;
+    for (k=0;k<nsn;k++) {
+      nn = S->snptr[k+1]-S->snptr[k];
+      na = S->relptr[k+1]-S->relptr[k];
+      if (S->chptr[k+1] > S->chptr[k] && na*(na+1) > S->update_factor_mem)
+	S->update_factor_mem = na*(na+1);
+      for (i=S->chptr[k+1]-1;i>=S->chptr[k];i--) {
+	l = work[--top];
+	stack_tmp -= l*l;
+	stack_stmp -= l;
+      }
+      if (na > 0) {
+	work[top++] = na;
+	stack_tmp += na*na;
+	stack_stmp += na;
+	if (stack_tmp > S->stack_mem) S->stack_mem = stack_tmp;
+	if (stack_stmp > S->stack_solve) S->stack_solve = stack_stmp;
+      }
+      if (top > S->stack_depth) S->stack_depth = top;
+    }
+  }
+
+  free(parent); free(colcount); free(work); free(q); free(flag);
+  free(lp); free(li); free(sn);
+  *symb = S;
+  return 0;
+
+ fail:
+  free(parent); free(colcount); free(work); free(q); free(flag);
+  free(lp); free(li); free(sn);
+  symbolic_free(S);
+  return -1;
+}
+
+void symbolic_free(symbolic *symb) {
+  if (!symb) return;
+  free(symb->p); free(symb->ip);
+  free(symb->snode); free(symb->snptr); free(symb->snpar); free(symb->snpost);
+  free(symb->sncolptr); free(symb->snrowidx);
+  free(symb->relptr); free(symb->relidx);
+  free(symb->chptr); free(symb->chidx);
+  free(symb->blkptr);
+  free(symb);
+}
@@ -0,0 +1,94 @@
+#include "chompack.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static void symm_block(const int_t nsn, const int_t *snptr, const int_t *sncolptr, const int_t *snrowidx,
+		       const int_t *blkptr, const int_t *p, int m, double * restrict B, int ldb,
+		       double * restrict C, int ldc, double alpha, double * restrict blkval, double * restrict ws) {
+  /*
+    C := C + alpha*X*B for the m columns of B and C (see symm()).
+   */
+  int_t k;
+  int nn,na,nj;
+  int_t i,j;
+  const int_t *ri;
+  double * restrict Bk, * restrict Ck;
+  double dOne=1.0,dZero=0.0;
+  char cL='L',cN='N',cT='T';
+
+  for (k=0;k<nsn;k++) {
+    nn = (int) (snptr[k+1]-snptr[k]);
+    nj = (int) (sncolptr[k+1]-sncolptr[k]);
+    na = nj-nn;
+    ri = snrowidx+sncolptr[k];
+    Bk = ws;
+    Ck = ws + (int_t)nj*m;
+
+    // gather the rows of B indexed by the clique
+    for (j=0;j<m;j++) {
+      if (p) for (i=0;i<nj;i++) Bk[j*nj+i] = B[j*ldb+p[ri[i]]];
+      else for (i=0;i<nj;i++) Bk[j*nj+i] = B[j*ldb+ri[i]];
+    }
+
+    // C_k := alpha*[X_{Nk,Nk} X_{Ak,Nk}'; X_{Ak,Nk} 0]*B_k
+    dsymm_(&cL, &cL, &nn, &m, &alpha, blkval+blkptr[k], &nj, Bk, &nj, &dZero, Ck, &nj);
+    if (na > 0) {
+      dgemm_(&cT, &cN, &nn, &m, &na, &alpha, blkval+blkptr[k]+nn, &nj, Bk+nn, &nj, &dOne, Ck, &nj);
+      dgemm_(&cN, &cN, &na, &m, &nn, &alpha, blkval+blkptr[k]+nn, &nj, Bk, &nj, &dZero, Ck+nn, &nj);
+    }
+
+    // scatter-add C_k
+    for (j=0;j<m;j++) {
+      if (p) for (i=0;i<nj;i++) C[j*ldc+p[ri[i]]] += Ck[j*nj+i];
+      else for (i=0;i<nj;i++) C[j*ldc+ri[i]] += Ck[j*nj+i];
+    }
+  }
+}
+
+void symm(const int_t n, const int_t nsn, const int_t *snptr, const int_t *sncolptr, const int_t *snrowidx,
+	  const int_t *blkptr, const int_t *p, int m, double * restrict B, int ldb, double * restrict C, int ldc,
+	  double alpha, double beta, double * restrict blkval, double * restrict ws, int_t ldws, int nthreads) {
+  /*
+    Computes the product
+
+       C := alpha*X*B + beta*C
+
+    where X is the symmetric matrix represented by a cspmatrix (the
+    lower triangle stored in blkval) and B and C are n-by-m dense
+    matrices. The rows p[i] of B and C correspond to the row/column i
+    of X (p = NULL: identity). For each supernode, the rows of B
+    indexed by the clique are gathered into ws, multiplied by the block
+    column (dsymm for the diagonal block, dgemm for the subdiagonal
+    block and its transpose), and the result is added to the rows of C
+    indexed by the clique.
+
+    Different supernodes update the same rows of C, so the columns of
+    B and C (and not the supernodes) are split among the threads. ws
+    must be of length at least nthreads*ldws where ldws =
+    2*clique_number*ceil(m/nthreads).
+   */
+  int t, nt, mb;
+  int_t i, j;
+
+  nt = (nthreads > m) ? m : nthreads;
+  if (nt < 1) nt = 1;
+  mb = (m + nt - 1)/nt;
+
+  if (beta != 1.0) {
+    for (j=0;j<m;j++) {
+      if (beta == 0.0) for (i=0;i<n;i++) C[j*ldc+i] = 0.0;
+      else for (i=0;i<n;i++) C[j*ldc+i] *= beta;
+    }
+  }
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(nt) schedule(static)
+#endif
+  for (t=0;t<nt;t++) {
+    int c0 = t*mb, mc = (c0+mb > m) ? m-c0 : mb;
+    if (mc > 0)
+      symm_block(nsn, snptr, sncolptr, snrowidx, blkptr, p, mc, B+c0*ldb, ldb, C+c0*ldc, ldc,
+		 alpha, blkval, ws+t*ldws);
+  }
+}
@@ -0,0 +1,87 @@
+#include "chompack.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static void gather(const int nj, const int m, const int_t * restrict ri, const int_t * restrict p,
+		   const double * restrict a, const int lda, double * restrict b) {
+  /*
+    Copies the rows p[ri[0]], ..., p[ri[nj-1]] of the m columns of A
+    to the nj-by-m matrix B (p is ignored if NULL).
+   */
+  int_t i,j;
+  for (j=0;j<m;j++) {
+    if (p) for (i=0;i<nj;i++) b[j*nj+i] = a[j*lda+p[ri[i]]];
+    else for (i=0;i<nj;i++) b[j*nj+i] = a[j*lda+ri[i]];
+  }
+}
+
+void syr2k(int_t *Nsn, int_t *snptr, int_t *sncolptr, int_t *snrowidx, int_t *blkptr, int_t *p,
+	   int m, double * restrict U, int ldu, double * restrict V, int ldv, double * restrict w,
+	   double alpha, double beta, double * restrict blkval, double * restrict ws, int_t ldws, int nthreads) {
+  /*
+    Computes the projected low-rank update
+
+       X := beta*X + alpha*P(U*V' + V*U')     if V is not NULL
+       X := beta*X + alpha*P(U*diag(w)*U')    if V is NULL
+
+    where U and V are n-by-m dense matrices and w is a vector of
+    length m (w = 1 if NULL). The rows of the supernodal clique k are
+    gathered once into ws, and the block column k of X is then updated
+    by a dsyr2k/dsyrk for the diagonal block and a dgemm for the
+    subdiagonal block.
+
+    ws must be of length at least nthreads*ldws where ldws =
+    2*m*clique_number. The supernodal loop is parallelized with OpenMP
+    if available; the block columns of X are disjoint, so no
+    synchronization is required.
+   */
+  int_t k;
+  int nn,na,nj;
+  int_t i,j;
+  double * restrict Uk, * restrict Vk;
+  double dOne=1.0,halfalpha=0.5*alpha;
+  char cL='L',cN='N',cT='T';
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(nthreads) schedule(dynamic) private(k,nn,na,nj,i,j,Uk,Vk)
+#endif
+  for (k=0;k<*Nsn;k++) {
+#ifdef _OPENMP
+    Uk = ws + omp_get_thread_num()*ldws;
+#else
+    Uk = ws;
+#endif
+    nn = (int) (snptr[k+1]-snptr[k]);
+    nj = (int) (sncolptr[k+1]-sncolptr[k]);
+    na = nj-nn;
+    Vk = Uk + (int_t)nj*m;
+
+    gather(nj, m, snrowidx+sncolptr[k], p, U, ldu, Uk);
+    if (V) {
+      gather(nj, m, snrowidx+sncolptr[k], p, V, ldv, Vk);
+
+      // diagonal block: X_kk := beta*X_kk + alpha*(U_k*V_k' + V_k*U_k')
+      dsyr2k_(&cL, &cN, &nn, &m, &alpha, Uk, &nj, Vk, &nj, &beta, blkval+blkptr[k], &nj);
+      if (na > 0) {
+	// subdiagonal block
+	dgemm_(&cN, &cT, &na, &nn, &m, &alpha, Uk+nn, &nj, Vk, &nj, &beta, blkval+blkptr[k]+nn, &nj);
+	dgemm_(&cN, &cT, &na, &nn, &m, &alpha, Vk+nn, &nj, Uk, &nj, &dOne, blkval+blkptr[k]+nn, &nj);
+      }
+    }
+    else if (w) {
+      // Vk := U_k[:nn,:]*diag(w)
+      for (j=0;j<m;j++) {
+	for (i=0;i<nn;i++) Vk[j*nn+i] = w[j]*Uk[j*nj+i];
+      }
+      dsyr2k_(&cL, &cN, &nn, &m, &halfalpha, Uk, &nj, Vk, &nn, &beta, blkval+blkptr[k], &nj);
+      if (na > 0)
+	dgemm_(&cN, &cT, &na, &nn, &m, &alpha, Uk+nn, &nj, Vk, &nn, &beta, blkval+blkptr[k]+nn, &nj);
+    }
+    else {
+      dsyrk_(&cL, &cN, &nn, &m, &alpha, Uk, &nj, &beta, blkval+blkptr[k], &nj);
+      if (na > 0)
+	dgemm_(&cN, &cT, &na, &nn, &m, &alpha, Uk+nn, &nj, Uk, &nj, &beta, blkval+blkptr[k]+nn, &nj);
+    }
+  }
+}
@@ -1,31 +1,35 @@
 #include "chompack.h"
+#include "generic.h"
+#include "small.h"
 
-void trsm(const char trans, 
-	  int nrhs,
-	  const double alpha,
-	  const int_t n,         // order of matrix
-	  const int_t nsn,       // number of supernodes/cliques
-	  const int_t *snpost,   // post-ordering of supernodes
-	  const int_t *snptr,    // supernode pointer
-	  const int_t *snode,    // supernode array
-	  const int_t *relptr,
-	  const int_t *relidx,
-	  const int_t *chptr,
-	  const int_t *chidx,
-	  const int_t *blkptr,
-	  const int_t *p,
-	  double * restrict blkval,
-	  double * restrict a,
-	  int * lda,
-	  double * restrict fws,  // frontal matrix workspace
-	  double * restrict upd,  // update matrix workspace
-	  int_t * restrict upd_size
-	  ) {
+void GENERIC(trsm)(const char trans,
+		   int nrhs,
+		   const scalar_t alpha,
+		   const int_t n,           // order of matrix
+		   const int_t nsn,         // number of supernodes/cliques
+		   const index_t *snpost,   // post-ordering of supernodes
+		   const index_t *snptr,    // supernode pointer
+		   const index_t *snode,    // supernode array
+		   const index_t *relptr,
+		   const index_t *relidx,
+		   const index_t *chptr,
+		   const index_t *chidx,
+		   const int_t *blkptr,
+		   const index_t *p,
+		   scalar_t * restrict blkval,
+		   scalar_t * restrict a,
+		   int * lda,
+		   scalar_t * restrict fws,  // frontal matrix workspace
+		   scalar_t * restrict upd,  // update matrix workspace
+		   int_t * restrict upd_size
+		   ) {
 
-  int nn,na,nj,offset,i,j,k,ki,ir,l,N,nup=0;
-  double * restrict U;
-  double dOne=1.0,dNegOne=-1.0;
+  int nn,na,nj,k,ki,ir,l,N,nup=0,small;
+  int_t offset,i,j;
+  scalar_t * restrict U;
+  scalar_t One=1.0,NegOne=-1.0;
   char cL = 'L', cT = 'T', cN = 'N';
+  PROF_DECL;
 
   U = upd;   // pointer to top of update storage
 
@@ -35,6 +39,8 @@ void trsm(const char trans,
       nn = snptr[k+1]-snptr[k];
       na = relptr[k+1]-relptr[k];
       nj = na + nn;
+      small = (nn <= SMALL_NN && na <= SMALL_NA);
+      PROF_BEGIN(PROF_TRSM_N, k, nn, na);
 
       // extract block from rhs
       for (j=0;j<nrhs;j++) {
@@ -47,6 +53,7 @@ void trsm(const char trans,
 	  fws[offset+i] = 0.0;
 	}
       }
+      PROF_PHASE(PHASE_ASSEMBLY);
 
       // add contributions from children
       for (l=chptr[k+1]-1;l>=chptr[k];l--) {
@@ -60,17 +67,25 @@ void trsm(const char trans,
 	  }
 	}
       }
+      PROF_PHASE(PHASE_EXTEND_ADD);
 
       // if k is not a root node
       if (na > 0) {
-	dgemm_(&cN,&cN,&na,&nrhs,&nn,&dNegOne,blkval+blkptr[k]+nn,&nj,fws,&nj,&dOne,fws+nn, &nj);
+	if (small) SMALL_DISPATCH(nn, small_gemm(NN, 'N', na, nrhs, blkval+blkptr[k]+nn, nj, fws, fws+nn, nj));
+	else BLAS(gemm)(&cN,&cN,&na,&nrhs,&nn,&NegOne,blkval+blkptr[k]+nn,&nj,fws,&nj,&One,fws+nn, &nj);
+	PROF_PHASE(PHASE_SYRK);
 	upd_size[nup++] = na;
-	dlacpy_(&cN, &na, &nrhs, fws+nn, &nj, U, &na); 
-	U += na*nrhs;
+	for (j=0;j<nrhs;j++) {
+	  for (i=0;i<na;i++) U[na*j+i] = fws[nj*j+nn+i];
+	}
+	U += (int_t)na*nrhs;
+	PROF_PHASE(PHASE_COPY);
       }
 
       // scale and copy block to rhs
-      dtrsm_(&cL, &cL, &cN, &cN, &nn, &nrhs, &dOne, blkval+blkptr[k], &nj, fws, &nj);
+      if (small) SMALL_DISPATCH(nn, small_trsm(NN, 'N', blkval+blkptr[k], nj, fws, nj, nrhs));
+      else BLAS(trsm)(&cL, &cL, &cN, &cN, &nn, &nrhs, &One, blkval+blkptr[k], &nj, fws, &nj);
+      PROF_PHASE(PHASE_TRSM);
       for (j=0;j<nrhs;j++) {
 	offset = nj*j;
 	for (i=0;i<nn;i++) {
@@ -78,6 +93,9 @@ void trsm(const char trans,
 	  a[j*(*lda) + p[ir]] = fws[offset+i];
 	}
       }
+      PROF_PHASE(PHASE_COPY);
+      PROF_FLOPS(nrhs*(nn*(double)nn + 2.0*na*nn));
+      PROF_END(nup, U-upd);
      
     }
   }
@@ -88,6 +106,8 @@ void trsm(const char trans,
       nn = snptr[k+1]-snptr[k];
       na = relptr[k+1]-relptr[k];
       nj = na + nn;
+      small = (nn <= SMALL_NN && na <= SMALL_NA);
+      PROF_BEGIN(PROF_TRSM_T, k, nn, na);
 
       // extract block from rhs
       for (j=0;j<nrhs;j++) {
@@ -100,14 +120,22 @@ void trsm(const char trans,
 	  fws[offset+i] = 0.0;
 	}
       }
-      dtrsm_(&cL, &cL, &cT, &cN, &nn, &nrhs, &dOne, blkval+blkptr[k], &nj, fws, &nj);
+      PROF_PHASE(PHASE_ASSEMBLY);
+      if (small) SMALL_DISPATCH(nn, small_trsm(NN, 'T', blkval+blkptr[k], nj, fws, nj, nrhs));
+      else BLAS(trsm)(&cL, &cL, &cT, &cN, &nn, &nrhs, &One, blkval+blkptr[k], &nj, fws, &nj);
+      PROF_PHASE(PHASE_TRSM);
       
       // if k is not a root node
       if (na > 0) {
 	nup--;
 	U -= upd_size[nup]*nrhs;
-	dlacpy_(&cN, &na, &nrhs, U, &na, fws+nn, &nj); 
-	dgemm_(&cT,&cN,&nn,&nrhs,&na,&dNegOne,blkval+blkptr[k]+nn,&nj,fws+nn,&nj,&dOne,fws,&nj);
+	for (j=0;j<nrhs;j++) {
+	  for (i=0;i<na;i++) fws[nj*j+nn+i] = U[na*j+i];
+	}
+	PROF_PHASE(PHASE_COPY);
+	if (small) SMALL_DISPATCH(nn, small_gemm(NN, 'T', na, nrhs, blkval+blkptr[k]+nn, nj, fws, fws+nn, nj));
+	else BLAS(gemm)(&cT,&cN,&nn,&nrhs,&na,&NegOne,blkval+blkptr[k]+nn,&nj,fws+nn,&nj,&One,fws,&nj);
+	PROF_PHASE(PHASE_SYRK);
       }
 
       // stack contributions for children
@@ -120,8 +148,9 @@ void trsm(const char trans,
 	    U[N*j+i] = fws[nj*j+relidx[offset+i]];
 	  }
 	}
-	U += N*nrhs;
+	U += (int_t)N*nrhs;
       }
+      PROF_PHASE(PHASE_EXTEND_ADD);
       
       // copy block to rhs
       for (j=0;j<nrhs;j++) {
@@ -131,6 +160,9 @@ void trsm(const char trans,
 	  a[j*(*lda) + p[ir]] = fws[offset+i];
 	}
       }
+      PROF_PHASE(PHASE_COPY);
+      PROF_FLOPS(nrhs*(nn*(double)nn + 2.0*na*nn));
+      PROF_END(nup, U-upd);
             
     }
   }
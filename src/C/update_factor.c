@@ -1,10 +1,11 @@
 #include "chompack.h"
 
-int update_factor(const int_t *ri, int *nn, int *na, double * restrict u, int *ldu, double * restrict f, int *ldf, double *ws) {
+int update_factor(const int_t *ri, int *nn, int *na, double * restrict u, int *ldu, double * restrict f, int *ldf, double * restrict ws) {
 
-  int N1,N2,i,j,ii,jj,offset,info,m,iOne=1;
-  double dOne=1.0,dNegOne=-1.0,dtmp=0.0,tau=0.0;
-  char cL='L',cU='U',cT='T',cN='N';
+  int N1,N2,i,j,jj,js,jb,cs,mp,ldt,info;
+  double dOne=1.0,dNegOne=-1.0;
+  double *C, *tau, *T, *work;
+  char cL='L',cT='T',cN='N',cB='B',cC='C';
 
   /*
     Compute:
@@ -27,32 +28,52 @@ int update_factor(const int_t *ri, int *nn, int *na, double * restrict u, int *l
 
   // check if updating is necessary
   if (N2 > 0) {
-    // extract C = F[nn:,r[N1:]]
+    /*
+      Partition workspace (see UPDATE_FACTOR_WS):
+        C     na-by-N2 matrix, leading dimension na
+        tau   N2 scalar factors of the Householder reflectors
+        T     triangular factor of a block reflector
+        work  workspace for dlarfb
+    */
+    ldt = UPDATE_FACTOR_NB;
+    C = ws;
+    tau = C + (*na)*N2;
+    T = tau + N2;
+    work = T + ldt*ldt;
+
+    // extract C = F[nn:,r[N1:]] and zero out entries above the nonzeros
+    // of each column in the rows spanned by C
+    cs = ri[N1]-(*nn);
     for (j=0;j<N2;j++) {
       jj = ri[N1+j];
-      for (ii=jj;ii<(*ldf);ii++) {
-        ws[(*na)*j+ii-(*nn)] = f[(*ldf)*jj+ii];
-      }
+      for (i=cs;i<jj-(*nn);i++) C[(*na)*j+i] = 0.0;
+      for (i=jj;i<(*ldf);i++) C[(*na)*j+i-(*nn)] = f[(*ldf)*jj+i];
     }
 
-    // reduce C to lower triangular from
-    for (j=0;j<N2;j++) {
-      jj = ri[(*ldu)-1-j]-(*nn);  // index of column in C (ws)
-      ii = ((*na)-jj)-(j+1);            // number of nonzeros to zero out
-      if (ii == 0) continue;
+    /*
+      Reduce C to lower triangular form (QL factorization). Column j
+      of C is nonzero in rows ri[N1+j]-nn, ..., na-1 only, so a panel
+      of columns js, ..., js+jb-1 is reduced by reflectors that act on
+      rows ri[N1+js]-nn, ..., na-N2+js+jb-1 only.
+    */
+    for (j=N2;j>0;j-=jb) {
+      jb = (j < UPDATE_FACTOR_NB) ? j : UPDATE_FACTOR_NB;
+      js = j - jb;
+      cs = ri[N1+js]-(*nn);       // first nonzero row of panel
+      mp = (*na)-N2+j-cs;         // number of rows spanned by reflectors
 
-      // compute and apply Householder reflector
-      m = ii + 1;
-      dlarfg_(&m, ws+(*na)*(N2-j)-1-j, ws+(*na)*(N2-j)-1-j-ii, &iOne, &tau);
-      dtmp = ws[(*na)*(N2-j)-1-j];
-      ws[(*na)*(N2-j)-1-j] = 1.0;
-      i = N2-1-j;
-      dlarfx_(&cL, &m, &i, ws+(*na)*(N2-j)-1-j-ii, &tau, ws+(*na)-1-j-ii, na, ws+(*na)*(*na));
-      ws[(*na)*(N2-j)-1-j] = dtmp;
+      // compute QL factorization of panel
+      dgeql2_(&mp, &jb, C+(*na)*js+cs, na, tau+js, work, &info);
+
+      // apply block reflector H' to columns to the left of panel
+      if (js > 0) {
+	dlarft_(&cB, &cC, &mp, &jb, C+(*na)*js+cs, na, tau+js, T, &ldt);
+	dlarfb_(&cL, &cT, &cB, &cC, &mp, &js, &jb, C+(*na)*js+cs, na, T, &ldt, C+cs, na, work, &js);
+      }
     }
 
-    // copy lower triangular matrix from ws to 2,2 block of U
-    dlacpy_(&cL, &N2, &N2, ws+(*na)-N2, na, u+((*ldu)+1)*N1, ldu);
+    // copy lower triangular matrix from C to 2,2 block of U
+    dlacpy_(&cL, &N2, &N2, C+(*na)-N2, na, u+((*ldu)+1)*N1, ldu);
 
     // compute L_{21} by solving L_{22}'*L_{21} = B
     dtrtrs_(&cL, &cT, &cN, &N2, &N1, u+N1*(*ldu)+N1, ldu, u+N1, ldu, &info);
@@ -62,47 +83,6 @@ int update_factor(const int_t *ri, int *nn, int *na, double * restrict u, int *l
     dsyrk_(&cL, &cT, &N1, &N2, &dNegOne, u+N1, ldu, &dOne, u, ldu);
   }
 
-  /* Compute Li_{11}  (reverse -- factorize -- reverse) */
-  // reverse 1,1 block
-  offset = ((*ldu)+1)*(N1-1);
-  for (j=0;j<N1/2;j++) {
-    for (i=0;i<N1;i++) {
-      dtmp = u[offset-j*(*ldu)-i];
-      u[offset-j*(*ldu)-i] = u[(*ldu)*j+i];
-      u[(*ldu)*j+i] = dtmp;
-    }
-  }
-  if (N1 % 2) { // nn is odd
-    j = N1/2;
-    for (i=0;i<N1/2;i++) {
-      dtmp = u[offset-j*(*ldu)-i];
-      u[offset-j*(*ldu)-i] = u[(*ldu)*j+i];
-      u[(*ldu)*j+i] = dtmp;
-    }
-  }
-
-  // factorize 1,1 block
-  dpotrf_(&cU, &N1, u, ldu, &info);
-  if (info) return info;
-
-  // reverse 1,1 block
-  offset = ((*ldu)+1)*(N1-1);
-  for (j=0;j<N1/2;j++) {
-    for (i=0;i<N1;i++) {
-      dtmp = u[offset-j*(*ldu)-i];
-      u[offset-j*(*ldu)-i] = u[(*ldu)*j+i];
-      u[(*ldu)*j+i] = dtmp;
-    }
-  }
-  if (N1 % 2) { // nn is odd
-    j = N1/2;
-    for (i=0;i<N1/2;i++) {
-      dtmp = u[offset-j*(*ldu)-i];
-      u[offset-j*(*ldu)-i] = u[(*ldu)*j+i];
-      u[(*ldu)*j+i] = dtmp;
-    }
-  }
-
-  return 0;
-
+  // compute Li_{11} such that A - Li_{21}'*Li_{21} = Li_{11}'*Li_{11}
+  return drpotrf(&N1, u, ldu);
 }
@@ -21,27 +21,29 @@ from ._version import get_versions
 __version__ = get_versions()['version']
 del get_versions
 
-from chompack.symbolic import symbolic, cspmatrix, merge_size_fill, peo
+from chompack.symbolic import symbolic, cspmatrix, merge_size_fill, merge_auto, peo
 from cvxopt import spmatrix
 
 try:
-    from chompack.cbase import cholesky,llt,completion,projected_inverse,hessian,trsm
+    from chompack.cbase import cholesky,llt,completion,projected_inverse,hessian,trsm,solve,ldl,ldltrsm
     from chompack.pybase import trmm, psdcompletion, edmcompletion, mrcompletion
     __py_only__ = False
 except:
-    from chompack.pybase import cholesky,llt,completion,projected_inverse,hessian,trsm,trmm,psdcompletion,mrcompletion,edmcompletion
+    from chompack.pybase import cholesky,llt,completion,projected_inverse,hessian,trsm,solve,trmm,psdcompletion,mrcompletion,edmcompletion,ldl,ldltrsm
     __py_only__ = True
     
 from chompack.pfcholesky import pfcholesky
+from chompack.steplength import steplength
 from chompack.misc import tril, triu, symmetrize, perm, eye
 from chompack.conversion import convert_block, convert_conelp
-from chompack.base import dot, syr2
+from chompack.base import dot, gram, syr2, syrk, symm
+from chompack.spmap import spmap
 from chompack.maxchord import maxchord
 from chompack.mcs import maxcardsearch
 
 __all__ = ["__version__","cspmatrix","spmatrix","symbolic","peo","maxcardsearch","maxchord",\
            "cholesky", "llt", "completion", "psdcompletion", "edmcompletion", "mrcompletion","projected_inverse", "hessian",\
-           "trsm", "trmm", "tril", "triu", "convert_block", "convert_conelp", "dot", "syr2"]
+           "trsm", "trmm", "solve", "ldl", "ldltrsm", "steplength", "tril", "triu", "convert_block", "convert_conelp", "dot", "gram", "syr2", "syrk", "symm", "spmap"]
 
 from ._version import get_versions
 __version__ = get_versions()['version']
@@ -25,43 +25,143 @@ except:
                 val += 2.0*blas.dot(X.blkval,Y.blkval,offsetx=offset+ck*j+j,offsety=offset+ck*j+j,n=ck-j)
         return val
 
-def syr2(X, u, v, alpha = 1.0, beta = 1.0, reordered=False):
-    r"""
-    Computes the projected rank 2 update of a cspmatrix X
-
-    .. math::
-         X := \alpha*P(u v^T + v u^T) + \beta X.
-    """
-    assert X.is_factor is False, "cspmatrix factor object"
-    symb = X.symb
-    n = symb.n
-    snptr = symb.snptr
-    snode = symb.snode
-    blkval = X.blkval
-    blkptr = symb.blkptr
-    relptr = symb.relptr
-    snrowidx = symb.snrowidx
-    sncolptr = symb.sncolptr
-
-    if symb.p is not None and reordered is False:
-        up = u[symb.p]
-        vp = v[symb.p]
-    else:
-        up = u
-        vp = v
+try:
+    from chompack.cbase import gram
+except:
+    def gram(X, Y = None):
+        """
+        Computes the matrix of trace products G[i,j] = tr(X[i]*Y[j])
+        of two lists of cspmatrix objects (Y defaults to X).
+        """
+        if Y is None or Y is X:
+            m = len(X)
+            G = matrix(0.0,(m,m))
+            for j in range(m):
+                for i in range(j,m):
+                    G[i,j] = dot(X[i],X[j])
+                    G[j,i] = G[i,j]
+            return G
+        G = matrix(0.0,(len(X),len(Y)))
+        for j in range(len(Y)):
+            for i in range(len(X)):
+                G[i,j] = dot(X[i],Y[j])
+        return G
+
+try:
+    from chompack.cbase import syr2, syrk
+except:
+    def syr2(X, u, v, alpha = 1.0, beta = 1.0, reordered=False):
+        r"""
+        Computes the projected rank 2 update of a cspmatrix X
+
+        .. math::
+             X := \alpha*P(u v^T + v u^T) + \beta X.
+        """
+        assert X.is_factor is False, "cspmatrix factor object"
+        symb = X.symb
+        n = symb.n
+        snptr = symb.snptr
+        snode = symb.snode
+        blkval = X.blkval
+        blkptr = symb.blkptr
+        relptr = symb.relptr
+        snrowidx = symb.snrowidx
+        sncolptr = symb.sncolptr
+
+        if symb.p is not None and reordered is False:
+            up = u[symb.p]
+            vp = v[symb.p]
+        else:
+            up = u
+            vp = v
             
-    for k in range(symb.Nsn):
-        nn = snptr[k+1]-snptr[k]     
-        na = relptr[k+1]-relptr[k] 
-        nj = na + nn
+        for k in range(symb.Nsn):
+            nn = snptr[k+1]-snptr[k]     
+            na = relptr[k+1]-relptr[k] 
+            nj = na + nn
 
-        for i in range(nn): blas.scal(beta, blkval, n = nj-i, offset = blkptr[k]+(nj+1)*i)
+            for i in range(nn): blas.scal(beta, blkval, n = nj-i, offset = blkptr[k]+(nj+1)*i)
 
-        uk = up[snrowidx[sncolptr[k]:sncolptr[k+1]]]
-        vk = vp[snrowidx[sncolptr[k]:sncolptr[k+1]]]
+            uk = up[snrowidx[sncolptr[k]:sncolptr[k+1]]]
+            vk = vp[snrowidx[sncolptr[k]:sncolptr[k+1]]]
 
-        blas.syr2(uk, vk, blkval, n = nn, offsetA = blkptr[k], ldA = nj, alpha = alpha)
-        blas.ger(uk, vk, blkval, m = na, n = nn, offsetx = nn, offsetA = blkptr[k]+nn, ldA = nj, alpha = alpha)
-        blas.ger(vk, uk, blkval, m = na, n = nn, offsetx = nn, offsetA = blkptr[k]+nn, ldA = nj, alpha = alpha)
+            blas.syr2(uk, vk, blkval, n = nn, offsetA = blkptr[k], ldA = nj, alpha = alpha)
+            blas.ger(uk, vk, blkval, m = na, n = nn, offsetx = nn, offsetA = blkptr[k]+nn, ldA = nj, alpha = alpha)
+            blas.ger(vk, uk, blkval, m = na, n = nn, offsetx = nn, offsetA = blkptr[k]+nn, ldA = nj, alpha = alpha)
         
-    return
+        return
+
+    def syrk(X, U, w = None, alpha = 1.0, beta = 1.0, reordered = False, nthreads = 1):
+        r"""
+        Computes the projected low-rank update of a cspmatrix X
+
+        .. math::
+             X := \alpha*P(U \mathbf{diag}(w) U^T) + \beta X.
+        """
+        assert X.is_factor is False, "cspmatrix factor object"
+        symb = X.symb
+        snptr = symb.snptr
+        blkval = X.blkval
+        blkptr = symb.blkptr
+        snrowidx = symb.snrowidx
+        sncolptr = symb.sncolptr
+        m = U.size[1]
+
+        if symb.p is not None and reordered is False:
+            Up = U[symb.p,:]
+        else:
+            Up = U
+
+        for k in range(symb.Nsn):
+            nn = snptr[k+1]-snptr[k]
+            nj = sncolptr[k+1]-sncolptr[k]
+            Uk = Up[snrowidx[sncolptr[k]:sncolptr[k+1]],:]
+            Vk = +Uk[:nn,:]
+            if w is not None:
+                for j in range(m): Vk[:,j] *= w[j]
+            if nn > 0:
+                blas.syr2k(Uk, Vk, blkval, n = nn, k = m, ldA = nj, ldB = nn, ldC = nj, offsetC = blkptr[k], alpha = 0.5*alpha, beta = beta)
+            if nj > nn:
+                blas.gemm(Uk, Vk, blkval, transB = 'T', m = nj-nn, n = nn, k = m, ldA = nj, ldB = nn, offsetA = nn, ldC = nj, offsetC = blkptr[k]+nn, alpha = alpha, beta = beta)
+        return
+
+try:
+    from chompack.cbase import symm
+except:
+    def symm(X, B, C, alpha = 1.0, beta = 0.0, reordered = False, nthreads = 1):
+        r"""
+        Computes the product of a cspmatrix X and a dense matrix
+
+        .. math::
+             C := \alpha X B + \beta C.
+        """
+        assert X.is_factor is False, "cspmatrix factor object"
+        symb = X.symb
+        n = symb.n
+        snptr = symb.snptr
+        blkval = X.blkval
+        blkptr = symb.blkptr
+        snrowidx = symb.snrowidx
+        sncolptr = symb.sncolptr
+        assert isinstance(B, matrix) and isinstance(C, matrix) and B.size[0] == n and C.size == B.size, \
+            "B and C must be matrices with n rows and the same number of columns"
+        m = B.size[1]
+
+        if symb.p is not None and reordered is False:
+            p = symb.p
+        else:
+            p = matrix(range(n))
+
+        blas.scal(beta, C)
+        for k in range(symb.Nsn):
+            nn = snptr[k+1]-snptr[k]
+            nj = sncolptr[k+1]-sncolptr[k]
+            r = p[snrowidx[sncolptr[k]:sncolptr[k+1]]]
+            Bk = B[r,:]
+            Ck = matrix(0.0, (nj,m))
+            blas.symm(blkval, Bk, Ck, m = nn, n = m, ldA = nj, offsetA = blkptr[k], alpha = alpha)
+            if nj > nn:
+                blas.gemm(blkval, Bk, Ck, transA = 'T', m = nn, n = m, k = nj-nn, ldA = nj, offsetA = blkptr[k]+nn, offsetB = nn, alpha = alpha, beta = 1.0)
+                blas.gemm(blkval, Bk, Ck, m = nj-nn, n = m, k = nn, ldA = nj, offsetA = blkptr[k]+nn, offsetC = nn, alpha = alpha)
+            C[r,:] += Ck
+        return
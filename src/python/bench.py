@@ -0,0 +1,274 @@
+"""
+End-to-end benchmark of chompack.
+
+Times the stages of a typical pipeline (symbolic factorization,
+cspmatrix assembly and conversion, numerical kernels, completion, and
+clique conversion of a cone LP) on scalable generated instances. The
+C implementation and the Python reference implementation
+(:py:mod:`chompack.pybase`) are both timed where both exist.
+
+Results can be stored as a baseline and later runs compared against
+it; stages that are slower than the baseline by more than a given
+tolerance are flagged. Run ``python -m chompack.bench --help`` for
+usage.
+"""
+from __future__ import print_function
+import sys, time, json, random, platform, argparse
+from cvxopt import matrix, spmatrix, amd
+from chompack.symbolic import symbolic, cspmatrix
+from chompack import pybase
+import chompack.conversion as conversion
+
+try:
+    from chompack import cbase
+except:
+    cbase = None
+
+__all__ = ['problem', 'run', 'compare', 'main']
+
+SCALES = {
+    'small':  ['grid2d:20', 'grid3d:6', 'band:400:8', 'arrow:400:8', 'randchordal:300:0.9'],
+    'medium': ['grid2d:50', 'grid3d:12', 'band:2000:16', 'arrow:2000:16', 'randchordal:1500:0.9'],
+    'large':  ['grid2d:120', 'grid3d:20', 'band:10000:32', 'arrow:10000:32', 'randchordal:8000:0.9'],
+}
+
+STAGES = ['symbolic', 'iadd', 'spmatrix', 'cholesky', 'llt', 'projected_inverse', 'completion',
+          'hessian', 'trsm', 'psdcompletion', 'convert_conelp']
+
+# dense completion is O(n^2) in memory; skip it for larger problems
+MAX_DENSE = 1500
+
+
+def _edges(spec, rng):
+    """
+    Returns (n, edges) where edges is a list of strictly lower triangular
+    entries (i,j), i > j, of the sparsity pattern given by spec.
+    """
+    name, args = spec.split(':')[0], spec.split(':')[1:]
+    if name in ('grid2d', 'grid3d'):
+        N = int(args[0])
+        nz = N if name == 'grid3d' else 1
+        n = N*N*nz
+        E = []
+        for z in range(nz):
+            for y in range(N):
+                for x in range(N):
+                    j = x + N*(y + N*z)
+                    if x+1 < N: E.append((j+1, j))
+                    if y+1 < N: E.append((j+N, j))
+                    if z+1 < nz: E.append((j+N*N, j))
+        return n, E
+    elif name == 'band':
+        n, bw = int(args[0]), int(args[1])
+        return n, [(i, j) for j in range(n) for i in range(j+1, min(n, j+bw+1))]
+    elif name == 'arrow':
+        n, w = int(args[0]), int(args[1])
+        return n, [(i, j) for i in range(n-w, n) for j in range(i)]
+    elif name == 'randchordal':
+        n = int(args[0])
+        keep = float(args[1]) if len(args) > 1 else 0.9
+        adj = [[] for _ in range(n)]
+        E = []
+        for j in range(n-2, -1, -1):
+            p = rng.randint(j+1, n-1)
+            adj[j] = [p] + [i for i in adj[p] if rng.random() < keep]
+            E.extend((i, j) for i in adj[j])
+        return n, E
+    raise ValueError("invalid problem specification '%s'" % spec)
+
+
+def problem(spec, seed = 1):
+    """
+    Generates a sparse positive definite matrix (lower triangular part)
+    with the sparsity pattern given by spec, which is one of
+
+        grid2d:N, grid3d:N, band:n:bw, arrow:n:w, randchordal:n[:keep]
+
+    The off-diagonal values are random and the diagonal is dominant.
+    """
+    rng = random.Random(seed)
+    n, E = _edges(spec, rng)
+    V = [2.0*rng.random()-1.0 for _ in E]
+    d = [1.0]*n
+    for (i, j), v in zip(E, V):
+        d[i] += abs(v)
+        d[j] += abs(v)
+    return spmatrix(V + d, [i for i, j in E] + list(range(n)), [j for i, j in E] + list(range(n)), (n, n))
+
+
+def _timeit(setup, fun, reps, warmup):
+    """
+    Calls fun(*setup()) warmup+reps times and returns the timings of
+    the last reps calls; setup() is not timed.
+    """
+    t = []
+    for r in range(warmup + reps):
+        args = setup()
+        t0 = time.perf_counter() if hasattr(time, 'perf_counter') else time.time()
+        fun(*args)
+        t1 = time.perf_counter() if hasattr(time, 'perf_counter') else time.time()
+        if r >= warmup: t.append(t1-t0)
+    t.sort()
+    m = len(t)
+    return {'min': t[0], 'median': t[m//2] if m % 2 else 0.5*(t[m//2-1]+t[m//2]), 'mean': sum(t)/m, 'reps': m}
+
+
+def _sdp(A, m, seed):
+    """
+    Cone LP with a single semidefinite block whose aggregate sparsity
+    pattern is that of A: G has m columns, each the vectorized lower
+    triangular part of a random subset of the entries of A.
+    """
+    rng = random.Random(seed)
+    n = A.size[0]
+    I, J, V = [], [], []
+    for i, j, v in zip(A.I, A.J, A.V):
+        I.append(i + j*n); J.append(rng.randint(0, m-1)); V.append(v)
+    G = spmatrix(V, I, J, (n*n, m))
+    h = spmatrix(1.0, [j*(n+1) for j in range(n)], n*[0], (n*n, 1))
+    c = matrix([rng.random() for _ in range(m)])
+    return c, G, h, {'l': 0, 'q': [], 's': [n]}
+
+
+def _stages(spec, A, stages, backends):
+    """
+    Yields (stage, backend, setup, fun) for each timed stage.
+    """
+    symb = symbolic(A, p = amd.order)
+    X = cspmatrix(symb) + A
+    L = X.copy()
+    (cbase or pybase).cholesky(L)
+    Y = L.copy()
+    (cbase or pybase).projected_inverse(Y)
+    B = matrix([random.random() for _ in range(symb.n)])
+
+    impl = {'c': cbase, 'py': pybase}
+    if 'symbolic' in stages:
+        yield 'symbolic', 'py', lambda: (), lambda: symbolic(A, p = amd.order)
+    if 'iadd' in stages:
+        yield 'iadd', 'py', lambda: (cspmatrix(symb),), lambda Z: Z._iadd_spmatrix(A)
+    if 'spmatrix' in stages:
+        yield 'spmatrix', 'py', lambda: (), lambda: X.spmatrix(reordered = False, symmetric = True)
+    for be in backends:
+        mod = impl[be]
+        if mod is None: continue
+        if 'cholesky' in stages:
+            yield 'cholesky', be, lambda: (X.copy(),), mod.cholesky
+        if 'llt' in stages:
+            yield 'llt', be, lambda: (L.copy(),), mod.llt
+        if 'projected_inverse' in stages:
+            yield 'projected_inverse', be, lambda: (L.copy(),), mod.projected_inverse
+        if 'completion' in stages:
+            yield 'completion', be, lambda: (Y.copy(),), lambda Z: mod.completion(Z, factored_updates = False)
+        if 'hessian' in stages:
+            yield 'hessian', be, lambda: ([X.copy()],), lambda U: (mod.hessian(L, Y, U, adj = False), mod.hessian(L, Y, U, adj = True))
+        if 'trsm' in stages:
+            yield 'trsm', be, lambda: (matrix(B),), lambda b: (mod.trsm(L, b), mod.trsm(L, b, trans = 'T'))
+    if 'psdcompletion' in stages and symb.n <= MAX_DENSE:
+        yield 'psdcompletion', 'py', lambda: (), lambda: pybase.psdcompletion(Y)
+    if 'convert_conelp' in stages:
+        prob = _sdp(A, max(1, min(50, symb.n//4)), 1)
+        saved = conversion.block_convert
+        for be in backends:
+            if be == 'c' and saved is None: continue
+            def fun(be = be):
+                conversion.block_convert = saved if be == 'c' else None
+                try:
+                    conversion.convert_conelp(*prob, max_density = 1.0)
+                finally:
+                    conversion.block_convert = saved
+            yield 'convert_conelp', be, lambda: (), fun
+
+
+def run(problems = None, scale = 'small', stages = None, backends = ('c', 'py'), reps = 5, warmup = 1, seed = 1, log = None):
+    """
+    Runs the benchmark and returns a dictionary with the keys 'meta'
+    and 'results'. The results are keyed by 'problem/stage/backend'.
+
+    :param problems:  list of problem specifications (default: SCALES[scale])
+    :param scale:     'small', 'medium', or 'large'
+    :param stages:    list of stages (default: all)
+    :param backends:  'c' and/or 'py'
+    """
+    problems = problems or SCALES[scale]
+    stages = stages or STAGES
+    results = {}
+    random.seed(seed)
+    for spec in problems:
+        A = problem(spec, seed)
+        for stage, be, setup, fun in _stages(spec, A, stages, backends):
+            key = '%s/%s/%s' % (spec, stage, be)
+            results[key] = _timeit(setup, fun, reps, warmup)
+            if log: log("%-40s %12.6f s" % (key, results[key]['min']))
+    meta = {'python': platform.python_version(), 'machine': platform.machine(),
+            'platform': platform.platform(), 'c_extension': cbase is not None,
+            'reps': reps, 'warmup': warmup, 'seed': seed}
+    return {'meta': meta, 'results': results}
+
+
+def compare(current, baseline, tol = 0.25, stat = 'min'):
+    """
+    Compares two benchmark results and returns a list of
+    (key, baseline time, current time, ratio) for each entry that is
+    slower than the baseline by more than a factor 1+tol.
+    """
+    slow = []
+    for key, res in sorted(current['results'].items()):
+        ref = baseline['results'].get(key)
+        if ref is None or ref[stat] <= 0.0: continue
+        ratio = res[stat]/ref[stat]
+        if ratio > 1.0 + tol:
+            slow.append((key, ref[stat], res[stat], ratio))
+    return slow
+
+
+def main(argv = None):
+    parser = argparse.ArgumentParser(prog = 'python -m chompack.bench',
+                                     description = 'End-to-end benchmark of chompack.')
+    parser.add_argument('--problem', action = 'append', dest = 'problems',
+                        help = 'problem specification (grid2d:N, grid3d:N, band:n:bw, arrow:n:w, '
+                        'randchordal:n[:keep]); may be repeated')
+    parser.add_argument('--scale', choices = sorted(SCALES), default = 'small', help = 'problem suite (default: small)')
+    parser.add_argument('--stages', help = 'comma-separated list of stages (default: %s)' % ','.join(STAGES))
+    parser.add_argument('--backends', default = 'c,py', help = 'comma-separated list of backends (default: c,py)')
+    parser.add_argument('--reps', type = int, default = 5)
+    parser.add_argument('--warmup', type = int, default = 1)
+    parser.add_argument('--seed', type = int, default = 1)
+    parser.add_argument('--output', help = 'write results to this JSON file')
+    parser.add_argument('--baseline', help = 'compare against the results in this JSON file')
+    parser.add_argument('--save-baseline', help = 'write results as a new baseline to this JSON file')
+    parser.add_argument('--tolerance', type = float, default = 0.25,
+                        help = 'flag stages that are slower than the baseline by more than this fraction (default: 0.25)')
+    args = parser.parse_args(argv)
+
+    stages = args.stages.split(',') if args.stages else None
+    for s in stages or []:
+        if s not in STAGES: parser.error("unknown stage '%s'" % s)
+    backends = args.backends.split(',')
+    for b in backends:
+        if b not in ('c', 'py'): parser.error("unknown backend '%s'" % b)
+
+    log = lambda s: print(s, file = sys.stderr)
+    res = run(args.problems, args.scale, stages, backends, args.reps, args.warmup, args.seed, log)
+
+    for fname in (args.output, args.save_baseline):
+        if fname:
+            with open(fname, 'w') as f:
+                json.dump(res, f, indent = 1, sort_keys = True)
+    if args.output is None and args.save_baseline is None:
+        json.dump(res, sys.stdout, indent = 1, sort_keys = True)
+        print()
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            base = json.load(f)
+        slow = compare(res, base, args.tolerance)
+        for key, t0, t1, ratio in slow:
+            log("SLOWER  %-40s %12.6f s -> %12.6f s  (x%.2f)" % (key, t0, t1, ratio))
+        if slow: return 1
+        log("no slowdowns beyond %.0f%% relative to %s" % (100*args.tolerance, args.baseline))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1,8 +1,12 @@
 from cvxopt import matrix, spdiag, spmatrix, sparse, amd
-import itertools
 from chompack.symbolic import symbolic
 from chompack.misc import tril, symmetrize, perm
 
+try:
+    from chompack.cbase import block_convert, block_coupling, block_to_sparse
+except:
+    block_convert = None
+
 def symb_to_block(symb, coupling = 'full'):
     """
     Maps a symbolic factorization to a block-diagonal structure with
@@ -119,7 +123,10 @@ def convert_block(G, h, dim, **kwargs):
     The return value `blk2sparse` is a 4-tuple
     (`blki,I,J,n`) that defines a mapping between the sparse
     matrix representation and the converted block-diagonal
-    representation. If `blkvec` represents a block-diagonal matrix,
+    representation; `blki`, `I`, and `J` are integer
+    :py:class:`matrix` objects of equal length, and `n` is the
+    length of the block-diagonal representation. If `blkvec`
+    represents a block-diagonal matrix,
     then
 
     .. code-block:: python
@@ -206,6 +213,16 @@ def convert_block(G, h, dim, **kwargs):
         coupling = spmatrix(1.0,[i for j in range(Va.size[0]) for i in range(j,min(Va.size[0],j+bw+1))],\
                             [j for j in range(Va.size[0]) for i in range(j,min(Va.size[0],j+bw+1))],Va.size)
         
+    if block_convert is not None:
+        # build G_b, h_b, and G_c from index arrays computed in C
+        dims = [F.sncolptr[k+1]-F.sncolptr[k] for k in range(F.Nsn)]
+        G_converted = block_convert(F, G)
+        h_converted = block_convert(F, spmatrix(h.V, h.I, h.J, h.size, tc = tc))
+        if type(coupling) is spmatrix: G_coupling = block_coupling(F, coupling, tc)
+        elif coupling == 'full': G_coupling = block_coupling(F, None, tc)
+        else: G_coupling = spmatrix([], [], [], (G_converted.size[0], 0), tc = tc)
+        return (G_converted, h_converted, G_coupling, dims), block_to_sparse(F), F
+
     dims, sparse_to_block, constraints = symb_to_block(F, coupling = coupling)
         
     # dimension of block-diagonal representation
@@ -313,8 +330,8 @@ def convert_block(G, h, dim, **kwargs):
     idx.sort()
     idx, blki = zip(*idx)
     blki = matrix(blki)
-    I = [v%dim for v in idx]
-    J = [v//dim for v in idx]
+    I = matrix([v%dim for v in idx])
+    J = matrix([v//dim for v in idx])
     n = sum([di**2 for di in dims])
     
     return (G_converted, h_converted, G_coupling, dims), (blki, I, J, n), F
@@ -339,7 +356,8 @@ def convert_conelp(c, G, h, dims, A = None, b = None, **kwargs):
         probc, blk2sparse, symbs = convert_conelp(*prob)
     
     The return value `blk2sparse` is a list of 4-tuples
-    (`blki,I,J,n`) that each defines a mapping between the sparse
+    (`blki,I,J,n`), as returned by :py:func:`convert_block`, that
+    each defines a mapping between the sparse
     matrix representation and the converted block-diagonal
     representation, and `symbs` is a list of symbolic factorizations
     corresponding to each of the semidefinite blocks in the original cone LP.
@@ -392,17 +410,20 @@ def convert_conelp(c, G, h, dims, A = None, b = None, **kwargs):
 
     G1 = sparse(G_converted)
 
+    # stack the coupling blocks block-diagonally from their index matrices
     I,J,V = [],[],[]
     offset = [G_lq.size[0], 0]
     for Gcpl in G_coupling:
-        I.append(Gcpl.I + offset[0])
-        J.append(Gcpl.J + offset[1])
-        V.append(Gcpl.V)
+        if len(Gcpl):
+            I.append(Gcpl.I + offset[0])
+            J.append(Gcpl.J + offset[1])
+            V.append(Gcpl.V)
         offset[0] += Gcpl.size[0]
         offset[1] += Gcpl.size[1]
-    G2 = spmatrix([v for v in itertools.chain(*V)],
-                  [v for v in itertools.chain(*I)],
-                  [v for v in itertools.chain(*J)],tuple(offset))
+    if V:
+        G2 = spmatrix(matrix(V), matrix(I), matrix(J), tuple(offset), tc = G.typecode)
+    else:
+        G2 = spmatrix([], [], [], tuple(offset), tc = G.typecode)
     
     if offset[0] == 0 or offset[1] == 0:
         G = G1
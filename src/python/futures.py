@@ -0,0 +1,112 @@
+"""
+Asynchronous execution of the numeric routines.
+
+The C routines release the GIL while the multifrontal kernels run, so
+independent factorizations submitted from several Python threads run
+concurrently. :py:class:`Executor` wraps a thread pool and returns
+:py:class:`concurrent.futures.Future` objects. Example:
+
+.. code-block:: python
+
+    with chompack.futures.Executor(max_workers = 4) as ex:
+        fs = [ex.cholesky(X) for X in Xs]
+        for f in fs: f.result()
+
+A :py:class:`cspmatrix` may be read by several calls at once (e.g.,
+:py:func:`trsm` with the same factor), but a call that modifies it
+(e.g., :py:func:`cholesky`) raises :py:exc:`RuntimeError` if the
+matrix is in use by another call. Two :py:class:`cspmatrix` objects
+that share a `blkval` array are not protected.
+"""
+from concurrent.futures import ThreadPoolExecutor
+import chompack as cp
+
+__all__ = ['Executor']
+
+
+class Executor(object):
+    """
+    Thread pool for the numeric routines.
+
+    :param max_workers:  maximum number of threads (default: see :py:class:`concurrent.futures.ThreadPoolExecutor`)
+
+    Each method submits the corresponding routine with the same
+    arguments and returns a :py:class:`concurrent.futures.Future`
+    whose result is the return value of the routine.
+    """
+
+    def __init__(self, max_workers = None):
+        self._pool = ThreadPoolExecutor(max_workers = max_workers)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.shutdown(wait = True)
+        return False
+
+    def submit(self, fn, *args, **kwargs):
+        """
+        Schedules `fn(*args, **kwargs)` and returns a future.
+        """
+        return self._pool.submit(fn, *args, **kwargs)
+
+    def shutdown(self, wait = True):
+        """
+        Frees the threads when the pending calls are done.
+        """
+        self._pool.shutdown(wait = wait)
+
+    def cholesky(self, X, **kwargs):
+        """
+        Submits :py:func:`chompack.cholesky`.
+        """
+        return self.submit(cp.cholesky, X, **kwargs)
+
+    def llt(self, L):
+        """
+        Submits :py:func:`chompack.llt`.
+        """
+        return self.submit(cp.llt, L)
+
+    def projected_inverse(self, L):
+        """
+        Submits :py:func:`chompack.projected_inverse`.
+        """
+        return self.submit(cp.projected_inverse, L)
+
+    def completion(self, X, **kwargs):
+        """
+        Submits :py:func:`chompack.completion`.
+        """
+        return self.submit(cp.completion, X, **kwargs)
+
+    def hessian(self, L, Y, U, **kwargs):
+        """
+        Submits :py:func:`chompack.hessian`.
+        """
+        return self.submit(cp.hessian, L, Y, U, **kwargs)
+
+    def trsm(self, L, B, **kwargs):
+        """
+        Submits :py:func:`chompack.trsm`.
+        """
+        return self.submit(cp.trsm, L, B, **kwargs)
+
+    def solve(self, A, L, B, **kwargs):
+        """
+        Submits :py:func:`chompack.solve`.
+        """
+        return self.submit(cp.solve, A, L, B, **kwargs)
+
+    def ldl(self, X, ipiv, **kwargs):
+        """
+        Submits :py:func:`chompack.ldl`.
+        """
+        return self.submit(cp.ldl, X, ipiv, **kwargs)
+
+    def ldltrsm(self, L, ipiv, B, **kwargs):
+        """
+        Submits :py:func:`chompack.ldltrsm`.
+        """
+        return self.submit(cp.ldltrsm, L, ipiv, B, **kwargs)
@@ -0,0 +1,131 @@
+"""
+Per-supernode instrumentation of the multifrontal kernels.
+
+The C extension must be built with ``CHOMPACK_PROFILE=1`` (see
+setup.py); otherwise the instrumentation is compiled out and
+:py:func:`enable` raises :py:exc:`NotImplementedError`. Example:
+
+.. code-block:: python
+
+    with chompack.profiling.record() as prof:
+        chompack.cholesky(L)
+    print(chompack.profiling.summary(prof.data))
+    chompack.profiling.chrome_trace(prof.data, 'cholesky.json')
+
+The trace can be viewed in chrome://tracing or https://ui.perfetto.dev.
+"""
+import json
+
+try:
+    from chompack.cbase import profile as _profile, profile_data as _profile_data
+except:
+    _profile = _profile_data = None
+
+__all__ = ['KERNELS', 'PHASES', 'enable', 'disable', 'data', 'record', 'summary', 'chrome_trace']
+
+# must match the PROF_* and PHASE_* enums in chompack.h
+KERNELS = ['cholesky', 'llt', 'projected_inverse', 'completion',
+           'hessian_y2k', 'hessian_m2t', 'hessian_scale', 'trsm_n', 'trsm_t']
+PHASES = ['assembly', 'factor', 'trsm', 'syrk', 'extend_add', 'copy']
+
+
+def enable():
+    """
+    Discards recorded data and enables instrumentation.
+    """
+    if _profile is None:
+        raise NotImplementedError("instrumentation requires the C extension")
+    _profile(True)
+
+
+def disable():
+    """
+    Disables instrumentation (the recorded data is discarded).
+    """
+    if _profile is None:
+        raise NotImplementedError("instrumentation requires the C extension")
+    _profile(False)
+
+
+def data():
+    """
+    Returns the data recorded since :py:func:`enable` was called as a
+    dictionary of column matrices with one entry per (kernel, supernode)
+    record. See :py:data:`KERNELS` and :py:data:`PHASES`.
+    """
+    if _profile_data is None:
+        raise NotImplementedError("instrumentation requires the C extension")
+    return _profile_data()
+
+
+class record(object):
+    """
+    Context manager that enables instrumentation on entry and stores
+    the recorded data in the attribute `data` on exit.
+    """
+    def __init__(self):
+        self.data = None
+
+    def __enter__(self):
+        enable()
+        return self
+
+    def __exit__(self, *exc):
+        self.data = data()
+        disable()
+        return False
+
+
+def summary(D):
+    """
+    Returns a dictionary with per-kernel totals: the number of
+    supernodes, the time spent in each phase, the total time, the flop
+    count, and the peak size of the update matrix stack in bytes.
+    """
+    S = {}
+    for t in range(len(D['kernel'])):
+        name = KERNELS[D['kernel'][t]]
+        s = S.setdefault(name, dict([('supernodes', 0), ('time', 0.0), ('flops', 0.0), ('stack_bytes', 0)] +
+                                    [(ph, 0.0) for ph in PHASES]))
+        s['supernodes'] += 1
+        for ph in PHASES:
+            s[ph] += D[ph][t]
+            s['time'] += D[ph][t]
+        s['flops'] += D['flops'][t]
+        s['stack_bytes'] = max(s['stack_bytes'], D['stack_bytes'][t])
+    return S
+
+
+def chrome_trace(D, filename = None):
+    """
+    Converts the recorded data to the Chrome trace event format (also
+    read by Perfetto). Each supernode is a complete event with its
+    phases as nested events (laid out in the order of :py:data:`PHASES`;
+    a phase that occurs more than once per supernode is merged), and
+    the size of the update matrix stack is a counter. The kernels are
+    shown as separate threads.
+
+    Returns the trace as a dictionary, and writes it to `filename` as
+    JSON if given.
+    """
+    events = [{'name': 'thread_name', 'ph': 'M', 'pid': 0, 'tid': k, 'args': {'name': name}}
+              for k, name in enumerate(KERNELS)]
+    for t in range(len(D['kernel'])):
+        k = D['kernel'][t]
+        ts = 1e6*D['start'][t]
+        dur = 1e6*sum(D[ph][t] for ph in PHASES)
+        args = {'supernode': D['supernode'][t], 'nn': D['nn'][t], 'na': D['na'][t], 'flops': D['flops'][t]}
+        events.append({'name': 'supernode %i' % D['supernode'][t], 'cat': KERNELS[k], 'ph': 'X',
+                       'pid': 0, 'tid': k, 'ts': ts, 'dur': dur, 'args': args})
+        for ph in PHASES:
+            d = 1e6*D[ph][t]
+            if d > 0.0:
+                events.append({'name': ph, 'cat': KERNELS[k], 'ph': 'X', 'pid': 0, 'tid': k, 'ts': ts, 'dur': d})
+            ts += d
+        events.append({'name': 'update stack', 'ph': 'C', 'pid': 0, 'tid': k, 'ts': ts,
+                       'args': {'bytes': D['stack_bytes'][t], 'depth': D['stack_depth'][t]}})
+    trace = {'traceEvents': events, 'displayTimeUnit': 'ms'}
+    if filename is not None:
+        with open(filename, 'w') as f:
+            json.dump(trace, f)
+    return trace
@@ -23,9 +23,11 @@ from chompack.pybase.completion import completion
 from chompack.pybase.projected_inverse import projected_inverse
 from chompack.pybase.hessian import hessian
 from chompack.pybase.trsm import trsm
+from chompack.pybase.solve import solve
 from chompack.pybase.trmm import trmm
 from chompack.pybase.psdcompletion import psdcompletion
 from chompack.pybase.edmcompletion import edmcompletion
 from chompack.pybase.mrcompletion import mrcompletion
+from chompack.pybase.ldl import ldl, ldltrsm
     
-__all__ = ['cholesky','llt','competion','projected_inverse','hessian','trsm','trmm','psdcompletion','edmcompletion','mrcompletion']
+__all__ = ['cholesky','llt','competion','projected_inverse','hessian','trsm','solve','trmm','psdcompletion','edmcompletion','mrcompletion','ldl','ldltrsm']
@@ -2,7 +2,7 @@ from cvxopt import matrix, blas, lapack
 from chompack.symbolic import cspmatrix
 from chompack.misc import frontal_add_update
 
-def cholesky(X):
+def cholesky(X, nthreads = 1, delta = None, tol = None):
     """
     Supernodal multifrontal Cholesky factorization:
 
@@ -12,10 +12,25 @@ def cholesky(X):
     where :math:`L` is lower-triangular. On exit, the argument :math:`X`
     contains the Cholesky factor :math:`L`.
 
+    If `delta` is given, a pivot :math:`d` that is not greater than `tol`
+    (after the updates from the preceding columns) is replaced by
+    :math:`\max(\delta, -d)` and the factorization continues, so that
+    :math:`LL^T = X + E` with :math:`E` diagonal. The factorization then
+    returns a tuple (I, V) with the perturbed columns (in the original
+    ordering, in the order in which they were perturbed) and the
+    diagonal entries of :math:`E`.
+
     :param X:    :py:class:`cspmatrix`
+    :param nthreads:  number of threads (ignored by the Python implementation)
+    :param delta:  float (optional)
+    :param tol:    float (default: `delta`)
     """
 
     assert isinstance(X, cspmatrix) and X.is_factor is False, "X must be a cspmatrix"
+    if delta is not None:
+        assert delta > 0.0, "delta must be positive"
+        if tol is None: tol = delta
+        pcol, pval = [], []
 
     n = X.symb.n
     snpost = X.symb.snpost
@@ -46,7 +61,19 @@ def cholesky(X):
             frontal_add_update(F, Ui, relidx, relptr, chidx[i])
 
         # factor L_{Nk,Nk}
-        lapack.potrf(F, n = nn, ldA = nj)
+        if delta is None:
+            lapack.potrf(F, n = nn, ldA = nj)
+        else:
+            for j in range(nn):
+                if not F[j,j] > tol:
+                    d = max(delta, -F[j,j])
+                    pcol.append(X.symb.p[snptr[k]+j])
+                    pval.append(d - F[j,j])
+                    F[j,j] = d
+                F[j,j] = F[j,j]**0.5
+                F[j+1:nn,j] /= F[j,j]
+                for i in range(j+1,nn):
+                    F[i:nn,i] -= F[i:nn,j]*F[i,j]
 
         # if supernode k is not a root node, compute and push update matrix onto stack
         if na > 0:   
@@ -76,5 +103,7 @@ def cholesky(X):
 
     X.is_factor = True
 
+    if delta is not None:
+        return matrix(pcol, (len(pcol),1), 'i'), matrix(pval, (len(pval),1), 'd')
     return
 
@@ -0,0 +1,252 @@
+from cvxopt import matrix, blas, lapack
+from chompack.symbolic import cspmatrix
+from chompack.misc import frontal_add_update
+
+def _inertia(F, ipiv, nn, inertia):
+    k = 0
+    while k < nn:
+        if ipiv[k] > 0:
+            a = F[k,k]
+            inertia[0 if a > 0.0 else (1 if a < 0.0 else 2)] += 1
+            k += 1
+        else:
+            a, b, c = F[k,k], F[k+1,k], F[k+1,k+1]
+            det = a*c - b*b
+            if det < 0.0:
+                inertia[0] += 1; inertia[1] += 1
+            elif det > 0.0:
+                inertia[0 if a > 0.0 else 1] += 2
+            else:
+                inertia[2] += 1
+                inertia[0 if a+c > 0.0 else (1 if a+c < 0.0 else 2)] += 1
+            k += 2
+    return
+
+def ldl(X, ipiv, signs = None, delta = 0.0):
+    r"""
+    Supernodal multifrontal LDL factorization of a symmetric matrix:
+
+    .. math::
+         X = WDW^T
+
+    where :math:`W` is unit lower-triangular and :math:`D` is block
+    diagonal with one block per supernode, :math:`D_k = P_k L_k T_k
+    L_k^T P_k^T`. The diagonal blocks are factored with Bunch-Kaufman
+    pivoting within the supernode, so the ordering and sparsity pattern
+    of :math:`W` are those of the Cholesky factor.
+
+    If `signs` is given, the diagonal blocks are instead factored
+    without pivoting (:math:`P_k = I`, :math:`T_k` diagonal), and a
+    pivot :math:`d_i` with :math:`s_i d_i < \delta` is replaced by
+    :math:`s_i\delta` (static regularization of quasidefinite matrices).
+
+    An :py:exc:`ArithmeticError` is raised if a pivot is zero and the
+    factorization cannot be completed. Without `signs`, a zero pivot in
+    a root supernode is not an error and is counted in the inertia; with
+    `signs` and :math:`\delta = 0`, every zero pivot is an error.
+
+    On exit, the argument :math:`X` contains the factorization, and
+    `ipiv` the pivots of the diagonal blocks. Returns the inertia
+    (number of positive, negative, and zero eigenvalues) of :math:`D`
+    and the number of regularized pivots.
+
+    :param X:      :py:class:`cspmatrix`
+    :param ipiv:   'i' matrix of length n
+    :param signs:  'i' matrix of length n with the expected signs (+1 or -1) of the pivots (optional)
+    :param delta:  float (default: 0.0)
+    """
+
+    assert isinstance(X, cspmatrix) and X.is_factor is False, "X must be a cspmatrix"
+
+    n = X.symb.n
+    snpost = X.symb.snpost
+    snptr = X.symb.snptr
+    snode = X.symb.snode
+    chptr = X.symb.chptr
+    chidx = X.symb.chidx
+
+    relptr = X.symb.relptr
+    relidx = X.symb.relidx
+    blkptr = X.symb.blkptr
+    blkval = X.blkval
+    p = X.symb.p
+
+    assert isinstance(ipiv, matrix) and ipiv.typecode == 'i' and len(ipiv) == n, "ipiv must be an 'i' matrix of length n"
+    if signs is not None:
+        assert isinstance(signs, matrix) and signs.typecode == 'i' and len(signs) == n, "signs must be an 'i' matrix of length n"
+
+    inertia = [0, 0, 0]
+    nreg = 0
+    stack = []
+
+    for k in snpost:
+
+        nn = snptr[k+1]-snptr[k]       # |Nk|
+        na = relptr[k+1]-relptr[k]     # |Ak|
+        nj = na + nn
+
+        # build frontal matrix
+        F = matrix(0.0, (nj, nj))
+        lapack.lacpy(blkval, F, offsetA = blkptr[k], m = nj, n = nn, ldA = nj, uplo = 'L')
+
+        # add update matrices from children to frontal matrix
+        for i in range(chptr[k+1]-1,chptr[k]-1,-1):
+            Ui = stack.pop()
+            frontal_add_update(F, Ui, relidx, relptr, chidx[i])
+
+        # factor D_k = F_{Nk,Nk}
+        piv = matrix(0, (nn,1))
+        if signs is not None:
+            for j in range(nn):
+                piv[j] = j+1
+                s = -1.0 if signs[p[snode[snptr[k]+j]]] < 0 else 1.0
+                d = F[j,j]
+                if s*d < delta and delta > 0.0:
+                    d = s*delta
+                    nreg += 1
+                if d == 0.0: raise ArithmeticError("factorization failed")
+                F[j,j] = d
+                for i in range(j+1,nn):
+                    F[i:nn,i] -= F[i:nn,j]*(F[i,j]/d)
+                F[j+1:nn,j] /= d
+        else:
+            try:
+                lapack.sytrf(F, piv, n = nn, ldA = nj)
+            except ArithmeticError:
+                if na > 0: raise ArithmeticError("factorization failed")
+        ipiv[snptr[k]:snptr[k+1]] = piv
+        _inertia(F, piv, nn, inertia)
+
+        if na > 0:
+            # compute W_{Ak,Nk} := F_{Ak,Nk}*inv(D_k)
+            Wt = F[nn:,:nn].T
+            lapack.sytrs(F, piv, Wt, n = nn, ldA = nj)
+
+            # compute Uk = F_{Ak,Ak} - F_{Ak,Nk}*inv(D_k)*F_{Ak,Nk}'
+            blas.gemm(F, Wt, F, m = na, n = na, k = nn, alpha = -1.0, beta = 1.0,
+                      offsetA = nn, ldA = nj, offsetC = nn*nj+nn, ldC = nj)
+            F[nn:,:nn] = Wt.T
+
+            # add Uk to stack
+            Uk = matrix(0.0,(na,na))
+            lapack.lacpy(F, Uk, m = na, n = na, uplo = 'L', offsetA = nn*nj+nn, ldA = nj)
+            stack.append(Uk)
+
+        # copy the leading Nk columns of frontal matrix to blkval
+        lapack.lacpy(F, blkval, uplo = "L", offsetB = blkptr[k], m = nj, n = nn, ldB = nj)
+
+    X.is_factor = True
+
+    return tuple(inertia), nreg
+
+def ldltrsm(L, ipiv, B, trans = 'N', nrhs = None, offsetB = 0, ldB = None):
+    r"""
+    Solves a system of equations with the factors of an LDL
+    factorization :math:`X = WDW^T` computed by :py:func:`ldl`.
+    Computes
+
+    .. math::
+
+       B &:= W^{-1} B  \text{ if trans is 'N'} \\
+       B &:= D^{-1} B  \text{ if trans is 'D'} \\
+       B &:= W^{-T} B  \text{ if trans is 'T'}
+
+    so that :math:`X^{-1}B` is computed by three calls with trans
+    equal to 'N', 'D', and 'T'.
+
+    :param L:  :py:class:`cspmatrix` factor computed by :py:func:`ldl`
+    :param ipiv:  pivots returned by :py:func:`ldl`
+    :param B:  matrix
+    :param trans:  'N', 'D', or 'T' (default: 'N')
+    :param nrhs:   number of right-hand sides (default: number of columns in :math:`B`)
+    :param offsetB: integer (default: 0)
+    :param ldB:   leading dimension of :math:`B` (default: number of rows in :math:`B`)
+    """
+
+    assert isinstance(L, cspmatrix) and L.is_factor is True, "L must be a cspmatrix factor"
+    assert isinstance(B, matrix), "B must be a matrix"
+
+    if ldB is None: ldB = B.size[0]
+    if nrhs is None: nrhs = B.size[1]
+    assert trans in ['N', 'D', 'T']
+
+    snpost = L.symb.snpost
+    snptr = L.symb.snptr
+    snode = L.symb.snode
+    chptr = L.symb.chptr
+    chidx = L.symb.chidx
+
+    relptr = L.symb.relptr
+    relidx = L.symb.relidx
+    blkptr = L.symb.blkptr
+    blkval = L.blkval
+    p = L.symb.p
+
+    def get(Uk, k):
+        for j in range(nrhs):
+            for i,ir in enumerate(snode[snptr[k]:snptr[k+1]]):
+                Uk[i,j] = B[offsetB + j*ldB + p[ir]]
+
+    def put(Uk, k):
+        for j in range(nrhs):
+            for i,ir in enumerate(snode[snptr[k]:snptr[k+1]]):
+                B[offsetB + j*ldB + p[ir]] = Uk[i,j]
+
+    stack = []
+
+    if trans == 'D':
+
+        for k in snpost:
+            nn = snptr[k+1]-snptr[k]
+            nj = nn + relptr[k+1]-relptr[k]
+            Uk = matrix(0.0,(nn,nrhs))
+            get(Uk, k)
+            lapack.sytrs(blkval, ipiv[snptr[k]:snptr[k+1]], Uk, n = nn, offsetA = blkptr[k], ldA = nj)
+            put(Uk, k)
+
+    elif trans == 'N':
+
+        for k in snpost:
+            nn = snptr[k+1]-snptr[k]
+            na = relptr[k+1]-relptr[k]
+            nj = na + nn
+
+            Uk = matrix(0.0,(nj,nrhs))
+            get(Uk, k)
+
+            # add contributions from children
+            for _ in range(chptr[k],chptr[k+1]):
+                Ui, i = stack.pop()
+                r = relidx[relptr[i]:relptr[i+1]]
+                Uk[r,:] += Ui
+
+            # if k is not a root node
+            if na > 0:
+                blas.gemm(blkval, Uk, Uk, alpha = -1.0, beta = 1.0, m = na, n = nrhs, k = nn,\
+                          offsetA = blkptr[k]+nn, ldA = nj, offsetC = nn)
+                stack.append((Uk[nn:,:],k))
+            put(Uk, k)
+
+    else: # trans is 'T'
+
+        for k in reversed(list(snpost)):
+            nn = snptr[k+1]-snptr[k]
+            na = relptr[k+1]-relptr[k]
+            nj = na + nn
+
+            Uk = matrix(0.0,(nj,nrhs))
+            get(Uk, k)
+
+            # if k is not a root node
+            if na > 0:
+                Uk[nn:,:] = stack.pop()
+                blas.gemm(blkval, Uk, Uk, alpha = -1.0, beta = 1.0, m = nn, n = nrhs, k = na,\
+                          transA = 'T', offsetA = blkptr[k]+nn, ldA = nj, offsetB = nn)
+
+            # stack contributions for children
+            for ii in range(chptr[k],chptr[k+1]):
+                i = chidx[ii]
+                stack.append(Uk[relidx[relptr[i]:relptr[i+1]],:])
+            put(Uk, k)
+
+    return
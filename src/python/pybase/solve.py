@@ -0,0 +1,73 @@
+from cvxopt import matrix, blas
+from chompack.symbolic import cspmatrix
+from chompack.pybase.trsm import trsm
+from chompack.base import symm
+
+def solve(A, L, B, refine = 0, tol = 0.0):
+    r"""
+    Solves a system of equations
+
+    .. math::
+         AX = B
+
+    with the Cholesky factor :math:`L` of :math:`A` (or of a
+    perturbation of :math:`A`, e.g., computed with dynamic
+    regularization), followed by at most `refine` steps of iterative
+    refinement
+
+    .. math::
+         R := B - AX, \quad X := X + L^{-T}L^{-1}R
+
+    where the residual is computed with the :py:class:`cspmatrix`
+    :math:`A`. Refinement stops when :math:`\|r_j\|_2 \leq
+    \mathrm{tol}\,\|b_j\|_2` for all columns, or when a step fails to
+    halve the largest relative residual; a step that does not reduce
+    it is undone. On exit, :math:`B` is overwritten by :math:`X`.
+    Returns a 'd' matrix with the residual norms :math:`\|b_j -
+    Ax_j\|_2`.
+
+    :param A:       :py:class:`cspmatrix`
+    :param L:       :py:class:`cspmatrix` factor with the same symbolic factorization
+    :param B:       'd' matrix with n rows
+    :param refine:  maximum number of refinement steps (default: 0)
+    :param tol:     relative residual tolerance (default: 0.0)
+    """
+
+    assert isinstance(A, cspmatrix) and A.is_factor is False, "A must be a cspmatrix"
+    assert isinstance(L, cspmatrix) and L.is_factor is True, "L must be a cspmatrix factor"
+    assert A.symb is L.symb, "Symbolic factorization mismatch"
+    assert isinstance(B, matrix) and B.typecode == 'd' and B.size[0] == A.symb.n, "B must be a 'd' matrix with n rows"
+
+    n, m = B.size
+    Bc = +B
+    resnrm = matrix(0.0, (m,1))
+
+    def residual():
+        R = +Bc
+        symm(A, B, R, alpha = -1.0, beta = 1.0)
+        conv, relres = True, 0.0
+        for j in range(m):
+            resnrm[j] = blas.nrm2(R[:,j])
+            bn = blas.nrm2(Bc[:,j])
+            if resnrm[j] > tol*bn: conv = False
+            if bn > 0.0: relres = max(relres, resnrm[j]/bn)
+            elif resnrm[j] > 0.0: relres = float('inf')
+        return R, conv, relres
+
+    trsm(L, B)
+    trsm(L, B, trans = 'T')
+    R, conv, relres = residual()
+    for _ in range(refine):
+        if conv: break
+        lstres, Bp, resnrmp = relres, +B, +resnrm
+        trsm(L, R)
+        trsm(L, R, trans = 'T')
+        blas.axpy(R, B)
+        R, conv, relres = residual()
+        if not 2.0*relres <= lstres:
+            if not relres < lstres:
+                # the step did not reduce the residual: return the previous iterate
+                blas.copy(Bp, B)
+                blas.copy(resnrmp, resnrm)
+            break
+    return resnrm
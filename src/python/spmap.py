@@ -0,0 +1,118 @@
+from cvxopt import matrix, spmatrix
+from chompack.symbolic import cspmatrix
+from bisect import bisect_left
+
+try:
+    from chompack.cbase import spmap_build, spmap_dot, spmap_axpy
+except:
+    def spmap_build(symb, A):
+        """
+        Computes blkval offsets of the lower triangular entries of a list
+        of sparse matrices. Returns (ptr, off, v, wv) such that the entries
+        of the i'th matrix are off[ptr[i]:ptr[i+1]] with values v and
+        trace product weights wv.
+        """
+        snptr = symb.snptr
+        snode = symb.snode
+        sncolptr = symb.sncolptr
+        snrowidx = symb.snrowidx
+        blkptr = symb.blkptr
+        ip = symb.ip
+
+        colsn = matrix(0,(symb.n,1))
+        for k in range(symb.Nsn):
+            colsn[snode[snptr[k]:snptr[k+1]]] = k
+
+        ptr, off, v, wv = [0], [], [], []
+        for i,Ai in enumerate(A):
+            assert isinstance(Ai, spmatrix) and Ai.size == (symb.n,symb.n), "A[%i] must be a sparse matrix of order %i" % (i,symb.n)
+            for ii,jj,val in zip(Ai.I,Ai.J,Ai.V):
+                if ii < jj: continue
+                ii, jj = ip[ii], ip[jj]
+                if ii < jj: ii, jj = jj, ii
+                k = colsn[jj]
+                r = list(snrowidx[sncolptr[k]:sncolptr[k+1]])
+                l = bisect_left(r, ii)
+                if l == len(r) or r[l] != ii:
+                    raise ValueError("sparsity pattern of A[%i] is not contained in the chordal embedding" % i)
+                off.append(blkptr[k] + len(r)*(jj-r[0]) + l)
+                v.append(val)
+                wv.append(val if ii == jj else 2.0*val)
+            ptr.append(len(off))
+        return matrix(ptr,tc='i'), matrix(off,(len(off),1),tc='i'), matrix(v,(len(v),1),tc='d'), matrix(wv,(len(wv),1),tc='d')
+
+    def spmap_dot(ptr, off, wv, X):
+        """
+        Computes y[i] = tr(A_i*X) from the maps computed by spmap_build.
+        """
+        m = len(ptr)-1
+        M = spmatrix(wv, [i for i in range(m) for _ in range(ptr[i],ptr[i+1])], off, (m,len(X.blkval)))
+        return M*X.blkval
+
+    def spmap_axpy(ptr, off, v, y, X, alpha = 1.0):
+        """
+        Computes X := X + alpha*sum_i y[i]*A_i from the maps computed by
+        spmap_build.
+        """
+        for i in range(len(ptr)-1):
+            X.blkval[off[ptr[i]:ptr[i+1]]] += alpha*y[i]*v[ptr[i]:ptr[i+1]]
+        return
+
+class spmap(object):
+    r"""
+    Index maps of a list of sparse symmetric matrices :math:`A_1,\ldots,A_m`
+    into the :py:class:`cspmatrix` storage of a symbolic factorization. The
+    maps are computed once; the trace products :math:`\mathbf{tr}(A_i X)` and
+    the adjoint :math:`\sum_i y_i A_i` are then evaluated without
+    converting :math:`X` to a sparse matrix.
+
+    The sparsity pattern of each :math:`A_i` must be contained in the
+    chordal embedding, and only the lower triangular entries are
+    accessed.
+
+    :param symb:  :py:class:`symbolic` object
+    :param A:     list of :py:class:`spmatrix` objects
+    """
+
+    def __init__(self, symb, A):
+        self.symb = symb
+        self.ptr, self.off, self.v, self.wv = spmap_build(symb, list(A))
+
+    def __repr__(self):
+        return "<index map of %i sparse matrices, nnz=%i>" % (self.m, len(self.off))
+
+    @property
+    def m(self):
+        """
+        Number of sparse matrices.
+        """
+        return len(self.ptr)-1
+
+    def dot(self, X):
+        r"""
+        Returns the vector of trace products :math:`y_i = \mathbf{tr}(A_i X)`.
+
+        :param X:  :py:class:`cspmatrix`
+        """
+        assert X.symb == self.symb, "Symbolic factorization mismatch"
+        assert X.is_factor is False, "cspmatrix factor object"
+        return spmap_dot(self.ptr, self.off, self.wv, X)
+
+    def adjoint(self, y, X = None, alpha = 1.0, beta = 0.0):
+        r"""
+        Computes :math:`X := \alpha \sum_i y_i A_i + \beta X` and returns
+        :math:`X`. A new :py:class:`cspmatrix` is created if :math:`X` is `None`.
+
+        :param y:      matrix of length :math:`m`
+        :param X:      :py:class:`cspmatrix` (default: `None`)
+        :param alpha:  float (default: 1.0)
+        :param beta:   float (default: 0.0)
+        """
+        if X is None:
+            X = cspmatrix(self.symb)
+        else:
+            assert X.symb == self.symb, "Symbolic factorization mismatch"
+            assert X.is_factor is False, "cspmatrix factor object"
+            if beta != 1.0: X *= float(beta)
+        spmap_axpy(self.ptr, self.off, self.v, matrix(y,tc='d'), X, alpha)
+        return X
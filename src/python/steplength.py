@@ -0,0 +1,129 @@
+import chompack as cp
+from chompack.symbolic import cspmatrix
+from cvxopt import matrix, blas, lapack
+from math import sin, sqrt
+
+def _lanczos_min(op, n, maxiter, tol):
+    """
+    Estimates the smallest eigenvalue of the symmetric operator op with
+    the Lanczos method (with full reorthogonalization). Returns the
+    smallest Ritz value and its residual norm.
+    """
+    m = min(maxiter, n)
+    V = matrix(0.0, (n, m+1))
+    a = matrix(0.0, (m,1))
+    b = matrix(0.0, (m,1))
+    v = matrix([sin(i+1.0) for i in range(n)])   # deterministic start vector
+    blas.scal(1.0/blas.nrm2(v), v)
+    V[:,0] = v
+    theta, res = 0.0, 0.0
+    for j in range(m):
+        w = op(V[:,j])
+        a[j] = blas.dot(w, V[:,j])
+        # full reorthogonalization against V[:,:j+1]
+        for _ in range(2):
+            h = matrix(0.0, (j+1,1))
+            blas.gemv(V, w, h, trans = 'T', n = j+1)
+            blas.gemv(V, h, w, alpha = -1.0, beta = 1.0, n = j+1)
+        b[j] = blas.nrm2(w)
+
+        # Ritz values of the tridiagonal matrix T_{j+1}
+        T = matrix(0.0, (j+1,j+1))
+        T[::j+2] = a[:j+1]
+        if j > 0: T[1::j+2] = b[:j]
+        lam = matrix(0.0, (j+1,1))
+        lapack.syevd(T, lam, jobz = 'V')
+        theta, res = lam[0], b[j]*abs(T[j,0])
+        if res <= tol*max(1.0, abs(theta)) or b[j] == 0.0: break
+        V[:,j+1] = w/b[j]
+    return theta, res
+
+def steplength(X, dX, completable = False, maxiter = 20, tol = 1e-8, verify = True, backoff = 0.99):
+    r"""
+    Step length to the boundary of the cone of positive definite
+    matrices with sparsity pattern :math:`E`:
+
+    .. math::
+         \alpha = \sup \{ t \geq 0 \mid X + t \Delta X \succ 0 \}
+
+    or, if `completable` is `True`, of the cone of matrices with a
+    positive definite completion (i.e., every clique block :math:`X_{\gamma\gamma}
+    + t\Delta X_{\gamma\gamma}` is positive definite).
+
+    In the positive definite case, :math:`X = LL^T` is factored once and
+    the smallest eigenvalue :math:`\lambda` of :math:`L^{-1}\Delta X
+    L^{-T}` is estimated with at most `maxiter` Lanczos iterations,
+    each of which costs two triangular solves with :math:`L` and a
+    product with :math:`\Delta X`, and :math:`\alpha = -1/\lambda`
+    (:math:`\infty` if :math:`\lambda \geq 0`). A Lanczos estimate of
+    :math:`\lambda` is too large rather than too small, so it is
+    lowered by the residual norm of the Ritz pair. If `verify` is
+    `True`, the step `backoff*alpha` is certified by a Cholesky
+    factorization of :math:`X + \mathrm{backoff}\,\alpha\Delta X`; if this
+    fails, :math:`\alpha` is halved until it succeeds.
+
+    In the completable case, :math:`\alpha` is computed exactly from
+    the dense clique blocks, and no further verification is needed.
+
+    Returns a tuple (alpha, certified), where `certified` is `True`
+    if :math:`X + \mathrm{backoff}\,\alpha \Delta X` is known to be in
+    the cone (always in the completable case, and if `verify` is
+    `True` in the positive definite case).
+
+    :param X:        :py:class:`cspmatrix` (positive definite or positive definite completable)
+    :param dX:       :py:class:`cspmatrix` with the same symbolic factorization
+    :param completable:  boolean (default: False)
+    :param maxiter:  maximum number of Lanczos iterations (default: 20)
+    :param tol:      relative tolerance on the residual of the Ritz pair (default: 1e-8)
+    :param verify:   boolean (default: True)
+    :param backoff:  float in (0,1] (default: 0.99)
+    """
+
+    assert isinstance(X, cspmatrix) and X.is_factor is False, "X must be a cspmatrix"
+    assert isinstance(dX, cspmatrix) and dX.is_factor is False, "dX must be a cspmatrix"
+    assert X.symb == dX.symb, "Symbolic factorization mismatch"
+    n = X.symb.n
+
+    if completable:
+        Xs = X.spmatrix(reordered = True, symmetric = True)
+        Ds = dX.spmatrix(reordered = True, symmetric = True)
+        lmin = 0.0
+        for c in X.symb.cliques():
+            Xc, Dc = matrix(Xs[c,c]), matrix(Ds[c,c])
+            try:
+                lapack.potrf(Xc)
+            except ArithmeticError:
+                raise ValueError("X is not positive definite completable")
+            # Dc := inv(Lc)*Dc*inv(Lc')
+            blas.trsm(Xc, Dc)
+            blas.trsm(Xc, Dc, side = 'R', transA = 'T')
+            lam = matrix(0.0, (len(c),1))
+            lapack.syevd(Dc, lam)
+            lmin = min(lmin, lam[0])
+        alpha = -1.0/lmin if lmin < 0.0 else float('inf')
+        return alpha, True
+
+    L = X.copy()
+    cp.cholesky(L)
+    Ds = dX.spmatrix(reordered = False, symmetric = True)
+
+    def op(v):
+        # v := inv(L)*dX*inv(L')*v
+        cp.trsm(L, v, trans = 'T')
+        v = Ds*v
+        cp.trsm(L, v)
+        return v
+
+    theta, res = _lanczos_min(op, n, maxiter, tol)
+    lmin = theta - res
+    if lmin >= 0.0: return float('inf'), False
+
+    alpha = -1.0/lmin
+    if not verify: return alpha, False
+    while True:
+        Z = X + (backoff*alpha)*dX
+        try:
+            cp.cholesky(Z)
+            return alpha, True
+        except ArithmeticError:
+            alpha *= 0.5
@@ -1,7 +1,29 @@
-from cvxopt import matrix, spmatrix, normal, blas, printing
+from cvxopt import matrix, spmatrix, normal, blas, lapack, printing
 from chompack.misc import tril, perm, symmetrize
 from chompack.misc import lmerge
 from types import BuiltinFunctionType, FunctionType
+import os, json, math, time, platform
+from bisect import bisect_left
+
+try:
+    from chompack.cbase import amalgamate as _amalgamate, merge_calibrate as _merge_calibrate
+except:
+    _amalgamate = _merge_calibrate = None
+
+try:
+    from chompack.cbase import csc as _csc, csc_colptr as _csc_colptr, csc_fill as _csc_fill
+except:
+    _csc = _csc_colptr = _csc_fill = None
+
+try:
+    from chompack.cbase import coo_add as _coo_add
+except:
+    _coo_add = None
+
+try:
+    from chompack.cbase import UPDATE_FACTOR_NB as _UPDATE_FACTOR_NB
+except:
+    _UPDATE_FACTOR_NB = 32
             
 def __tdfs(j, k, head, next, post, stack):
     """
@@ -283,6 +305,9 @@ def amalgamate(colcount, snode, snptr, snpar, snpost, merge_function):
 
     snpost    vector with amalgamated supernodal post ordering
     """
+    if _amalgamate is not None:
+        return _amalgamate(colcount, snode, snptr, snpar, snpost, merge_function)
+
     N = len(snpost)
     ch = {}
     for j in snpost:
@@ -494,6 +519,120 @@ def merge_size_fill(tsize = 8, tfill = 8):
             return False
     # insert parameters into docstring of fmerge and return fmerge
     fmerge.__doc__ %= (tsize, tfill)
+    # parameters for the C implementation of amalgamate
+    fmerge.size_fill = (tsize, tfill)
+    return fmerge
+
+MERGE_AUTO_SIZES = [1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256]
+
+def _calibrate(sizes, tmin):
+    """
+    Python version of chompack.cbase.merge_calibrate (times the cvxopt
+    BLAS and LAPACK interfaces).
+    """
+    def rate(flops, fun, setup = lambda: None):
+        reps = 0
+        t0 = time.time()
+        while True:
+            setup(); fun(); reps += 1
+            t = time.time() - t0
+            if t >= tmin: return reps*flops/t
+
+    model = {'size': list(sizes), 'potrf': [], 'trsm': [], 'syrk': []}
+    for b in sizes:
+        A = matrix([[1.0/(1.0+i+j) for i in range(b)] for j in range(b)])
+        A[::b+1] = float(b)
+        L = +A
+        lapack.potrf(L)
+        C = matrix(0.0, (b,b))
+        B, B0 = matrix(1.0, (b,b)), matrix(1.0, (b,b))
+        model['potrf'].append(rate(b**3/3.0, lambda: lapack.potrf(C), lambda: blas.copy(A, C)))
+        model['trsm'].append(rate(float(b**3), lambda: blas.trsm(L, B, side = 'R', transA = 'T'), lambda: blas.copy(B0, B)))
+        model['syrk'].append(rate(float(b**3), lambda: blas.syrk(B, C, alpha = -1.0)))
+    b = sizes[-1]
+    F, U, I = matrix(0.0, (b,b)), matrix(1.0/b, (b,b)), list(range(b))
+    model['extend_add'] = 2.0/(b*(b+1.0))/rate(1.0, lambda: F.__setitem__((I,I), F[I,I] + U))
+    X, Y = matrix(0.0, (1,1)), matrix(0.0, (1,1))
+    model['overhead'] = 1.0/rate(1.0, lambda: (blas.copy(X, Y), blas.copy(Y, X)))
+    return model
+
+def _front_time(model, nn, na):
+    """
+    Predicted time of a supernode of order nn with a separator of
+    order na in cholesky() (see src/C/amalgamate.c).
+    """
+    def rate(r):
+        S = model['size']
+        if nn <= S[0]: return r[0]
+        if nn >= S[-1]: return r[-1]
+        k = 1
+        while S[k] < nn: k += 1
+        x = (math.log(nn) - math.log(S[k-1]))/(math.log(S[k]) - math.log(S[k-1]))
+        return math.exp((1.0-x)*math.log(r[k-1]) + x*math.log(r[k]))
+    t = model['overhead'] + nn**3/3.0/rate(model['potrf'])
+    if na > 0:
+        t += float(na*nn**2)/rate(model['trsm']) + float(na**2*nn)/rate(model['syrk']) + model['extend_add']*na*(na+1)/2.0
+    return t
+
+def merge_auto(model = None, cache = True, recalibrate = False, tmin = 0.01):
+    """
+    Cost-model-driven heuristic for supernodal amalgamation (clique
+    merging).
+
+    Returns a function that returns `True` if the predicted time of
+    :py:func:`cholesky` for the merged supernode does not exceed the
+    sum of the predicted times for supernode k and supernode par(k).
+    The predicted time of a supernode of order :math:`n` with a
+    separator of order :math:`a` is
+
+    .. math::
+        t_0 + \\frac{n^3/3}{r_{\\mathrm{potrf}}(n)} + \\frac{an^2}{r_{\\mathrm{trsm}}(n)}
+            + \\frac{a^2 n}{r_{\\mathrm{syrk}}(n)} + t_a a(a+1)/2
+
+    where the flop rates :math:`r` of the dense kernels are measured
+    at a range of block sizes (and interpolated in between), :math:`t_0`
+    is the per-supernode overhead, and :math:`t_a` is the time per
+    entry of an extend-add operation.
+
+    The calibration takes a few seconds and is done once per machine:
+    it is stored as JSON in the directory given by the environment
+    variable `CHOMPACK_CACHE` (default: `~/.cache/chompack`).
+
+    :param model:        cost model as returned by an earlier call (the attribute `cost_model` of the returned function); skips calibration (optional)
+    :param cache:        read and store the calibration on disk
+    :param recalibrate:  ignore a stored calibration
+    :param tmin:         minimum time (in seconds) for each measurement
+    """
+    if model is None:
+        path = os.path.join(os.environ.get('CHOMPACK_CACHE', os.path.join(os.path.expanduser('~'), '.cache', 'chompack')),
+                            'merge_auto.json')
+        key = '%s/%s/%s' % (platform.node(), platform.machine(), 'c' if _merge_calibrate else 'py')
+        models = {}
+        if cache:
+            try:
+                with open(path) as f: models = json.load(f)
+            except (IOError, OSError, ValueError):
+                models = {}
+        model = None if recalibrate else models.get(key)
+        if model is None:
+            model = (_merge_calibrate or _calibrate)(MERGE_AUTO_SIZES, tmin)
+            if cache:
+                models[key] = model
+                try:
+                    if not os.path.isdir(os.path.dirname(path)): os.makedirs(os.path.dirname(path))
+                    with open(path, 'w') as f: json.dump(models, f, indent = 1, sort_keys = True)
+                except (IOError, OSError):
+                    pass
+
+    def fmerge(ccp, cck, np, nk):
+        """
+        Cost-model-driven merge heuristic (see merge_auto).
+
+           d = fmerge(Jp, Jk, Np, Nk)
+        """
+        return _front_time(model, np+nk, ccp-np) <= _front_time(model, np, ccp-np) + _front_time(model, nk, cck-nk)
+    # parameters for the C implementation of amalgamate
+    fmerge.cost_model = model
     return fmerge
 
 class symbolic(object):
@@ -523,7 +662,9 @@ class symbolic(object):
 
     The clique k is merged with its parent if the return value is `True`.
     """
-    
+
+    _colsn = None   # supernode of each column (see cspmatrix.add_coo)
+
     def __init__(self, A, p = None, merge_function = None, **kwargs):
 
         assert isinstance(A,spmatrix), "A must be a sparse matrix"
@@ -642,11 +783,15 @@ class symbolic(object):
         stack_solve = 0
         stack_stmp = 0
 
+        update_factor_mem = 0
+
         for k in snpost:
             nn = snptr[k+1]-snptr[k]       # |Nk|
             na = relptr[k+1]-relptr[k]     # |Ak|
             nj = na + nn
             cln = max(cln,nj)              # this is the clique number
+            if chptr[k+1] > chptr[k]:      # workspace for factored updates
+                update_factor_mem = max(update_factor_mem,na*(na+1))
             for i in range(chptr[k+1]-1,chptr[k]-1,-1):
                 na_ch = stack.pop()
                 stack_tmp -= na_ch**2
@@ -677,7 +822,8 @@ class symbolic(object):
         self.__memory = {'stack_depth':stack_depth,
                          'stack_mem':stack_mem,
                          'frontal_mem':cln**2,                         
-                         'stack_solve':stack_solve}
+                         'stack_solve':stack_solve,
+                         'update_factor_mem':update_factor_mem}
 
         return
 
@@ -846,6 +992,68 @@ class symbolic(object):
         """
         return self.__ip
 
+    def cost(self, nrhs = 1, factored_updates = False):
+        r"""
+        Predicted cost of the numerical routines. Returns a dictionary
+        with the keys 'flops', 'critical_path', 'parallelism', and
+        'memory', each of which is a dictionary with one entry per
+        routine ('cholesky', 'llt', 'projected_inverse', 'completion',
+        'hessian', and 'trsm').
+
+        - 'flops': nominal flop count (BLAS/LAPACK operations only;
+          'hessian' is one application of :math:`\mathcal G_X` or its
+          adjoint, and 'trsm' is one triangular solve with `nrhs`
+          right-hand sides)
+        - 'critical_path': largest flop count along a path from a leaf
+          to a root of the supernodal elimination tree, i.e., the
+          cost if independent subtrees are processed in parallel
+        - 'parallelism': 'flops' divided by 'critical_path'
+        - 'memory': peak memory in bytes, i.e., the `blkval` arrays
+          that the routine operates on and the workspace it allocates
+
+        :param nrhs:              integer (default: 1)
+        :param factored_updates:  boolean (default: `False`)
+        """
+        from struct import calcsize
+        ops = ['cholesky', 'llt', 'projected_inverse', 'completion', 'hessian', 'trsm']
+        snptr, relptr, chptr, chidx = self.snptr, self.relptr, self.chptr, self.chidx
+        w = dict((op, [0.0]*self.Nsn) for op in ops)
+        for k in range(self.Nsn):
+            nn = float(snptr[k+1]-snptr[k])
+            na = float(relptr[k+1]-relptr[k])
+            nj = nn + na
+            w['cholesky'][k] = nn**3/3. + 2.*na*nn**2 + na**2*nn
+            w['llt'][k] = na*nn**2 + nj**2*nn
+            w['projected_inverse'][k] = 4.*nn**3/3. + 2.*na**2*nn + 2.*nn**2*na
+            w['completion'][k] = (0.0 if factored_updates else na**3/3.) + 2.*na**2*nn + na*nn**2 + 2.*nn**3/3.
+            w['hessian'][k] = (0.0 if factored_updates else na**3/3.) + 4.*na**2*nn + 2.*na*nn**2 \
+                + nj*nn**2 + nn**3 + na**2*nn
+            w['trsm'][k] = nrhs*(nn**2 + 2.*na*nn)
+
+        # critical path: supernodes are postordered, so children precede parents
+        flops, cpath, par = {}, {}, {}
+        for op in ops:
+            c = [0.0]*self.Nsn
+            for k in self.snpost:
+                c[k] = w[op][k] + max([c[ch] for ch in chidx[chptr[k]:chptr[k+1]]] or [0.0])
+            flops[op] = sum(w[op])
+            cpath[op] = max(c or [0.0])
+            par[op] = flops[op]/cpath[op] if cpath[op] > 0 else 1.0
+
+        # memory: blkval arrays and workspace as allocated by the C routines
+        ds, its = calcsize('d'), calcsize('P')
+        mem = self.memory
+        blk = ds*self.blkptr[-1]
+        work = ds*(mem['stack_mem'] + mem['frontal_mem']) + its*mem['stack_depth']
+        ufws = ds*(mem['update_factor_mem'] + _UPDATE_FACTOR_NB*(_UPDATE_FACTOR_NB + self.clique_number))   # UPDATE_FACTOR_WS
+        memory = {'cholesky': blk + work,
+                  'llt': blk + work,
+                  'projected_inverse': blk + work,
+                  'completion': blk + work + (ufws if factored_updates else 0),
+                  'hessian': 3*blk + work + (ufws if factored_updates else 0),
+                  'trsm': blk + ds*nrhs*(self.n + mem['stack_solve'] + self.clique_number) + its*mem['stack_depth']}
+        return {'flops': flops, 'critical_path': cpath, 'parallelism': par, 'memory': memory}
+
     @property
     def clique_number(self):
         """
@@ -888,7 +1096,97 @@ class symbolic(object):
         the i'th element is the index of the parent of supernode i.
         """
         return list(self.snpar)
+
+    def memoryviews(self):
+        """
+        Returns a dictionary with read-only memoryviews of the index
+        arrays (snptr, snode, snpar, snpost, relptr, relidx, chptr,
+        chidx, sncolptr, snrowidx, blkptr, p, ip). The views share
+        memory with the symbolic factorization, so they can be passed to
+        numpy (e.g., `numpy.asarray`) without copying.
+        """
+        names = ('snptr', 'snode', 'snpar', 'snpost', 'relptr', 'relidx', 'chptr',
+                 'chidx', 'sncolptr', 'snrowidx', 'blkptr', 'p', 'ip')
+        views = {}
+        for name in names:
+            a = getattr(self, name)
+            if a is None: continue
+            views[name] = _flatview(a)
+            if hasattr(views[name], 'toreadonly'): views[name] = views[name].toreadonly()
+        return views
         
+def _flatview(a):
+    """
+    Returns a 1-D memoryview of the buffer a (a cvxopt matrix exports
+    a 2-D buffer with one column).
+    """
+    mv = memoryview(a)
+    return mv.cast('B').cast(mv.format)
+
+def _blkmatrix(a):
+    """
+    Returns the blkval array a as a 'd' :py:class:`matrix` (a itself if
+    it is a matrix, and otherwise a copy of the buffer).
+    """
+    if isinstance(a, matrix): return a
+    mv = _flatview(a)
+    if mv.format != 'd':
+        raise TypeError("blkval must be a 'd' matrix or a buffer of doubles")
+    return matrix(mv, (len(mv),1), 'd')
+
+def _blkaxpy(x, y, alpha = 1.0):
+    """
+    y := alpha*x + y for blkval arrays x and y (matrices or contiguous
+    buffers of doubles).
+    """
+    ym = _blkmatrix(y)
+    blas.axpy(_blkmatrix(x), ym, alpha = alpha)
+    if ym is not y: _flatview(y)[:] = _flatview(ym)
+
+def _blkscal(alpha, x):
+    """
+    x := alpha*x for a blkval array x (a matrix or a contiguous buffer
+    of doubles).
+    """
+    xm = _blkmatrix(x)
+    blas.scal(alpha, xm)
+    if xm is not x: _flatview(x)[:] = _flatview(xm)
+
+def _asbuffer(a, tc):
+    """
+    Returns a, or a :py:class:`matrix` with typecode tc if a does not
+    export a buffer (e.g., a list).
+    """
+    if isinstance(a, matrix): return a
+    try:
+        memoryview(a)
+        return a
+    except TypeError:
+        return matrix(a, tc = tc)
+
+# file format of cspmatrix.save() and cspmatrix.open(): a header of
+# MMAP_OFFSET bytes (page aligned, so that blkval is), followed by blkval
+MMAP_OFFSET = 4096
+_MMAP_MAGIC = b'CHOMPACK'
+_MMAP_KEY = 40
+
+def _mmap_header(symb, factor):
+    """
+    Header of a cspmatrix file: magic, format version, and the order,
+    number of supernodes and length of blkval with a CRC-32 of the
+    symbolic factorization (the first _MMAP_KEY bytes), followed by the
+    factor flag.
+    """
+    from struct import pack
+    from zlib import crc32
+    views = symb.memoryviews()
+    crc = 0
+    for name in ('p', 'snptr', 'sncolptr', 'snrowidx', 'blkptr'):
+        crc = crc32(views[name].cast('B'), crc)
+    header = _MMAP_MAGIC + pack('<IIqqq', 1, crc & 0xffffffff, symb.n, symb.Nsn, symb.blkptr[-1]) \
+             + pack('<B', 1 if factor else 0)
+    return header + b'\0'*(MMAP_OFFSET - len(header))
+
 class cspmatrix(object):
     """
     Chordal sparse matrix object.
@@ -912,6 +1210,8 @@ class cspmatrix(object):
     matrix. 
     """
 
+    _busy = 0   # concurrent use by the C routines (see chompack.futures)
+
     def __init__(self, symb, blkval = None, factor = False):
 
         assert isinstance(symb, symbolic), "symb must be an instance of symbolic"
@@ -936,19 +1236,21 @@ class cspmatrix(object):
             nn = self.symb.snptr[k+1]-self.symb.snptr[k]  
             na = self.symb.relptr[k+1]-self.symb.relptr[k]
             nnz += nn*na + nn*(nn+1)/2
+        if isinstance(self.blkval, matrix): tc = self.blkval.typecode
+        else: tc = _flatview(self.blkval).format
         if self.is_factor:
             return "<%ix%i chordal sparse matrix (factor), tc='%s', nnz=%i, nsn=%i>"\
-              % (self.symb.n,self.symb.n,self.blkval.typecode,nnz,self.symb.Nsn) 
+              % (self.symb.n,self.symb.n,tc,nnz,self.symb.Nsn) 
         else:
             return "<%ix%i chorcal sparse matrix, tc='%s', nnz=%i, nsn=%i>"\
-              % (self.symb.n,self.symb.n,self.blkval.typecode,nnz,self.symb.Nsn)
+              % (self.symb.n,self.symb.n,tc,nnz,self.symb.Nsn)
         
     def __iadd__(self, B):
         assert self.is_factor is False, "Addition of cspmatrix factors not supported"
         if isinstance(B, cspmatrix):
             assert self.symb == B.symb, "Symbolic factorization mismatch"
             assert B.is_factor is False, "Addition of cspmatrix factors not supported"
-            blas.axpy(B.blkval, self.blkval)
+            _blkaxpy(B.blkval, self.blkval)
         elif isinstance(B, spmatrix):
             self._iadd_spmatrix(B)
         else:
@@ -960,7 +1262,7 @@ class cspmatrix(object):
         if isinstance(B, cspmatrix):
             assert self.symb == B.symb, "Symbolic factorization mismatch"
             assert B.is_factor is False, "Addition of cspmatrix factors not supported"
-            blas.axpy(B.blkval, self.blkval, alpha = -1.0)
+            _blkaxpy(B.blkval, self.blkval, alpha = -1.0)
         elif isinstance(B, spmatrix):
             self._iadd_spmatrix(B, alpha = -1.0)    
         else:
@@ -998,9 +1300,9 @@ class cspmatrix(object):
 
     def __imul__(self, a):
         if isinstance(a,float):
-            blas.scal(a, self.blkval)
+            _blkscal(a, self.blkval)
         elif isinstance(a, int) or isinstance(a, long):
-            blas.scal(float(a), self.blkval)
+            _blkscal(float(a), self.blkval)
         else:
             raise NotImplementedError("only scalar multiplication has been implemented")
         return self
@@ -1052,8 +1354,13 @@ class cspmatrix(object):
         if self.is_factor:
             if symmetric: raise ValueError("'symmetric = True' not implemented for Cholesky factors")
             if not reordered: raise ValueError("'reordered = False' not implemented for Cholesky factors")
+
+        if _csc is not None:
+            return _csc(self, uplo = 'S' if symmetric else 'L', reordered = reordered or self.symb.p is None)
+
+        if self.is_factor:
             snpost = self.symb.snpost
-            blkval = +blkval
+            blkval = +_blkmatrix(blkval)
             for k in snpost:
                 j = snode[snptr[k]]            # representative vertex
                 nn = snptr[k+1]-snptr[k]       # |Nk|
@@ -1110,6 +1417,50 @@ class cspmatrix(object):
             if symmetric: return tmp
             else: return tril(tmp) 
 
+    def csc_chunks(self, maxnnz, uplo = 'L', reordered = True):
+        """
+        Generator that streams the :py:class:`cspmatrix` :math:`A` in
+        compressed column storage, in consecutive column ranges with
+        at most `maxnnz` nonzeros (or one column, if it has more).
+        Yields tuples (c0, c1, colptr, rowidx, val): the row indices
+        and values of column c (c0 <= c < c1) are rowidx[k] and val[k]
+        for colptr[c]-colptr[c0] <= k < colptr[c+1]-colptr[c0], sorted
+        by row index. `colptr` is the column pointer of the entire
+        matrix, and the buffers `rowidx` and `val` are reused by the
+        next range.
+
+        :param maxnnz:     positive integer
+        :param uplo:       'L' (lower triangle), 'U' (upper triangle), or 'S' (symmetric) (default: 'L')
+        :param reordered:  boolean (default: True)
+        """
+        assert uplo in ['L', 'U', 'S'], "uplo must be 'L', 'U', or 'S'"
+        if self.is_factor and (uplo != 'L' or not reordered):
+            raise ValueError("only uplo = 'L' and reordered = True are implemented for Cholesky factors")
+        n = self.symb.n
+        reordered = reordered or self.symb.p is None
+
+        if _csc_colptr is not None:
+            colptr = _csc_colptr(self, uplo = uplo, reordered = reordered)
+        else:
+            A = self.spmatrix(reordered = reordered, symmetric = (uplo == 'S'))
+            if uplo == 'U': A = A.T
+            colptr, ri, v = A.CCS
+
+        mnz = max([maxnnz] + [colptr[c+1]-colptr[c] for c in range(n)])
+        rowidx, val = matrix(0, (mnz,1)), matrix(0.0, (mnz,1))
+        c0 = 0
+        while c0 < n:
+            c1 = c0 + 1
+            while c1 < n and colptr[c1+1]-colptr[c0] <= maxnnz: c1 += 1
+            if _csc_fill is not None:
+                _csc_fill(self, colptr, rowidx, val, uplo = uplo, reordered = reordered, c0 = c0, c1 = c1)
+            else:
+                m = colptr[c1]-colptr[c0]
+                rowidx[:m] = ri[colptr[c0]:colptr[c1]]
+                val[:m] = v[colptr[c0]:colptr[c1]]
+            yield c0, c1, colptr, rowidx, val
+            c0 = c1
+
     def diag(self, reordered = True):
         """
         Returns a vector with the diagonal elements of the matrix.
@@ -1133,13 +1484,193 @@ class cspmatrix(object):
         symbolic factorization, but with a copy of the array
         that stores the numerical values.
         """
-        return cspmatrix(self.symb, blkval = +self.blkval, factor = self.is_factor)
-    
+        if isinstance(self.blkval, matrix):
+            return cspmatrix(self.symb, blkval = +self.blkval, factor = self.is_factor)
+        return cspmatrix(self.symb, blkval = matrix(self.blkval, (len(self.blkval),1), 'd'), factor = self.is_factor)
+
+    def memoryview(self):
+        """
+        Returns a memoryview of the array that stores the numerical
+        values (not a copy). The routines in :py:mod:`chompack` accept
+        any contiguous buffer of doubles as `blkval`, so an array
+        created from the view (e.g., with `numpy.asarray`) can be
+        modified in place or wrapped in a new :py:class:`cspmatrix`.
+        """
+        return _flatview(self.blkval)
+
+    def save(self, filename):
+        """
+        Writes the numerical values to the file `filename` in the
+        format read by :py:meth:`cspmatrix.open`: a header of
+        4096 bytes (MMAP_OFFSET), followed by `blkval` as native
+        doubles in `blkptr` order. The header records the factor flag
+        and a checksum of the symbolic factorization.
+        """
+        with open(filename, 'wb') as f:
+            f.write(_mmap_header(self.symb, self.is_factor))
+            f.write(memoryview(self.blkval).cast('B'))
+
+    @staticmethod
+    def open(filename, symb, mode = 'r+', factor = False):
+        """
+        Returns a :py:class:`cspmatrix` whose `blkval` is a memory-mapped
+        file, so that the numerical values need not fit in memory and
+        persist across processes.
+
+        :param filename:  file written by :py:meth:`cspmatrix.save`, or by a previous call with mode 'w+'
+        :param symb:      :py:class:`symbolic` object (the one used to write the file, or one computed from the same pattern and ordering)
+        :param mode:      'r+' (changes are written to the file), 'c' (copy-on-write: changes are not written to the file), or 'w+' (creates or overwrites the file with a zero matrix)
+        :param factor:    factor flag of a new file (mode 'w+')
+
+        The C routines (e.g., :py:func:`cholesky`, :py:func:`trsm` and
+        :py:func:`projected_inverse`) work on the mapping in place and
+        advise the operating system of their traversal order: the
+        supernodes are stored in postorder, so the bottom-up routines
+        read the file sequentially. :py:meth:`spmatrix` and
+        :py:func:`hessian` need a cvxopt `blkval`; use :py:meth:`copy`
+        to load the matrix into memory. Call :py:meth:`flush` to write
+        the values and the factor flag (mode 'r+' and 'w+'), and
+        :py:meth:`close` to release the mapping; the returned matrix is
+        also a context manager that closes it on exit:
+
+        .. code-block:: python
+
+            with cspmatrix.open(filename, symb) as L:
+                cholesky(L)
+        """
+        import mmap
+        length = symb.blkptr[-1]
+        if mode == 'w+':
+            with open(filename, 'w+b') as f:
+                f.write(_mmap_header(symb, factor))
+                f.truncate(MMAP_OFFSET + 8*length)
+        elif mode not in ('r+', 'c'):
+            raise ValueError("mode must be 'r+', 'c' or 'w+'")
+        with open(filename, 'rb' if mode == 'c' else 'r+b') as f:
+            header = f.read(MMAP_OFFSET)
+            if len(header) != MMAP_OFFSET or header[:8] != _MMAP_MAGIC:
+                raise ValueError("%s is not a cspmatrix file" % filename)
+            if header[:_MMAP_KEY] != _mmap_header(symb, False)[:_MMAP_KEY]:
+                raise ValueError("%s does not match the symbolic factorization" % filename)
+            mm = mmap.mmap(f.fileno(), MMAP_OFFSET + 8*length,
+                           access = mmap.ACCESS_COPY if mode == 'c' else mmap.ACCESS_WRITE)
+        blkval = memoryview(mm)[MMAP_OFFSET:MMAP_OFFSET+8*length].cast('d')
+        X = cspmatrix(symb, blkval = blkval, factor = bool(header[_MMAP_KEY] & 1))
+        X._mmap = mm
+        return X
+
+    def flush(self):
+        """
+        Writes the factor flag and the modified values of a matrix
+        returned by :py:meth:`cspmatrix.open` (mode 'r+' or 'w+') to
+        the file. No effect for other matrices.
+        """
+        mm = getattr(self, '_mmap', None)
+        if mm is None: return
+        mm[:MMAP_OFFSET] = _mmap_header(self.symb, self.is_factor)
+        mm.flush()
+
+    def close(self):
+        """
+        Flushes and unmaps a matrix returned by :py:meth:`cspmatrix.open`;
+        its `blkval` is then `None`. A :py:exc:`BufferError` is raised
+        (and the mapping is kept) while views of `blkval`, e.g., from
+        :py:meth:`memoryview` or `numpy.asarray`, are still alive.
+        No effect for other matrices.
+        """
+        mm = getattr(self, '_mmap', None)
+        if mm is None: return
+        self.flush()
+        self.blkval.release()
+        try:
+            mm.close()
+        except BufferError:
+            # other views still export the mapping: keep it usable
+            self.blkval = memoryview(mm)[MMAP_OFFSET:MMAP_OFFSET+8*self.symb.blkptr[-1]].cast('d')
+            raise
+        self._mmap = None
+        self.blkval = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+        return False
+
+    def add_coo(self, I, J, V, alpha = 1.0, uplo = 'L'):
+        """
+        Adds a chunk of entries of a sparse symmetric matrix in
+        coordinate format, in the original ordering:
+        `X[I[t],J[t]] += alpha*V[t]`. Duplicate entries are summed.
+
+        :param I, J:   row and column indices (:py:class:`matrix`, list, or buffer of integers, e.g., a numpy array)
+        :param V:      values (:py:class:`matrix`, list, or buffer of doubles)
+        :param alpha:  float (default: 1.0)
+        :param uplo:   'L' (entries above the diagonal are ignored), 'U' (entries below the diagonal are ignored), or 'A' (every entry is added to the lower triangle); default: 'L'
+
+        The entries are mapped through the inverse permutation to an
+        offset in `blkval` and accumulated in place, so a matrix that
+        arrives in chunks is assembled without forming a
+        :py:class:`spmatrix`: the memory used in addition to `blkval`
+        is proportional to the chunk. A :py:exc:`ValueError` is raised
+        if an entry is out of range or not contained in the chordal
+        embedding; the chunk is then not added.
+        """
+        assert self.is_factor is False, "cannot add entries to a cspmatrix factor"
+        assert uplo in ('L','U','A'), "uplo must be 'L', 'U' or 'A'"
+        if _coo_add is not None:
+            I, J, V = [_asbuffer(a, tc) for a, tc in ((I,'i'), (J,'i'), (V,'d'))]
+            _coo_add(self, I, J, V, alpha = alpha, uplo = uplo)
+            return
+
+        symb = self.symb
+        if symb._colsn is None:
+            colsn = matrix(0, (symb.n,1))
+            for k in range(symb.Nsn): colsn[symb.snode[symb.snptr[k]:symb.snptr[k+1]]] = k
+            symb._colsn = colsn
+        I, J, V = list(I), list(J), list(V)
+        assert len(I) == len(J) == len(V), "I, J and V must have the same length"
+        off = []
+        for t, (i, j) in enumerate(zip(I, J)):
+            if not (0 <= i < symb.n and 0 <= j < symb.n):
+                raise ValueError("entry %i is out of range" % t)
+            if (uplo == 'L' and i < j) or (uplo == 'U' and i > j):
+                off.append(-1)
+                continue
+            ii, jj = symb.ip[i], symb.ip[j]
+            if ii < jj: ii, jj = jj, ii
+            k = symb._colsn[jj]
+            r = list(symb.snrowidx[symb.sncolptr[k]:symb.sncolptr[k+1]])
+            l = bisect_left(r, ii)
+            if l == len(r) or r[l] != ii:
+                raise ValueError("entry %i (%i,%i) is not contained in the chordal embedding" % (t, i, j))
+            off.append(symb.blkptr[k] + len(r)*(jj-r[0]) + l)
+        for t, o in enumerate(off):
+            if o >= 0: self.blkval[o] += alpha*V[t]
+
+    def add_csc(self, colptr, rowidx, val, col0 = 0, alpha = 1.0, uplo = 'L'):
+        """
+        Adds a chunk of consecutive columns of a sparse symmetric matrix
+        in compressed column storage, in the original ordering: the
+        entries of column `col0+j` are `rowidx[colptr[j]:colptr[j+1]]`
+        with values `val[colptr[j]:colptr[j+1]]` (`colptr[0]` = 0).
+        The other arguments are as in :py:meth:`add_coo`.
+        """
+        colptr = list(colptr)
+        J = matrix(0, (colptr[-1],1))
+        for j in range(len(colptr)-1): J[colptr[j]:colptr[j+1]] = col0+j
+        self.add_coo(rowidx, J, val, alpha = alpha, uplo = uplo)
+
     def _iadd_spmatrix(self, X, alpha = 1.0):
         """
         Add a sparse matrix :math:`X` to :py:class:`cspmatrix`.
         """
         assert self.is_factor is False, "cannot add spmatrix to a cspmatrix factor"
+        if _coo_add is not None:
+            # lower triangle of X, without symmetrized or permuted copies
+            _coo_add(self, X.I, X.J, X.V, alpha = alpha)
+            return
 
         n = self.symb.n
         snptr = self.symb.snptr
@@ -0,0 +1,22 @@
+import unittest
+import chompack.bench as bench
+
+class TestBench(unittest.TestCase):
+
+    def test_problem(self):
+        for spec, n in [('grid2d:5', 25), ('grid3d:3', 27), ('band:30:3', 30), ('arrow:30:4', 30), ('randchordal:40:0.8', 40)]:
+            A = bench.problem(spec)
+            self.assertEqual(A.size, (n,n))
+            self.assertTrue(all(i >= j for i,j in zip(A.I,A.J)))
+        self.assertRaises(ValueError, bench.problem, 'foo:10')
+
+    def test_run_compare(self):
+        res = bench.run(['grid2d:6'], reps = 1, warmup = 0)
+        self.assertTrue('grid2d:6/cholesky/py' in res['results'])
+        self.assertEqual(bench.compare(res, res, tol = 0.0), [])
+        slow = dict(res, results = dict((k, dict(v, min = 0.5*v['min'])) for k,v in res['results'].items()))
+        self.assertEqual(len(bench.compare(res, slow, tol = 1.5)), 0)
+        self.assertEqual(len(bench.compare(res, slow, tol = 0.5)), len([v for v in res['results'].values() if v['min'] > 0]))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -1,7 +1,7 @@
 import unittest
 import random
 import chompack as cp
-from cvxopt import matrix,spmatrix,amd
+from cvxopt import matrix,spmatrix,sparse,amd
 
 class TestConversion(unittest.TestCase):
 
@@ -11,9 +11,48 @@ class TestConversion(unittest.TestCase):
     def assertAlmostEqualLists(self,u,v):
         for ui,vi in zip(u,v): self.assertAlmostEqual(ui,vi)
             
-    # Add test cases
-    #
-    #
+    def test_convert_block(self):
+        random.seed(2)
+        dim = 25
+        nz = [(i,j) for j in range(dim) for i in range(j,dim) if i == j or random.random() < 0.08]
+        H = spmatrix([random.random()-0.5 for _ in nz], [i for i,j in nz], [j for i,j in nz], (dim,dim))
+        h = spmatrix(H.V, [i+j*dim for i,j in nz], len(nz)*[0], (dim**2,1))
+        G = spmatrix([1.0,2.0,-1.0], [0, dim+1, 2*dim+2], [0,1,2], (dim**2,3))
+        (Gc, hc, Gcpl, dims), (blki, I, J, n), F = cp.convert_block(G, h, dim, max_density = 1.0)
+        self.assertEqual(Gc.size, (n,3))
+        self.assertEqual(sum(dims[k]**2 for k in range(len(dims))), n)
+        # block-diagonal representation of h maps back to H
+        self.assertTrue(all(type(x) is matrix and x.typecode == 'i' for x in (blki, I, J)))
+        S = spmatrix(matrix(hc)[blki], I, J, (dim,dim))
+        self.assertAlmostEqualLists(list(matrix(S)), list(matrix(H)))
+        # full coupling: one constraint per separator entry
+        na = [F.relptr[k+1]-F.relptr[k] for k in range(F.Nsn)]
+        self.assertEqual(Gcpl.size[1], sum(a*(a+1)//2 for a in na))
+        for j in range(Gcpl.size[1]):
+            self.assertAlmostEqual(sum(Gcpl[:,j]), 0.0)
+
+    def test_convert_conelp(self):
+        random.seed(3)
+        dim = 20
+        Gs, hs = [], []
+        for _ in range(2):
+            nz = [(i,j) for j in range(dim) for i in range(j,dim) if i == j or random.random() < 0.1]
+            hs.append(spmatrix([random.random()-0.5 for _ in nz], [i+j*dim for i,j in nz], len(nz)*[0], (dim**2,1)))
+            Gs.append(spmatrix([1.0,-1.0], [0, dim+1], [0,1], (dim**2,2)))
+        G = sparse([spmatrix([1.0,1.0], [0,0], [0,1], (1,2))] + Gs)
+        h = matrix([matrix(1.0)] + [matrix(hk) for hk in hs])
+        c = matrix(1.0, (2,1))
+        (ct, Gt, ht, dimst), b2s, symbs = cp.convert_conelp(c, G, h, {'l':1,'q':[],'s':[dim,dim]}, max_density = 1.0)
+        self.assertEqual(len(b2s), 2)
+        # the coupling blocks are stacked block-diagonally after the original columns
+        ncpl = [sum(a*(a+1)//2 for a in [F.relptr[k+1]-F.relptr[k] for k in range(F.Nsn)]) for F in symbs]
+        self.assertEqual(Gt.size, (1 + sum(n for _,_,_,n in b2s), 2 + sum(ncpl)))
+        self.assertEqual(ct.size, (Gt.size[1],1))
+        for j in range(2, Gt.size[1]):
+            self.assertAlmostEqual(sum(Gt[:,j]), 0.0)
+        self.assertEqual(Gt[1 + b2s[0][3]:, 2:2 + ncpl[0]].I.size[0], 0)
+        self.assertEqual(Gt[:1 + b2s[0][3], 2 + ncpl[0]:].I.size[0], 0)
+
     
 if __name__ == '__main__':
     unittest.main()
@@ -44,6 +44,111 @@ class TestCspmatrix(unittest.TestCase):
 
         self.assertAlmostEqualLists(list(Ac.diag(reordered=False)), list(self.A[::18]))
         self.assertAlmostEqualLists(list(Ac.diag(reordered=True)), list(self.A[self.symb.p,self.symb.p][::18]))
-                    
+
+    def test_csc_chunks(self):
+        Ac = cp.cspmatrix(self.symb) + self.A
+        for uplo in ['L', 'U', 'S']:
+            A = Ac.spmatrix(reordered=False, symmetric=(uplo == 'S'))
+            if uplo == 'U': A = A.T
+            I, J, V = [], [], []
+            for c0, c1, colptr, rowidx, val in Ac.csc_chunks(10, uplo=uplo, reordered=False):
+                for c in range(c0, c1):
+                    for k in range(colptr[c]-colptr[c0], colptr[c+1]-colptr[c0]):
+                        I.append(rowidx[k]); J.append(c); V.append(val[k])
+            diff = list(A - spmatrix(V, I, J, A.size))
+            self.assertAlmostEqualLists(diff, len(diff)*[0.0])
+
+    def test_memoryview(self):
+        Ac = cp.cspmatrix(self.symb) + self.A
+        mv = Ac.memoryview()
+        self.assertTrue(mv.format == 'd' and mv.ndim == 1 and len(mv) == len(Ac.blkval))
+        mv[0] = -1.0
+        self.assertEqual(Ac.blkval[0], -1.0)
+        snptr = self.symb.memoryviews()['snptr']
+        self.assertEqual(snptr.ndim, 1)
+        self.assertEqual(snptr[1], self.symb.snptr[1])
+        self.assertEqual(list(snptr), list(self.symb.snptr))
+
+        L = cp.cspmatrix(self.symb) + self.A + spmatrix(20.0, range(17), range(17))
+        L.is_factor = True
+        B = matrix([float(i+1) for i in range(34)], (17,2))
+        Bv = +B
+        cp.trsm(L, B)
+        cp.trsm(L, memoryview(Bv))
+        self.assertAlmostEqualLists(list(B), list(Bv))
+
+    def test_buffer_arithmetic(self):
+        # in-place arithmetic and repr on a blkval that is not a matrix
+        from array import array
+        Ac = cp.cspmatrix(self.symb) + self.A
+        Ab = cp.cspmatrix(self.symb, blkval = array('d', list(Ac.blkval)))
+        self.assertTrue("tc='d'" in repr(Ab))
+        Ab += Ac
+        Ab *= 0.5
+        Ab -= Ac
+        Ab *= 2
+        self.assertAlmostEqualLists(list(Ab.blkval), len(Ab.blkval)*[0.0])
+        Ac += Ab
+        self.assertAlmostEqualLists(list(Ac.blkval), list((cp.cspmatrix(self.symb) + self.A).blkval))
+
+    def test_blkval_type(self):
+        # an integer blkval is rejected by the C routines
+        L = cp.cspmatrix(self.symb, blkval = matrix(0, (len(cp.cspmatrix(self.symb).blkval),1)))
+        self.assertRaises(TypeError, cp.cholesky, L)
+
+    def test_mmap(self):
+        import os, tempfile
+        L = cp.cspmatrix(self.symb) + self.A + spmatrix(20.0, range(17), range(17))
+        Lm = L.copy()
+        cp.cholesky(L)
+        filenames = []
+        for _ in range(2):
+            fd, filename = tempfile.mkstemp()
+            os.close(fd)
+            filenames.append(filename)
+        try:
+            with cp.cspmatrix.open(filenames[0], self.symb, mode = 'w+') as Lf:
+                for i in range(len(Lm.blkval)): Lf.blkval[i] = Lm.blkval[i]
+                cp.cholesky(Lf)
+            self.assertTrue(Lf.blkval is None)
+            Lf.close()
+            with cp.cspmatrix.open(filenames[0], self.symb) as Lf:
+                self.assertTrue(Lf.is_factor)
+                self.assertAlmostEqualLists(list(L.blkval), list(Lf.blkval))
+                B = matrix([float(i+1) for i in range(17)])
+                Bf = +B
+                cp.trsm(L, B)
+                cp.trsm(Lf, Bf)
+                self.assertAlmostEqualLists(list(B), list(Bf))
+                # a live view keeps the mapping open
+                mv = Lf.memoryview()
+                self.assertRaises(BufferError, Lf.close)
+                self.assertEqual(Lf.blkval[0], mv[0])
+                del mv
+            L.save(filenames[1])
+            with cp.cspmatrix.open(filenames[1], self.symb, mode = 'c') as Lc:
+                self.assertAlmostEqualLists(list(L.blkval), list(Lc.copy().blkval))
+        finally:
+            for filename in filenames: os.remove(filename)
+
+    def test_add_coo(self):
+        Ac = cp.cspmatrix(self.symb) + self.A
+        I, J, V = list(self.A.I), list(self.A.J), list(self.A.V)
+        m = len(I)//2
+        X = cp.cspmatrix(self.symb)
+        X.add_coo(I[:m], J[:m], V[:m])
+        X.add_coo(J[m:], I[m:], V[m:], uplo = 'U')
+        self.assertAlmostEqualLists(list(Ac.blkval), list(X.blkval))
+
+        # a chunk with an invalid entry is not added
+        self.assertRaises(ValueError, X.add_coo, [0, 17], [0, 0], [1.0, 1.0])
+        self.assertAlmostEqualLists(list(Ac.blkval), list(X.blkval))
+
+        X = cp.cspmatrix(self.symb)
+        colptr, rowidx, val = self.A.CCS
+        X.add_csc(colptr[:9], rowidx[:colptr[8]], val[:colptr[8]])
+        X.add_csc([c - colptr[8] for c in colptr[8:]], rowidx[colptr[8]:], val[colptr[8]:], col0 = 8)
+        self.assertAlmostEqualLists(list(Ac.blkval), list(X.blkval))
+
 if __name__ == '__main__':
     unittest.main()
@@ -1,7 +1,7 @@
 import unittest
 import random
 import chompack as cp
-from cvxopt import matrix,spmatrix,amd,blas
+from cvxopt import matrix,spmatrix,amd,blas,lapack
 
 class TestNumeric(unittest.TestCase):
 
@@ -21,6 +21,51 @@ class TestNumeric(unittest.TestCase):
         A = cp.cspmatrix(self.symb) + self.A
         B = cp.cspmatrix(self.symb) - 2*self.A
         self.assertAlmostEqual(2.0*blas.dot(A.blkval, B.blkval) - blas.dot(A.diag(),B.diag()), cp.dot(A,B))
+
+    def test_gram(self):
+        X = [cp.cspmatrix(self.symb) + (k+1)*self.A for k in range(3)]
+        Y = [cp.cspmatrix(self.symb) - (k+2)*self.A for k in range(2)]
+        G = cp.gram(X,Y)
+        self.assertAlmostEqualLists([cp.dot(Xi,Yj) for Yj in Y for Xi in X], list(G))
+        G = cp.gram(X)
+        self.assertAlmostEqualLists([cp.dot(Xi,Xj) for Xj in X for Xi in X], list(G))
+
+    def test_syrk(self):
+        n = self.symb.n
+        U = matrix([random.random()-0.5 for _ in range(3*n)],(n,3))
+        w = matrix([1.0,-2.0,0.5])
+        X = cp.cspmatrix(self.symb) + self.A
+        Y = X.copy()
+        cp.syrk(X, U, w, alpha = 0.5, beta = 2.0)
+        for j in range(3):
+            cp.syr2(Y, U[:,j], U[:,j], alpha = 0.25*w[j], beta = 2.0 if j == 0 else 1.0)
+        self.assertAlmostEqualLists(list(X.blkval), list(Y.blkval))
+
+    def test_symm(self):
+        n = self.symb.n
+        X = cp.cspmatrix(self.symb) + self.A
+        B = matrix([random.random()-0.5 for _ in range(3*n)],(n,3))
+        C = matrix([random.random()-0.5 for _ in range(3*n)],(n,3))
+        C2 = +C
+        D = 2.0*(X.spmatrix(reordered = False, symmetric = True)*B) - C
+        cp.symm(X, B, C, alpha = 2.0, beta = -1.0)
+        self.assertAlmostEqualLists(list(C), list(D))
+
+        # reordered = True: the product with the permuted matrix
+        D = 2.0*(X.spmatrix(reordered = True, symmetric = True)*B) - C2
+        cp.symm(X, B, C2, alpha = 2.0, beta = -1.0, reordered = True)
+        self.assertAlmostEqualLists(list(C2), list(D))
+
+    def test_spmap(self):
+        I, J, V = self.A.I, self.A.J, self.A.V
+        Al = [spmatrix(V[k::3], I[k::3], J[k::3], self.A.size) for k in range(3)]
+        M = cp.spmap(self.symb, Al)
+        X = cp.cspmatrix(self.symb) + self.A
+        self.assertAlmostEqualLists(list(M.dot(X)), [cp.dot(cp.cspmatrix(self.symb) + Ai, X) for Ai in Al])
+        y = matrix([1.0, -2.0, 0.5])
+        Y = M.adjoint(y)
+        Z = cp.cspmatrix(self.symb) + (y[0]*Al[0] + y[1]*Al[1] + y[2]*Al[2])
+        self.assertAlmostEqualLists(list(Y.blkval), list(Z.blkval))
                     
     def test_cholesky(self):
         L = cp.cspmatrix(self.symb) + self.A
@@ -28,7 +73,36 @@ class TestNumeric(unittest.TestCase):
         Lm = L.spmatrix(reordered=True)
         diff = list( (cp.tril(cp.perm(Lm*Lm.T,self.symb.ip)) - self.A).V )
         self.assertAlmostEqualLists(diff, len(diff)*[0.0])
-        
+
+    def test_cholesky_reg(self):
+        n = self.symb.n
+        A = self.A - spmatrix([10.5*(i % 2) for i in range(n)], range(n), range(n))
+        L = cp.cspmatrix(self.symb) + A
+        I, V = cp.cholesky(L, delta = 1.0, tol = 1e-8)
+        self.assertTrue(len(I) > 0)
+        Lm = L.spmatrix(reordered=True)
+        diff = list( (cp.tril(cp.perm(Lm*Lm.T,self.symb.ip)) - A - spmatrix(V, I, I, (n,n))).V )
+        self.assertAlmostEqualLists(diff, len(diff)*[0.0])
+
+    def test_cholesky_tiled(self):
+        # two cliques of order 50 joined by a dense separator of order 500:
+        # both child fronts are large enough for the tiled factorization
+        # (without OpenMP, nthreads > 1 runs it sequentially)
+        I, J = [], []
+        for c in (range(50), range(50,100)):
+            for j in c:
+                rows = [i for i in c if i >= j] + list(range(100,600))
+                I += rows; J += len(rows)*[j]
+        for j in range(100,600):
+            I += range(j,600); J += (600-j)*[j]
+        A = spmatrix([random.random()-0.5 for _ in I], I, J, (600,600)) + spmatrix(600.0, range(600), range(600))
+        symb = cp.symbolic(A)
+        L1 = cp.cspmatrix(symb) + A
+        L2 = L1.copy()
+        cp.cholesky(L1)
+        cp.cholesky(L2, nthreads = 4)
+        self.assertAlmostEqualLists(list(L1.blkval), list(L2.blkval))
+
     def test_llt(self):
         A = cp.cspmatrix(self.symb) + self.A
         cp.cholesky(A)
@@ -123,6 +197,75 @@ class TestNumeric(unittest.TestCase):
         diff = list(B-Bt[self.symb.ip,:])[:]
         self.assertAlmostEqualLists(diff, len(diff)*[0.0])
         
+    def test_solve(self):
+        A = cp.cspmatrix(self.symb) + self.A
+        L = cp.cspmatrix(self.symb) + 1.05*self.A   # factor of a perturbation of A
+        cp.cholesky(L)
+        B = matrix([random.random()-0.5 for _ in range(2*self.symb.n)],(self.symb.n,2))
+        X = +B
+        res = cp.solve(A, L, X, refine = 20, tol = 1e-12)
+        R = B - A.spmatrix(reordered = False, symmetric = True)*X
+        for j in range(2):
+            self.assertTrue(res[j] <= 1e-12*blas.nrm2(B[:,j]))
+            self.assertAlmostEqual(res[j], blas.nrm2(R[:,j]))
+
+    def test_futures(self):
+        try:
+            from chompack.futures import Executor
+        except ImportError:
+            return
+        X = [cp.cspmatrix(self.symb) + (k+1)*self.A for k in range(4)]
+        Y = [Xk.copy() for Xk in X]
+        with Executor(max_workers = 4) as ex:
+            for f in [ex.cholesky(Xk) for Xk in X]: f.result()
+        for Xk, Yk in zip(X, Y):
+            cp.cholesky(Yk)
+            self.assertAlmostEqualLists(list(Xk.blkval), list(Yk.blkval))
+        if not cp.__py_only__:
+            X[0]._busy = 1    # in use by a concurrent call
+            self.assertRaises(RuntimeError, cp.llt, X[0])
+            cp.trsm(X[0], matrix(1.0, (self.symb.n, 1)))
+
+    def test_ldl(self):
+        n = self.symb.n
+        B = matrix([random.random()-0.5 for _ in range(2*n)],(n,2))
+        s = matrix([-1 if i % 3 == 0 else 1 for i in range(n)])
+        # indefinite (Bunch-Kaufman) and quasidefinite (regularized) matrices
+        for A, signs in [(self.A - spmatrix([10.5*(i % 2) for i in range(n)], range(n), range(n)), None),
+                         (self.A + spmatrix([20.0*si-10.0 for si in s], range(n), range(n)), s)]:
+            L = cp.cspmatrix(self.symb) + A
+            ipiv = matrix(0, (n,1))
+            inertia, nreg = cp.ldl(L, ipiv, signs = signs, delta = 1e-8)
+            self.assertEqual(sum(inertia), n)
+            self.assertEqual(nreg, 0)
+            if signs is not None: self.assertEqual(inertia[1], sum(1 for si in s if si < 0))
+            X = +B
+            cp.ldltrsm(L, ipiv, X, trans = 'N')
+            cp.ldltrsm(L, ipiv, X, trans = 'D')
+            cp.ldltrsm(L, ipiv, X, trans = 'T')
+            diff = list((cp.symmetrize(A)*X - B)[:])
+            self.assertAlmostEqualLists(diff, len(diff)*[0.0])
+
+    def test_steplength(self):
+        n = self.symb.n
+        X = cp.cspmatrix(self.symb) + self.A
+        I, J = self.A.I, self.A.J
+        dX = cp.cspmatrix(self.symb) + spmatrix([random.random()-0.7 for _ in I], I, J, (n,n))
+        alpha, certified = cp.steplength(X, dX, maxiter = n)
+        self.assertTrue(certified)
+        # dense reference
+        L = matrix(cp.symmetrize(self.A))
+        D = matrix(cp.symmetrize(dX.spmatrix(reordered = False)))
+        lapack.potrf(L)
+        blas.trsm(L, D)
+        blas.trsm(L, D, side = 'R', transA = 'T')
+        lam = matrix(0.0, (n,1))
+        lapack.syevd(D, lam)
+        self.assertAlmostEqual(alpha, -1.0/lam[0])
+        alpha_c, certified = cp.steplength(X, dX, completable = True)
+        self.assertTrue(certified)
+        self.assertTrue(alpha_c >= alpha*(1.0-1e-8))
+
     def test_pfcholesky(self):
         U = matrix(range(1,2*self.symb.n+1),(self.symb.n,2),tc='d')/self.symb.n
         alpha = matrix([1.2,-0.01])
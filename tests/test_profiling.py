@@ -0,0 +1,31 @@
+import unittest
+import chompack as cp
+import chompack.profiling as prof
+from cvxopt import spmatrix, amd
+
+class TestProfiling(unittest.TestCase):
+
+    def test_chrome_trace(self):
+        D = {'kernel': [0, 0], 'supernode': [0, 1], 'nn': [2, 1], 'na': [1, 0], 'stack_depth': [1, 0],
+             'stack_bytes': [8, 0], 'start': [0.0, 1e-3], 'flops': [10.0, 1.0]}
+        for ph in prof.PHASES: D[ph] = [1e-4, 0.0]
+        S = prof.summary(D)
+        self.assertEqual(S['cholesky']['supernodes'], 2)
+        self.assertAlmostEqual(S['cholesky']['time'], len(prof.PHASES)*1e-4)
+        self.assertEqual(S['cholesky']['stack_bytes'], 8)
+        T = prof.chrome_trace(D)
+        self.assertEqual(len([e for e in T['traceEvents'] if e['ph'] == 'X']), 2 + len(prof.PHASES))
+
+    def test_record(self):
+        A = spmatrix([4.0,1.0,4.0,1.0,4.0], [0,1,1,2,2], [0,0,1,1,2])
+        L = cp.cspmatrix(cp.symbolic(A, p = amd.order)) + A
+        try:
+            with prof.record() as P:
+                cp.cholesky(L)
+        except NotImplementedError:
+            self.skipTest("built without CHOMPACK_PROFILE")
+        S = prof.summary(P.data)
+        self.assertEqual(S['cholesky']['supernodes'], L.symb.Nsn)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -1,5 +1,6 @@
 import unittest
 import random
+import sys
 import chompack as cp
 from cvxopt import matrix,spmatrix,amd
 
@@ -40,6 +41,21 @@ class TestSymbolic(unittest.TestCase):
         #symb = cp.symbolic(self.A, p = amd.order)
         #self.assertEqual(list(symb.p), list(p))
                     
+    def test_cost(self):
+        symb = cp.symbolic(self.A, p = None)
+        c = symb.cost(nrhs = 2)
+        for op in ['cholesky','llt','projected_inverse','completion','hessian','trsm']:
+            self.assertTrue(c['flops'][op] > 0)
+            self.assertTrue(c['critical_path'][op] <= c['flops'][op])
+            self.assertAlmostEqual(c['parallelism'][op], c['flops'][op]/c['critical_path'][op])
+            self.assertTrue(c['memory'][op] >= 8*symb.blkptr[-1])
+        # trsm: two right-hand sides cost twice as much as one
+        self.assertAlmostEqual(c['flops']['trsm'], 2*symb.cost()['flops']['trsm'])
+        # cholesky flops of a single dense clique
+        symb = cp.symbolic(spmatrix(1.0, [i for j in range(4) for i in range(j,4)], [j for j in range(4) for i in range(j,4)]))
+        self.assertAlmostEqual(symb.cost()['flops']['cholesky'], 4**3/3.)
+        self.assertAlmostEqual(symb.cost()['parallelism']['cholesky'], 1.0)
+
     def test_merge(self):
         symb = cp.symbolic(self.A, p = None, merge_function = cp.merge_size_fill(0,0))
         self.assertEqual(symb.n, 17)
@@ -59,6 +75,37 @@ class TestSymbolic(unittest.TestCase):
         #self.assertEqual(symb.p, None)
         #self.assertEqual(symb.ip, None)
 
+    def test_merge_auto(self):
+        # fixed cost model: merging is free, so everything is merged
+        model = {'size': [1, 64], 'potrf': [1e9, 1e9], 'trsm': [1e9, 1e9], 'syrk': [1e9, 1e9],
+                 'overhead': 1.0, 'extend_add': 0.0}
+        fmerge = cp.merge_auto(model = model)
+        self.assertEqual(fmerge.cost_model, model)
+        self.assertTrue(fmerge(10, 5, 1, 1))
+        symb = cp.symbolic(self.A, p = None, merge_function = fmerge)
+        self.assertEqual(symb.Nsn, 1)
+        self.assertEqual(symb.clique_number, 17)
+
+        # no overhead or extend-add cost: merging only adds flops
+        model['overhead'] = 0.0
+        symb = cp.symbolic(self.A, p = None, merge_function = cp.merge_auto(model = model))
+        self.assertTrue(symb.Nsn > 1)
+
+        # C and Python implementations of amalgamate agree
+        symbmod = sys.modules['chompack.symbolic']
+        p = amd.order(self.A_nc)
+        for f in [cp.merge_size_fill(4,4), cp.merge_auto(model = model), lambda ccp,cck,np,nk: nk <= 2]:
+            symb1 = cp.symbolic(self.A_nc, p = p, merge_function = f)
+            camalgamate, symbmod._amalgamate = symbmod._amalgamate, None
+            try:
+                symb2 = cp.symbolic(self.A_nc, p = p, merge_function = f)
+            finally:
+                symbmod._amalgamate = camalgamate
+            self.assertEqual(symb1.Nsn, symb2.Nsn)
+            self.assertEqualLists(symb1.snpar, symb2.snpar)
+            self.assertEqualLists(symb1.snrowidx, symb2.snrowidx)
+            self.assertEqualLists(symb1.p, symb2.p)
+
     def test_symbolic_nc(self):
         symb = cp.symbolic(self.A_nc, p = None)
         self.assertEqual(symb.n, 23)